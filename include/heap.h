@@ -108,6 +108,44 @@ typedef struct st_heap_block
   ulong last_allocated; /* number of records there is allocated space for */
 } HP_BLOCK;
 
+/*
+  Columns whose data is kept out of the fixed size row, in the arena.
+  For a VARCHAR the row keeps the length bytes and a pointer to the data.
+  A BLOB is stored like in the record, with the pointer changed to point
+  into the arena.
+*/
+
+typedef struct st_hp_columndef
+{
+  uint offset;				/* Offset of column in record */
+  uint length;				/* Length of column in record */
+  uint length_bytes;			/* Bytes used to store data length */
+  uint null_pos;			/* Position to NULL indicator */
+  uint8 null_bit;			/* Bitmask to test for NULL, or 0 */
+  my_bool blob;				/* TRUE for BLOB, FALSE for VARCHAR */
+  uint stored_offset;			/* Offset of column in stored row */
+} HP_COLUMNDEF;
+
+#define HP_ARENA_ALIGN		16
+#define HP_ARENA_MAX_CHUNK	1024
+#define HP_ARENA_CLASSES	(HP_ARENA_MAX_CHUNK / HP_ARENA_ALIGN)
+#define HP_ARENA_PAGE_SIZE	(32*1024)
+
+/*
+  Page based allocator for the data of HP_COLUMNDEF columns.
+  Chunks up to HP_ARENA_MAX_CHUNK bytes are cut from pages and freed
+  chunks are kept on one free list per size, bigger chunks are
+  allocated one by one.
+*/
+
+typedef struct st_heap_arena
+{
+  uchar *pages;				/* List of pages, newest first */
+  uchar *free_pos, *free_end;		/* Unused part of newest page */
+  uchar *free_chunks[HP_ARENA_CLASSES];	/* Free lists by size */
+  struct st_hp_big_chunk *big_chunks;	/* Chunks allocated one by one */
+} HP_ARENA;
+
 struct st_heap_info;			/* For referense */
 
 typedef struct st_hp_keydef		/* Key definition with open */
@@ -141,7 +179,8 @@ typedef struct st_heap_share
   uint records;				/* records */
   uint blength;				/* records rounded up to 2^n */
   uint deleted;				/* Deleted records in database */
-  uint reclength;			/* Length of one record */
+  uint reclength;			/* Length of one stored record */
+  uint record_length;			/* Length of record given by caller */
   uint changed;
   uint keys,max_key_length;
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
@@ -156,6 +195,10 @@ typedef struct st_heap_share
   uint auto_key;
   uint auto_key_type;			/* real type of the auto key segment */
   ulonglong auto_increment;
+  my_bool internal;			/* Internal temporary table */
+  HP_COLUMNDEF *columndef;		/* Columns stored out of the row */
+  uint columns;
+  HP_ARENA arena;
 } HP_SHARE;
 
 struct st_hp_hash_info;
@@ -171,6 +214,7 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar *rowbuf;                         /* Stored row built by heap_update */
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -184,6 +228,8 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_COLUMNDEF *columndef;		/* Only for internal tables */
+  uint columns;
   ulong max_records;
   ulong min_records;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
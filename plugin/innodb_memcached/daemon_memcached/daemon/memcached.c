@@ -4035,6 +4035,106 @@ static char *get_suffix_buffer(conn *c) {
     return suffix;
 }
 
+/*
+ * Fetch all keys of a get command with one get_multi() call. The rest of
+ * the command line is tokenized in a copy, so that process_get_command()
+ * can tokenize it again. Returns the number of keys, with the items in
+ * *items in command line order, 0 if the engine could not do it, or -1
+ * if a key is too long.
+ */
+static int get_multi_prefetch(conn *c, token_t *key_token, item ***items) {
+    token_t tokens[MAX_TOKENS];
+    const void **keys = NULL;
+    int *nkeys = NULL;
+    char *rest = NULL;
+    int n = 0;
+    int size = 0;
+    bool ok = true;
+
+    *items = NULL;
+
+    if (settings.engine.v1->get_multi == NULL) {
+        return 0;
+    }
+
+    while (ok) {
+        for (; key_token->length != 0; key_token++) {
+            if (key_token->length > KEY_MAX_LENGTH) {
+                n = -1;
+                ok = false;
+                break;
+            }
+
+            if (n == size) {
+                size = size ? size * 2 : MAX_TOKENS;
+                const void **new_keys = realloc(keys, size * sizeof(*keys));
+                if (new_keys != NULL) {
+                    keys = new_keys;
+                }
+                int *new_nkeys = realloc(nkeys, size * sizeof(*nkeys));
+                if (new_nkeys != NULL) {
+                    nkeys = new_nkeys;
+                }
+                if (new_keys == NULL || new_nkeys == NULL) {
+                    ok = false;
+                    break;
+                }
+            }
+
+            keys[n] = key_token->value;
+            nkeys[n] = key_token->length;
+            n++;
+        }
+
+        if (!ok || key_token->value == NULL) {
+            break;
+        }
+
+        if (rest == NULL) {
+            rest = strdup(key_token->value);
+            if (rest == NULL) {
+                ok = false;
+                break;
+            }
+            tokenize_command(rest, tokens, MAX_TOKENS);
+        } else {
+            tokenize_command(key_token->value, tokens, MAX_TOKENS);
+        }
+        key_token = tokens;
+    }
+
+    if (ok) {
+        *items = malloc(n * sizeof(item *));
+        ok = *items != NULL
+             && settings.engine.v1->get_multi(settings.engine.v0, c, *items,
+                                              keys, nkeys, n, 0)
+                == ENGINE_SUCCESS;
+    }
+
+    if (!ok) {
+        free(*items);
+        *items = NULL;
+        n = n < 0 ? -1 : 0;
+    }
+
+    free(rest);
+    free(keys);
+    free(nkeys);
+
+    return n;
+}
+
+/* Release the prefetched items that were not handed out */
+static void get_multi_release(conn *c, item **items, int from, int n) {
+    for (; from < n; from++) {
+        if (items[from] != NULL) {
+            settings.engine.v1->release(settings.engine.v0, c, items[from]);
+        }
+    }
+
+    free(items);
+}
+
 /* ntokens is overwritten here... shrug.. */
 static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens, bool return_cas) {
     char *key;
@@ -4042,12 +4142,22 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
     int i = c->ileft;
     item *it;
     token_t *key_token = &tokens[KEY_TOKEN];
+    item **prefetched = NULL;
+    int nprefetched = 0;
+    int k = 0;
     assert(c != NULL);
 
-    /* We temporarily block the mgets commands till wl6650 checked in. */
+    /* Several keys are only supported by engines that do multi-get */
     if ((key_token + 1)->length > 0) {
-	out_string(c, "We temporarily don't support multiple get option.");
-	return NULL;
+        nprefetched = get_multi_prefetch(c, key_token, &prefetched);
+
+        if (nprefetched < 0) {
+            out_string(c, "CLIENT_ERROR bad command line format");
+            return NULL;
+        } else if (nprefetched == 0) {
+            out_string(c, "We temporarily don't support multiple get option.");
+            return NULL;
+        }
     }
 
     do {
@@ -4064,7 +4174,11 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
             ENGINE_ERROR_CODE ret = c->aiostat;
             c->aiostat = ENGINE_SUCCESS;
 
-            if (ret == ENGINE_SUCCESS) {
+            if (prefetched != NULL) {
+                it = prefetched[k];
+                prefetched[k++] = NULL;
+                ret = it != NULL ? ENGINE_SUCCESS : ENGINE_KEY_ENOENT;
+            } else if (ret == ENGINE_SUCCESS) {
                 ret = settings.engine.v1->get(settings.engine.v0, c, &it, key, nkey, 0);
             }
 
@@ -4111,6 +4225,9 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
                 if (suffix == NULL) {
                     out_string(c, "SERVER_ERROR out of memory rebuilding suffix");
                     settings.engine.v1->release(settings.engine.v0, c, it);
+                    if (prefetched != NULL) {
+                        get_multi_release(c, prefetched, k, nprefetched);
+                    }
                     return NULL;
                 }
                 int suffix_len = snprintf(suffix, SUFFIX_SIZE,
@@ -4134,6 +4251,9 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
                   if (cas == NULL) {
                     out_string(c, "SERVER_ERROR out of memory making CAS suffix");
                     settings.engine.v1->release(settings.engine.v0, c, it);
+                    if (prefetched != NULL) {
+                        get_multi_release(c, prefetched, k, nprefetched);
+                    }
                     return NULL;
                   }
                   int cas_len = snprintf(cas, SUFFIX_SIZE, " %"PRIu64"\r\n",
@@ -4182,6 +4302,14 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
             key_token++;
         }
 
+        /*
+         * Stop at a failure; the remaining prefetched items would not
+         * match the keys if they were tokenized again.
+         */
+        if (prefetched != NULL && key_token->length != 0) {
+            break;
+        }
+
         /*
          * If the command string hasn't been fully processed, get the next set
          * of tokens.
@@ -4193,6 +4321,10 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
 
     } while(key_token->value != NULL);
 
+    if (prefetched != NULL) {
+        get_multi_release(c, prefetched, k, nprefetched);
+    }
+
     c->icurr = c->ilist;
     c->ileft = i;
     c->suffixcurr = c->suffixlist;
@@ -7030,6 +7162,7 @@ typedef struct eng_config_info {
 	unsigned int    eng_r_batch_size;
 	unsigned int    eng_w_batch_size;
 	bool		enable_binlog;
+	unsigned int    eng_w_batch_time;
 } eng_config_info_t;
 #endif /* INNODB_MEMCACHED */
 
@@ -7075,6 +7208,7 @@ int main (int argc, char **argv) {
 	my_eng_config.eng_r_batch_size = m_config->m_r_batch_size;
 	my_eng_config.eng_w_batch_size = m_config->m_w_batch_size;
 	my_eng_config.enable_binlog = m_config->m_enable_binlog;
+	my_eng_config.eng_w_batch_time = m_config->m_w_batch_time;
 	my_eng_config.option_string = old_opts;
 	engine_config = (const char *) (&my_eng_config);
 
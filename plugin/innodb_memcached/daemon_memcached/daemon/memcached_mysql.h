@@ -36,6 +36,7 @@ struct memcached_context
 	void*		m_innodb_api_cb;
 	unsigned int	m_r_batch_size;
 	unsigned int	m_w_batch_size;
+	unsigned int	m_w_batch_time;
 	bool		m_enable_binlog;
 };
 
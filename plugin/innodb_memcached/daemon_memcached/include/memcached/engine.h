@@ -551,7 +551,35 @@ extern "C" {
         size_t (*errinfo)(ENGINE_HANDLE *handle, const void* cookie,
                           char *buffer, size_t buffsz);
 
-
+        /**
+         * Retrieve several items at once (optional).
+         *
+         * The engine may look the keys up in any order. Every item
+         * returned must be released with release(). If the engine
+         * returns anything but ENGINE_SUCCESS, no item was returned
+         * and the frontend refuses the command. It does not call get()
+         * for each key instead, because an engine may return the item
+         * of get() in a buffer of the connection that the next get()
+         * overwrites.
+         *
+         * @param handle the engine handle
+         * @param cookie The cookie provided by the frontend
+         * @param items output array that will receive the located
+         *              items, or NULL for the keys that were not found
+         * @param keys the keys to look up
+         * @param nkeys the lengths of the keys
+         * @param nitems the number of keys
+         * @param vbucket the virtual bucket id
+         *
+         * @return ENGINE_SUCCESS if all goes well
+         */
+        ENGINE_ERROR_CODE (*get_multi)(ENGINE_HANDLE* handle,
+                                       const void* cookie,
+                                       item** items,
+                                       const void** keys,
+                                       const int* nkeys,
+                                       int nitems,
+                                       uint16_t vbucket);
 
     } ENGINE_HANDLE_V1;
 
@@ -224,6 +224,12 @@ uint64_t
 mci_get_time(void);
 /*==============*/
 
+/*************************************************************//**
+Get current time in milliseconds */
+uint64_t
+mci_get_time_ms(void);
+/*=================*/
+
 /** types of operations performed */
 typedef enum conn_op_type {
 	CONN_OP_READ,		/*!< read operation */
@@ -232,6 +238,18 @@ typedef enum conn_op_type {
 	CONN_OP_FLUSH		/*!< flush operation */
 } conn_op_type_t;
 
+/*************************************************************//**
+Check whether the uncommitted updates of a connection were started
+longer than the write batch time window ago.
+@return true if the transaction should be committed */
+bool
+innodb_api_write_batch_expired(
+/*===========================*/
+	innodb_engine_t*	engine,		/*!< in: InnoDB Memcached
+						engine */
+	innodb_conn_data_t*	conn_data);	/*!< in: cursor affiliated
+						with a connection */
+
 /*************************************************************//**
 Increment read and write counters, if they exceed the batch size,
 commit the transaction. */
@@ -84,6 +84,12 @@ struct innodb_conn_data_struct {
 	uint64_t	n_writes_since_commit;
 					/*!< number of updates since
 					last commit */
+	uint64_t	write_batch_start;
+					/*!< time in milliseconds of the
+					first update since last commit */
+	int		n_mul_items;	/*!< number of items returned by
+					a multi-get that are not yet
+					released */
 	void*		thd;		/*!< MySQL THD, used for binlog */
 	void*		mysql_tbl;	/*!< MySQL TABLE, used for binlog */
 	meta_cfg_info_t*conn_meta;	/*!< metadata info for this
@@ -156,6 +162,9 @@ typedef struct innodb_engine {
 						size */
 	uint64_t		write_batch_size;/*!< configured write batch
 						size */
+	uint64_t		write_batch_time;/*!< configured write batch
+						time window in milliseconds,
+						or 0 */
 	hash_table_t*		meta_hash;	/*!< hash table for metadata */
 } innodb_engine_t;
 
@@ -941,6 +941,20 @@ mci_get_time(void)
 	return((uint64_t)tv.tv_sec);
 }
 
+/*************************************************************//**
+Get current time
+@return time in milliseconds */
+uint64_t
+mci_get_time_ms(void)
+/*=================*/
+{
+	struct timeval tv;
+
+	gettimeofday(&tv,NULL);
+
+	return((uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
 /*************************************************************//**
 Set up a record with multiple columns for insertion
 @return DB_SUCCESS if successful, otherwise, error code */
@@ -1885,6 +1899,24 @@ innodb_reset_conn(
 	return(commit_trx);
 }
 
+/*************************************************************//**
+Check whether the uncommitted updates of a connection were started
+longer than the write batch time window ago.
+@return true if the transaction should be committed */
+bool
+innodb_api_write_batch_expired(
+/*===========================*/
+	innodb_engine_t*	engine,		/*!< in: InnoDB Memcached
+						engine */
+	innodb_conn_data_t*	conn_data)	/*!< in: cursor affiliated
+						with a connection */
+{
+	return(engine->write_batch_time
+	       && conn_data->n_writes_since_commit > 0
+	       && mci_get_time_ms() - conn_data->write_batch_start
+	       >= engine->write_batch_time);
+}
+
 /*************************************************************//**
 Increment read and write counters, if they exceed the batch size,
 commit the transaction. */
@@ -1908,7 +1940,11 @@ innodb_api_cursor_reset(
 	case CONN_OP_DELETE:
 	case CONN_OP_WRITE:
 		conn_data->n_total_writes++;
-		conn_data->n_writes_since_commit++;
+
+		if (conn_data->n_writes_since_commit++ == 0
+		    && engine->write_batch_time) {
+			conn_data->write_batch_start = mci_get_time_ms();
+		}
 		break;
 	case CONN_OP_FLUSH:
 		break;
@@ -1916,6 +1952,7 @@ innodb_api_cursor_reset(
 
 	if (conn_data->n_reads_since_commit >= engine->read_batch_size
 	    || conn_data->n_writes_since_commit >= engine->write_batch_size
+	    || innodb_api_write_batch_expired(engine, conn_data)
 	    || (op_type == CONN_OP_FLUSH) || !commit) {
 		commit_trx = innodb_reset_conn(
 			conn_data, op_type == CONN_OP_FLUSH, commit,
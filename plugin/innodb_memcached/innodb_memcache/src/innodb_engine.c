@@ -72,6 +72,8 @@ typedef struct eng_config_info {
 	bool		eng_enable_binlog;	/*!< whether binlog is
 						enabled specifically for
 						this memcached engine */
+	unsigned int	eng_write_batch_time;	/*!< write batch time window
+						in milliseconds */
 } eng_config_info_t;
 
 extern option_t config_option_names[];
@@ -187,6 +189,7 @@ create_instance(
 	innodb_eng->engine.get_stats_struct = NULL;
 	innodb_eng->engine.errinfo = NULL;
 	innodb_eng->engine.bind = innodb_bind;
+	innodb_eng->engine.get_multi = innodb_get_multi;
 
 	innodb_eng->server = *api;
 	innodb_eng->get_server_api = get_server_api;
@@ -308,7 +311,9 @@ innodb_bk_thread(
 			if ((conn_data->n_writes_since_commit > 0
 			     || conn_data->n_reads_since_commit > 0)
 			    && trx_start
-			    && (time - trx_start > CONN_IDLE_TIME_TO_BK_COMMIT)
+			    && (time - trx_start > CONN_IDLE_TIME_TO_BK_COMMIT
+				|| innodb_api_write_batch_expired(
+					innodb_eng, conn_data))
 			    && !conn_data->in_use) {
 				/* binlog is running, make the thread
 				attach to conn_data->thd for binlog
@@ -406,6 +411,8 @@ innodb_initialize(
 					? my_eng_config->eng_write_batch_size
 					: CONN_NUM_WRITE_COMMIT);
 
+	innodb_eng->write_batch_time = my_eng_config->eng_write_batch_time;
+
 	innodb_eng->enable_binlog = my_eng_config->eng_enable_binlog;
 
 	innodb_eng->cfg_status = innodb_cb_get_cfg();
@@ -1430,6 +1437,17 @@ innodb_release(
 		return;
 	}
 
+	/* Items returned by innodb_get_multi() are copies */
+	if (conn_data->n_mul_items > 0 && item != conn_data->result) {
+		free(item);
+
+		if (--conn_data->n_mul_items == 0) {
+			conn_data->result_in_use = false;
+		}
+
+		return;
+	}
+
 	conn_data->result_in_use = false;
 
 	/* If item's memory comes from Memcached default engine, release it
@@ -1500,132 +1518,20 @@ convert_to_char(
 }
 
 /*******************************************************************//**
-Support memcached "GET" command, fetch the value according to key
-@return ENGINE_SUCCESS if successfully, otherwise error code */
+Check whether a row fetched by innodb_api_search() has expired, and
+assemble its "value" column(s) into a single memcached value
+@return false if the row has expired */
 static
-ENGINE_ERROR_CODE
-innodb_get(
-/*=======*/
-	ENGINE_HANDLE*		handle,		/*!< in: Engine Handle */
-	const void*		cookie,		/*!< in: connection cookie */
-	item**			item,		/*!< out: item to fill */
-	const void*		key,		/*!< in: search key */
-	const int		nkey,		/*!< in: key length */
-	uint16_t		vbucket __attribute__((unused)))
-						/*!< in: bucket, used by default
-						engine only */
+bool
+innodb_fill_result(
+/*===============*/
+	innodb_conn_data_t*	conn_data,	/*!< in/out: cursor affiliated
+						with the connection */
+	meta_cfg_info_t*	meta_info,	/*!< in: metadata */
+	mci_item_t*		result)		/*!< in/out: fetched row */
 {
-	struct innodb_engine*	innodb_eng = innodb_handle(handle);
-	ib_crsr_t		crsr;
-	ib_err_t		err = DB_SUCCESS;
-	mci_item_t*		result = NULL;
-	ENGINE_ERROR_CODE	err_ret = ENGINE_SUCCESS;
-	innodb_conn_data_t*	conn_data = NULL;
-	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
 	int			option_length;
 	const char*		option_delimiter;
-	size_t			key_len = nkey;
-	int			lock_mode;
-	bool			report_table_switch = false;
-
-	if (meta_info->get_option == META_CACHE_OPT_DISABLE) {
-		return(ENGINE_KEY_ENOENT);
-	}
-
-	if (meta_info->get_option == META_CACHE_OPT_DEFAULT
-	    || meta_info->get_option == META_CACHE_OPT_MIX) {
-		*item = item_get(default_handle(innodb_eng), key, nkey);
-
-		if (*item != NULL) {
-			return(ENGINE_SUCCESS);
-		}
-
-		if (meta_info->get_option == META_CACHE_OPT_DEFAULT) {
-			return(ENGINE_KEY_ENOENT);
-		}
-	}
-
-	/* Check if we need to switch table mapping */
-	err_ret = check_key_name_for_map_switch(handle, cookie, key, &key_len);
-
-	/* If specified new table map does not exist, or table does not
-	qualify for InnoDB memcached, return error */
-	if (err_ret != ENGINE_SUCCESS) {
-		goto err_exit;
-	}
-
-	/* If only the new mapping name is provided, and no key value,
-	return here */
-	if (key_len <= 0) {
-		/* If this is a command in the form of "get @@new_table_map",
-		for the purpose of switching to the specified table with
-		the table map name, if the switch is successful, we will
-		return the table name as result */
-		if (nkey > 0) {
-			report_table_switch = true;
-
-			goto search_done;
-		}
-
-		err_ret = ENGINE_KEY_ENOENT;
-		goto err_exit;
-	}
-
-	lock_mode = (innodb_eng->trx_level == IB_TRX_SERIALIZABLE
-		     && innodb_eng->read_batch_size == 1)
-			? IB_LOCK_S
-			: IB_LOCK_NONE;
-
-	conn_data = innodb_conn_init(innodb_eng, cookie, CONN_MODE_READ,
-				     lock_mode, false, NULL);
-
-	if (!conn_data) {
-		return(ENGINE_TMPFAIL);
-	}
-
-	result = (mci_item_t*)(conn_data->result);
-
-	err = innodb_api_search(conn_data, &crsr, key + nkey - key_len,
-				key_len, result, NULL, true);
-
-	if (err != DB_SUCCESS) {
-		err_ret = ENGINE_KEY_ENOENT;
-		goto func_exit;
-	}
-
-search_done:
-	if (report_table_switch) {
-		char	table_name[MAX_TABLE_NAME_LEN
-				   + MAX_DATABASE_NAME_LEN];
-		char*	name;
-		char*	dbname;
-
-		conn_data = innodb_eng->server.cookie->get_engine_specific(cookie);
-		assert(nkey > 0);
-
-		name = conn_data->conn_meta->col_info[CONTAINER_TABLE].col_name;
-		dbname = conn_data->conn_meta->col_info[CONTAINER_DB].col_name;
-#ifdef __WIN__
-		sprintf(table_name, "%s\%s", dbname, name);
-#else
-		snprintf(table_name, sizeof(table_name),
-			 "%s/%s", dbname, name);
-#endif
-
-		assert(!conn_data->result_in_use);
-		conn_data->result_in_use = true;
-		result = (mci_item_t*)(conn_data->result);
-
-		memset(result, 0, sizeof(*result));
-
-		memcpy(conn_data->row_buf, table_name, strlen(table_name));
-
-		result->col_value[MCI_COL_VALUE].value_str = conn_data->row_buf;
-		result->col_value[MCI_COL_VALUE].value_len = strlen(table_name);
-	}
-
-	result->col_value[MCI_COL_KEY].value_str = (char*)key;
-	result->col_value[MCI_COL_KEY].value_len = nkey;
 
 	/* Only if expiration field is enabled, and the value is not zero,
 	we will check whether the item is expired */
@@ -1649,8 +1555,7 @@ search_done:
 					false;
 			}
 
-			err_ret = ENGINE_KEY_ENOENT;
-			goto func_exit;
+			return(false);
 		}
 	}
 
@@ -1775,6 +1680,140 @@ search_done:
 		result->col_value[MCI_COL_VALUE].value_len = int_len;
 	}
 
+	return(true);
+}
+
+/*******************************************************************//**
+Support memcached "GET" command, fetch the value according to key
+@return ENGINE_SUCCESS if successfully, otherwise error code */
+static
+ENGINE_ERROR_CODE
+innodb_get(
+/*=======*/
+	ENGINE_HANDLE*		handle,		/*!< in: Engine Handle */
+	const void*		cookie,		/*!< in: connection cookie */
+	item**			item,		/*!< out: item to fill */
+	const void*		key,		/*!< in: search key */
+	const int		nkey,		/*!< in: key length */
+	uint16_t		vbucket __attribute__((unused)))
+						/*!< in: bucket, used by default
+						engine only */
+{
+	struct innodb_engine*	innodb_eng = innodb_handle(handle);
+	ib_crsr_t		crsr;
+	ib_err_t		err = DB_SUCCESS;
+	mci_item_t*		result = NULL;
+	ENGINE_ERROR_CODE	err_ret = ENGINE_SUCCESS;
+	innodb_conn_data_t*	conn_data = NULL;
+	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
+	size_t			key_len = nkey;
+	int			lock_mode;
+	bool			report_table_switch = false;
+
+	if (meta_info->get_option == META_CACHE_OPT_DISABLE) {
+		return(ENGINE_KEY_ENOENT);
+	}
+
+	if (meta_info->get_option == META_CACHE_OPT_DEFAULT
+	    || meta_info->get_option == META_CACHE_OPT_MIX) {
+		*item = item_get(default_handle(innodb_eng), key, nkey);
+
+		if (*item != NULL) {
+			return(ENGINE_SUCCESS);
+		}
+
+		if (meta_info->get_option == META_CACHE_OPT_DEFAULT) {
+			return(ENGINE_KEY_ENOENT);
+		}
+	}
+
+	/* Check if we need to switch table mapping */
+	err_ret = check_key_name_for_map_switch(handle, cookie, key, &key_len);
+
+	/* If specified new table map does not exist, or table does not
+	qualify for InnoDB memcached, return error */
+	if (err_ret != ENGINE_SUCCESS) {
+		goto err_exit;
+	}
+
+	/* If only the new mapping name is provided, and no key value,
+	return here */
+	if (key_len <= 0) {
+		/* If this is a command in the form of "get @@new_table_map",
+		for the purpose of switching to the specified table with
+		the table map name, if the switch is successful, we will
+		return the table name as result */
+		if (nkey > 0) {
+			report_table_switch = true;
+
+			goto search_done;
+		}
+
+		err_ret = ENGINE_KEY_ENOENT;
+		goto err_exit;
+	}
+
+	lock_mode = (innodb_eng->trx_level == IB_TRX_SERIALIZABLE
+		     && innodb_eng->read_batch_size == 1)
+			? IB_LOCK_S
+			: IB_LOCK_NONE;
+
+	conn_data = innodb_conn_init(innodb_eng, cookie, CONN_MODE_READ,
+				     lock_mode, false, NULL);
+
+	if (!conn_data) {
+		return(ENGINE_TMPFAIL);
+	}
+
+	result = (mci_item_t*)(conn_data->result);
+
+	err = innodb_api_search(conn_data, &crsr, key + nkey - key_len,
+				key_len, result, NULL, true);
+
+	if (err != DB_SUCCESS) {
+		err_ret = ENGINE_KEY_ENOENT;
+		goto func_exit;
+	}
+
+search_done:
+	if (report_table_switch) {
+		char	table_name[MAX_TABLE_NAME_LEN
+				   + MAX_DATABASE_NAME_LEN];
+		char*	name;
+		char*	dbname;
+
+		conn_data = innodb_eng->server.cookie->get_engine_specific(cookie);
+		assert(nkey > 0);
+
+		name = conn_data->conn_meta->col_info[CONTAINER_TABLE].col_name;
+		dbname = conn_data->conn_meta->col_info[CONTAINER_DB].col_name;
+#ifdef __WIN__
+		sprintf(table_name, "%s\%s", dbname, name);
+#else
+		snprintf(table_name, sizeof(table_name),
+			 "%s/%s", dbname, name);
+#endif
+
+		assert(!conn_data->result_in_use);
+		conn_data->result_in_use = true;
+		result = (mci_item_t*)(conn_data->result);
+
+		memset(result, 0, sizeof(*result));
+
+		memcpy(conn_data->row_buf, table_name, strlen(table_name));
+
+		result->col_value[MCI_COL_VALUE].value_str = conn_data->row_buf;
+		result->col_value[MCI_COL_VALUE].value_len = strlen(table_name);
+	}
+
+	result->col_value[MCI_COL_KEY].value_str = (char*)key;
+	result->col_value[MCI_COL_KEY].value_len = nkey;
+
+	if (!innodb_fill_result(conn_data, meta_info, result)) {
+		err_ret = ENGINE_KEY_ENOENT;
+		goto func_exit;
+	}
+
         *item = result;
 
 func_exit:
@@ -1795,6 +1834,195 @@ err_exit:
 	return(err_ret);
 }
 
+/** A key of a multi-get, and its position in the request */
+typedef struct innodb_mget_key {
+	const char*	key;		/*!< key value */
+	int		nkey;		/*!< key length */
+	int		pos;		/*!< position in the request */
+} innodb_mget_key_t;
+
+/*******************************************************************//**
+Compare two keys of a multi-get, so that they can be looked up in
+index order
+@return negative, 0 or positive, like memcmp() */
+static
+int
+innodb_mget_key_cmp(
+/*================*/
+	const void*	a,		/*!< in: innodb_mget_key_t */
+	const void*	b)		/*!< in: innodb_mget_key_t */
+{
+	const innodb_mget_key_t*	k1 = (const innodb_mget_key_t*) a;
+	const innodb_mget_key_t*	k2 = (const innodb_mget_key_t*) b;
+	int				cmp;
+
+	cmp = memcmp(k1->key, k2->key,
+		     k1->nkey < k2->nkey ? k1->nkey : k2->nkey);
+
+	if (cmp == 0) {
+		cmp = k1->nkey - k2->nkey;
+	}
+
+	return(cmp);
+}
+
+/*******************************************************************//**
+Copy a result assembled by innodb_fill_result() into its own memory, so
+that it stays valid while the next keys of a multi-get are fetched. The
+copy is freed by innodb_release().
+@return the copy, or NULL if out of memory */
+static
+mci_item_t*
+innodb_copy_result(
+/*===============*/
+	mci_item_t*	result)		/*!< in/out: assembled result */
+{
+	mci_column_t*	key = &result->col_value[MCI_COL_KEY];
+	mci_column_t*	value = &result->col_value[MCI_COL_VALUE];
+	mci_item_t*	copy;
+	char*		buf;
+
+	copy = malloc(sizeof(*copy) + key->value_len + value->value_len);
+
+	if (copy != NULL) {
+		*copy = *result;
+		buf = (char*) (copy + 1);
+
+		memcpy(buf, key->value_str, key->value_len);
+		copy->col_value[MCI_COL_KEY].value_str = buf;
+		buf += key->value_len;
+
+		if (value->value_len > 0) {
+			memcpy(buf, value->value_str, value->value_len);
+		}
+
+		copy->col_value[MCI_COL_VALUE].value_str = buf;
+		copy->col_value[MCI_COL_VALUE].allocated = false;
+		copy->extra_col_value = NULL;
+		copy->n_extra_col = 0;
+	}
+
+	if (value->allocated) {
+		free(value->value_str);
+		value->allocated = false;
+	}
+
+	return(copy);
+}
+
+/*******************************************************************//**
+Support memcached "GET" command with multiple keys. The keys are sorted
+and looked up with the connection's read cursor in a single transaction,
+so that the whole batch sees one read view. Table mapping switches and
+the caching options that involve the default engine are left to
+innodb_get().
+@return ENGINE_SUCCESS if successfully, otherwise error code */
+static
+ENGINE_ERROR_CODE
+innodb_get_multi(
+/*=============*/
+	ENGINE_HANDLE*		handle,		/*!< in: Engine Handle */
+	const void*		cookie,		/*!< in: connection cookie */
+	item**			items,		/*!< out: items to fill */
+	const void**		keys,		/*!< in: search keys */
+	const int*		nkeys,		/*!< in: key lengths */
+	int			n_keys,		/*!< in: number of keys */
+	uint16_t		vbucket __attribute__((unused)))
+						/*!< in: bucket, used by default
+						engine only */
+{
+	struct innodb_engine*	innodb_eng = innodb_handle(handle);
+	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
+	innodb_conn_data_t*	conn_data;
+	innodb_mget_key_t*	order;
+	mci_item_t*		result;
+	ib_crsr_t		crsr;
+	int			lock_mode;
+	int			i;
+
+	if (meta_info->get_option != META_CACHE_OPT_INNODB) {
+		return(ENGINE_ENOTSUP);
+	}
+
+	for (i = 0; i < n_keys; i++) {
+		const char*	key = (const char*) keys[i];
+
+		if (nkeys[i] > 1 && key[0] == '@' && key[1] == '@') {
+			return(ENGINE_ENOTSUP);
+		}
+	}
+
+	order = malloc(n_keys * sizeof(*order));
+
+	if (order == NULL) {
+		return(ENGINE_ENOTSUP);
+	}
+
+	for (i = 0; i < n_keys; i++) {
+		order[i].key = (const char*) keys[i];
+		order[i].nkey = nkeys[i];
+		order[i].pos = i;
+		items[i] = NULL;
+	}
+
+	qsort(order, n_keys, sizeof(*order), innodb_mget_key_cmp);
+
+	lock_mode = (innodb_eng->trx_level == IB_TRX_SERIALIZABLE
+		     && innodb_eng->read_batch_size == 1)
+			? IB_LOCK_S
+			: IB_LOCK_NONE;
+
+	conn_data = innodb_conn_init(innodb_eng, cookie, CONN_MODE_READ,
+				     lock_mode, false, NULL);
+
+	if (!conn_data) {
+		free(order);
+		return(ENGINE_TMPFAIL);
+	}
+
+	result = (mci_item_t*)(conn_data->result);
+
+	for (i = 0; i < n_keys; i++) {
+		ib_err_t	err;
+
+		err = innodb_api_search(conn_data, &crsr, order[i].key,
+					order[i].nkey, result, NULL, true);
+
+		if (err != DB_SUCCESS) {
+			continue;
+		}
+
+		result->col_value[MCI_COL_KEY].value_str =
+			(char*) order[i].key;
+		result->col_value[MCI_COL_KEY].value_len = order[i].nkey;
+
+		if (!innodb_fill_result(conn_data, meta_info, result)) {
+			continue;
+		}
+
+		items[order[i].pos] = innodb_copy_result(result);
+
+		if (items[order[i].pos] != NULL) {
+			conn_data->n_mul_items++;
+		}
+	}
+
+	free(order);
+
+	/* The results are copied; innodb_get_item_info() only needs to
+	know that they are not items of the default engine */
+	conn_data->result_in_use = conn_data->n_mul_items > 0;
+
+	/* Count every key against the read batch size, the last one is
+	counted by innodb_api_cursor_reset() */
+	conn_data->n_total_reads += n_keys - 1;
+	conn_data->n_reads_since_commit += n_keys - 1;
+
+	innodb_api_cursor_reset(innodb_eng, conn_data, CONN_OP_READ, true);
+
+	return(ENGINE_SUCCESS);
+}
+
 /*******************************************************************//**
 Get statistics info
 @return ENGINE_SUCCESS if successfully, otherwise error code */
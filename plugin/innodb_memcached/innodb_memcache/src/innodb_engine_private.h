@@ -141,6 +141,23 @@ innodb_get(
 	uint16_t	vbucket);	/*!< in: bucket, used by default
 					engine only */
 
+/*******************************************************************//**
+Support memcached "GET" command with multiple keys, fetch the values of
+all keys with one cursor and transaction
+@return ENGINE_SUCCESS if successfully, otherwise error code */
+static
+ENGINE_ERROR_CODE
+innodb_get_multi(
+/*=============*/
+	ENGINE_HANDLE*	handle,		/*!< in: Engine Handle */
+	const void*	cookie,		/*!< in: connection cookie */
+	item**		items,		/*!< out: items to fill */
+	const void**	keys,		/*!< in: search keys */
+	const int*	nkeys,		/*!< in: key lengths */
+	int		n_keys,		/*!< in: number of keys */
+	uint16_t	vbucket);	/*!< in: bucket, used by default
+					engine only */
+
 /*******************************************************************//**
 Get statistics info
 @return ENGINE_SUCCESS if successfully, otherwise error code */
@@ -105,4 +105,43 @@ protected:
   virtual uint get_max_threads() const { return 1; }
 };
 
+
+/**
+  This class represents the connection handling functionality of a pool
+  of threads. The connections are divided into thread groups. Each group
+  waits for client requests with epoll and executes them in a bounded
+  number of worker threads, so that the number of threads does not grow
+  with the number of connections.
+*/
+class Thread_pool_connection_handler : public Connection_handler
+{
+  Thread_pool_connection_handler(const Thread_pool_connection_handler&);
+  Thread_pool_connection_handler&
+    operator=(const Thread_pool_connection_handler&);
+
+public:
+  // System variables
+  static ulong size;
+  static ulong oversubscribe;
+  static ulong stall_limit;
+  static ulong max_threads;
+  static ulong idle_timeout;
+  static ulong high_prio_tickets;
+
+  Thread_pool_connection_handler() {}
+  virtual ~Thread_pool_connection_handler();
+
+  /**
+    Create the thread groups and start the timer thread.
+
+    @return true if the initialization failed, false otherwise.
+  */
+  bool init();
+
+protected:
+  virtual bool add_connection(Channel_info* channel_info);
+
+  virtual uint get_max_threads() const;
+};
+
 #endif // CONNECTION_HANDLER_IMPL_INCLUDED
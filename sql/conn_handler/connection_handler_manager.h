@@ -109,6 +109,7 @@ public:
   {
     SCHEDULER_ONE_THREAD_PER_CONNECTION=0,
     SCHEDULER_NO_THREADS,
+    SCHEDULER_THREAD_POOL,
     SCHEDULER_TYPES_COUNT
   };
 
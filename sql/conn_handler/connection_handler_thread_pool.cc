@@ -0,0 +1,1164 @@
+/*
+   Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "connection_handler_impl.h"
+
+#include "channel_info.h"                // Channel_info
+#include "connection_handler_manager.h"  // Connection_handler_manager
+#include "mysqld.h"                      // connection_attrib
+#include "mysqld_error.h"                // ER_*
+#include "mysqld_thd_manager.h"          // Global_THD_manager
+#include "sql_audit.h"                   // mysql_audit_release
+#include "sql_class.h"                   // THD
+#include "sql_connect.h"                 // close_connection
+#include "sql_parse.h"                   // do_command
+#include "log.h"                         // Error_log_throttle
+#include "mysql/thread_pool_priv.h"      // reset_thread_globals
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#endif
+
+
+// Initialize static members
+ulong Thread_pool_connection_handler::size= 0;
+ulong Thread_pool_connection_handler::oversubscribe= 3;
+ulong Thread_pool_connection_handler::stall_limit= 500;
+ulong Thread_pool_connection_handler::max_threads= 1000;
+ulong Thread_pool_connection_handler::idle_timeout= 60;
+ulong Thread_pool_connection_handler::high_prio_tickets= UINT_MAX32;
+
+
+#ifdef HAVE_EPOLL
+
+/*
+  Overview
+
+  The connections are divided into Thread_pool_connection_handler::size
+  thread groups. Each group has an epoll descriptor in which the idle
+  connections of the group are registered, and a queue of connections
+  that have a request waiting for a worker thread.
+
+  A worker thread of a group takes a request from the queue and executes
+  it. If the queue is empty and no other thread of the group waits in
+  epoll_wait(), the worker becomes the listener of the group, and moves
+  the connections that epoll reports readable to the queue. The other
+  workers wait for a request on their own condition variable.
+
+  At most 1 + oversubscribe workers of a group execute requests at the
+  same time. A worker that is blocked, for example on a row lock or on
+  disk I/O, does not count as active (see thd_wait_begin()), so that
+  another worker can take over.
+
+  A timer thread checks the groups every stall_limit milliseconds. If
+  no request was taken from the queue of a group during that time, the
+  active workers are considered stalled: an extra worker is woken or
+  created so that the queued requests make progress. The timer thread
+  also closes connections that have been idle for longer than
+  wait_timeout.
+
+  A connection that has an active transaction is queued with high
+  priority for up to high_prio_tickets requests in a row, so that it
+  releases its locks sooner.
+*/
+
+struct Thread_pool_group;
+
+/** State of a connection, protected by Thread_pool_group::mutex */
+enum enum_tp_connection_state
+{
+  /** Waiting for a request in epoll */
+  TP_CONNECTION_IDLE,
+  /** Waiting in the queue for a worker */
+  TP_CONNECTION_QUEUED,
+  /** Being handled by a worker */
+  TP_CONNECTION_ACTIVE,
+  /** Closed; freed when the listener of the group is done */
+  TP_CONNECTION_ENDED
+};
+
+
+/** A connection handled by the thread pool */
+struct Thread_pool_connection
+{
+  THD *thd;
+  Thread_pool_group *group;
+  enum_tp_connection_state state;
+  /** Whether the client has been authenticated */
+  bool logged_in;
+  /** Whether the connection is registered in the epoll descriptor */
+  bool registered;
+  /** Whether the connection was idle for longer than wait_timeout */
+  bool timed_out;
+  /** Whether the worker is blocked in thd_wait_begin() */
+  bool waiting;
+  /** Whether to queue the next request with high priority */
+  bool high_prio;
+  /** Number of high priority requests left */
+  ulong tickets;
+  /** Time (in microseconds) when wait_timeout expires while idle */
+  ulonglong deadline;
+  /** Links in Thread_pool_group::connections */
+  Thread_pool_connection *prev, *next;
+};
+
+
+/** A worker thread that waits for a request */
+struct Thread_pool_worker
+{
+  mysql_cond_t cond;
+  /** Set when the worker is woken up to handle a request */
+  bool woken;
+};
+
+
+/** A thread group */
+struct Thread_pool_group
+{
+  mysql_mutex_t mutex;
+  /** Idle connections of the group */
+  int epfd;
+  /** Pipe to wake up the listener; the read end is registered in epfd */
+  int pipe_fds[2];
+  /** Queued connections */
+  std::deque<Thread_pool_connection*> queue;
+  /** Queued connections with an active transaction */
+  std::deque<Thread_pool_connection*> high_prio_queue;
+  /** Workers waiting for a request; the most recent one is woken first */
+  std::vector<Thread_pool_worker*> waiting;
+  /** Worker that waits in epoll_wait(), or NULL */
+  Thread_pool_worker *listener;
+  /** Number of worker threads of the group */
+  uint thread_count;
+  /** Number of workers that execute a request and are not blocked */
+  uint active_thread_count;
+  /** Number of requests taken from the queue so far */
+  ulonglong dequeue_count;
+  /** dequeue_count at the previous check by the timer thread */
+  ulonglong last_dequeue_count;
+  /** Whether the active workers are stalled */
+  bool stalled;
+  /** Set when the thread pool is being shut down */
+  bool shutdown;
+  /** All connections of the group */
+  Thread_pool_connection *connections;
+  /** Connections that ended while the listener was in epoll_wait() */
+  std::vector<Thread_pool_connection*> ended;
+  /** Earliest deadline of an idle connection */
+  ulonglong next_deadline;
+};
+
+
+static Thread_pool_group *groups= NULL;
+static uint group_count= 0;
+
+/*
+  Total number of worker threads and the state of the timer thread.
+  Protected by LOCK_thread_pool.
+*/
+static uint total_threads= 0;
+static bool timer_running= false;
+static bool timer_shutdown= false;
+static mysql_mutex_t LOCK_thread_pool;
+static mysql_cond_t COND_thread_pool;
+
+// Error log throttle for the thread creation failure.
+static
+Error_log_throttle create_thread_err_log_throttle(Log_throttle
+                                                  ::LOG_THROTTLE_WINDOW_SIZE,
+                                                  sql_print_error,
+                                                  "Error log throttle: %10lu"
+                                                  " 'Can't create thread pool"
+                                                  " worker thread' error(s)"
+                                                  " suppressed");
+
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_thread_pool;
+static PSI_mutex_key key_LOCK_thread_pool_group;
+
+static PSI_mutex_info all_thread_pool_mutexes[]=
+{
+  { &key_LOCK_thread_pool, "LOCK_thread_pool", PSI_FLAG_GLOBAL},
+  { &key_LOCK_thread_pool_group, "Thread_pool_group::mutex", 0}
+};
+
+static PSI_cond_key key_COND_thread_pool;
+static PSI_cond_key key_COND_thread_pool_worker;
+
+static PSI_cond_info all_thread_pool_conds[]=
+{
+  { &key_COND_thread_pool, "COND_thread_pool", PSI_FLAG_GLOBAL},
+  { &key_COND_thread_pool_worker, "Thread_pool_worker::cond", 0}
+};
+
+static PSI_thread_key key_thread_pool_worker;
+static PSI_thread_key key_thread_pool_timer;
+
+static PSI_thread_info all_thread_pool_threads[]=
+{
+  { &key_thread_pool_worker, "thread_pool_worker", 0},
+  { &key_thread_pool_timer, "thread_pool_timer", PSI_FLAG_GLOBAL}
+};
+#endif
+
+
+static bool too_many_active(const Thread_pool_group *group)
+{
+  return (group->active_thread_count
+          >= 1 + Thread_pool_connection_handler::oversubscribe
+          && !group->stalled);
+}
+
+
+static bool queues_empty(const Thread_pool_group *group)
+{
+  return group->queue.empty() && group->high_prio_queue.empty();
+}
+
+
+/**
+  Wake up the listener of a group.
+*/
+
+static void wake_listener(Thread_pool_group *group)
+{
+  char c= 0;
+  if (write(group->pipe_fds[1], &c, 1) < 0)
+  {
+    /* The pipe is full, so the listener will wake up anyway. */
+  }
+}
+
+
+/**
+  Wake up a worker that waits for a request.
+
+  @retval true   A worker was woken up.
+  @retval false  No worker is waiting.
+*/
+
+static bool wake_worker(Thread_pool_group *group)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+
+  if (group->waiting.empty())
+    return false;
+
+  Thread_pool_worker *worker= group->waiting.back();
+  group->waiting.pop_back();
+  worker->woken= true;
+  mysql_cond_signal(&worker->cond);
+  return true;
+}
+
+
+pthread_handler_t tp_worker_main(void *arg);
+
+/**
+  Create a worker thread for a group. The total number of worker threads
+  is limited by max_threads, but every group may have one thread.
+*/
+
+static void create_worker(Thread_pool_group *group)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+
+  mysql_mutex_lock(&LOCK_thread_pool);
+  if (total_threads >= Thread_pool_connection_handler::max_threads &&
+      group->thread_count > 0)
+  {
+    mysql_mutex_unlock(&LOCK_thread_pool);
+    return;
+  }
+  total_threads++;
+  mysql_mutex_unlock(&LOCK_thread_pool);
+
+  group->thread_count++;
+
+  pthread_t id;
+  int error= mysql_thread_create(key_thread_pool_worker, &id,
+                                 &connection_attrib, tp_worker_main, group);
+  if (error)
+  {
+    group->thread_count--;
+
+    mysql_mutex_lock(&LOCK_thread_pool);
+    total_threads--;
+    mysql_cond_broadcast(&COND_thread_pool);
+    mysql_mutex_unlock(&LOCK_thread_pool);
+
+    connection_errors_internal++;
+    if (!create_thread_err_log_throttle.log())
+      sql_print_error("Can't create thread pool worker thread(errno= %d)",
+                      error);
+    return;
+  }
+
+  Global_THD_manager::get_instance()->inc_thread_created();
+}
+
+
+static void wake_or_create_worker(Thread_pool_group *group)
+{
+  if (!wake_worker(group))
+    create_worker(group);
+}
+
+
+/**
+  Queue a connection that was not reported by epoll, and make sure that
+  some worker will take it.
+*/
+
+static void queue_put(Thread_pool_group *group, Thread_pool_connection *conn)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+
+  conn->state= TP_CONNECTION_QUEUED;
+  if (conn->high_prio)
+    group->high_prio_queue.push_back(conn);
+  else
+    group->queue.push_back(conn);
+
+  if (wake_worker(group))
+    return;
+
+  if (group->listener != NULL)
+    wake_listener(group);
+  else if (!too_many_active(group))
+    create_worker(group);
+}
+
+
+static Thread_pool_connection *queue_get(Thread_pool_group *group)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+
+  std::deque<Thread_pool_connection*> *queue= &group->high_prio_queue;
+  if (queue->empty())
+    queue= &group->queue;
+  if (queue->empty())
+    return NULL;
+
+  Thread_pool_connection *conn= queue->front();
+  queue->pop_front();
+  group->dequeue_count++;
+  return conn;
+}
+
+
+/**
+  Wait in epoll_wait() and queue the connections that have a request.
+  Must be called with the group mutex held; the mutex is released
+  during the wait.
+*/
+
+static void listen(Thread_pool_group *group, Thread_pool_worker *worker)
+{
+  struct epoll_event events[16];
+
+  group->listener= worker;
+  mysql_mutex_unlock(&group->mutex);
+
+  int n= epoll_wait(group->epfd, events, array_elements(events), -1);
+
+  mysql_mutex_lock(&group->mutex);
+
+  for (int i= 0; i < n; i++)
+  {
+    Thread_pool_connection *conn=
+      static_cast<Thread_pool_connection*>(events[i].data.ptr);
+
+    if (conn == NULL)
+    {
+      char buf[64];
+      while (read(group->pipe_fds[0], buf, sizeof(buf)) == sizeof(buf))
+      {}
+      continue;
+    }
+
+    /*
+      The connection may have been queued by a kill or a timeout
+      after epoll_wait() returned.
+    */
+    if (conn->state != TP_CONNECTION_IDLE)
+      continue;
+
+    conn->state= TP_CONNECTION_QUEUED;
+    if (conn->high_prio)
+      group->high_prio_queue.push_back(conn);
+    else
+      group->queue.push_back(conn);
+  }
+
+  /* No event of this batch refers to the ended connections any more. */
+  for (std::vector<Thread_pool_connection*>::iterator it=
+         group->ended.begin(); it != group->ended.end(); ++it)
+    delete *it;
+  group->ended.clear();
+
+  group->listener= NULL;
+}
+
+
+/**
+  Get the next connection to handle.
+
+  @param group       thread group of the worker
+  @param worker      the calling worker
+  @param was_active  whether the worker has just handled a connection
+
+  @retval NULL   The worker thread should exit.
+  @retval !NULL  Connection that has a request; the worker is active.
+*/
+
+static Thread_pool_connection *get_event(Thread_pool_group *group,
+                                         Thread_pool_worker *worker,
+                                         bool was_active)
+{
+  Thread_pool_connection *conn= NULL;
+
+  mysql_mutex_lock(&group->mutex);
+
+  if (was_active)
+    group->active_thread_count--;
+
+  while (!group->shutdown)
+  {
+    if (!too_many_active(group))
+    {
+      conn= queue_get(group);
+      if (conn != NULL)
+      {
+        conn->state= TP_CONNECTION_ACTIVE;
+        group->active_thread_count++;
+        group->stalled= false;
+
+        /* Let a waiting worker listen or take the remaining requests. */
+        if (group->listener == NULL || !queues_empty(group))
+          wake_worker(group);
+        break;
+      }
+
+      if (group->listener == NULL)
+      {
+        listen(group, worker);
+        continue;
+      }
+    }
+
+    /* Wait until a request is available for this worker. */
+    worker->woken= false;
+    group->waiting.push_back(worker);
+
+    struct timespec abstime;
+    set_timespec(&abstime, Thread_pool_connection_handler::idle_timeout);
+
+    int error= 0;
+    while (!worker->woken && !group->shutdown && !error)
+      error= mysql_cond_timedwait(&worker->cond, &group->mutex, &abstime);
+
+    if (!worker->woken)
+    {
+      group->waiting.erase(std::find(group->waiting.begin(),
+                                     group->waiting.end(), worker));
+
+      /* Let idle threads exit, but keep one thread in each group. */
+      if (error && group->thread_count > 1)
+        break;
+    }
+  }
+
+  if (conn == NULL)
+    group->thread_count--;
+
+  mysql_mutex_unlock(&group->mutex);
+  return conn;
+}
+
+
+/**
+  Attach the THD of a connection to the current worker thread.
+*/
+
+static bool attach_thd(THD *thd, char *stack_start)
+{
+  thd->thread_stack= stack_start;
+  if (thd->store_globals())
+    return true;
+
+  /*
+    THD::mysys_var::abort is associated with the physical thread rather
+    than with the THD object.
+  */
+  thd->mysys_var->abort= 0;
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(set_thread)(thd_get_psi(thd));
+#endif
+  mysql_socket_set_thread_owner(thd->net.vio->mysql_socket);
+  return false;
+}
+
+
+/**
+  Detach the THD of a connection from the current worker thread.
+*/
+
+static void detach_thd(THD *thd, PSI_thread *worker_psi)
+{
+  reset_thread_globals(thd);
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(set_thread)(worker_psi);
+#endif
+}
+
+
+/**
+  Close a connection. The THD must be attached to the current thread.
+*/
+
+static void end_tp_connection(Thread_pool_connection *conn,
+                              PSI_thread *worker_psi)
+{
+  THD *thd= conn->thd;
+
+  if (conn->logged_in)
+    end_connection(thd);
+  close_connection(thd);
+  Connection_handler_manager::dec_connection_count();
+
+  thd->get_stmt_da()->reset_diagnostics_area();
+  thd->release_resources();
+  Global_THD_manager::get_instance()->remove_thd(thd);
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(delete_current_thread)();
+  PSI_THREAD_CALL(set_thread)(worker_psi);
+#endif
+
+  /* No more post_kill_notification() can refer to the connection. */
+  delete thd;
+
+  Thread_pool_group *group= conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+
+  if (conn->prev != NULL)
+    conn->prev->next= conn->next;
+  else
+    group->connections= conn->next;
+  if (conn->next != NULL)
+    conn->next->prev= conn->prev;
+
+  conn->state= TP_CONNECTION_ENDED;
+
+  /* The listener may hold an event that refers to the connection. */
+  if (group->listener != NULL)
+    group->ended.push_back(conn);
+  else
+    delete conn;
+
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+/**
+  Register an idle connection in the epoll descriptor of its group, so
+  that the next request is reported to the listener.
+
+  @return true if the connection must be closed, false otherwise.
+*/
+
+static bool arm_tp_connection(Thread_pool_connection *conn, my_socket fd)
+{
+  Thread_pool_group *group= conn->group;
+  THD *thd= conn->thd;
+  bool error= false;
+
+  mysql_mutex_lock(&group->mutex);
+
+  /* A kill does not queue a connection that is being handled. */
+  if (thd->killed == THD::KILL_CONNECTION)
+    error= true;
+  else
+  {
+    struct epoll_event ev;
+    ev.events= EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr= conn;
+
+    conn->state= TP_CONNECTION_IDLE;
+    if (epoll_ctl(group->epfd,
+                  conn->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+                  fd, &ev))
+    {
+      conn->state= TP_CONNECTION_ACTIVE;
+      error= true;
+    }
+    else
+    {
+      conn->registered= true;
+      if (conn->deadline < group->next_deadline)
+        group->next_deadline= conn->deadline;
+    }
+  }
+
+  mysql_mutex_unlock(&group->mutex);
+  return error;
+}
+
+
+/**
+  Handle a request of a connection: authenticate the client or execute
+  the commands that it has sent.
+*/
+
+static void handle_event(Thread_pool_connection *conn, PSI_thread *worker_psi)
+{
+  THD *thd= conn->thd;
+  bool error;
+
+  if (attach_thd(thd, (char*) &thd))
+  {
+    close_connection(thd, ER_OUT_OF_RESOURCES);
+    end_tp_connection(conn, worker_psi);
+    return;
+  }
+
+  if (conn->timed_out)
+  {
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    thd->killed= THD::KILL_CONNECTION;
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+  }
+
+  error= !thd_is_connection_alive(thd);
+
+  if (!error && !conn->logged_in)
+  {
+    if (thd_prepare_connection(thd))
+    {
+      Connection_handler_manager::get_instance()->inc_aborted_connects();
+      error= true;
+    }
+    else
+      conn->logged_in= true;
+  }
+  else if (!error)
+  {
+    mysql_audit_release(thd);
+    error= do_command(thd);
+  }
+
+  /* epoll does not report the data that has already been buffered. */
+  while (!error && thd_is_connection_alive(thd) &&
+         thd->net.vio->has_data(thd->net.vio))
+  {
+    mysql_audit_release(thd);
+    error= do_command(thd);
+  }
+
+  if (error || !thd_is_connection_alive(thd))
+  {
+    end_tp_connection(conn, worker_psi);
+    return;
+  }
+
+  /* Prioritize the next request of a session that holds locks. */
+  if (thd_is_transaction_active(thd) || thd->locked_tables_mode)
+  {
+    conn->high_prio= conn->tickets > 0;
+    if (conn->high_prio)
+      conn->tickets--;
+  }
+  else
+  {
+    conn->high_prio= false;
+    conn->tickets= Thread_pool_connection_handler::high_prio_tickets;
+  }
+
+  conn->deadline= my_micro_time() +
+    thd->variables.net_wait_timeout * 1000000ULL;
+
+  my_socket fd= mysql_socket_getfd(thd->net.vio->mysql_socket);
+
+  /*
+    Show the connection as waiting for the client, as do_command() does
+    while it reads the next command, and ignore KILL QUERY until then.
+  */
+  thd->net.reading_or_writing= 1;
+  thd->m_server_idle= true;
+
+  /*
+    Detach before registering the connection: another worker may take
+    the next request as soon as it is registered.
+  */
+  detach_thd(thd, worker_psi);
+
+  if (arm_tp_connection(conn, fd))
+  {
+    if (attach_thd(thd, (char*) &thd))
+      close_connection(thd, ER_OUT_OF_RESOURCES);
+    end_tp_connection(conn, worker_psi);
+  }
+}
+
+
+/**
+  Thread handler for a worker thread of a group.
+
+  @param arg   Thread group
+*/
+
+pthread_handler_t tp_worker_main(void *arg)
+{
+  Thread_pool_group *group= static_cast<Thread_pool_group*>(arg);
+  Thread_pool_worker worker;
+  PSI_thread *worker_psi= NULL;
+
+  if (my_thread_init())
+  {
+    mysql_mutex_lock(&group->mutex);
+    group->thread_count--;
+    mysql_mutex_unlock(&group->mutex);
+    goto end;
+  }
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  worker_psi= PSI_THREAD_CALL(get_thread)();
+#endif
+
+  mysql_cond_init(key_COND_thread_pool_worker, &worker.cond);
+  worker.woken= false;
+
+  for (bool was_active= false;; was_active= true)
+  {
+    Thread_pool_connection *conn= get_event(group, &worker, was_active);
+    if (conn == NULL)
+      break;
+    handle_event(conn, worker_psi);
+  }
+
+  mysql_cond_destroy(&worker.cond);
+
+  // Clean up errors now, before the thread ends.
+  ERR_remove_state(0);
+
+  my_thread_end();
+
+end:
+  mysql_mutex_lock(&LOCK_thread_pool);
+  total_threads--;
+  mysql_cond_broadcast(&COND_thread_pool);
+  mysql_mutex_unlock(&LOCK_thread_pool);
+
+  pthread_exit(0);
+  return NULL;
+}
+
+
+/**
+  Detect stalls and wait timeouts in a group.
+*/
+
+static void check_group(Thread_pool_group *group, ulonglong now)
+{
+  mysql_mutex_lock(&group->mutex);
+
+  if (group->shutdown)
+  {
+    mysql_mutex_unlock(&group->mutex);
+    return;
+  }
+
+  /*
+    If no request was taken from the queue since the previous check,
+    the active workers are stalled or there is no listener: let one
+    more worker run.
+  */
+  if ((!queues_empty(group) || group->listener == NULL) &&
+      group->dequeue_count == group->last_dequeue_count)
+  {
+    if (group->active_thread_count > 0)
+      group->stalled= true;
+    wake_or_create_worker(group);
+  }
+  group->last_dequeue_count= group->dequeue_count;
+
+  if (now >= group->next_deadline)
+  {
+    group->next_deadline= ULLONG_MAX;
+
+    for (Thread_pool_connection *conn= group->connections; conn != NULL;
+         conn= conn->next)
+    {
+      if (conn->state != TP_CONNECTION_IDLE)
+        continue;
+
+      if (conn->deadline <= now)
+      {
+        conn->timed_out= true;
+        queue_put(group, conn);
+      }
+      else if (conn->deadline < group->next_deadline)
+        group->next_deadline= conn->deadline;
+    }
+  }
+
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+/**
+  Thread handler for the timer thread.
+*/
+
+pthread_handler_t tp_timer_main(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+
+  mysql_mutex_lock(&LOCK_thread_pool);
+  while (!timer_shutdown)
+  {
+    struct timespec abstime;
+    set_timespec_nsec(&abstime,
+                      Thread_pool_connection_handler::stall_limit * 1000000ULL);
+    mysql_cond_timedwait(&COND_thread_pool, &LOCK_thread_pool, &abstime);
+    if (timer_shutdown)
+      break;
+    mysql_mutex_unlock(&LOCK_thread_pool);
+
+    ulonglong now= my_micro_time();
+    for (uint i= 0; i < group_count; i++)
+      check_group(&groups[i], now);
+
+    mysql_mutex_lock(&LOCK_thread_pool);
+  }
+  timer_running= false;
+  mysql_cond_broadcast(&COND_thread_pool);
+  mysql_mutex_unlock(&LOCK_thread_pool);
+
+  my_thread_end();
+  pthread_exit(0);
+  return NULL;
+}
+
+
+/**
+  Functions called by the server when a thread of the pool waits.
+*/
+
+static void tp_wait_begin(THD *thd, int wait_type __attribute__((unused)))
+{
+  if (thd == NULL)
+    thd= current_thd;
+  if (thd == NULL || thd != current_thd)
+    return;
+
+  Thread_pool_connection *conn=
+    static_cast<Thread_pool_connection*>(thd->scheduler.data);
+  if (conn == NULL || conn->waiting)
+    return;
+
+  Thread_pool_group *group= conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+  conn->waiting= true;
+  group->active_thread_count--;
+  if (group->active_thread_count == 0 &&
+      (!queues_empty(group) || group->listener == NULL))
+    wake_or_create_worker(group);
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+static void tp_wait_end(THD *thd)
+{
+  if (thd == NULL)
+    thd= current_thd;
+  if (thd == NULL || thd != current_thd)
+    return;
+
+  Thread_pool_connection *conn=
+    static_cast<Thread_pool_connection*>(thd->scheduler.data);
+  if (conn == NULL || !conn->waiting)
+    return;
+
+  Thread_pool_group *group= conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+  conn->waiting= false;
+  group->active_thread_count++;
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+/**
+  Queue an idle connection that was killed, so that a worker closes it.
+  Only a connection that is being closed is queued: THD::awake() does not
+  set THD::killed for KILL QUERY of an idle connection, and a worker would
+  then block reading a request that was never sent.
+  Called with LOCK_thd_data held.
+*/
+
+static void tp_post_kill_notification(THD *thd)
+{
+  Thread_pool_connection *conn=
+    static_cast<Thread_pool_connection*>(thd->scheduler.data);
+  if (conn == NULL || thd == current_thd ||
+      thd->killed != THD::KILL_CONNECTION)
+    return;
+
+  Thread_pool_group *group= conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+  if (conn->state == TP_CONNECTION_IDLE)
+    queue_put(group, conn);
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+static THD_event_functions tp_event_functions=
+{
+  tp_wait_begin, tp_wait_end, tp_post_kill_notification
+};
+
+
+bool Thread_pool_connection_handler::init()
+{
+#ifdef HAVE_PSI_INTERFACE
+  int count= array_elements(all_thread_pool_mutexes);
+  mysql_mutex_register("sql", all_thread_pool_mutexes, count);
+
+  count= array_elements(all_thread_pool_conds);
+  mysql_cond_register("sql", all_thread_pool_conds, count);
+
+  count= array_elements(all_thread_pool_threads);
+  mysql_thread_register("sql", all_thread_pool_threads, count);
+#endif
+
+  if (size == 0)
+  {
+    long n_cpus= sysconf(_SC_NPROCESSORS_ONLN);
+    size= n_cpus > 0 ? static_cast<ulong>(n_cpus) : 1;
+  }
+
+  mysql_mutex_init(key_LOCK_thread_pool, &LOCK_thread_pool,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_thread_pool, &COND_thread_pool);
+
+  groups= new (std::nothrow) Thread_pool_group[size];
+  if (groups == NULL)
+    return true;
+
+  for (group_count= 0; group_count < size; group_count++)
+  {
+    Thread_pool_group *group= &groups[group_count];
+
+    group->epfd= epoll_create(1024);
+    if (group->epfd < 0)
+      break;
+
+    if (pipe(group->pipe_fds))
+    {
+      close(group->epfd);
+      break;
+    }
+    fcntl(group->pipe_fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(group->pipe_fds[1], F_SETFL, O_NONBLOCK);
+
+    struct epoll_event ev;
+    ev.events= EPOLLIN;
+    ev.data.ptr= NULL;
+    if (epoll_ctl(group->epfd, EPOLL_CTL_ADD, group->pipe_fds[0], &ev))
+    {
+      close(group->pipe_fds[0]);
+      close(group->pipe_fds[1]);
+      close(group->epfd);
+      break;
+    }
+
+    mysql_mutex_init(key_LOCK_thread_pool_group, &group->mutex,
+                     MY_MUTEX_INIT_FAST);
+    group->listener= NULL;
+    group->thread_count= 0;
+    group->active_thread_count= 0;
+    group->dequeue_count= 0;
+    group->last_dequeue_count= 0;
+    group->stalled= false;
+    group->shutdown= false;
+    group->connections= NULL;
+    group->next_deadline= ULLONG_MAX;
+  }
+
+  if (group_count < size)
+  {
+    sql_print_error("Can't create the thread pool (errno= %d)", errno);
+    return true;
+  }
+
+  pthread_t id;
+  timer_running= true;
+  if (mysql_thread_create(key_thread_pool_timer, &id, &connection_attrib,
+                          tp_timer_main, NULL))
+  {
+    timer_running= false;
+    sql_print_error("Can't create the thread pool timer thread");
+    return true;
+  }
+
+  Connection_handler_manager::event_functions= &tp_event_functions;
+  return false;
+}
+
+
+Thread_pool_connection_handler::~Thread_pool_connection_handler()
+{
+  if (groups == NULL)
+    return;
+
+  if (Connection_handler_manager::event_functions == &tp_event_functions)
+    Connection_handler_manager::event_functions= NULL;
+
+  for (uint i= 0; i < group_count; i++)
+  {
+    Thread_pool_group *group= &groups[i];
+
+    mysql_mutex_lock(&group->mutex);
+    group->shutdown= true;
+    for (std::vector<Thread_pool_worker*>::iterator it=
+           group->waiting.begin(); it != group->waiting.end(); ++it)
+      mysql_cond_signal(&(*it)->cond);
+    wake_listener(group);
+    mysql_mutex_unlock(&group->mutex);
+  }
+
+  mysql_mutex_lock(&LOCK_thread_pool);
+  timer_shutdown= true;
+  mysql_cond_broadcast(&COND_thread_pool);
+  while (timer_running || total_threads > 0)
+    mysql_cond_wait(&COND_thread_pool, &LOCK_thread_pool);
+  mysql_mutex_unlock(&LOCK_thread_pool);
+
+  for (uint i= 0; i < group_count; i++)
+  {
+    Thread_pool_group *group= &groups[i];
+
+    for (std::vector<Thread_pool_connection*>::iterator it=
+           group->ended.begin(); it != group->ended.end(); ++it)
+      delete *it;
+
+    close(group->pipe_fds[0]);
+    close(group->pipe_fds[1]);
+    close(group->epfd);
+    mysql_mutex_destroy(&group->mutex);
+  }
+
+  delete[] groups;
+  groups= NULL;
+  group_count= 0;
+
+  mysql_cond_destroy(&COND_thread_pool);
+  mysql_mutex_destroy(&LOCK_thread_pool);
+}
+
+
+bool Thread_pool_connection_handler::add_connection(Channel_info* channel_info)
+{
+  Thread_pool_connection *conn= new (std::nothrow) Thread_pool_connection;
+  THD *thd= conn != NULL ? channel_info->create_thd() : NULL;
+  if (thd == NULL)
+  {
+    delete conn;
+    connection_errors_internal++;
+    channel_info->send_error_and_close_channel(ER_OUT_OF_RESOURCES, 0, false);
+    Connection_handler_manager::dec_connection_count();
+    return true;
+  }
+
+  thd->set_new_thread_id();
+  thd->start_utime= thd->thr_create_utime= my_micro_time();
+  thd->scheduler.data= conn;
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  thd_set_psi(thd, PSI_THREAD_CALL(new_thread)
+              (key_thread_one_connection, thd, thd->thread_id()));
+#endif
+  delete channel_info;
+
+  Global_THD_manager::get_instance()->add_thd(thd);
+
+  Thread_pool_group *group= &groups[thd->thread_id() % group_count];
+
+  conn->thd= thd;
+  conn->group= group;
+  conn->logged_in= false;
+  conn->registered= false;
+  conn->timed_out= false;
+  conn->waiting= false;
+  conn->high_prio= false;
+  conn->tickets= high_prio_tickets;
+  conn->deadline= ULLONG_MAX;
+
+  mysql_mutex_lock(&group->mutex);
+  conn->prev= NULL;
+  conn->next= group->connections;
+  if (conn->next != NULL)
+    conn->next->prev= conn;
+  group->connections= conn;
+  queue_put(group, conn);
+  mysql_mutex_unlock(&group->mutex);
+
+  return false;
+}
+
+
+uint Thread_pool_connection_handler::get_max_threads() const
+{
+  return max_threads;
+}
+
+#else /* HAVE_EPOLL */
+
+bool Thread_pool_connection_handler::init()
+{
+  sql_print_error("The thread pool is not supported on this platform");
+  return true;
+}
+
+
+Thread_pool_connection_handler::~Thread_pool_connection_handler()
+{
+}
+
+
+bool Thread_pool_connection_handler::add_connection(Channel_info* channel_info)
+{
+  DBUG_ASSERT(false);
+  return true;
+}
+
+
+uint Thread_pool_connection_handler::get_max_threads() const
+{
+  return 0;
+}
+
+#endif /* HAVE_EPOLL */
@@ -549,6 +549,10 @@ bool Query_cache::try_lock(bool use_timeout)
   }
   mysql_mutex_unlock(&structure_guard_mutex);
 
+  /* Wait for the readers in send_result_to_client() to leave. */
+  if (!interrupt)
+    mysql_rwlock_wrlock(&structure_guard_latch);
+
   DBUG_RETURN(interrupt);
 }
 
@@ -582,6 +586,8 @@ void Query_cache::lock_and_suspend(void)
   mysql_cond_broadcast(&COND_cache_status_changed);
   mysql_mutex_unlock(&structure_guard_mutex);
 
+  mysql_rwlock_wrlock(&structure_guard_latch);
+
   DBUG_VOID_RETURN;
 }
 
@@ -609,6 +615,8 @@ void Query_cache::lock(void)
 #endif
   mysql_mutex_unlock(&structure_guard_mutex);
 
+  mysql_rwlock_wrlock(&structure_guard_latch);
+
   DBUG_VOID_RETURN;
 }
 
@@ -620,6 +628,7 @@ void Query_cache::lock(void)
 void Query_cache::unlock(void)
 {
   DBUG_ENTER("Query_cache::unlock");
+  mysql_rwlock_unlock(&structure_guard_latch);
   mysql_mutex_lock(&structure_guard_mutex);
 #ifndef DBUG_OFF
   THD *thd= current_thd;
@@ -630,12 +639,85 @@ void Query_cache::unlock(void)
               m_cache_lock_status == Query_cache::LOCKED_NO_WAIT);
   m_cache_lock_status= Query_cache::UNLOCKED;
   DBUG_PRINT("Query_cache",("Sending signal"));
-  mysql_cond_signal(&COND_cache_status_changed);
+  /*
+    Both lockers and readers in try_lock_shared() may be waiting, so
+    all of them have to be woken up.
+  */
+  mysql_cond_broadcast(&COND_cache_status_changed);
   mysql_mutex_unlock(&structure_guard_mutex);
   DBUG_VOID_RETURN;
 }
 
 
+/**
+  Get shared access to the query cache for a lookup.
+
+  Lookups do not use the cache lock but only take structure_guard_latch
+  in shared mode, which every holder of the cache lock holds exclusively.
+  If the cache lock is held or wanted, wait like try_lock(TRUE) does:
+  give up after a timeout, or at once if the whole cache is being flushed.
+
+  @return
+   @retval FALSE A shared latch was taken
+   @retval TRUE The locking attempt failed
+*/
+
+bool Query_cache::try_lock_shared(void)
+{
+  DBUG_ENTER("Query_cache::try_lock_shared");
+
+  /*
+    Do not take the latch while a thread is waiting for the cache lock.
+    The latch prefers readers, so a stream of lookups could otherwise
+    keep it shared and starve the thread in lock(). The status is read
+    without the mutex; a stale value only lets one more lookup in.
+  */
+  if (m_cache_lock_status == Query_cache::UNLOCKED &&
+      !mysql_rwlock_tryrdlock(&structure_guard_latch))
+    DBUG_RETURN(FALSE);
+
+  bool interrupt= FALSE;
+  THD *thd= current_thd;
+  Query_cache_wait_state wait_state(thd, __func__, __FILE__, __LINE__);
+
+  mysql_mutex_lock(&structure_guard_mutex);
+  while (m_cache_lock_status == Query_cache::LOCKED)
+  {
+    struct timespec waittime;
+    set_timespec_nsec(&waittime, 50000000UL);  /* Wait for 50 msec */
+    int res= mysql_cond_timedwait(&COND_cache_status_changed,
+                                  &structure_guard_mutex, &waittime);
+    if (res == ETIMEDOUT)
+    {
+      interrupt= TRUE;
+      break;
+    }
+  }
+  if (m_cache_lock_status == Query_cache::LOCKED_NO_WAIT)
+    interrupt= TRUE;
+  /*
+    Nobody holds the latch exclusively while the status is UNLOCKED, so
+    this does not block. Taking it before the mutex is released keeps a
+    new locker from getting in between.
+  */
+  if (!interrupt)
+    mysql_rwlock_rdlock(&structure_guard_latch);
+  mysql_mutex_unlock(&structure_guard_mutex);
+
+  DBUG_RETURN(interrupt);
+}
+
+
+/**
+  Release the shared latch taken by try_lock_shared().
+*/
+
+void Query_cache::unlock_shared(void)
+{
+  mysql_rwlock_unlock(&structure_guard_latch);
+}
+
+
 /**
   Helper function for determine if a SELECT statement has a SQL_NO_CACHE
   directive.
@@ -845,7 +927,7 @@ inline void Query_cache_query::unlock_reading()
 void Query_cache_query::init_n_lock()
 {
   DBUG_ENTER("Query_cache_query::init_n_lock");
-  res=0; wri = 0; len = 0;
+  res=0; wri = 0; len = 0; ref_flag= 0;
   mysql_rwlock_init(key_rwlock_query_cache_query_lock, &lock);
   lock_writing();
   DBUG_PRINT("qcache", ("inited & locked query for block 0x%lx",
@@ -991,8 +1073,8 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
     header->result(result);
     DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
     // The following call will remove the lock on query_block
-    query_cache.free_query(query_block);
-    query_cache.refused++;
+    free_query(query_block);
+    refused++;
     // append_result_data no success => we need unlock
     unlock();
     DBUG_VOID_RETURN;
@@ -1103,9 +1185,9 @@ void Query_cache::end_of_result(THD *thd)
     }
     last_result_block= header->result()->prev;
     allign_size= ALIGN_SIZE(last_result_block->used);
-    len= max(query_cache.min_allocation_unit, allign_size);
-    if (last_result_block->length >= query_cache.min_allocation_unit + len)
-      query_cache.split_block(last_result_block,len);
+    len= max(min_allocation_unit, allign_size);
+    if (last_result_block->length >= min_allocation_unit + len)
+      split_block(last_result_block,len);
 
     header->found_rows(limit_found_rows);
     header->result()->type= Query_cache_block::RESULT;
@@ -1172,8 +1254,9 @@ Query_cache::Query_cache(ulong query_cache_limit_arg,
 			 uint def_table_hash_size_arg)
   :query_cache_size(0),
    query_cache_limit(query_cache_limit_arg),
-   queries_in_cache(0), hits(0), inserts(0), refused(0),
-   total_blocks(0), lowmem_prunes(0), m_query_cache_is_disabled(FALSE),
+   queries_in_cache(0), inserts(0), refused(0),
+   total_blocks(0), lowmem_prunes(0), hits(0),
+   m_query_cache_is_disabled(FALSE),
    min_allocation_unit(ALIGN_SIZE(min_allocation_unit_arg)),
    min_result_data_size(ALIGN_SIZE(min_result_data_size_arg)),
    def_query_hash_size(ALIGN_SIZE(def_query_hash_size_arg)),
@@ -1416,6 +1499,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
 	double_linked_list_simple_include(query_block, &queries_blocks);
 	inserts++;
 	queries_in_cache++;
+	thd->query_cache_tls.query_cache= this;
 	thd->query_cache_tls.first_query_block= query_block;
 	header->writer(&thd->query_cache_tls);
 	header->tables_type(tables_type);
@@ -1599,13 +1683,12 @@ int Query_cache::send_result_to_client(THD *thd, const LEX_CSTRING &sql)
     }
   }
   /*
-    Try to obtain an exclusive lock on the query cache. If the cache is
+    Try to obtain a shared latch on the query cache. If the cache is
     disabled or if a full cache flush is in progress, the attempt to
-    get the lock is aborted.
-
-    The 'TRUE' parameter indicate that the lock is allowed to timeout
+    get the latch is aborted. The lookup below only reads the cache
+    structure, so concurrent lookups do not block each other.
   */
-  if (try_lock(TRUE))
+  if (try_lock_shared())
     goto err;
 
   if (query_cache_size == 0)
@@ -1756,7 +1839,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
         DBUG_PRINT("qcache",
                    ("Temporary table detected: '%s.%s'",
                     tmptable->s->db.str, tmptable->s->table_name.str));
-        unlock();
+        unlock_shared();
         /*
           We should not store result of this query because it contain
           temporary tables => assign following variable to make check
@@ -1777,7 +1860,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
       DBUG_PRINT("qcache",
 		 ("probably no SELECT access to %s.%s =>  return to normal processing",
 		  table_list.db, table_list.alias));
-      unlock();
+      unlock_shared();
       thd->lex->safe_to_cache_query=0;		// Don't try to cache this
       BLOCK_UNLOCK_RD(query_block);
       DBUG_RETURN(-1);				// Privilege error
@@ -1810,14 +1893,22 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
         DBUG_PRINT("qcache", ("Handler does not allow caching for %s.%s",
                                table_list.db, table_list.alias));
         BLOCK_UNLOCK_RD(query_block);
+        char invalidate_key[MAX_DBKEY_LENGTH];
+        size_t invalidate_key_length= 0;
         if (engine_data != table->engine_data())
         {
           DBUG_PRINT("qcache",
                      ("Handler require invalidation queries of %s.%s %lu-%lu",
                       table_list.db, table_list.alias,
                       (ulong) engine_data, (ulong) table->engine_data()));
-          invalidate_table_internal(thd, (uchar *) table->db(),
-                                    table->key_length());
+          /*
+            Invalidation changes the cache structure, so it is done
+            below under the cache lock instead of the shared latch.
+            Copy the key, as the table block may be freed as soon as
+            the latch is released.
+          */
+          invalidate_key_length= table->key_length();
+          memcpy(invalidate_key, table->db(), invalidate_key_length);
         }
         else
           thd->lex->safe_to_cache_query= 0;       // Don't try to cache this
@@ -1828,16 +1919,25 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
         */
         DBUG_ASSERT(! thd->transaction_rollback_request);
         trans_rollback_stmt(thd);
-        goto err_unlock;				// Parse query
+        unlock_shared();
+        if (invalidate_key_length)
+          invalidate_table(thd, (uchar *) invalidate_key,
+                           invalidate_key_length);
+        goto err;				// Parse query
      }
    }
     else
       DBUG_PRINT("qcache", ("handler allow caching %s,%s",
 			    table_list.db, table_list.alias));
   }
-  move_to_query_list_end(query_block);
-  hits++;
-  unlock();
+  /*
+    Instead of moving the query to the end of the list as the most
+    recently used, which would need the cache lock, mark it so that
+    free_old_query() passes it over once.
+  */
+  query->referenced(1);
+  my_atomic_add64(&hits, 1);
+  unlock_shared();
 
   /*
     Send cached result to client
@@ -1896,7 +1996,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
   DBUG_RETURN(1);				// Result sent to client
 
 err_unlock:
-  unlock();
+  unlock_shared();
 err:
   MYSQL_QUERY_CACHE_MISS(const_cast<char*>(thd->query().str));
   DBUG_RETURN(0);				// Query was not cached
@@ -1915,10 +2015,10 @@ err:
                              be invalidated once the transaction commits.
 */
 
-void Query_cache::invalidate_single(THD *thd, TABLE_LIST *table_used,
-                                    my_bool using_transactions)
+void Query_cache_manager::invalidate_single(THD *thd, TABLE_LIST *table_used,
+                                            my_bool using_transactions)
 {
-  DBUG_ENTER("Query_cache::invalidate_single (table list)");
+  DBUG_ENTER("Query_cache_manager::invalidate_single (table list)");
   if (is_disabled())
     DBUG_VOID_RETURN;
 
@@ -1944,13 +2044,13 @@ void Query_cache::invalidate_single(THD *thd, TABLE_LIST *table_used,
 /**
   Remove all cached queries that use any of the tables in the list.
 
-  @see Query_cache::invalidate_single().
+  @see Query_cache_manager::invalidate_single().
 */
 
-void Query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
-			     my_bool using_transactions)
+void Query_cache_manager::invalidate(THD *thd, TABLE_LIST *tables_used,
+                                     my_bool using_transactions)
 {
-  DBUG_ENTER("Query_cache::invalidate (table list)");
+  DBUG_ENTER("Query_cache_manager::invalidate (table list)");
   if (is_disabled())
     DBUG_VOID_RETURN;
 
@@ -1963,9 +2063,9 @@ void Query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
   DBUG_VOID_RETURN;
 }
 
-void Query_cache::invalidate(CHANGED_TABLE_LIST *tables_used)
+void Query_cache_manager::invalidate(CHANGED_TABLE_LIST *tables_used)
 {
-  DBUG_ENTER("Query_cache::invalidate (changed table list)");
+  DBUG_ENTER("Query_cache_manager::invalidate (changed table list)");
   if (is_disabled())
     DBUG_VOID_RETURN;
 
@@ -1992,9 +2092,9 @@ void Query_cache::invalidate(CHANGED_TABLE_LIST *tables_used)
   NOTE
     can be used only for opened tables
 */
-void Query_cache::invalidate_locked_for_write(TABLE_LIST *tables_used)
+void Query_cache_manager::invalidate_locked_for_write(TABLE_LIST *tables_used)
 {
-  DBUG_ENTER("Query_cache::invalidate_locked_for_write");
+  DBUG_ENTER("Query_cache_manager::invalidate_locked_for_write");
   if (is_disabled())
     DBUG_VOID_RETURN;
 
@@ -2015,10 +2115,10 @@ void Query_cache::invalidate_locked_for_write(TABLE_LIST *tables_used)
   Remove all cached queries that uses the given table
 */
 
-void Query_cache::invalidate(THD *thd, TABLE *table, 
-			     my_bool using_transactions)
+void Query_cache_manager::invalidate(THD *thd, TABLE *table,
+                                     my_bool using_transactions)
 {
-  DBUG_ENTER("Query_cache::invalidate (table)");
+  DBUG_ENTER("Query_cache_manager::invalidate (table)");
   if (is_disabled())
     DBUG_VOID_RETURN;
 
@@ -2033,10 +2133,11 @@ void Query_cache::invalidate(THD *thd, TABLE *table,
   DBUG_VOID_RETURN;
 }
 
-void Query_cache::invalidate(THD *thd, const char *key, uint32  key_length,
-			     my_bool using_transactions)
+void Query_cache_manager::invalidate(THD *thd, const char *key,
+                                     uint32 key_length,
+                                     my_bool using_transactions)
 {
-  DBUG_ENTER("Query_cache::invalidate (key)");
+  DBUG_ENTER("Query_cache_manager::invalidate (key)");
   if (is_disabled())
    DBUG_VOID_RETURN;
 
@@ -2128,17 +2229,21 @@ void Query_cache::invalidate(const char *db)
 }
 
 
-void Query_cache::invalidate_by_MyISAM_filename(const char *filename)
+void Query_cache_manager::invalidate_by_MyISAM_filename(const char *filename)
 {
-  DBUG_ENTER("Query_cache::invalidate_by_MyISAM_filename");
+  DBUG_ENTER("Query_cache_manager::invalidate_by_MyISAM_filename");
 
   /* Calculate the key outside the lock to make the lock shorter */
   char key[MAX_DBKEY_LENGTH];
   size_t db_length;
-  size_t key_length= filename_2_table_key(key, filename, &db_length);
+  size_t key_length= Query_cache::filename_2_table_key(key, filename,
+                                                      &db_length);
   THD *thd= current_thd;
   invalidate_table(thd,(uchar *)key, key_length);
-  DBUG_EXECUTE("check_querycache", check_integrity(LOCK_WHILE_CHECKING););
+  DBUG_EXECUTE("check_querycache",
+               for (uint i= 0; i < query_cache_instances; i++)
+                 m_query_cache[i].check_integrity(
+                   Query_cache::LOCK_WHILE_CHECKING););
   DBUG_VOID_RETURN;
 }
 
@@ -2221,6 +2326,7 @@ void Query_cache::destroy()
     free_cache();
     unlock();
 
+    mysql_rwlock_destroy(&structure_guard_latch);
     mysql_cond_destroy(&COND_cache_status_changed);
     mysql_mutex_destroy(&structure_guard_mutex);
     initialized = 0;
@@ -2240,7 +2346,11 @@ void Query_cache::init()
                    &structure_guard_mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_COND_cache_status_changed,
                   &COND_cache_status_changed);
+  mysql_rwlock_init(key_rwlock_query_cache_structure_guard_latch,
+                    &structure_guard_latch);
   m_cache_lock_status= Query_cache::UNLOCKED;
+  for (uint i= 0; i < QUERY_CACHE_TABLE_FILTER_SIZE; i++)
+    m_table_filter[i]= 0;
   initialized = 1;
   /*
     If we explicitly turn off query cache from the command line query cache will
@@ -2249,7 +2359,7 @@ void Query_cache::init()
     be used.
   */
   if (global_system_variables.query_cache_type == 0)
-    query_cache.disable_query_cache();
+    disable_query_cache();
 
   DBUG_VOID_RETURN;
 }
@@ -2447,6 +2557,8 @@ void Query_cache::make_disabled()
   first_block= 0;
   total_blocks= 0;
   tables_blocks= 0;
+  for (uint i= 0; i < QUERY_CACHE_TABLE_FILTER_SIZE; i++)
+    m_table_filter[i]= 0;
   DBUG_VOID_RETURN;
 }
 
@@ -2517,16 +2629,27 @@ my_bool Query_cache::free_old_query()
       Also we don't need remove locked queries at this point.
     */
     Query_cache_block *query_block= 0;
-    if (queries_blocks != 0)
+    /*
+      Search until we find first query that we can remove. Hits do not
+      reorder the query list as they only hold the shared latch; a query
+      that was hit since the last search is passed over once instead
+      (second chance), and taken only if nothing else can be removed.
+    */
+    for (uint pass= 0; pass < 2 && query_block == 0; pass++)
     {
       Query_cache_block *block = queries_blocks;
-      /* Search until we find first query that we can remove */
       do
       {
 	Query_cache_query *header = block->query();
-	if (header->result() != 0 &&
-	    header->result()->type == Query_cache_block::RESULT &&
-	    block->query()->try_lock_writing())
+	if (header->result() == 0 ||
+	    header->result()->type != Query_cache_block::RESULT)
+	  continue;
+	if (pass == 0 && header->referenced())
+	{
+	  header->referenced(0);
+	  continue;
+	}
+	if (block->query()->try_lock_writing())
 	{
 	  query_block = block;
 	  break;
@@ -2912,7 +3035,7 @@ my_bool Query_cache::allocate_data_chain(Query_cache_block **result_block,
   Invalidate the first table in the table_list
 */
 
-void Query_cache::invalidate_table(THD *thd, TABLE_LIST *table_list)
+void Query_cache_manager::invalidate_table(THD *thd, TABLE_LIST *table_list)
 {
   if (table_list->table != 0)
     invalidate_table(thd, table_list->table);	// Table is open
@@ -2927,7 +3050,7 @@ void Query_cache::invalidate_table(THD *thd, TABLE_LIST *table_list)
   }
 }
 
-void Query_cache::invalidate_table(THD *thd, TABLE *table)
+void Query_cache_manager::invalidate_table(THD *thd, TABLE *table)
 {
   invalidate_table(thd, (uchar*) table->s->table_cache_key.str,
                    table->s->table_cache_key.length);
@@ -3215,6 +3338,8 @@ Query_cache::insert_table(size_t key_len, const char *key,
       free_memory_block(table_block);
       DBUG_RETURN(0);
     }
+    my_atomic_add32(&m_table_filter[table_filter_slot((const uchar*) key,
+                                                      key_len)], 1);
     char *db= header->db();
     header->table(db + db_length + 1);
     header->key_length(key_len);
@@ -3275,11 +3400,32 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
     double_linked_list_exclude(table_block,
                                &tables_blocks);
     my_hash_delete(&tables,(uchar *) table_block);
+    my_atomic_add32(&m_table_filter[table_filter_slot(
+                      table_block_data->data(),
+                      table_block_data->key_length())], -1);
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
 }
 
+/**
+  Slot of the table filter for a table key. Hashed with the collation
+  of the 'tables' hash, so keys that the hash matches share a slot.
+*/
+
+uint Query_cache::table_filter_slot(const uchar *key, size_t key_length)
+{
+#ifndef FN_NO_CASE_SENSE
+  const CHARSET_INFO *cs= &my_charset_bin;
+#else
+  const CHARSET_INFO *cs= lower_case_table_names ? &my_charset_bin :
+                          files_charset_info;
+#endif
+  ulong nr1= 1, nr2= 4;
+  cs->coll->hash_sort(cs, key, key_length, &nr1, &nr2);
+  return (uint) (nr1 % QUERY_CACHE_TABLE_FILTER_SIZE);
+}
+
 /*****************************************************************************
   Free memory management
 *****************************************************************************/
@@ -3557,15 +3703,6 @@ uint Query_cache::find_bin(size_t size)
  Lists management
 *****************************************************************************/
 
-void Query_cache::move_to_query_list_end(Query_cache_block *query_block)
-{
-  DBUG_ENTER("Query_cache::move_to_query_list_end");
-  double_linked_list_exclude(query_block, &queries_blocks);
-  double_linked_list_simple_include(query_block, &queries_blocks);
-  DBUG_VOID_RETURN;
-}
-
-
 void Query_cache::insert_into_free_memory_sorted_list(Query_cache_block *
 						      new_block,
 						      Query_cache_block **
@@ -4299,6 +4436,210 @@ size_t Query_cache::filename_2_table_key (char *key, const char *path,
                                   filename, NAME_LEN) - key) + 1);
 }
 
+/*****************************************************************************
+  Query_cache_manager methods
+*****************************************************************************/
+
+/**
+  Choose the instance that caches the given statement.
+
+  The query text and the current database are part of the key of a
+  cached query, so a statement always maps to the same instance.
+*/
+
+Query_cache *Query_cache_manager::get_cache(THD *thd,
+                                            const LEX_CSTRING &query)
+{
+  /* Without cache memory nothing is found, so any instance will do. */
+  if (query_cache_instances == 1 || query_cache_size == 0)
+    return &m_query_cache[0];
+
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (const uchar*) query.str,
+                                 query.length, &nr1, &nr2);
+  if (thd->db().str)
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (const uchar*) thd->db().str,
+                                   thd->db().length, &nr1, &nr2);
+  return &m_query_cache[nr1 % query_cache_instances];
+}
+
+
+void Query_cache_manager::init()
+{
+  DBUG_ENTER("Query_cache_manager::init");
+  for (uint i= 0; i < query_cache_instances; i++)
+  {
+    m_query_cache[i].init();
+    m_query_cache[i].result_size_limit(query_cache_limit);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Resize the cache memory, split evenly between the instances.
+
+  @return Total size of the cache memory actually allocated.
+*/
+
+ulong Query_cache_manager::resize(ulong query_cache_size_arg)
+{
+  DBUG_ENTER("Query_cache_manager::resize");
+  ulong instance_size= query_cache_size_arg / query_cache_instances;
+  ulong new_query_cache_size= 0;
+  for (uint i= 0; i < query_cache_instances; i++)
+    new_query_cache_size+= m_query_cache[i].resize(instance_size);
+  query_cache_size= new_query_cache_size;
+  DBUG_RETURN(new_query_cache_size);
+}
+
+
+void Query_cache_manager::result_size_limit(ulong limit)
+{
+  query_cache_limit= limit;
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].result_size_limit(limit);
+}
+
+
+ulong Query_cache_manager::set_min_res_unit(ulong size)
+{
+  ulong min_res_unit= size;
+  for (uint i= 0; i < query_cache_instances; i++)
+    min_res_unit= m_query_cache[i].set_min_res_unit(size);
+  return min_res_unit;
+}
+
+
+void Query_cache_manager::store_query(THD *thd, TABLE_LIST *used_tables)
+{
+  get_cache(thd, thd->query())->store_query(thd, used_tables);
+}
+
+
+int Query_cache_manager::send_result_to_client(THD *thd,
+                                               const LEX_CSTRING &sql)
+{
+  return get_cache(thd, sql)->send_result_to_client(thd, sql);
+}
+
+
+/*
+  The results of a statement go to the instance that registered it
+  in store_query().
+*/
+
+void Query_cache_manager::insert(Query_cache_tls *query_cache_tls,
+                                 const char *packet, ulong length,
+                                 unsigned pkt_nr)
+{
+  if (query_cache_tls->first_query_block == NULL)
+    return;
+  query_cache_tls->query_cache->insert(query_cache_tls, packet, length,
+                                       pkt_nr);
+}
+
+
+void Query_cache_manager::end_of_result(THD *thd)
+{
+  Query_cache_tls *query_cache_tls= &thd->query_cache_tls;
+  if (query_cache_tls->first_query_block == NULL)
+    return;
+  query_cache_tls->query_cache->end_of_result(thd);
+}
+
+
+void Query_cache_manager::abort(Query_cache_tls *query_cache_tls)
+{
+  if (query_cache_tls->first_query_block == NULL)
+    return;
+  query_cache_tls->query_cache->abort(query_cache_tls);
+}
+
+
+/**
+  Remove all cached queries that use the given table from the
+  instances that may have such queries.
+*/
+
+void Query_cache_manager::invalidate_table(THD *thd, uchar *key,
+                                           size_t key_length)
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+  {
+    if (m_query_cache[i].may_have_table(key, key_length))
+      m_query_cache[i].invalidate_table(thd, key, key_length);
+  }
+}
+
+
+void Query_cache_manager::invalidate(const char *db)
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].invalidate(db);
+}
+
+
+void Query_cache_manager::flush()
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].flush();
+}
+
+
+void Query_cache_manager::pack(ulong join_limit, uint iteration_limit)
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].pack(join_limit, iteration_limit);
+}
+
+
+void Query_cache_manager::destroy()
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].destroy();
+}
+
+
+ulong Query_cache_manager::sum_status(ulong Query_cache::*counter)
+{
+  ulong sum= 0;
+  for (uint i= 0; i < query_cache_instances; i++)
+    sum+= m_query_cache[i].*counter;
+  return sum;
+}
+
+
+ulong Query_cache_manager::sum_hits()
+{
+  int64 sum= 0;
+  for (uint i= 0; i < query_cache_instances; i++)
+    sum+= my_atomic_load64(&m_query_cache[i].hits);
+  return (ulong) sum;
+}
+
+
+/** Reset the counters cleared by FLUSH STATUS. */
+
+void Query_cache_manager::reset_counters()
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+  {
+    Query_cache *cache= &m_query_cache[i];
+    my_atomic_store64(&cache->hits, 0);
+    cache->inserts= cache->refused= cache->lowmem_prunes= 0;
+  }
+}
+
+
+void Query_cache_manager::wreck(uint line, const char *message)
+{
+  for (uint i= 0; i < query_cache_instances; i++)
+    m_query_cache[i].wreck(line, message);
+}
+
+
 /****************************************************************************
   Functions to be used when debugging
 ****************************************************************************/
@@ -18,6 +18,7 @@
 
 #include "hash.h"
 #include "my_base.h"                            /* ha_rows */
+#include "my_atomic.h"
 
 class MY_LOCALE;
 struct TABLE_LIST;
@@ -42,6 +43,9 @@ typedef ulonglong sql_mode_t;
 #define QUERY_CACHE_DEF_QUERY_HASH_SIZE		1024
 #define QUERY_CACHE_DEF_TABLE_HASH_SIZE		1024
 
+/* number of slots in the per instance filter of cached tables */
+#define QUERY_CACHE_TABLE_FILTER_SIZE		1024
+
 /* minimal result data size when data allocated */
 #define QUERY_CACHE_MIN_RESULT_DATA_SIZE	1024*4
 
@@ -159,6 +163,12 @@ struct Query_cache_query
   Query_cache_tls *wri;
   ulong len;
   uint8 tbls_type;
+  /*
+    Set when the query is served from the cache, cleared when
+    free_old_query() passes the query over. Written under the shared
+    structure latch, so it is only a hint.
+  */
+  uint8 ref_flag;
   unsigned int last_pkt_nr;
 
   Query_cache_query() {}                      /* Remove gcc warning */
@@ -172,6 +182,8 @@ struct Query_cache_query
   inline void writer(Query_cache_tls *p)   { wri= p; }
   inline uint8 tables_type()               { return tbls_type; }
   inline void tables_type(uint8 type)      { tbls_type= type; }
+  inline uint8 referenced()                { return ref_flag; }
+  inline void referenced(uint8 flag)       { ref_flag= flag; }
   inline ulong length()			   { return len; }
   inline ulong add(ulong packet_len)	   { return(len+= packet_len); }
   inline void length(ulong length_arg)	   { len= length_arg; }
@@ -282,12 +294,15 @@ struct Query_cache_memory_bin_step
 
 class Query_cache
 {
+  friend class Query_cache_manager;
 public:
   /* Info */
   ulong query_cache_size, query_cache_limit;
   /* statistics */
-  ulong free_memory, queries_in_cache, hits, inserts, refused,
+  ulong free_memory, queries_in_cache, inserts, refused,
     free_memory_blocks, total_blocks, lowmem_prunes;
+  /* Incremented under the shared structure latch, so updated atomically */
+  volatile int64 hits;
 
 
 private:
@@ -300,9 +315,18 @@ private:
 
   bool m_query_cache_is_disabled;
 
+  /**
+    Counting filter over the keys of the tables in 'tables'. A slot is
+    non-zero if a table hashing to it has cached queries. It is read
+    without any lock by may_have_table(), so Query_cache_manager can
+    skip instances that have nothing to invalidate.
+  */
+  volatile int32 m_table_filter[QUERY_CACHE_TABLE_FILTER_SIZE];
+
   void free_query_internal(Query_cache_block *point);
   void invalidate_table_internal(THD *thd, uchar *key, size_t key_length);
   void disable_query_cache(void) { m_query_cache_is_disabled= TRUE; }
+  static uint table_filter_slot(const uchar *key, size_t key_length);
 
 protected:
   /*
@@ -320,6 +344,13 @@ protected:
     till the end of a flush operation.
   */
   mysql_mutex_t structure_guard_mutex;
+  /*
+    Every holder of the cache lock (see lock()) also holds this latch
+    exclusively. send_result_to_client() only reads the hashes and
+    lists, so it takes the latch in shared mode instead of the cache
+    lock, and cache hits do not serialize on structure_guard_mutex.
+  */
+  mysql_rwlock_t structure_guard_latch;
   uchar *cache;					// cache memory
   Query_cache_block *first_block;		// physical location block list
   Query_cache_block *queries_blocks;		// query list (LIFO)
@@ -357,10 +388,6 @@ protected:
 			      ulong data_len,
 			      Query_cache_block *query_block,
 			      my_bool first_block);
-  void invalidate_table(THD *thd, TABLE_LIST *table);
-  void invalidate_table(THD *thd, TABLE *table);
-  void invalidate_table(THD *thd, uchar *key, size_t key_length);
-  void invalidate_table(THD *thd, Query_cache_block *table_block);
   void invalidate_query_block_list(THD *thd, 
                                    Query_cache_block_table *list_root);
 
@@ -390,7 +417,6 @@ protected:
   my_bool move_by_type(uchar **border, Query_cache_block **before,
 		       ulong *gap, Query_cache_block *i);
   uint find_bin(size_t size);
-  void move_to_query_list_end(Query_cache_block *block);
   void insert_into_free_memory_sorted_list(Query_cache_block *new_block,
 					   Query_cache_block **list);
   void pack_cache();
@@ -464,23 +490,22 @@ protected:
   */
   int send_result_to_client(THD *thd, const LEX_CSTRING &sql);
 
-  /* Remove all queries that use the given table */
-  void invalidate_single(THD* thd, TABLE_LIST *table_used,
-                         my_bool using_transactions);
-  /* Remove all queries that uses any of the listed following tables */
-  void invalidate(THD* thd, TABLE_LIST *tables_used,
-		  my_bool using_transactions);
-  void invalidate(CHANGED_TABLE_LIST *tables_used);
-  void invalidate_locked_for_write(TABLE_LIST *tables_used);
-  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
-  void invalidate(THD *thd, const char *key, uint32  key_length,
-		  my_bool using_transactions);
+  /* Remove all queries that use the table with the given key */
+  void invalidate_table(THD *thd, uchar *key, size_t key_length);
 
   /* Remove all queries that uses any of the tables in following database */
   void invalidate(const char *db);
 
-  /* Remove all queries that uses any of the listed following table */
-  void invalidate_by_MyISAM_filename(const char *filename);
+  /**
+    Check if there may be cached queries using the table with the given
+    key. Does not lock the cache; a false result is exact for tables
+    registered before the call.
+  */
+  bool may_have_table(const uchar *key, size_t key_length)
+  {
+    return my_atomic_load32(&m_table_filter[table_filter_slot(key,
+                                                              key_length)]);
+  }
 
   void flush();
   void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
@@ -519,6 +544,91 @@ protected:
   void lock(void);
   void lock_and_suspend(void);
   void unlock(void);
+  bool try_lock_shared(void);
+  void unlock_shared(void);
+};
+
+
+/**
+  Container class for all query cache instances in the system.
+
+  Each instance has its own memory, hashes and locks. A statement is
+  cached in the instance chosen by the hash of its text and current
+  database, so lookups and stores of different statements do not
+  contend. Table invalidation visits only the instances whose table
+  filter says they may have queries on the table.
+*/
+
+class Query_cache_manager
+{
+public:
+  /** Maximum supported number of query cache instances. */
+  static const int MAX_QUERY_CACHES= 64;
+
+  /* Info */
+  ulong query_cache_size, query_cache_limit;
+
+  Query_cache_manager() : query_cache_size(0), query_cache_limit(ULONG_MAX) {}
+
+  /** All instances are enabled or disabled together. */
+  bool is_disabled(void) { return m_query_cache[0].is_disabled(); }
+
+  void init();
+  ulong resize(ulong query_cache_size);
+  void result_size_limit(ulong limit);
+  ulong set_min_res_unit(ulong size);
+
+  void store_query(THD *thd, TABLE_LIST *used_tables);
+  int send_result_to_client(THD *thd, const LEX_CSTRING &sql);
+
+  void insert(Query_cache_tls *query_cache_tls,
+              const char *packet,
+              ulong length,
+              unsigned pkt_nr);
+  void end_of_result(THD *thd);
+  void abort(Query_cache_tls *query_cache_tls);
+
+  /* Remove all queries that use the given table */
+  void invalidate_single(THD* thd, TABLE_LIST *table_used,
+                         my_bool using_transactions);
+  /* Remove all queries that uses any of the listed following tables */
+  void invalidate(THD* thd, TABLE_LIST *tables_used,
+		  my_bool using_transactions);
+  void invalidate(CHANGED_TABLE_LIST *tables_used);
+  void invalidate_locked_for_write(TABLE_LIST *tables_used);
+  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
+  void invalidate(THD *thd, const char *key, uint32  key_length,
+		  my_bool using_transactions);
+
+  /* Remove all queries that uses any of the tables in following database */
+  void invalidate(const char *db);
+
+  /* Remove all queries that uses any of the listed following table */
+  void invalidate_by_MyISAM_filename(const char *filename);
+
+  void flush();
+  void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
+	    uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
+  void destroy();
+
+  /* Statistics summed over all instances */
+  ulong sum_status(ulong Query_cache::*counter);
+  ulong sum_hits();
+  void reset_counters();
+
+  void wreck(uint line, const char *message);
+
+private:
+  Query_cache *get_cache(THD *thd, const LEX_CSTRING &query);
+  void invalidate_table(THD *thd, TABLE_LIST *table);
+  void invalidate_table(THD *thd, TABLE *table);
+  void invalidate_table(THD *thd, uchar *key, size_t key_length);
+
+  /**
+    An array of Query_cache instances.
+    Only the first query_cache_instances elements in it are used.
+  */
+  Query_cache m_query_cache[MAX_QUERY_CACHES];
 };
 
 struct Query_cache_query_flags
@@ -544,5 +654,5 @@ struct Query_cache_query_flags
 };
 #define QUERY_CACHE_FLAGS_SIZE sizeof(Query_cache_query_flags)
 
-extern Query_cache query_cache;
+extern Query_cache_manager query_cache;
 #endif
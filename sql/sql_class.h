@@ -394,6 +394,7 @@ class MY_LOCALE;
 */
 
 struct Query_cache_block;
+class Query_cache;
 
 struct Query_cache_tls
 {
@@ -402,12 +403,17 @@ struct Query_cache_tls
     functions and methods to maintain proper locking.
   */
   Query_cache_block *first_query_block;
+  /**
+    The query cache instance 'first_query_block' belongs to. Only
+    meaningful while 'first_query_block' is set.
+  */
+  Query_cache *query_cache;
   void set_first_query_block(Query_cache_block *first_query_block_arg)
   {
     first_query_block= first_query_block_arg;
   }
 
-  Query_cache_tls() :first_query_block(NULL) {}
+  Query_cache_tls() :first_query_block(NULL), query_cache(NULL) {}
 };
 
 #include "sql_lex.h"				/* Must be here */
@@ -618,6 +624,8 @@ typedef struct system_status_var
   ulonglong filesort_range_count;
   ulonglong filesort_rows;
   ulonglong filesort_scan_count;
+  ulonglong join_order_cache_hits;
+  ulonglong join_order_cache_misses;
   /* Prepared statements and binary protocol */
   ulonglong com_stmt_prepare;
   ulonglong com_stmt_reprepare;
@@ -3346,8 +3346,47 @@ end_update(JOIN *join, QEP_TAB *const qep_tab, bool end_of_records)
       // Old and new records are the same, ok to ignore
       if (error == HA_ERR_RECORD_IS_THE_SAME)
         DBUG_RETURN(NESTED_LOOP_OK);
-      table->file->print_error(error, MYF(0));   /* purecov: inspected */
-      DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
+      if (error != HA_ERR_RECORD_FILE_FULL)
+      {
+        table->file->print_error(error, MYF(0)); /* purecov: inspected */
+        DBUG_RETURN(NESTED_LOOP_ERROR);          /* purecov: inspected */
+      }
+      /*
+        Longer BLOB values don't fit in the HEAP table. Remove the old
+        row and let the conversion to disk write the updated one.
+        The BLOBs of record[0] that were not updated point into the
+        memory of the old row, so copy them before it is freed.
+      */
+      for (uint *blob= table->s->blob_field,
+             *blob_end= blob + table->s->blob_fields;
+           blob < blob_end; blob++)
+      {
+        Field_blob *const field= (Field_blob*) table->field[*blob];
+        uchar *data;
+        if (field->is_null())
+          continue;
+        field->get_ptr(&data);
+        const uint32 length= field->get_length();
+        if (length &&
+            !(data= (uchar*) join->thd->memdup(data, length)))
+          DBUG_RETURN(NESTED_LOOP_ERROR);        /* purecov: inspected */
+        field->set_ptr(length, data);
+      }
+      if ((error= table->file->ha_delete_row(table->record[1])))
+      {
+        table->file->print_error(error, MYF(0));
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
+      if (create_ondisk_from_heap(join->thd, table,
+                                  tmp_tbl->start_recinfo,
+                                  &tmp_tbl->recinfo,
+                                  HA_ERR_RECORD_FILE_FULL, FALSE, NULL))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      if ((error= table->file->ha_index_init(0, 0)))
+      {
+        table->file->print_error(error, MYF(0));
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
     }
     DBUG_RETURN(NESTED_LOOP_OK);
   }
@@ -3641,8 +3680,8 @@ QEP_TAB::remove_duplicates()
 
   free_io_cache(tbl);				// Safety
   tbl->file->info(HA_STATUS_VARIABLE);
-  if (tbl->s->db_type() == heap_hton ||
-      (!tbl->s->blob_fields &&
+  if (!tbl->s->blob_fields &&
+      (tbl->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(reclength) + HASH_OVERHEAD) * tbl->file->stats.records <
 	join()->thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join()->thd, tbl,
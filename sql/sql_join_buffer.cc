@@ -30,6 +30,9 @@
 #include "sql_join_buffer.h"
 #include "sql_tmp_table.h"  // instantiate_tmp_table()
 #include "opt_trace.h"
+#include "item_cmpfunc.h"   // Item_func_trig_cond
+#include "mysqld.h"         // mysql_tmpdir
+#include "unireg.h"         // TEMP_PREFIX
 
 #include <algorithm>
 using std::max;
@@ -3443,6 +3446,1049 @@ bool JOIN_CACHE_BKA_UNIQUE::check_match(uchar *rec_ptr)
 }
 
 
+/*
+  Check whether the values of two expressions can be hashed as join keys
+
+  SYNOPSIS
+    hash_key_type()
+      inner         the expression over the joined table
+      outer         the expression over the preceding tables
+      cmp_cs        the collation the expressions are compared with
+      key     OUT   the descriptor of the key to fill in
+
+  DESCRIPTION
+    The function checks whether the values of 'inner' and 'outer' can be
+    hashed in such a way that equal values always get equal hash values.
+    Expressions with subqueries or stored functions are never used: they
+    are evaluated for hash values once more than they would be evaluated
+    by the regular join.
+    The function is used both by the optimizer to estimate the cost of a
+    hash join and by add_hash_join_key().
+
+  RETURN
+    TRUE    the values can be hashed, key->type and key->cs are filled in
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::hash_key_type(Item *inner, Item *outer,
+                                    const CHARSET_INFO *cmp_cs,
+                                    HASH_JOIN_KEY *key)
+{
+  if (inner->has_subquery() || outer->has_subquery() ||
+      inner->has_stored_program() || outer->has_stored_program())
+    return FALSE;
+
+  const Item_result inner_type= inner->result_type();
+  const Item_result outer_type= outer->result_type();
+  if (inner->is_temporal() || outer->is_temporal())
+  {
+    /* Packed temporal values are comparable only within one type */
+    if (!inner->is_temporal() || !outer->is_temporal() ||
+        inner->field_type() != outer->field_type())
+      return FALSE;
+    key->type= HASH_KEY_TEMPORAL;
+  }
+  else if (inner_type == STRING_RESULT && outer_type == STRING_RESULT)
+  {
+    if (cmp_cs == NULL ||
+        !my_charset_same(inner->collation.collation, cmp_cs) ||
+        !my_charset_same(outer->collation.collation, cmp_cs))
+      return FALSE;
+    key->type= HASH_KEY_STRING;
+    key->cs= cmp_cs;
+  }
+  else if (inner_type == INT_RESULT && outer_type == INT_RESULT)
+    key->type= HASH_KEY_INT;
+  else if ((inner_type == INT_RESULT || inner_type == REAL_RESULT ||
+            inner_type == DECIMAL_RESULT) &&
+           (outer_type == INT_RESULT || outer_type == REAL_RESULT ||
+            outer_type == DECIMAL_RESULT))
+    key->type= HASH_KEY_REAL;
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+
+/*
+  Check whether an equality can be used as a hash join key
+
+  SYNOPSIS
+    add_hash_join_key()
+      cond          the condition to check
+      inner_tables  the map of the joined table
+      outer_tables  the map of the tables preceding the joined table
+      const_tables  the map of the constant tables
+      key     OUT   the descriptor of the key to fill in
+
+  DESCRIPTION
+    The function checks whether 'cond' is an equality between an expression
+    that depends only on the joined table and an expression that depends on
+    the preceding tables, and whether the values of both expressions can be
+    hashed, see hash_key_type(). Non-deterministic expressions are never
+    used as they depend on RAND_TABLE_BIT.
+    The function is used both by the optimizer to estimate the cost of a
+    hash join and by collect_hash_join_keys().
+
+  RETURN
+    TRUE    the equality is usable, the descriptor 'key' is filled in
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::add_hash_join_key(Item *cond, table_map inner_tables,
+                                        table_map outer_tables,
+                                        table_map const_tables,
+                                        HASH_JOIN_KEY *key)
+{
+  if (cond->type() != Item::FUNC_ITEM ||
+      ((Item_func *) cond)->functype() != Item_func::EQ_FUNC)
+    return FALSE;
+
+  Item_func_eq *eq= (Item_func_eq *) cond;
+  Item **args= eq->arguments();
+  for (uint i= 0; i < 2; i++)
+  {
+    Item *inner= args[i];
+    Item *outer= args[1 - i];
+    const table_map inner_used= inner->used_tables();
+    const table_map outer_used= outer->used_tables();
+
+    if (!(inner_used & inner_tables) ||
+        (inner_used & ~(inner_tables | const_tables | OUTER_REF_TABLE_BIT)) ||
+        !(outer_used & outer_tables & ~const_tables) ||
+        (outer_used & ~(outer_tables | OUTER_REF_TABLE_BIT)))
+      continue;
+
+    if (!hash_key_type(inner, outer, eq->compare_collation(), key))
+      return FALSE;
+
+    key->inner= inner;
+    key->outer= outer;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Collect the equalities of a condition usable as hash join keys
+
+  SYNOPSIS
+    collect_hash_join_keys()
+      cond          the condition attached to the joined table
+      first_inner   the first inner table of the outer join the joined
+                    table belongs to, or NO_PLAN_IDX
+      inner_tables  the map of the joined table
+      outer_tables  the map of the tables preceding the joined table
+      const_tables  the map of the constant tables
+      keys    OUT   the array of the key descriptors
+      key_parts IN/OUT  the number of the filled elements of 'keys'
+
+  DESCRIPTION
+    Only the top level conjuncts of the condition are looked through.
+    A conjunct guarded by the trigger that turns the join condition off for
+    null complemented rows of the outer join of the joined table is also
+    looked into: the trigger is always on when matches are searched for.
+    Conditions guarded by any other trigger are ignored.
+*/
+
+static void collect_hash_join_keys(Item *cond, plan_idx first_inner,
+                                   table_map inner_tables,
+                                   table_map outer_tables,
+                                   table_map const_tables,
+                                   HASH_JOIN_KEY *keys, uint *key_parts)
+{
+  if (*key_parts == MAX_REF_PARTS)
+    return;
+
+  if (cond->type() == Item::COND_ITEM)
+  {
+    if (((Item_cond *) cond)->functype() != Item_func::COND_AND_FUNC)
+      return;
+    List_iterator<Item> li(*((Item_cond *) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+      collect_hash_join_keys(item, first_inner, inner_tables, outer_tables,
+                             const_tables, keys, key_parts);
+    return;
+  }
+
+  if (cond->type() == Item::FUNC_ITEM &&
+      ((Item_func *) cond)->functype() == Item_func::TRIG_COND_FUNC)
+  {
+    Item_func_trig_cond *trig_cond= (Item_func_trig_cond *) cond;
+    if (first_inner != NO_PLAN_IDX &&
+        trig_cond->get_trig_type() == Item_func_trig_cond::IS_NOT_NULL_COMPL &&
+        trig_cond->get_idx() == first_inner)
+      collect_hash_join_keys(trig_cond->arguments()[0], first_inner,
+                             inner_tables, outer_tables, const_tables,
+                             keys, key_parts);
+    return;
+  }
+
+  if (JOIN_CACHE_BNLH::add_hash_join_key(cond, inner_tables, outer_tables,
+                                         const_tables, keys + *key_parts))
+    (*key_parts)++;
+}
+
+
+/* 
+  Find the equalities of the condition of a table usable as hash join keys
+
+  SYNOPSIS
+    get_hash_join_keys()
+      tab           the joined table
+      const_tables  the map of the constant tables of the join
+      keys    OUT   the array of MAX_REF_PARTS key descriptors to fill in
+
+  DESCRIPTION
+    The function is used both by setup_join_buffering() to decide whether
+    the hash join can be employed for the table and by the init method of
+    JOIN_CACHE_BNLH to build the key descriptors.
+
+  RETURN
+    the number of the found equalities, 0 if the hash join can't be used
+*/
+
+uint JOIN_CACHE_BNLH::get_hash_join_keys(const QEP_shared_owner *tab,
+                                         table_map const_tables,
+                                         HASH_JOIN_KEY *keys)
+{
+  uint key_parts= 0;
+  if (!tab->condition())
+    return 0;
+  const table_map inner_tables= tab->table()->pos_in_table_list->map();
+  const table_map outer_tables=
+    (tab->prefix_tables() & ~(inner_tables | PSEUDO_TABLE_BITS)) |
+    const_tables;
+  collect_hash_join_keys(tab->condition(), tab->first_inner(),
+                         inner_tables, outer_tables, const_tables,
+                         keys, &key_parts);
+  return key_parts;
+}
+
+
+/* 
+  Initialize a BNLH cache       
+
+  SYNOPSIS
+    init()
+
+  DESCRIPTION
+    The function initializes the cache structure. It supposed to be called
+    right after a constructor for the JOIN_CACHE_BNLH.
+    Additionally to what JOIN_CACHE_BNL::init does the function builds the
+    descriptors of the hash join keys, and allocates the hash table at the
+    very end of the join buffer.
+    The number of hash entries is the maximal number of records that can
+    be put into the remaining part of the buffer.
+
+  RETURN
+    0   initialization with buffer allocations has been succeeded
+    1   otherwise
+*/
+
+int JOIN_CACHE_BNLH::init()
+{
+  int rc;
+  DBUG_ENTER("JOIN_CACHE_BNLH::init");
+
+  hash_table= NULL;
+  spill_partitions= 0;
+  spill_probe= NULL;
+
+  if (!(key_parts= get_hash_join_keys(qep_tab, join->const_table_map,
+                                      hash_keys)))
+    DBUG_RETURN(1);
+
+  if ((rc= JOIN_CACHE_BNL::init()))
+    DBUG_RETURN(rc);
+
+  /* The record length is needed to move records to the spill files */
+  if (!with_length)
+  {
+    with_length= TRUE;
+    pack_length+= get_size_of_rec_length();
+    pack_length_with_blob_ptrs+= get_size_of_rec_length();
+  }
+
+  /* Take into account the reference to the next record and the hash value */
+  pack_length+= hash_prefix_length();
+  pack_length_with_blob_ptrs+= hash_prefix_length();
+
+  hash_entries= (uint) (buff_size / (pack_length_with_blob_ptrs +
+                                     get_size_of_rec_offset()));
+  if (!hash_entries)
+    DBUG_RETURN(1);
+
+  /* Initialize the hash table */
+  hash_table= buff + (buff_size - hash_entries*get_size_of_rec_offset());
+  cleanup_hash_table();
+
+  spill_allowed= can_spill(prev_cache != NULL, blobs != 0, qep_tab->table());
+
+  DBUG_RETURN(0);
+}
+
+
+/* 
+  Reset the JOIN_CACHE_BNLH buffer for reading/writing
+
+  SYNOPSIS
+    reset_cache()
+      for_writing  if it's TRUE the function reset the buffer for writing
+
+  DESCRIPTION
+    Additionally to what the default implementation does this function
+    cleans up the hash table allocated within the buffer when the buffer
+    is reset for writing.
+    
+  RETURN
+    none
+*/
+
+void JOIN_CACHE_BNLH::reset_cache(bool for_writing)
+{
+  this->JOIN_CACHE::reset_cache(for_writing);
+  if (for_writing && hash_table)
+    cleanup_hash_table();
+}
+
+
+/* 
+  Clean up the hash table of the JOIN_CACHE_BNLH join buffer
+*/
+
+void JOIN_CACHE_BNLH::cleanup_hash_table()
+{
+  memset(hash_table, 0, (buff+buff_size)-hash_table);
+}
+
+
+/* 
+  Calculate the hash value for the equi-join keys
+
+  SYNOPSIS
+    calc_hash_value()
+      outer             TRUE <=> hash the expressions over the preceding
+                        tables, FALSE <=> hash the expressions over the
+                        joined table
+      hash_value  OUT   the calculated hash value
+
+  DESCRIPTION
+    The expressions are evaluated over the current contents of the record
+    buffers. The values are hashed by the rules of their comparison: strings
+    are hashed according to the comparison collation, numbers compared as
+    doubles are hashed as doubles.
+    The caller has to check thd->is_error() after the call.
+
+  RETURN
+    TRUE    one of the values is NULL: the record or the row can't match
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::calc_hash_value(bool outer, uint32 *hash_value)
+{
+  ulong nr1= 1, nr2= 4;
+  for (uint i= 0; i < key_parts; i++)
+  {
+    const HASH_JOIN_KEY *key= hash_keys + i;
+    Item *item= outer ? key->outer : key->inner;
+    uchar val_buff[8];
+    switch (key->type) {
+    case HASH_KEY_STRING:
+    {
+      char str_buff[STRING_BUFFER_USUAL_SIZE];
+      String tmp(str_buff, sizeof(str_buff), key->cs);
+      String *res= item->val_str(&tmp);
+      if (res == NULL)
+        return TRUE;
+      key->cs->coll->hash_sort(key->cs, (const uchar *) res->ptr(),
+                               res->length(), &nr1, &nr2);
+      continue;
+    }
+    case HASH_KEY_TEMPORAL:
+      int8store(val_buff, item->val_temporal_by_field_type());
+      break;
+    case HASH_KEY_INT:
+      int8store(val_buff, item->val_int());
+      break;
+    default:
+    {
+      DBUG_ASSERT(key->type == HASH_KEY_REAL);
+      double nr= item->val_real();
+      if (nr == 0.0)
+        nr= 0.0;                                  // -0.0 is equal to 0.0
+      float8store(val_buff, nr);
+    }
+    }
+    if (item->null_value)
+      return TRUE;
+    my_charset_bin.coll->hash_sort(&my_charset_bin, val_buff,
+                                   sizeof(val_buff), &nr1, &nr2);
+  }
+  *hash_value= (uint32) nr1;
+  return FALSE;
+}
+
+
+/* 
+  Link a record into the chain of the records of its hash bucket
+
+  SYNOPSIS
+    link_hash_record()
+      rec_ptr     position of the first field of the record in the buffer
+      hash_value  the hash value of the record
+
+  DESCRIPTION
+    The records of a bucket are linked into a circular list. The hash entry
+    refers to the last record of the list, the new record is added right
+    after it, so the list keeps the records in the order they were added.
+*/
+
+void JOIN_CACHE_BNLH::link_hash_record(uchar *rec_ptr, uint32 hash_value)
+{
+  const uint ofs= get_size_of_rec_offset();
+  uchar *entry= hash_table + ofs*(hash_value % hash_entries);
+  uchar *next_ref_ptr= rec_ptr-rec_fields_offset();
+  if (get_offset(ofs, entry) == 0)
+    store_offset(ofs, next_ref_ptr, (ulong) (rec_ptr-buff));
+  else
+  {
+    uchar *last_next_ref_ptr= buff+get_offset(ofs, entry)-rec_fields_offset();
+    /* rec->next_rec= last_rec->next_rec */
+    memcpy(next_ref_ptr, last_next_ref_ptr, ofs);
+    /* last_rec->next_rec= rec */
+    store_offset(ofs, last_next_ref_ptr, (ulong) (rec_ptr-buff));
+  }
+  /* entry->last_rec= rec */
+  store_offset(ofs, entry, (ulong) (rec_ptr-buff));
+}
+
+
+/* 
+  Add a record into the JOIN_CACHE_BNLH buffer
+
+  SYNOPSIS
+    put_record_in_cache()
+
+  DESCRIPTION
+    Additionally to what the default implementation does this function
+    calculates the hash value over the outer expressions of the hash join
+    keys, stores it in the prefix of the record and links the record into
+    the chain of its hash bucket. A record with NULL keys is not linked.
+    While the records are spilled they are not linked either: they are
+    linked when read back from the spill files.
+
+  RETURN
+    TRUE    if it has been decided that it should be the last record
+            in the join buffer,
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record_in_cache()
+{
+  const uint ofs= get_size_of_rec_offset();
+  uchar *next_ref_ptr= pos;
+  uint32 hash_value;
+  pos+= hash_prefix_length();
+
+  // Write record to join buffer
+  bool is_full= JOIN_CACHE::put_record_in_cache();
+
+  if (calc_hash_value(TRUE, &hash_value))
+  {
+    /* The record can't have matches, keep it for null complementing */
+    store_offset(ofs, next_ref_ptr, 0);
+    return is_full;
+  }
+  int4store(next_ref_ptr+ofs, hash_value);
+  if (spill_partitions)
+    store_offset(ofs, next_ref_ptr, 1);
+  else
+    link_hash_record(curr_rec_pos, hash_value);
+  return is_full;
+}
+
+
+/*
+  Read the next record from the JOIN_CACHE_BNLH buffer
+
+  SYNOPSIS
+    get_record()
+
+  DESCRIPTION
+    Additionally to what the default implementation of the virtual 
+    function get_record does this implementation skips the prefix
+    with the link to the next record and the hash value.
+
+  RETURN
+    TRUE  - there are no more records to read from the join buffer
+    FALSE - otherwise
+*/
+
+bool JOIN_CACHE_BNLH::get_record()
+{ 
+  pos+= hash_prefix_length();
+  return this->JOIN_CACHE::get_record();
+}
+
+
+/* 
+  Skip record from the JOIN_CACHE_BNLH join buffer if its match flag is on
+
+  SYNOPSIS
+    skip_record_if_match()
+
+  DESCRIPTION
+    This implementation of the virtual function skip_record_if_match does
+    the same as the default implementation does, but it takes into account
+    the prefix with the link to the next record and the hash value.
+
+  RETURN
+    TRUE  - the match flag is on and the record has been skipped
+    FALSE - the match flag is off 
+*/
+
+bool JOIN_CACHE_BNLH::skip_record_if_match()
+{
+  uchar *save_pos= pos;
+  pos+= hash_prefix_length();
+  if (!this->JOIN_CACHE::skip_record_if_match())
+  {
+    pos= save_pos;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+
+/*
+  Add a record into the JOIN_CACHE_BNLH buffer, join or spill it when full
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    When the join buffer gets full and the records may be spilled, the
+    function starts spilling instead of joining the records from the buffer.
+    From now on the records of any full buffer are moved to the spill files,
+    and they are joined only when all records have been put into the cache.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::put_record()
+{
+  const bool is_full= put_record_in_cache();
+  if (join->thd->is_error())
+    return NESTED_LOOP_ERROR;
+  if (!is_full)
+    return NESTED_LOOP_OK;
+  if (spill_partitions || spill_allowed)
+  {
+    if ((!spill_partitions && start_spilling()) || spill_buffered_records())
+      return NESTED_LOOP_ERROR;
+    return NESTED_LOOP_OK;
+  }
+  return join_records(FALSE);
+}
+
+
+/*
+  Join the records from the join buffer, or from the spilled partitions
+
+  SYNOPSIS
+    end_send()
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::end_send()
+{
+  if (!spill_partitions)
+    return join_records(FALSE);
+  const enum_nested_loop_state rc= join_spilled_partitions();
+  end_spilling();
+  return rc;
+}
+
+
+/*
+  Start spilling the records of the JOIN_CACHE_BNLH buffer to partitions
+
+  SYNOPSIS
+    start_spilling()
+
+  DESCRIPTION
+    The function chooses the number of partitions such that the records of
+    one partition are expected to fit into the join buffer. The expectation
+    is based on the estimated number of records to be put into the cache
+    and on the average length of the records in the full join buffer.
+    The number of partitions is a power of 2 between 2 and
+    1 << HASH_JOIN_MAX_SPILL_BITS. A partition that still does not fit
+    into the buffer is joined in several passes.
+    The temporary files are opened only once and reused by the following
+    executions of the join.
+
+  RETURN
+    FALSE   spilling has been started
+    TRUE    an error occurred
+*/
+
+bool JOIN_CACHE_BNLH::start_spilling()
+{
+  DBUG_ENTER("JOIN_CACHE_BNLH::start_spilling");
+  DBUG_ASSERT(records && spill_allowed);
+
+  if (spill_outer == NULL)
+  {
+    const uint max_partitions= 1U << HASH_JOIN_MAX_SPILL_BITS;
+    if (!(spill_outer= (IO_CACHE *) sql_calloc(sizeof(IO_CACHE) *
+                                                max_partitions)) ||
+        !(spill_inner= (IO_CACHE *) sql_calloc(sizeof(IO_CACHE) *
+                                                max_partitions)) ||
+        !(spill_outer_rows= (ha_rows *) sql_calloc(sizeof(ha_rows) *
+                                                    max_partitions)) ||
+        !(spill_inner_rows= (ha_rows *) sql_calloc(sizeof(ha_rows) *
+                                                    max_partitions)))
+      DBUG_RETURN(TRUE);
+  }
+
+  const POSITION *const prev_pos= qep_tab[-1].position();
+  const double rec_length= (double) (end_pos-buff) / records;
+  const double parts= prev_pos ?
+    prev_pos->prefix_rowcount * rec_length / (hash_table-buff) : 0.0;
+  for (spill_bits= 1;
+       spill_bits < HASH_JOIN_MAX_SPILL_BITS && (1U << spill_bits) < parts;
+       spill_bits++)
+  {}
+
+  for (uint i= 0; i < (1U << spill_bits); i++)
+  {
+    IO_CACHE *files[2]= { &spill_outer[i], &spill_inner[i] };
+    for (uint j= 0; j < 2; j++)
+    {
+      if (my_b_inited(files[j]) ?
+          reinit_io_cache(files[j], WRITE_CACHE, 0L, 0, 0) :
+          open_cached_file(files[j], mysql_tmpdir, TEMP_PREFIX,
+                           HASH_JOIN_SPILL_BUFFER_SIZE, MYF(MY_WME)))
+        DBUG_RETURN(TRUE);
+    }
+    spill_outer_rows[i]= spill_inner_rows[i]= 0;
+  }
+  spill_partitions= 1U << spill_bits;
+  DBUG_PRINT("info", ("spilling to %u partitions", spill_partitions));
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Move all records from the JOIN_CACHE_BNLH buffer to the spill files
+
+  SYNOPSIS
+    spill_buffered_records()
+
+  DESCRIPTION
+    Each record is written together with its prefix and prepended by its
+    total length. The record goes to the partition of its hash value; a
+    record with NULL keys goes to the first partition where it only can
+    get a null complement. The join buffer is reset for writing afterwards.
+
+  RETURN
+    FALSE   the records have been written
+    TRUE    an error occurred
+*/
+
+bool JOIN_CACHE_BNLH::spill_buffered_records()
+{
+  const uint ofs= get_size_of_rec_offset();
+  uchar len_buff[4];
+  uchar *rec= buff;
+  while (rec < end_pos)
+  {
+    const ulong len= hash_prefix_length() + get_size_of_rec_length() +
+                     get_rec_length(rec+hash_prefix_length());
+    const uint part= get_offset(ofs, rec) ?
+                     get_partition(uint4korr(rec+ofs)) : 0;
+    IO_CACHE *file= &spill_outer[part];
+    int4store(len_buff, len);
+    if (my_b_write(file, len_buff, sizeof(len_buff)) ||
+        my_b_write(file, rec, len))
+      return TRUE;
+    spill_outer_rows[part]++;
+    rec+= len;
+  }
+  reset_cache(TRUE);
+  return FALSE;
+}
+
+
+/*
+  Spill the rows of the joined table to partitions
+
+  SYNOPSIS
+    spill_inner_table()
+
+  DESCRIPTION
+    The function scans the joined table once and writes each row that meets
+    the conditions pushed to the table and has no NULL keys into the spill
+    file of the partition of its hash value. A row is written as its hash
+    value followed by the row id, if it's needed by the join, followed by
+    the image of the record buffer.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::spill_inner_table()
+{
+  int error;
+  TABLE *const table= qep_tab->table();
+  uchar hash_buff[4];
+
+  if ((error= (*qep_tab->read_first_record)(qep_tab)))
+    return error < 0 ? NESTED_LOOP_OK : NESTED_LOOP_ERROR;
+
+  READ_RECORD *info= &qep_tab->read_record;
+  do
+  {
+    if (join->thd->killed)
+    {
+      /* The user has aborted the execution of the query */
+      join->thd->send_kill_message();
+      return NESTED_LOOP_KILLED;
+    }
+
+    join->examined_rows++;
+    if (const_cond)
+    {
+      const bool consider_record= const_cond->val_int() != FALSE;
+      if (join->thd->is_error())              // error in condition evaluation
+        return NESTED_LOOP_ERROR;
+      if (!consider_record)
+        continue;
+    }
+
+    uint32 hash_value;
+    const bool null_key= calc_hash_value(FALSE, &hash_value);
+    if (join->thd->is_error())
+      return NESTED_LOOP_ERROR;
+    if (null_key)
+      continue;
+
+    if (qep_tab->keep_current_rowid)
+      table->file->position(table->record[0]);
+
+    const uint part= get_partition(hash_value);
+    IO_CACHE *file= &spill_inner[part];
+    int4store(hash_buff, hash_value);
+    if (my_b_write(file, hash_buff, sizeof(hash_buff)) ||
+        (qep_tab->keep_current_rowid &&
+         my_b_write(file, table->file->ref, table->file->ref_length)) ||
+        my_b_write(file, table->record[0], table->s->reclength))
+      return NESTED_LOOP_ERROR;
+    spill_inner_rows[part]++;
+  } while (!(error= info->read_record(info)));
+
+  return error > 0 ? NESTED_LOOP_ERROR : NESTED_LOOP_OK;
+}
+
+
+/*
+  Read the spilled records of a partition into the JOIN_CACHE_BNLH buffer
+
+  SYNOPSIS
+    load_spilled_records()
+      file            the spill file with the records of the partition
+      rows    IN/OUT  the number of the records remaining in the file
+      pending IN/OUT  the length of the record whose length has been read
+                      from the file, but the record itself has not been
+                      read as it did not fit into the buffer, or 0
+
+  DESCRIPTION
+    The records are read while they fit into the join buffer. Any read
+    record with non-NULL keys is linked into the hash table.
+
+  RETURN
+    FALSE   success
+    TRUE    an error occurred
+*/
+
+bool JOIN_CACHE_BNLH::load_spilled_records(IO_CACHE *file, ha_rows *rows,
+                                           uint32 *pending)
+{
+  const uint ofs= get_size_of_rec_offset();
+  uchar len_buff[4];
+  while (*rows)
+  {
+    uint32 len= *pending;
+    if (!len)
+    {
+      if (my_b_read(file, len_buff, sizeof(len_buff)))
+        return TRUE;
+      len= uint4korr(len_buff);
+    }
+    if (records && len > rem_space())
+    {
+      *pending= len;
+      return FALSE;
+    }
+    DBUG_ASSERT(len <= rem_space());
+    uchar *rec= end_pos;
+    if (my_b_read(file, rec, len))
+      return TRUE;
+    *pending= 0;
+    (*rows)--;
+    records++;
+    curr_rec_pos= last_rec_pos= rec+rec_fields_offset();
+    end_pos= pos= rec+len;
+    if (get_offset(ofs, rec))
+      link_hash_record(last_rec_pos, uint4korr(rec+ofs));
+  }
+  return FALSE;
+}
+
+
+/*
+  Join the spilled partitions
+
+  SYNOPSIS
+    join_spilled_partitions()
+
+  DESCRIPTION
+    The function spills the records remaining in the join buffer and all
+    rows of the joined table. Then for each partition the records are read
+    back into the join buffer and joined with the rows of the partition by
+    join_records(). A partition of the records that does not fit into the
+    join buffer is joined in several passes over the rows of the partition.
+    A partition without rows of the joined table is skipped unless the
+    records need null complements.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_partitions()
+{
+  enum_nested_loop_state rc;
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_partitions");
+
+  if (records && spill_buffered_records())
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  if ((rc= spill_inner_table()) != NESTED_LOOP_OK)
+    DBUG_RETURN(rc);
+
+  const bool outer_join= qep_tab->first_inner() != NO_PLAN_IDX;
+  for (uint part= 0; part < spill_partitions; part++)
+  {
+    ha_rows rows= spill_outer_rows[part];
+    uint32 pending= 0;
+    if (!rows || (!spill_inner_rows[part] && !outer_join))
+      continue;
+    if (reinit_io_cache(&spill_outer[part], READ_CACHE, 0L, 0, 0))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    spill_probe= &spill_inner[part];
+    spill_probe_rows= spill_inner_rows[part];
+    while (rows)
+    {
+      if (load_spilled_records(&spill_outer[part], &rows, &pending))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      if ((rc= join_records(FALSE)) != NESTED_LOOP_OK)
+        DBUG_RETURN(rc);
+    }
+  }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
+/*
+  Stop spilling: the following records are joined in the join buffer
+*/
+
+void JOIN_CACHE_BNLH::end_spilling()
+{
+  spill_partitions= 0;
+  spill_probe= NULL;
+  reset_cache(TRUE);
+}
+
+
+void JOIN_CACHE_BNLH::free()
+{
+  if (spill_outer)
+  {
+    for (uint i= 0; i < (1U << HASH_JOIN_MAX_SPILL_BITS); i++)
+    {
+      close_cached_file(&spill_outer[i]);
+      close_cached_file(&spill_inner[i]);
+    }
+    spill_outer= spill_inner= NULL;
+  }
+  JOIN_CACHE::free();
+}
+
+
+/*
+  Join a row of the joined table with the records of its hash bucket
+
+  SYNOPSIS
+    join_hash_bucket()
+      hash_value  the hash value calculated for the row
+
+  DESCRIPTION
+    The function looks through the chain of the records linked to the hash
+    entry for 'hash_value' and generates all full extensions for the records
+    with the same hash value. The records are checked by check_match() as
+    the equal hash values do not guarantee the equality of the keys.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_hash_bucket(uint32 hash_value)
+{
+  enum_nested_loop_state rc;
+  const uint ofs= get_size_of_rec_offset();
+  uchar *entry= hash_table + ofs*(hash_value % hash_entries);
+
+  if (get_offset(ofs, entry) == 0)
+    return NESTED_LOOP_OK;
+
+  uchar *last_rec_ptr= buff+get_offset(ofs, entry);
+  uchar *rec_ptr= last_rec_ptr;
+  do
+  {
+    rec_ptr= get_next_hash_rec(rec_ptr);
+    /* Records with different hash values may share the hash entry */
+    if (get_hash_value(rec_ptr) != hash_value)
+      continue;
+    /* 
+      If only the first match is needed and it has been already found for
+      the record then the record is skipped.
+    */
+    if (check_only_first_match && get_match_flag_by_pos(rec_ptr))
+      continue;
+    get_record_by_pos(rec_ptr);
+    if ((rc= generate_full_extensions(rec_ptr)) != NESTED_LOOP_OK)
+      return rc;
+  } while (rec_ptr != last_rec_ptr);
+
+  return NESTED_LOOP_OK;
+}
+
+
+/*
+  Using the hash table find matches from the next table for records from
+  the join buffer
+
+  SYNOPSIS
+    join_matching_records()
+      skip_last    do not look for matches for the last partial join record 
+
+  DESCRIPTION
+    The function retrieves all rows of the join_tab table as the BNL
+    algorithm does, but each row is checked for matches only against the
+    records from the join buffer linked to the hash entry of the row.
+    When a spilled partition is joined the rows are read from the spill
+    file of the partition instead of the table.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/ 
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_matching_records(bool skip_last)
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *const table= qep_tab->table();
+
+  /* The last record is never skipped by the hash join */
+  DBUG_ASSERT(!skip_last);
+
+  table->null_row= 0;
+
+  /* Return at once if there are no records in the join buffer */
+  if (!records)     
+    return NESTED_LOOP_OK;   
+
+  if (spill_probe)
+  {
+    uchar hash_buff[4];
+    if (reinit_io_cache(spill_probe, READ_CACHE, 0L, 0, 0))
+      return NESTED_LOOP_ERROR;
+    for (ha_rows cnt= spill_probe_rows; cnt; cnt--)
+    {
+      if (join->thd->killed)
+      {
+        /* The user has aborted the execution of the query */
+        join->thd->send_kill_message();
+        return NESTED_LOOP_KILLED;
+      }
+      if (my_b_read(spill_probe, hash_buff, sizeof(hash_buff)) ||
+          (qep_tab->keep_current_rowid &&
+           my_b_read(spill_probe, table->file->ref,
+                     table->file->ref_length)) ||
+          my_b_read(spill_probe, table->record[0], table->s->reclength))
+        return NESTED_LOOP_ERROR;
+      table->status= 0;
+      if ((rc= join_hash_bucket(uint4korr(hash_buff))) != NESTED_LOOP_OK)
+        return rc;
+    }
+    return NESTED_LOOP_OK;
+  }
+
+  // See setup_join_buffering(=: dynamic range => no cache.
+  DBUG_ASSERT(!(qep_tab->dynamic_range() && qep_tab->quick()));
+
+  /* Start retrieving all records of the joined table */
+  if ((error= (*qep_tab->read_first_record)(qep_tab)))
+    return error < 0 ? NESTED_LOOP_OK : NESTED_LOOP_ERROR;
+
+  READ_RECORD *info= &qep_tab->read_record;
+  do
+  {
+    if (qep_tab->keep_current_rowid)
+      table->file->position(table->record[0]);
+
+    if (join->thd->killed)
+    {
+      /* The user has aborted the execution of the query */
+      join->thd->send_kill_message();
+      return NESTED_LOOP_KILLED;
+    }
+
+    join->examined_rows++;
+    if (const_cond)
+    {
+      const bool consider_record= const_cond->val_int() != FALSE;
+      if (join->thd->is_error())              // error in condition evaluation
+        return NESTED_LOOP_ERROR;
+      if (!consider_record)
+        continue;
+    }
+
+    uint32 hash_value;
+    const bool null_key= calc_hash_value(FALSE, &hash_value);
+    if (join->thd->is_error())
+      return NESTED_LOOP_ERROR;
+    /* A row with NULL keys can't match any record */
+    if (null_key)
+      continue;
+
+    if ((rc= join_hash_bucket(hash_value)) != NESTED_LOOP_OK)
+      return rc;
+  } while (!(error= info->read_record(info)));
+
+  if (error > 0)				// Fatal error
+    rc= NESTED_LOOP_ERROR; 
+  return rc;
+}
+
+
 /****************************************************************************
  * Join cache module end
  ****************************************************************************/
@@ -486,7 +486,7 @@ public:
 
   /** Bits describing cache's type @sa setup_join_buffering() */
   enum enum_join_cache_type
-  {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4};
+  {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4, ALG_BNLH= 8};
 
   virtual enum_join_cache_type cache_type() const= 0;
 
@@ -495,6 +495,7 @@ public:
   { return cache_type() & (ALG_BKA | ALG_BKA_UNIQUE ); }
 
   friend class JOIN_CACHE_BNL;
+  friend class JOIN_CACHE_BNLH;
   friend class JOIN_CACHE_BKA;
   friend class JOIN_CACHE_BKA_UNIQUE;
 };
@@ -517,10 +518,230 @@ public:
 
   enum_join_cache_type cache_type() const { return ALG_BNL; }
 
-private:
+protected:
   Item *const_cond;
 };
 
+/* 
+  Categories of the values compared by the equalities used as hash join keys.
+*/
+#define HASH_KEY_INT      1        /* integer values hashed as longlong */
+#define HASH_KEY_REAL     2        /* numeric values hashed as double */
+#define HASH_KEY_STRING   3        /* strings hashed by their collation */
+#define HASH_KEY_TEMPORAL 4        /* packed temporal values of one type */
+
+/* Log2 of the maximal number of partitions spilled by a hash join */
+#define HASH_JOIN_MAX_SPILL_BITS    5
+/* Size of the IO_CACHE buffer of a hash join spill file */
+#define HASH_JOIN_SPILL_BUFFER_SIZE (IO_SIZE*4)
+
+/*
+  The HASH_JOIN_KEY structure describes one equality outer_expr=inner_expr
+  of the join condition used to build hash values for the records put into
+  a JOIN_CACHE_BNLH buffer (outer_expr) and for the rows of the joined
+  table (inner_expr).
+*/
+typedef struct st_hash_join_key {
+  Item *outer;  /**< expression over the tables preceding the joined table */
+  Item *inner;  /**< expression over the joined table */
+  /* 
+    Category of the compared values. Both expressions are hashed in the
+    same way so equal values always get equal hash values.
+  */
+  uint type;
+  const CHARSET_INFO *cs; /**< collation used to hash string values */
+} HASH_JOIN_KEY;
+
+/*
+  The class JOIN_CACHE_BNLH supports the hash join variant of the Block Nested
+  Loops algorithm. It is employed instead of JOIN_CACHE_BNL when the condition
+  attached to the joined table contains equalities between expressions over
+  the joined table and expressions over the preceding tables.
+  Any record put into the join buffer is prepended by a reference to the next
+  record with the same hash bucket followed by the hash value calculated over
+  the outer expressions of these equalities. The records of one bucket are
+  linked in a circular list whose last element is referred to from the hash
+  table placed at the very end of the join buffer. A record with a NULL
+  value in any of the outer expressions gets a nil reference and is not
+  linked: it can't have matches but it still may need a null complement.
+  For each row of the joined table only the records from the bucket for the
+  hash value of the inner expressions are checked with check_match().
+
+  If the join buffer gets full and the records in it are not linked to
+  a previous join buffer, the records are not joined at once. Instead all
+  records from the join buffer, and later all rows of the joined table, are
+  distributed between a number of partitions spilled to temporary files by
+  their hash values. Each partition is then joined separately when all
+  records have been put into the cache, see end_send().
+*/
+
+class JOIN_CACHE_BNLH :public JOIN_CACHE_BNL
+{
+
+private:
+
+  /* Descriptors of the equalities used to build hash values */
+  HASH_JOIN_KEY hash_keys[MAX_REF_PARTS];
+  /* Number of elements in hash_keys */
+  uint key_parts;
+
+  /* The beginning of the hash table in the join buffer */
+  uchar *hash_table;
+  /* Number of hash entries in the hash table */
+  uint hash_entries;
+
+  /* Set if the records may be spilled to partitions in temporary files */
+  bool spill_allowed;
+  /* Number of partitions the records are spilled to (0 - no spilling) */
+  uint spill_partitions;
+  /* Log2 of spill_partitions */
+  uint spill_bits;
+  /* Temporary files with the records of the join buffer per partition */
+  IO_CACHE *spill_outer;
+  /* Temporary files with the rows of the joined table per partition */
+  IO_CACHE *spill_inner;
+  /* Number of records written into each of the spill_outer files */
+  ha_rows *spill_outer_rows;
+  /* Number of rows written into each of the spill_inner files */
+  ha_rows *spill_inner_rows;
+  /* 
+    When joining a spilled partition: the file with the rows of the joined
+    table to be read instead of scanning the table, and the number of rows.
+  */
+  IO_CACHE *spill_probe;
+  ha_rows spill_probe_rows;
+
+  /* 
+    Size of the prefix of a record in the join buffer: the reference to the
+    next record in the bucket chain followed by the hash value.
+  */
+  uint hash_prefix_length() { return get_size_of_rec_offset() + 4; }
+
+  /* 
+    The offset of the record fields from the beginning of the record
+    representation that starts with the hash prefix followed by the length
+    of the record followed by a reference to the record segment in the
+    previous cache, if any.
+  */
+  uint rec_fields_offset()
+  {
+    return hash_prefix_length() + get_size_of_rec_length() +
+           (prev_cache ? prev_cache->get_size_of_rec_offset() : 0);
+  }
+
+  /* Get the hash value of the record whose fields start at rec_ptr */
+  uint32 get_hash_value(uchar *rec_ptr)
+  {
+    return uint4korr(rec_ptr-rec_fields_offset()+get_size_of_rec_offset());
+  }
+
+  /* Get the next record in the bucket chain of the record at rec_ptr */
+  uchar *get_next_hash_rec(uchar *rec_ptr)
+  {
+    return buff+get_offset(get_size_of_rec_offset(),
+                           rec_ptr-rec_fields_offset());
+  }
+
+  /* Calculate the hash value over the outer or the inner expressions */
+  bool calc_hash_value(bool outer, uint32 *hash_value);
+
+  /* Link the record at rec_ptr into the chain of its hash bucket */
+  void link_hash_record(uchar *rec_ptr, uint32 hash_value);
+
+  void cleanup_hash_table();
+
+  /* Get the partition a record or a row with hash_value is spilled to */
+  uint get_partition(uint32 hash_value)
+  {
+    return (uint) ((uint32) (hash_value * 0x9E3779B1U) >> (32 - spill_bits));
+  }
+
+  bool start_spilling();
+  bool spill_buffered_records();
+  enum_nested_loop_state spill_inner_table();
+  bool load_spilled_records(IO_CACHE *file, ha_rows *rows, uint32 *pending);
+  enum_nested_loop_state join_spilled_partitions();
+  void end_spilling();
+
+  /* Join the row of the joined table with the records of its hash bucket */
+  enum_nested_loop_state join_hash_bucket(uint32 hash_value);
+
+protected:
+
+  /* 
+    Calculate how much space in the buffer would not be occupied by
+    records and the hash table.
+  */ 
+  ulong rem_space()
+  {
+    return end_pos < hash_table ? (ulong) (hash_table-end_pos) : 0UL;
+  }
+
+  /* Skip record from JOIN_CACHE_BNLH buffer if its match flag is on */
+  bool skip_record_if_match();
+
+  /* Using the hash table find matches for records from join buffer */
+  enum_nested_loop_state join_matching_records(bool skip_last);
+
+  /* Add a record into the JOIN_CACHE_BNLH buffer */
+  bool put_record_in_cache();
+
+public:
+
+  JOIN_CACHE_BNLH(JOIN *j, QEP_TAB *qep_tab_arg, JOIN_CACHE *prev)
+    : JOIN_CACHE_BNL(j, qep_tab_arg, prev), key_parts(0), hash_table(NULL),
+    spill_allowed(false), spill_partitions(0), spill_outer(NULL),
+    spill_inner(NULL), spill_probe(NULL)
+  {}
+
+  /* Initialize the BNLH cache */
+  int init();
+
+  /* Reset the JOIN_CACHE_BNLH buffer for reading/writing */
+  void reset_cache(bool for_writing);
+
+  /* Read the next record from the JOIN_CACHE_BNLH buffer */
+  bool get_record();
+
+  /* Add a record into join buffer, spill the buffer if it's full */
+  enum_nested_loop_state put_record();
+
+  /* Join records from the join buffer or from the spilled partitions */
+  enum_nested_loop_state end_send();
+
+  void free();
+
+  /* Find the equalities of the condition of tab usable as hash join keys */
+  static uint get_hash_join_keys(const QEP_shared_owner *tab,
+                                 table_map const_tables,
+                                 HASH_JOIN_KEY *keys);
+
+  /* Check whether an equality can be used as a hash join key */
+  static bool add_hash_join_key(Item *cond, table_map inner_tables,
+                                table_map outer_tables,
+                                table_map const_tables,
+                                HASH_JOIN_KEY *key);
+
+  /* Check whether the values of inner and outer can be hashed as keys */
+  static bool hash_key_type(Item *inner, Item *outer,
+                            const CHARSET_INFO *cmp_cs, HASH_JOIN_KEY *key);
+
+  /*
+    Check whether the records of the join buffer and the rows of the joined
+    table can be spilled to partitions. The records can be moved to the
+    spill files and back only if they do not refer to a previous join
+    buffer ('linked') or to blob data outside of the join buffer. The rows
+    of the joined table are spilled as they are in the record buffer, so
+    they must not contain blob pointers either.
+  */
+  static bool can_spill(bool linked, bool blobs, const TABLE *table)
+  {
+    return !linked && !blobs && !table->s->blob_fields;
+  }
+
+  enum_join_cache_type cache_type() const { return ALG_BNLH; }
+};
+
 class JOIN_CACHE_BKA :public JOIN_CACHE
 {
 protected:
@@ -2162,6 +2162,7 @@ st_select_lex::st_select_lex
   first_execution(true),
   first_natural_join_processing(true),
   sj_pullout_done(false),
+  join_order_cache(NULL),
   no_wrap_view_item(false),
   exclude_from_table_unique_test(false),
   prev_join_using(NULL),
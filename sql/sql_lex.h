@@ -448,6 +448,7 @@ struct LEX;
 class THD;
 class select_result;
 class JOIN;
+class Join_order_cache;
 class select_union;
 
 /**
@@ -886,6 +887,11 @@ public:
   bool first_execution;
   bool first_natural_join_processing;
   bool sj_pullout_done;
+  /**
+    Join order saved for later executions of a prepared statement, see
+    Join_order_cache. Allocated on the statement mem_root when needed.
+  */
+  Join_order_cache *join_order_cache;
   /* do not wrap view fields with Item_ref */
   bool no_wrap_view_item;
   /* exclude this select from check of unique_table() */
@@ -2728,7 +2728,9 @@ void revise_cache_usage(JOIN_TAB *join_tab)
     If block_nested_loop is turned on, and if all other criteria for using
     join buffering is fulfilled (see below), then join buffer is used 
     for any join operation (inner join, outer join, semi-join) with 'JT_ALL' 
-    access method.  In that case, a JOIN_CACHE_BNL type is always employed.
+    access method.  In that case, a JOIN_CACHE_BNL type is employed, unless
+    hash_join is also turned on and the condition attached to the table
+    contains equi-join predicates: then a JOIN_CACHE_BNLH type is employed.
 
     If an index is used to access rows of the joined table and batched_key_access
     is on, then a JOIN_CACHE_BKA type is employed. (Unless debug flag,
@@ -2897,6 +2899,20 @@ static bool setup_join_buffering(JOIN_TAB *tab, JOIN *join,
       goto no_join_cache;
     }
 
+    /*
+      Use the hash join variant of BNL if the condition of the table
+      contains equalities usable as hash join keys.
+    */
+    if (join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_JOIN))
+    {
+      HASH_JOIN_KEY keys[MAX_REF_PARTS];
+      if (JOIN_CACHE_BNLH::get_hash_join_keys(tab, join->const_table_map,
+                                              keys))
+      {
+        tab->set_use_join_cache(JOIN_CACHE::ALG_BNLH);
+        return false;
+      }
+    }
     tab->set_use_join_cache(JOIN_CACHE::ALG_BNL);
     return false;
   case JT_SYSTEM:
@@ -30,6 +30,7 @@
 #include "opt_range.h"
 #include "opt_trace.h"
 #include "sql_executor.h"
+#include "sql_join_buffer.h"     // JOIN_CACHE_BNLH
 #include "merge_sort.h"
 #include <my_bit.h>
 
@@ -81,6 +82,124 @@ cache_record_length(JOIN *join,uint idx)
 }
 
 
+/**
+  Estimate the filtering effect of the equalities that a hash join
+  (JOIN_CACHE_BNLH) could use as hash keys when 'tab' is joined to the
+  partial plan join->best_ref[const_tables..idx-1].
+
+  The equalities are checked with the predicates the hash join itself
+  uses, JOIN_CACHE_BNLH::add_hash_join_key() and
+  JOIN_CACHE_BNLH::hash_key_type(). Multiple equalities without a
+  constant are considered too, as they are turned into such equalities
+  between a column of 'tab' and a column of a prefix table; constant
+  predicates are already part of the condition filter of the scan.
+
+  @param join   the join being optimized
+  @param tab    the table to be joined
+  @param idx    the index in join->best_ref[] where 'tab' is added
+
+  @return fraction of (prefix row, row of 'tab') pairs expected to
+          have equal hash keys, or 1.0 if there are no usable keys
+*/
+
+static float hash_join_filter(JOIN *join, const JOIN_TAB *tab, uint idx)
+{
+  const table_map tab_map= tab->table_ref->map();
+  table_map prefix_tables= join->const_table_map;
+  for (uint i= join->const_tables; i < idx; i++)
+    prefix_tables|= join->best_ref[i]->table_ref->map();
+
+  Item *const cond= tab->join_cond() ? tab->join_cond() : join->where_cond;
+  if (cond == NULL)
+    return COND_FILTER_ALLPASS;
+
+  TABLE *const table= tab->table();
+  DBUG_ASSERT(bitmap_is_clear_all(&table->tmp_set));
+
+  List<Item> single;
+  List<Item> *conds;
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+    conds= ((Item_cond*) cond)->argument_list();
+  else
+  {
+    single.push_back(cond);
+    conds= &single;
+  }
+
+  float filter= COND_FILTER_ALLPASS;
+  List_iterator<Item> it(*conds);
+  Item *item;
+  while ((item= it++))
+  {
+    if (item->type() != Item::FUNC_ITEM)
+      continue;
+    Item_func *const func= (Item_func*) item;
+    HASH_JOIN_KEY key;
+    bool usable= false;
+    if (func->functype() == Item_func::EQ_FUNC)
+      usable= JOIN_CACHE_BNLH::add_hash_join_key(func, tab_map,
+                                                 prefix_tables,
+                                                 join->const_table_map,
+                                                 &key);
+    else if (func->functype() == Item_func::MULT_EQUAL_FUNC &&
+             !((Item_equal*) func)->get_const())
+    {
+      Item_equal *const item_equal= (Item_equal*) func;
+      Item_field *inner= NULL;
+      Item_field *outer= NULL;
+      Item_equal_iterator fi(*item_equal);
+      Item_field *field;
+      while ((field= fi++))
+      {
+        const table_map used= field->used_tables();
+        if (used == tab_map)
+          inner= field;
+        else if (used & prefix_tables & ~join->const_table_map)
+          outer= field;
+      }
+      usable= inner != NULL && outer != NULL &&
+              JOIN_CACHE_BNLH::hash_key_type(inner, outer,
+                                             item_equal->compare_collation(),
+                                             &key);
+    }
+    if (usable)
+      filter*= item->get_filtering_effect(tab_map, prefix_tables,
+                                          &table->tmp_set,
+                                          rows2double(tab->records()));
+  }
+  return filter;
+}
+
+
+/**
+  Check whether a hash join of 'tab' to the partial plan
+  join->best_ref[const_tables..idx-1] could spill its partitions to disk
+  when the join buffer is full, see JOIN_CACHE_BNLH::can_spill().
+
+  The join buffer of 'tab' is linked to the one of the previous table if
+  that table uses join buffering. Otherwise the buffer holds the columns of
+  all prefix tables, which are assumed to include BLOB columns if a prefix
+  table has any.
+
+  @param join   the join being optimized
+  @param tab    the table to be joined
+  @param idx    the index in join->positions[] where 'tab' is added
+
+  @return true if the hash join can spill
+*/
+
+static bool hash_join_can_spill(JOIN *join, const JOIN_TAB *tab, uint idx)
+{
+  const bool linked= idx > join->const_tables &&
+                     join->positions[idx - 1].use_join_buffer;
+  bool blobs= false;
+  for (uint i= join->const_tables; i < idx && !blobs; i++)
+    blobs= join->positions[i].table->table()->s->blob_fields != 0;
+  return JOIN_CACHE_BNLH::can_spill(linked, blobs, tab->table());
+}
+
+
 /**
   Find the best index to do 'ref' access on for a table.
 
@@ -860,12 +979,65 @@ Optimize_table_order::calculate_scan_cost(const JOIN_TAB *tab,
                prefix_rowcount /
                (double) thd->variables.join_buff_size);
 
-      scan_and_filter_cost= buffer_count *
-        (single_scan_read_cost +
-         cost_model->row_evaluate_cost(tab->records() - *rows_after_filtering));
+      const float hash_filter=
+        thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_JOIN) ?
+        hash_join_filter(join, tab, idx) : COND_FILTER_ALLPASS;
 
-      trace_access_scan->add("using_join_cache", true);
-      trace_access_scan->add("buffers_needed", (ulong)buffer_count);
+      if (hash_filter < COND_FILTER_ALLPASS)
+      {
+        /*
+          Hash join: rows of the scanned table that pass the attached
+          conditions are only compared with the buffered rows that
+          have the same hash key. If more than one buffer would be
+          needed, both sides are partitioned to disk and the table is
+          scanned once; each row is then written and read back once.
+          When spilling is not possible, the table is scanned once per
+          buffer as for BNL.
+
+          The caller charges row_evaluate_cost(prefix_rowcount *
+          rows_after_filtering) for comparing the rows that pass the
+          attached conditions with the buffered rows. Only the pairs
+          with equal hash keys are compared, so the rest is credited
+          here. The fanout is not changed: the equalities are already
+          part of the condition filter of the table. The credit does
+          not make the cost lower than the cost of reading the rows.
+        */
+        double scans= buffer_count;
+        double spill_cost= 0.0;
+        if (buffer_count >= 2.0 && hash_join_can_spill(join, tab, idx))
+        {
+          scans= 1.0;
+          const double spilled_rows= prefix_rowcount + *rows_after_filtering;
+          spill_cost=
+            cost_model->tmptable_readwrite_cost(Cost_model_server::DISK_TMPTABLE,
+                                                spilled_rows, spilled_rows);
+        }
+        const double read_cost= scans * single_scan_read_cost + spill_cost;
+        const double compare_credit=
+          cost_model->row_evaluate_cost(prefix_rowcount *
+                                        *rows_after_filtering *
+                                        (1.0 - hash_filter));
+        scan_and_filter_cost= read_cost +
+          scans * cost_model->row_evaluate_cost(tab->records() -
+                                                *rows_after_filtering) +
+          cost_model->row_evaluate_cost(prefix_rowcount +
+                                        scans * *rows_after_filtering);
+        scan_and_filter_cost= std::max(scan_and_filter_cost - compare_credit,
+                                       read_cost);
+
+        trace_access_scan->add("using_hash_join", true);
+        trace_access_scan->add("buffers_needed", (ulong)scans);
+      }
+      else
+      {
+        scan_and_filter_cost= buffer_count *
+          (single_scan_read_cost +
+           cost_model->row_evaluate_cost(tab->records() -
+                                         *rows_after_filtering));
+
+        trace_access_scan->add("using_join_cache", true);
+        trace_access_scan->add("buffers_needed", (ulong)buffer_count);
+      }
     }
   }
 
@@ -1858,12 +2030,27 @@ bool Optimize_table_order::choose_table_order()
                            Item::enum_walk(Item::WALK_POSTFIX), NULL);
   }
 
+  Join_order_cache *const order_cache=
+    straight_join ? NULL : get_join_order_cache();
+
   if (straight_join)
     optimize_straight_join(join_tables);
+  else if (order_cache && order_cache->matches(join))
+  {
+    // Same plan inputs as when the order was saved: only cost that order
+    thd->status_var.join_order_cache_hits++;
+    order_cache->apply(join);
+    optimize_straight_join(join_tables);
+  }
   else
   {
     if (greedy_search(join_tables))
       DBUG_RETURN(true);
+    if (order_cache)
+    {
+      thd->status_var.join_order_cache_misses++;
+      order_cache->save(join);
+    }
   }
 
   // Remaining part of this function not needed when processing semi-join nests.
@@ -2014,6 +2201,103 @@ void Optimize_table_order::optimize_straight_join(table_map join_tables)
 }
 
 
+/**
+  Get the saved join order of the query block, creating an empty one if
+  needed.
+
+  @return the Join_order_cache of the query block, or NULL if the join
+          order may not be reused
+*/
+
+Join_order_cache *Optimize_table_order::get_join_order_cache()
+{
+  SELECT_LEX *const select_lex= join->select_lex;
+  Query_arena *const stmt_arena= thd->stmt_arena;
+
+  /*
+    Only when the query block is executed again (1). Semi-join strategies
+    (2) and subquery strategies (3) are chosen together with the order.
+    The optimizer trace shows the full search (4), and with a single
+    table there is no order to choose (5).
+  */
+  if (stmt_arena->is_conventional() ||                          // (1)
+      stmt_arena->is_stmt_prepare() ||                          // (1)
+      emb_sjm_nest || has_sj ||                                 // (2)
+      join->unit->item ||                                       // (3)
+      thd->opt_trace.is_started() ||                            // (4)
+      join->tables - join->const_tables < 2)                    // (5)
+    return NULL;
+
+  if (select_lex->join_order_cache == NULL)
+    select_lex->join_order_cache=
+      new (stmt_arena->mem_root) Join_order_cache;
+  return select_lex->join_order_cache;
+}
+
+
+uchar Join_order_cache::selectivity_class(ha_rows rows)
+{
+  uchar rows_class= 0;
+  for (; rows; rows>>= 1)
+    rows_class++;
+  return rows_class;
+}
+
+
+bool Join_order_cache::matches(const JOIN *join) const
+{
+  const THD *const thd= join->thd;
+
+  if (!m_valid ||
+      m_tables != join->tables ||
+      m_const_table_map != join->const_table_map ||
+      m_optimizer_switch != thd->variables.optimizer_switch ||
+      m_search_depth != thd->variables.optimizer_search_depth ||
+      m_prune_level != thd->variables.optimizer_prune_level)
+    return false;
+
+  for (uint i= join->const_tables; i < join->tables; i++)
+  {
+    const JOIN_TAB *const tab= join->best_ref[i];
+    if (m_class[tab->table_ref->tableno()] !=
+        selectivity_class(tab->found_records))
+      return false;
+  }
+  return true;
+}
+
+
+void Join_order_cache::apply(JOIN *join) const
+{
+  JOIN_TAB *tab_by_tableno[MAX_TABLES];
+
+  for (uint i= join->const_tables; i < join->tables; i++)
+    tab_by_tableno[join->best_ref[i]->table_ref->tableno()]= join->best_ref[i];
+  for (uint i= join->const_tables; i < join->tables; i++)
+    join->best_ref[i]= tab_by_tableno[m_order[i]];
+}
+
+
+void Join_order_cache::save(const JOIN *join)
+{
+  const THD *const thd= join->thd;
+
+  for (uint i= join->const_tables; i < join->tables; i++)
+  {
+    const JOIN_TAB *const tab= join->best_positions[i].table;
+    const uint tableno= tab->table_ref->tableno();
+    m_order[i]= static_cast<uchar>(tableno);
+    m_class[tableno]= selectivity_class(tab->found_records);
+  }
+  m_tables= join->tables;
+  m_const_table_map= join->const_table_map;
+  m_optimizer_switch= thd->variables.optimizer_switch;
+  m_search_depth= thd->variables.optimizer_search_depth;
+  m_prune_level= thd->variables.optimizer_prune_level;
+  m_valid= true;
+}
+
+
 /**
   Check whether a semijoin materialization strategy is allowed for
   the current (semi)join table order.
@@ -24,6 +24,7 @@
 #include "sql_optimizer.h"
 
 class Opt_trace_object;
+class Join_order_cache;
 
 /**
   This class determines the optimal join order for tables within
@@ -135,6 +136,7 @@ private:
   void backout_nj_state(const table_map remaining_tables,
                         const JOIN_TAB *tab);
   void optimize_straight_join(table_map join_tables);
+  Join_order_cache *get_join_order_cache();
   bool greedy_search(table_map remaining_tables);
   bool best_extension_by_limited_search(table_map remaining_tables,
                                         uint idx,
@@ -164,6 +166,59 @@ private:
   static uint determine_search_depth(uint search_depth, uint table_count);
 };
 
+
+/**
+  Join order chosen for a query block of a prepared statement, which
+  later executions reuse instead of searching for it again.
+
+  The saved order is used only when the parameters give the same plan
+  inputs: the same tables are const, every other table has the same
+  selectivity class, and the optimizer settings are unchanged. The
+  selectivity class of a table is the order of magnitude (base 2) of its
+  row estimate after range analysis. Otherwise the order is searched as
+  usual and replaces the saved one, so changed statistics also make a
+  new search. A metadata change reprepares the statement, which creates
+  new query blocks with no saved order.
+
+  Only the order is reused. Range analysis still runs, as ranges are
+  built from the parameter values, and the access method of each table
+  is chosen again for the saved order.
+
+  The status variables Join_order_cache_hits and Join_order_cache_misses
+  count the optimizations that used the saved order and those that
+  searched for it.
+*/
+
+class Join_order_cache : public Sql_alloc
+{
+public:
+  Join_order_cache() : m_valid(false) {}
+
+  /// @return true if the saved order can be used for this optimization
+  bool matches(const JOIN *join) const;
+
+  /// Put the non-const tables of join->best_ref in the saved order
+  void apply(JOIN *join) const;
+
+  /// Save the order of join->best_positions
+  void save(const JOIN *join);
+
+private:
+  static uchar selectivity_class(ha_rows rows);
+
+  bool m_valid;
+  uint m_tables;
+  table_map m_const_table_map;
+  /// Optimizer settings the order was chosen with
+  ulonglong m_optimizer_switch;
+  ulong m_search_depth;
+  ulong m_prune_level;
+  /// Table numbers, from the first non-const table on
+  uchar m_order[MAX_TABLES];
+  /// Selectivity class of each table, by table number
+  uchar m_class[MAX_TABLES];
+};
+
 void get_partial_join_cost(JOIN *join, uint n_tables, double *cost_arg,
                            double *rowcount_arg);
 
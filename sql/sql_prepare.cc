@@ -3809,6 +3809,8 @@ Prepared_statement::swap_prepared_statement(Prepared_statement *copy)
   @note
     Preconditions, postconditions.
     - See the comment for Prepared_statement::prepare().
+    - The optimizer may reuse a join order saved by an earlier execution,
+      see Join_order_cache.
 
   @retval
     FALSE	    ok
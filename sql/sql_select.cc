@@ -1741,13 +1741,14 @@ void QEP_TAB::push_index_cond(const JOIN_TAB *join_tab,
     Fields of other non-const tables aren't allowed in following cases:
        type is:
         (JT_ALL | JT_INDEX_SCAN | JT_RANGE | JT_INDEX_MERGE)
-       and BNL is used.
+       and BNL or BNLH is used.
     and allowed otherwise.
   */
   const bool other_tbls_ok=
     !((type() == JT_ALL || type() == JT_INDEX_SCAN ||
        type() == JT_RANGE || type() ==  JT_INDEX_MERGE) &&
-      join_tab->use_join_cache() == JOIN_CACHE::ALG_BNL);
+      (join_tab->use_join_cache() &
+       (JOIN_CACHE::ALG_BNL | JOIN_CACHE::ALG_BNLH)));
 
 
   /*
@@ -2069,6 +2070,9 @@ void QEP_TAB::init_join_cache(JOIN_TAB *join_tab)
   case JOIN_CACHE::ALG_BNL:
     op= new JOIN_CACHE_BNL(join_, this, prev_cache);
     break;
+  case JOIN_CACHE::ALG_BNLH:
+    op= new JOIN_CACHE_BNLH(join_, this, prev_cache);
+    break;
   case JOIN_CACHE::ALG_BKA:
     op= new JOIN_CACHE_BKA(join_, this, join_tab->join_cache_flags, prev_cache);
     break;
@@ -931,9 +931,8 @@ update_hidden:
     table->file= get_new_handler(share, &table->mem_root,
                                  share->db_type());
   }
-  else if (blob_count ||
-           (thd->variables.big_tables &&
-            !(select_options & SELECT_SMALL_RESULT)))
+  else if (thd->variables.big_tables &&
+           !(select_options & SELECT_SMALL_RESULT))
   {
     /*
      * Except for special conditions, tmp table engine will be choosen by user.
@@ -2368,7 +2368,8 @@ static const char *optimizer_switch_names[]=
   "block_nested_loop", "batched_key_access",
   "materialization", "semijoin", "loosescan", "firstmatch",
   "subquery_materialization_cost_based",
-  "use_index_extensions", "condition_fanout_filter", "default", NullS
+  "use_index_extensions", "condition_fanout_filter", "hash_join",
+  "default", NullS
 };
 static Sys_var_flagset Sys_optimizer_switch(
        "optimizer_switch",
@@ -2379,7 +2380,8 @@ static Sys_var_flagset Sys_optimizer_switch(
        ", materialization, semijoin, loosescan, firstmatch,"
        " subquery_materialization_cost_based"
        ", block_nested_loop, batched_key_access, use_index_extensions, "
-       "condition_fanout_filter} and val is one of {on, off, default}",
+       "condition_fanout_filter, hash_join} and val is one of "
+       "{on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(NULL), ON_UPDATE(NULL));
@@ -2740,13 +2742,14 @@ static Sys_var_ulong Sys_trans_prealloc_size(
 #ifndef EMBEDDED_LIBRARY
 static const char *thread_handling_names[]=
 {
-  "one-thread-per-connection", "no-threads", "loaded-dynamically",
-  0
+  "one-thread-per-connection", "no-threads", "pool-of-threads",
+  "loaded-dynamically", 0
 };
 static Sys_var_enum Sys_thread_handling(
        "thread_handling",
        "Define threads usage for handling queries, one of "
-       "one-thread-per-connection, no-threads, loaded-dynamically"
+       "one-thread-per-connection, no-threads, pool-of-threads, "
+       "loaded-dynamically"
        , READ_ONLY GLOBAL_VAR(Connection_handler_manager::thread_handling),
        CMD_LINE(REQUIRED_ARG), thread_handling_names, DEFAULT(0));
 #endif // !EMBEDDED_LIBRARY
@@ -2774,11 +2777,24 @@ static Sys_var_ulong Sys_query_cache_size(
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_query_cache_size));
 
+static bool fix_query_cache_limit(sys_var *self, THD *thd, enum_var_type type)
+{
+  query_cache.result_size_limit(query_cache.query_cache_limit);
+  return false;
+}
 static Sys_var_ulong Sys_query_cache_limit(
        "query_cache_limit",
        "Don't cache results that are bigger than this",
        GLOBAL_VAR(query_cache.query_cache_limit), CMD_LINE(REQUIRED_ARG),
-       VALID_RANGE(0, ULONG_MAX), DEFAULT(1024*1024), BLOCK_SIZE(1));
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(1024*1024), BLOCK_SIZE(1),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_query_cache_limit));
+
+static Sys_var_ulong Sys_query_cache_instances(
+       "query_cache_instances", "The number of query cache instances",
+       READ_ONLY GLOBAL_VAR(query_cache_instances), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, Query_cache_manager::MAX_QUERY_CACHES), DEFAULT(1),
+       BLOCK_SIZE(1));
 
 static bool fix_qcache_min_res_unit(sys_var *self, THD *thd, enum_var_type type)
 {
@@ -3381,6 +3397,54 @@ static Sys_var_ulong Sys_thread_cache_size(
        GLOBAL_VAR(Per_thread_connection_handler::max_blocked_pthreads),
        CMD_LINE(REQUIRED_ARG, OPT_THREAD_CACHE_SIZE),
        VALID_RANGE(0, 16384), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_size(
+       "thread_pool_size",
+       "Number of thread groups of the thread pool, used with "
+       "thread_handling=pool-of-threads. 0 means the number of CPUs",
+       READ_ONLY GLOBAL_VAR(Thread_pool_connection_handler::size),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 128), DEFAULT(0),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_oversubscribe(
+       "thread_pool_oversubscribe",
+       "How many worker threads of a thread group may execute queries "
+       "at the same time in addition to the first one",
+       GLOBAL_VAR(Thread_pool_connection_handler::oversubscribe),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1000), DEFAULT(3),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_stall_limit(
+       "thread_pool_stall_limit",
+       "Time in milliseconds after which the queries that are executing "
+       "in a thread group are considered stalled, and another worker "
+       "thread is allowed to start",
+       GLOBAL_VAR(Thread_pool_connection_handler::stall_limit),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(10, UINT_MAX32), DEFAULT(500),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_max_threads(
+       "thread_pool_max_threads",
+       "Maximum number of worker threads of the thread pool",
+       GLOBAL_VAR(Thread_pool_connection_handler::max_threads),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 65536), DEFAULT(1000),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_idle_timeout(
+       "thread_pool_idle_timeout",
+       "Time in seconds after which an idle worker thread of the thread "
+       "pool exits",
+       GLOBAL_VAR(Thread_pool_connection_handler::idle_timeout),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, UINT_MAX32), DEFAULT(60),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_thread_pool_high_prio_tickets(
+       "thread_pool_high_prio_tickets",
+       "Number of consecutive requests of a connection with an active "
+       "transaction that the thread pool queues with high priority",
+       GLOBAL_VAR(Thread_pool_connection_handler::high_prio_tickets),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, UINT_MAX32),
+       DEFAULT(UINT_MAX32), BLOCK_SIZE(1));
 #endif // !EMBEDDED_LIBRARY
 
 /**
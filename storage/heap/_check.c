@@ -18,8 +18,8 @@
 
 #include "heapdef.h"
 
-static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status);
+static int check_one_key(HP_SHARE *share, HP_KEYDEF *keydef, uint keynr,
+			 ulong records, ulong blength, my_bool print_status);
 static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
 			    my_bool print_status);
 
@@ -54,7 +54,7 @@ int heap_check_heap(HP_INFO *info, my_bool print_status)
     if (share->keydef[key].algorithm == HA_KEY_ALG_BTREE)
       error|= check_one_rb_key(info, key, share->records, print_status);
     else
-      error|= check_one_key(share->keydef + key, key, share->records,
+      error|= check_one_key(share, share->keydef + key, key, share->records,
 			    share->blength, print_status);
   }
   /*
@@ -97,8 +97,8 @@ int heap_check_heap(HP_INFO *info, my_bool print_status)
 }
 
 
-static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status)
+static int check_one_key(HP_SHARE *share, HP_KEYDEF *keydef, uint keynr,
+			 ulong records, ulong blength, my_bool print_status)
 {
   int error;
   ulong i,found,max_links,seek,links;
@@ -111,6 +111,13 @@ static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
   for (i=found=max_links=seek=0 ; i < records ; i++)
   {
     hash_info=hp_find_hash(&keydef->block,i);
+    if (!hp_same_hash_of_key(share, hash_info,
+                             hp_rec_hashnr(keydef, hash_info->ptr_to_rec)))
+    {
+      DBUG_PRINT("error",("Wrong hash stored for record: 0x%lx",
+                          (long) hash_info->ptr_to_rec));
+      error=1;
+    }
     if (hp_mask(hp_rec_hashnr(keydef, hash_info->ptr_to_rec),
 		blength,records) == i)
     {
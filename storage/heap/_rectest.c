@@ -20,9 +20,11 @@
 
 int hp_rectest(HP_INFO *info, const uchar *old)
 {
+  HP_SHARE *share= info->s;
   DBUG_ENTER("hp_rectest");
 
-  if (memcmp(info->current_ptr,old,(size_t) info->s->reclength))
+  if (share->columns ? hp_cmp_stored_record(share, info->current_ptr, old) :
+      memcmp(info->current_ptr,old,(size_t) share->reclength))
   {
     DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED)); /* Record have changed */
   }
@@ -634,15 +634,56 @@ ha_rows ha_heap::records_in_range(uint inx, key_range *min_key,
 }
 
 
+/*
+  VARCHAR columns of internal temporary tables with room for at least
+  this many bytes are stored out of the row, see HP_COLUMNDEF
+*/
+#define HEAP_MIN_OUT_OF_ROW_LENGTH 64
+
+/**
+  Check if the data of a field of an internal temporary table should be
+  stored out of the row.
+
+  BLOBs always are. A VARCHAR is if it is long enough and no key part
+  uses it, as the keys are made from the stored row.
+*/
+
+static bool heap_out_of_row_field(TABLE *table_arg, Field *field)
+{
+  uint offset= field->offset(table_arg->record[0]);
+
+  if (field->flags & BLOB_FLAG)
+    return true;
+  if (field->real_type() != MYSQL_TYPE_VARCHAR ||
+      field->field_length < HEAP_MIN_OUT_OF_ROW_LENGTH)
+    return false;
+  for (uint key= 0; key < table_arg->s->keys; key++)
+  {
+    KEY_PART_INFO *key_part= table_arg->key_info[key].key_part;
+    KEY_PART_INFO *key_part_end=
+      key_part + table_arg->key_info[key].user_defined_key_parts;
+    for (; key_part != key_part_end; key_part++)
+    {
+      if (key_part->offset >= offset &&
+          key_part->offset < offset + field->pack_length())
+        return false;
+    }
+  }
+  return true;
+}
+
+
 static int
 heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                             HP_CREATE_INFO *hp_create_info)
 {
   uint key, parts, mem_per_row= 0, keys= table_arg->s->keys;
-  uint auto_key= 0, auto_key_type= 0;
+  uint auto_key= 0, auto_key_type= 0, columns= 0, stored_length;
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_COLUMNDEF *column;
+  Field **field;
   TABLE_SHARE *share= table_arg->s;
   bool found_real_auto_increment= 0;
 
@@ -650,13 +691,49 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
 
   for (key= parts= 0; key < keys; key++)
     parts+= table_arg->key_info[key].user_defined_key_parts;
+  if (internal_table)
+  {
+    for (field= table_arg->field; *field; field++)
+      if (heap_out_of_row_field(table_arg, *field))
+        columns++;
+  }
 
   if (!(keydef= (HP_KEYDEF*) my_malloc(hp_key_memory_HP_KEYDEF,
                                        keys * sizeof(HP_KEYDEF) +
-				       parts * sizeof(HA_KEYSEG),
+				       parts * sizeof(HA_KEYSEG) +
+                                       columns * sizeof(HP_COLUMNDEF),
 				       MYF(MY_WME))))
     return my_errno;
   seg= reinterpret_cast<HA_KEYSEG*>(keydef + keys);
+  column= reinterpret_cast<HP_COLUMNDEF*>(seg + parts);
+  hp_create_info->columndef= column;
+  hp_create_info->columns= columns;
+  stored_length= share->reclength;
+  for (field= table_arg->field; columns && *field; field++)
+  {
+    if (!heap_out_of_row_field(table_arg, *field))
+      continue;
+    column->offset= (*field)->offset(table_arg->record[0]);
+    column->length= (*field)->pack_length();
+    if ((column->blob= MY_TEST((*field)->flags & BLOB_FLAG)))
+      column->length_bytes= ((Field_blob*) *field)->pack_length_no_ptr();
+    else
+    {
+      column->length_bytes= ((Field_varstring*) *field)->length_bytes;
+      stored_length-= column->length - column->length_bytes - sizeof(uchar*);
+    }
+    if ((*field)->real_maybe_null())
+    {
+      column->null_bit= (*field)->null_bit;
+      column->null_pos= (*field)->null_offset();
+    }
+    else
+    {
+      column->null_bit= 0;
+      column->null_pos= 0;
+    }
+    column++;
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -671,7 +748,7 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     case HA_KEY_ALG_UNDEF:
     case HA_KEY_ALG_HASH:
       keydef[key].algorithm= HA_KEY_ALG_HASH;
-      mem_per_row+= sizeof(char*) * 2; // = sizeof(HASH_INFO)
+      mem_per_row+= hp_hash_info_length(internal_table);
       break;
     case HA_KEY_ALG_BTREE:
       keydef[key].algorithm= HA_KEY_ALG_BTREE;
@@ -727,7 +804,7 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
       }
     }
   }
-  mem_per_row+= MY_ALIGN(share->reclength + 1, sizeof(char*));
+  mem_per_row+= MY_ALIGN(stored_length + 1, sizeof(char*));
   if (table_arg->found_next_number_field)
   {
     keydef[share->next_number_index].flag|= HA_AUTO_KEY;
@@ -736,6 +813,13 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  /*
+    share->max_rows doesn't account for the data stored out of the row,
+    so limit the memory of such tables to what create_tmp_table() allows
+  */
+  if (hp_create_info->columns)
+    set_if_smaller(hp_create_info->max_table_size,
+                   current_thd->variables.tmp_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
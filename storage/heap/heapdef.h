@@ -50,8 +50,26 @@ typedef struct st_hp_hash_info
 {
   struct st_hp_hash_info *next_key;
   uchar *ptr_to_rec;
+  ulong hash_of_key;			/* Only for internal tables */
 } HASH_INFO;
 
+/*
+  Hash index entries of internal temporary tables also keep the
+  hp_rec_hashnr() of their record, those of other tables end before
+  hash_of_key. Entries must be copied with hp_copy_hash_info().
+*/
+#define hp_hash_info_length(internal) \
+  ((internal) ? sizeof(HASH_INFO) : offsetof(HASH_INFO, hash_of_key))
+#define hp_copy_hash_info(share,to,from) \
+  memcpy((to), (from), hp_hash_info_length((share)->internal))
+#define hp_hash_of_key(share,keydef,pos) \
+  ((share)->internal ? (pos)->hash_of_key : \
+   hp_rec_hashnr((keydef), (pos)->ptr_to_rec))
+#define hp_same_hash_of_key(share,pos,hashnr) \
+  (!(share)->internal || (pos)->hash_of_key == (hashnr))
+#define hp_set_hash_of_key(share,pos,hashnr) \
+  do { if ((share)->internal) (pos)->hash_of_key= (hashnr); } while (0)
+
 typedef struct {
   HA_KEYSEG *keyseg;
   uint key_length;
@@ -102,6 +120,17 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern uchar *hp_arena_alloc(HP_SHARE *share, size_t length);
+extern void hp_arena_free(HP_SHARE *share, uchar *chunk, size_t length);
+extern void hp_arena_clear(HP_SHARE *share);
+extern int hp_pack_record(HP_SHARE *share, uchar *pos, const uchar *record,
+                          const uchar *old);
+extern void hp_extract_record(HP_SHARE *share, uchar *record,
+                              const uchar *pos);
+extern void hp_free_columns(HP_SHARE *share, const uchar *pos,
+                            const uchar *keep);
+extern int hp_cmp_stored_record(HP_SHARE *share, const uchar *pos,
+                                const uchar *record);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -109,6 +138,7 @@ extern PSI_memory_key hp_key_memory_HP_SHARE;
 extern PSI_memory_key hp_key_memory_HP_INFO;
 extern PSI_memory_key hp_key_memory_HP_PTRS;
 extern PSI_memory_key hp_key_memory_HP_KEYDEF;
+extern PSI_memory_key hp_key_memory_HP_ARENA;
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key hp_key_mutex_HP_SHARE_intern_lock;
@@ -0,0 +1,168 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Memory for the data of columns stored out of the row, see HP_ARENA.
+
+  Pages start with a pointer to the next page, padded to HP_ARENA_ALIGN.
+  A free chunk holds a pointer to the next free chunk of the same size.
+  The memory of the pages and big chunks is counted in data_length, so
+  it is limited by max_table_size like the rows.
+*/
+
+#include "heapdef.h"
+
+typedef struct st_hp_big_chunk
+{
+  struct st_hp_big_chunk *next, *prev;
+  size_t alloc_length;
+} HP_BIG_CHUNK;
+
+#define HP_ARENA_PAGE_HEADER	MY_ALIGN(sizeof(uchar*), HP_ARENA_ALIGN)
+#define HP_BIG_CHUNK_HEADER	MY_ALIGN(sizeof(HP_BIG_CHUNK), HP_ARENA_ALIGN)
+
+#define chunk_size(A)		MY_ALIGN((A), HP_ARENA_ALIGN)
+#define chunk_class(A)		((A) / HP_ARENA_ALIGN - 1)
+
+
+static my_bool arena_is_full(HP_SHARE *share, size_t length)
+{
+  if (share->data_length + share->index_length + length >=
+      share->max_table_size)
+  {
+    my_errno= HA_ERR_RECORD_FILE_FULL;
+    return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Allocate memory for column data
+
+  SYNOPSIS
+    hp_arena_alloc()
+    share		Heap table
+    length		Length of data, > 0
+
+  RETURN
+    0	  Error, my_errno is set. HA_ERR_RECORD_FILE_FULL if the table
+	  would grow over max_table_size.
+    #	  Chunk of at least length bytes
+*/
+
+uchar *hp_arena_alloc(HP_SHARE *share, size_t length)
+{
+  HP_ARENA *arena= &share->arena;
+  size_t size= chunk_size(length);
+  uchar *chunk;
+  DBUG_ENTER("hp_arena_alloc");
+  DBUG_ASSERT(length > 0);
+
+  if (size > HP_ARENA_MAX_CHUNK)
+  {
+    HP_BIG_CHUNK *big;
+    size_t alloc_length= HP_BIG_CHUNK_HEADER + length;
+    if (arena_is_full(share, alloc_length))
+      DBUG_RETURN(0);
+    if (!(big= (HP_BIG_CHUNK*) my_malloc(hp_key_memory_HP_ARENA,
+                                         alloc_length, MYF(MY_WME))))
+      DBUG_RETURN(0);
+    big->alloc_length= alloc_length;
+    big->prev= 0;
+    if ((big->next= arena->big_chunks))
+      big->next->prev= big;
+    arena->big_chunks= big;
+    share->data_length+= alloc_length;
+    DBUG_RETURN((uchar*) big + HP_BIG_CHUNK_HEADER);
+  }
+
+  if ((chunk= arena->free_chunks[chunk_class(size)]))
+  {
+    arena->free_chunks[chunk_class(size)]= *((uchar**) chunk);
+    DBUG_RETURN(chunk);
+  }
+
+  if ((size_t) (arena->free_end - arena->free_pos) < size)
+  {
+    uchar *page;
+    if (arena_is_full(share, HP_ARENA_PAGE_SIZE))
+      DBUG_RETURN(0);
+    if (!(page= (uchar*) my_malloc(hp_key_memory_HP_ARENA,
+                                   HP_ARENA_PAGE_SIZE, MYF(MY_WME))))
+      DBUG_RETURN(0);
+    /* Keep the rest of the old page for smaller chunks */
+    if (arena->free_end > arena->free_pos)
+      hp_arena_free(share, arena->free_pos,
+                    (size_t) (arena->free_end - arena->free_pos));
+    *((uchar**) page)= arena->pages;
+    arena->pages= page;
+    arena->free_pos= page + HP_ARENA_PAGE_HEADER;
+    arena->free_end= page + HP_ARENA_PAGE_SIZE;
+    share->data_length+= HP_ARENA_PAGE_SIZE;
+  }
+  chunk= arena->free_pos;
+  arena->free_pos+= size;
+  DBUG_RETURN(chunk);
+}
+
+
+/*
+  Free a chunk allocated by hp_arena_alloc() with the same length
+*/
+
+void hp_arena_free(HP_SHARE *share, uchar *chunk, size_t length)
+{
+  HP_ARENA *arena= &share->arena;
+  size_t size= chunk_size(length);
+
+  if (size > HP_ARENA_MAX_CHUNK)
+  {
+    HP_BIG_CHUNK *big= (HP_BIG_CHUNK*) (chunk - HP_BIG_CHUNK_HEADER);
+    if (big->prev)
+      big->prev->next= big->next;
+    else
+      arena->big_chunks= big->next;
+    if (big->next)
+      big->next->prev= big->prev;
+    share->data_length-= big->alloc_length;
+    my_free(big);
+    return;
+  }
+  *((uchar**) chunk)= arena->free_chunks[chunk_class(size)];
+  arena->free_chunks[chunk_class(size)]= chunk;
+}
+
+
+	/* Free all memory of the arena */
+
+void hp_arena_clear(HP_SHARE *share)
+{
+  HP_ARENA *arena= &share->arena;
+  uchar *page, *next_page;
+  HP_BIG_CHUNK *big, *next_big;
+
+  for (page= arena->pages; page; page= next_page)
+  {
+    next_page= *((uchar**) page);
+    my_free(page);
+  }
+  for (big= arena->big_chunks; big; big= next_big)
+  {
+    next_big= big->next;
+    my_free(big);
+  }
+  memset(arena, 0, sizeof(*arena));
+}
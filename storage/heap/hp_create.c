@@ -18,6 +18,7 @@
 static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2);
 static void init_block(HP_BLOCK *block,uint reclength,ulong min_records,
 		       ulong max_records);
+static uint stored_offset(HP_COLUMNDEF *columndef, uint columns, uint offset);
 
 /* Create a heap table */
 
@@ -28,6 +29,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
   HP_SHARE *share= 0;
   HA_KEYSEG *keyseg;
   HP_KEYDEF *keydef= create_info->keydef;
+  HP_COLUMNDEF *columndef= create_info->columndef;
+  uint columns= create_info->columns;
   uint reclength= create_info->reclength;
   uint keys= create_info->keys;
   ulong min_records= create_info->min_records;
@@ -50,7 +53,11 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
   {
     HP_KEYDEF *keyinfo;
     DBUG_PRINT("info",("Initializing new table"));
-    
+
+    /* Columns stored out of the row make the stored row shorter */
+    if (columns)
+      reclength= stored_offset(columndef, columns, reclength);
+
     /*
       We have to store sometimes uchar* del_link in records,
       so the record length should be at least sizeof(uchar*)
@@ -134,12 +141,22 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!(share= (HP_SHARE*) my_malloc(hp_key_memory_HP_SHARE,
                                        (uint) sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+				       columns*sizeof(HP_COLUMNDEF),
 				       MYF(MY_ZEROFILL))))
       goto err;
     share->keydef= (HP_KEYDEF*) (share + 1);
     share->key_stat_version= 1;
+    share->internal= create_info->internal_table;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
+    share->columndef= (HP_COLUMNDEF*) (keyseg + key_segs);
+    share->columns= columns;
+    for (i= 0; i < columns; i++)
+    {
+      share->columndef[i]= columndef[i];
+      share->columndef[i].stored_offset= stored_offset(columndef, columns,
+                                                       columndef[i].offset);
+    }
     init_block(&share->block, reclength + 1, min_records, max_records);
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
@@ -148,6 +165,13 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       keyinfo->seg= keyseg;
       memcpy(keyseg, keydef[i].seg,
 	     (size_t) (sizeof(keyseg[0]) * keydef[i].keysegs));
+      for (j= 0; columns && j < keydef[i].keysegs; j++)
+      {
+        keyseg[j].start= stored_offset(columndef, columns, keyseg[j].start);
+        if (keyseg[j].null_bit)
+          keyseg[j].null_pos= stored_offset(columndef, columns,
+                                            keyseg[j].null_pos);
+      }
       keyseg+= keydef[i].keysegs;
 
       if (keydef[i].algorithm == HA_KEY_ALG_BTREE)
@@ -166,8 +190,9 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       }
       else
       {
-	init_block(&keyinfo->block, sizeof(HASH_INFO), min_records,
-		   max_records);
+	init_block(&keyinfo->block,
+		   hp_hash_info_length(create_info->internal_table),
+		   min_records, max_records);
 	keyinfo->delete_key= hp_delete_key;
 	keyinfo->write_key= hp_write_key;
         keyinfo->hash_buckets= 0;
@@ -180,6 +205,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     share->max_table_size= create_info->max_table_size;
     share->data_length= share->index_length= 0;
     share->reclength= reclength;
+    share->record_length= create_info->reclength;
     share->blength= 1;
     share->keys= keys;
     share->max_key_length= max_length;
@@ -230,6 +256,25 @@ static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2)
 		    param->search_flag, not_used);
 }
 
+/*
+  Offset in the stored row of the byte at offset in the record.
+  columndef is sorted by offset and offset may not be inside a column.
+*/
+
+static uint stored_offset(HP_COLUMNDEF *columndef, uint columns, uint offset)
+{
+  HP_COLUMNDEF *column, *end= columndef + columns;
+  uint shrink= 0;
+
+  for (column= columndef; column < end && column->offset < offset; column++)
+  {
+    DBUG_ASSERT(column->offset + column->length <= offset);
+    if (!column->blob)
+      shrink+= column->length - (column->length_bytes + sizeof(uchar*));
+  }
+  return offset - shrink;
+}
+
 static void init_block(HP_BLOCK *block, uint reclength, ulong min_records,
 		       ulong max_records)
 {
@@ -33,6 +33,8 @@ int heap_delete(HP_INFO *info, const uchar *record)
 
   if ( --(share->records) < share->blength >> 1) share->blength>>=1;
   pos=info->current_ptr;
+  if (share->columns)
+    record= pos;				/* Keys use the stored row */
 
   p_lastinx = share->keydef + info->lastinx;
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end; 
@@ -43,6 +45,8 @@ int heap_delete(HP_INFO *info, const uchar *record)
   }
 
   info->update=HA_STATE_DELETED;
+  if (share->columns)
+    hp_free_columns(share, pos, 0);
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
   pos[share->reclength]=0;		/* Record deleted */
@@ -104,7 +108,7 @@ int hp_rb_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 		  const uchar *record, uchar *recpos, int flag)
 {
-  ulong blength, pos2, pos_hashnr, lastpos_hashnr, key_pos;
+  ulong blength, pos2, pos_hashnr, lastpos_hashnr, key_pos, rec_hashnr;
   HASH_INFO *lastpos,*gpos,*pos,*pos3,*empty,*last_ptr;
   HP_SHARE *share=info->s;
   DBUG_ENTER("hp_delete_key");
@@ -116,14 +120,16 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   last_ptr=0;
 
   /* Search after record with key */
-  key_pos= hp_mask(hp_rec_hashnr(keyinfo, record), blength, share->records + 1);
+  rec_hashnr= hp_rec_hashnr(keyinfo, record);
+  key_pos= hp_mask(rec_hashnr, blength, share->records + 1);
   pos= hp_find_hash(&keyinfo->block, key_pos);
 
   gpos = pos3 = 0;
 
   while (pos->ptr_to_rec != recpos)
   {
-    if (flag && !hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 0))
+    if (flag && hp_same_hash_of_key(share, pos, rec_hashnr) &&
+        !hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 0))
       last_ptr=pos;				/* Previous same key */
     gpos=pos;
     if (!(pos=pos->next_key))
@@ -149,6 +155,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   {
     empty=pos->next_key;
     pos->ptr_to_rec=empty->ptr_to_rec;
+    hp_set_hash_of_key(share, pos, empty->hash_of_key);
     pos->next_key=empty->next_key;
   }
   else
@@ -158,23 +165,23 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     DBUG_RETURN (0);
 
   /* Move the last key (lastpos) */
-  lastpos_hashnr = hp_rec_hashnr(keyinfo, lastpos->ptr_to_rec);
+  lastpos_hashnr = hp_hash_of_key(share, keyinfo, lastpos);
   /* pos is where lastpos should be */
   pos=hp_find_hash(&keyinfo->block, hp_mask(lastpos_hashnr, share->blength,
 					    share->records));
   if (pos == empty)			/* Move to empty position. */
   {
-    empty[0]=lastpos[0];
+    hp_copy_hash_info(share, empty, lastpos);
     DBUG_RETURN(0);
   }
-  pos_hashnr = hp_rec_hashnr(keyinfo, pos->ptr_to_rec);
+  pos_hashnr = hp_hash_of_key(share, keyinfo, pos);
   /* pos3 is where the pos should be */
   pos3= hp_find_hash(&keyinfo->block,
 		     hp_mask(pos_hashnr, share->blength, share->records));
   if (pos != pos3)
   {					/* pos is on wrong posit */
-    empty[0]=pos[0];			/* Save it here */
-    pos[0]=lastpos[0];			/* This shold be here */
+    hp_copy_hash_info(share, empty, pos);	/* Save it here */
+    hp_copy_hash_info(share, pos, lastpos);	/* This shold be here */
     hp_movelink(pos, pos3, empty);	/* Fix link to pos */
     DBUG_RETURN(0);
   }
@@ -183,7 +190,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   {					/* Identical key-positions */
     if (pos2 != share->records)
     {
-      empty[0]=lastpos[0];
+      hp_copy_hash_info(share, empty, lastpos);
       hp_movelink(lastpos, pos, empty);
       DBUG_RETURN(0);
     }
@@ -205,7 +212,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     keyinfo->hash_buckets--;
   }
 
-  empty[0]=lastpos[0];
+  hp_copy_hash_info(share, empty, lastpos);
   hp_movelink(pos3, empty, pos->next_key);
   pos->next_key=empty;
   DBUG_RETURN(0);
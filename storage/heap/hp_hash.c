@@ -103,6 +103,7 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
   HASH_INFO *pos,*prev_ptr;
   int flag;
   uint old_nextflag;
+  ulong hashnr;
   HP_SHARE *share=info->s;
   DBUG_ENTER("hp_search");
   old_nextflag=nextflag;
@@ -111,11 +112,13 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
 
   if (share->records)
   {
-    pos=hp_find_hash(&keyinfo->block, hp_mask(hp_hashnr(keyinfo, key),
+    hashnr= hp_hashnr(keyinfo, key);
+    pos=hp_find_hash(&keyinfo->block, hp_mask(hashnr,
 					      share->blength, share->records));
     do
     {
-      if (!hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
+      if (hp_same_hash_of_key(share, pos, hashnr) &&
+          !hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
       {
 	switch (nextflag) {
 	case 0:					/* Search after key */
@@ -147,7 +150,7 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
       {
 	flag=0;					/* Reset flag */
 	if (hp_find_hash(&keyinfo->block,
-			 hp_mask(hp_rec_hashnr(keyinfo, pos->ptr_to_rec),
+			 hp_mask(hp_hash_of_key(share, keyinfo, pos),
 				  share->blength, share->records)) != pos)
 	  break;				/* Wrong link */
       }
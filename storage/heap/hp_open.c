@@ -32,7 +32,8 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
 
   if (!(info= (HP_INFO*) my_malloc(hp_key_memory_HP_INFO,
                                    (uint) sizeof(HP_INFO) +
-				  2 * share->max_key_length,
+				  2 * share->max_key_length +
+                                  (share->columns ? share->reclength : 0),
 				  MYF(MY_ZEROFILL))))
   {
     DBUG_RETURN(0);
@@ -42,6 +43,8 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
   info->s= share;
   info->lastkey= (uchar*) (info + 1);
   info->recbuf= (uchar*) (info->lastkey + share->max_key_length);
+  if (share->columns)
+    info->rowbuf= info->recbuf + share->max_key_length;
   info->mode= mode;
   info->current_record= (ulong) ~0L;		/* No current record */
   info->lastinx= info->errkey= -1;
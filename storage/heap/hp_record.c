@@ -0,0 +1,277 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Conversion between records and stored rows for tables with columns
+  stored out of the row (see HP_COLUMNDEF).
+
+  The stored row is the record with every such column replaced by its
+  length bytes and a pointer to the data in the arena (0 if there is no
+  data). All other bytes keep their order, so the key segments only
+  need their offsets moved, which heap_create() does.
+*/
+
+#include "heapdef.h"
+
+#define column_stored_length(C)	((C)->blob ? (C)->length :		\
+				 (C)->length_bytes + sizeof(uchar*))
+
+
+static size_t column_data_length(const HP_COLUMNDEF *column,
+                                 const uchar *pos)
+{
+  switch (column->length_bytes) {
+  case 1:
+    return (size_t) *pos;
+  case 2:
+    return (size_t) uint2korr(pos);
+  case 3:
+    return (size_t) uint3korr(pos);
+  case 4:
+    return (size_t) uint4korr(pos);
+  default:
+    DBUG_ASSERT(0);
+  }
+  return 0;
+}
+
+
+static void store_column_data_length(const HP_COLUMNDEF *column, uchar *pos,
+                                     size_t length)
+{
+  switch (column->length_bytes) {
+  case 1:
+    *pos= (uchar) length;
+    break;
+  case 2:
+    int2store(pos, length);
+    break;
+  case 3:
+    int3store(pos, length);
+    break;
+  case 4:
+    int4store(pos, length);
+    break;
+  default:
+    DBUG_ASSERT(0);
+  }
+}
+
+
+static uchar *column_chunk(const HP_COLUMNDEF *column, const uchar *pos)
+{
+  uchar *chunk;
+  memcpy(&chunk, pos + column->stored_offset + column->length_bytes,
+         sizeof(chunk));
+  return chunk;
+}
+
+
+/*
+  Free the data of the columns in stored row pos written by
+  hp_pack_record() up to (not including) column end
+*/
+
+static void free_columns(HP_SHARE *share, const uchar *pos,
+                         const uchar *keep, HP_COLUMNDEF *end)
+{
+  HP_COLUMNDEF *column;
+
+  for (column= share->columndef; column < end; column++)
+  {
+    uchar *chunk= column_chunk(column, pos);
+    if (chunk && !(keep && chunk == column_chunk(column, keep)))
+      hp_arena_free(share, chunk,
+                    column_data_length(column, pos + column->stored_offset));
+  }
+}
+
+
+/*
+  Make a stored row from a record
+
+  SYNOPSIS
+    hp_pack_record()
+    share		Heap table
+    pos			Where to store the row
+    record		Record to store
+    old			Stored row that the record replaces, or 0 for a
+			new row. Data equal to that of old is not copied
+			again.
+
+  RETURN
+    0	  ok
+    #	  Error, nothing was allocated. HA_ERR_RECORD_FILE_FULL if
+	  the table would grow over max_table_size.
+*/
+
+int hp_pack_record(HP_SHARE *share, uchar *pos, const uchar *record,
+                   const uchar *old)
+{
+  HP_COLUMNDEF *column, *end= share->columndef + share->columns;
+  const uchar *from= record;
+  uchar *to= pos;
+  DBUG_ENTER("hp_pack_record");
+
+  for (column= share->columndef; column < end; column++)
+  {
+    size_t fixed_length= (size_t) (record + column->offset - from);
+    const uchar *data;
+    uchar *chunk= 0;
+    size_t length= 0;
+
+    memcpy(to, from, fixed_length);
+    to+= fixed_length;
+    from+= fixed_length;
+    DBUG_ASSERT(to == pos + column->stored_offset);
+
+    if (!column->null_bit || !(record[column->null_pos] & column->null_bit))
+      length= column_data_length(column, from);
+    if (column->blob)
+      memcpy(&data, from + column->length_bytes, sizeof(data));
+    else
+    {
+      data= from + column->length_bytes;
+      set_if_smaller(length, column->length - column->length_bytes);
+    }
+
+    if (length)
+    {
+      uchar *old_chunk= old ? column_chunk(column, old) : 0;
+      if (old_chunk &&
+          column_data_length(column, old + column->stored_offset) == length &&
+          (old_chunk == data || !memcmp(old_chunk, data, length)))
+        chunk= old_chunk;
+      else
+      {
+        if (!(chunk= hp_arena_alloc(share, length)))
+        {
+          free_columns(share, pos, old, column);
+          DBUG_RETURN(my_errno);
+        }
+        memcpy(chunk, data, length);
+      }
+    }
+    store_column_data_length(column, to, length);
+    memcpy(to + column->length_bytes, &chunk, sizeof(chunk));
+    to+= column_stored_length(column);
+    from+= column->length;
+  }
+  memcpy(to, from, (size_t) (record + share->record_length - from));
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Make a record from a stored row
+*/
+
+void hp_extract_record(HP_SHARE *share, uchar *record, const uchar *pos)
+{
+  HP_COLUMNDEF *column, *end= share->columndef + share->columns;
+  const uchar *from= pos;
+  uchar *to= record;
+
+  if (!share->columns)
+  {
+    memcpy(record, pos, (size_t) share->reclength);
+    return;
+  }
+  for (column= share->columndef; column < end; column++)
+  {
+    size_t fixed_length= (size_t) (record + column->offset - to);
+    memcpy(to, from, fixed_length);
+    to+= fixed_length;
+    from+= fixed_length;
+
+    if (column->blob)
+      memcpy(to, from, column->length);         /* Pointer into the arena */
+    else
+    {
+      size_t length= column_data_length(column, from);
+      memcpy(to, from, column->length_bytes);
+      if (length)
+        memcpy(to + column->length_bytes, column_chunk(column, pos), length);
+    }
+    to+= column->length;
+    from+= column_stored_length(column);
+  }
+  memcpy(to, from, (size_t) (record + share->record_length - to));
+}
+
+
+/*
+  Free the data of the columns of a stored row
+
+  SYNOPSIS
+    hp_free_columns()
+    share		Heap table
+    pos			Stored row
+    keep		Stored row made by hp_pack_record() with pos as old,
+			data shared with it is not freed. May be 0.
+*/
+
+void hp_free_columns(HP_SHARE *share, const uchar *pos, const uchar *keep)
+{
+  free_columns(share, pos, keep, share->columndef + share->columns);
+}
+
+
+/*
+  Compare a stored row with a record
+
+  RETURN
+    0	  Same row
+    1	  Different
+*/
+
+int hp_cmp_stored_record(HP_SHARE *share, const uchar *pos,
+                         const uchar *record)
+{
+  HP_COLUMNDEF *column, *end= share->columndef + share->columns;
+  const uchar *from= record;
+  const uchar *stored= pos;
+
+  for (column= share->columndef; column < end; column++)
+  {
+    size_t fixed_length= (size_t) (record + column->offset - from);
+    size_t length;
+    const uchar *data;
+
+    if (memcmp(stored, from, fixed_length))
+      return 1;
+    stored+= fixed_length;
+    from+= fixed_length;
+
+    if (!column->null_bit || !(record[column->null_pos] & column->null_bit))
+    {
+      length= column_data_length(column, from);
+      if (column->blob)
+        memcpy(&data, from + column->length_bytes, sizeof(data));
+      else
+      {
+        data= from + column->length_bytes;
+        set_if_smaller(length, column->length - column->length_bytes);
+      }
+      if (length != column_data_length(column, stored) ||
+          (length && memcmp(column_chunk(column, pos), data, length)))
+        return 1;
+    }
+    stored+= column_stored_length(column);
+    from+= column->length;
+  }
+  return MY_TEST(memcmp(stored, from,
+                        (size_t) (record + share->record_length - from)));
+}
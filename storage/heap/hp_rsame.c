@@ -40,14 +40,15 @@ int heap_rsame(HP_INFO *info, uchar *record, int inx)
     else if (inx != -1)
     {
       info->lastinx=inx;
-      hp_make_key(share->keydef + inx, info->lastkey, record);
+      hp_make_key(share->keydef + inx, info->lastkey,
+                  share->columns ? info->current_ptr : record);
       if (!hp_search(info, share->keydef + inx, info->lastkey, 3))
       {
 	info->update=0;
 	DBUG_RETURN(my_errno);
       }
     }
-    memcpy(record,info->current_ptr,(size_t) share->reclength);
+    hp_extract_record(share, record, info->current_ptr);
     DBUG_RETURN(0);
   }
   info->update=0;
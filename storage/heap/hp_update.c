@@ -31,6 +31,14 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
 
   if (info->opt_flag & READ_CHECK_USED && hp_rectest(info,old))
     DBUG_RETURN(my_errno);				/* Record changed */
+  if (share->columns)
+  {
+    /* Keys use the stored rows, data not changed is shared with old */
+    if (hp_pack_record(share, info->rowbuf, heap_new, pos))
+      DBUG_RETURN(my_errno);
+    old= pos;
+    heap_new= info->rowbuf;
+  }
   if (--(share->records) < share->blength >> 1) share->blength>>= 1;
   share->changed=1;
 
@@ -47,6 +55,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     }
   }
 
+  if (share->columns)
+    hp_free_columns(share, pos, heap_new);
   memcpy(pos,heap_new,(size_t) share->reclength);
   if (++(share->records) == share->blength) share->blength+= share->blength;
 
@@ -83,6 +93,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
       keydef--;
     }
   }
+  if (share->columns)
+    hp_free_columns(share, heap_new, pos);
   if (++(share->records) == share->blength)
     share->blength+= share->blength;
   DBUG_RETURN(my_errno);
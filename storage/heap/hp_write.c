@@ -43,6 +43,12 @@ int heap_write(HP_INFO *info, const uchar *record)
 #endif
   if (!(pos=next_free_record_pos(share)))
     DBUG_RETURN(my_errno);
+  if (share->columns)
+  {
+    if (hp_pack_record(share, pos, record, 0))
+      goto err_free_pos;
+    record= pos;				/* Keys use the stored row */
+  }
   share->changed=1;
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
@@ -52,7 +58,8 @@ int heap_write(HP_INFO *info, const uchar *record)
       goto err;
   }
 
-  memcpy(pos,record,(size_t) share->reclength);
+  if (!share->columns)
+    memcpy(pos,record,(size_t) share->reclength);
   pos[share->reclength]=1;		/* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -86,7 +93,10 @@ err:
       break;
     keydef--;
   } 
+  if (share->columns)
+    hp_free_columns(share, pos, 0);
 
+err_free_pos:
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -195,7 +205,8 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 {
   HP_SHARE *share = info->s;
   int flag;
-  ulong halfbuff,hashnr,first_index;
+  ulong halfbuff,hashnr,first_index,rec_hashnr;
+  ulong hash_of_key= 0, hash_of_key2= 0;
   uchar *ptr_to_rec= NULL, *ptr_to_rec2= NULL;
   HASH_INFO *empty, *gpos= NULL, *gpos2= NULL, *pos;
   DBUG_ENTER("hp_write_key");
@@ -226,7 +237,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   {
     do
     {
-      hashnr = hp_rec_hashnr(keyinfo, pos->ptr_to_rec);
+      hashnr = hp_hash_of_key(share, keyinfo, pos);
       if (flag == 0)
       {
         /* 
@@ -259,6 +270,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	    /* key shall be moved to the current empty position */
 	    gpos=empty;
 	    ptr_to_rec=pos->ptr_to_rec;
+	    hash_of_key=hashnr;
 	    empty=pos;				/* This place is now free */
 	  }
 	  else
@@ -270,6 +282,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	    flag=LOWFIND | LOWUSED;
 	    gpos=pos;
 	    ptr_to_rec=pos->ptr_to_rec;
+	    hash_of_key=hashnr;
 	  }
 	}
 	else
@@ -279,11 +292,13 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  {
 	    /* Change link of previous lower-list key */
 	    gpos->ptr_to_rec=ptr_to_rec;
+	    hp_set_hash_of_key(share, gpos, hash_of_key);
 	    gpos->next_key=pos;
 	    flag= (flag & HIGHFIND) | (LOWFIND | LOWUSED);
 	  }
 	  gpos=pos;
 	  ptr_to_rec=pos->ptr_to_rec;
+	  hash_of_key=hashnr;
 	}
       }
       else
@@ -296,6 +311,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  gpos2= empty;
           empty= pos;
 	  ptr_to_rec2=pos->ptr_to_rec;
+	  hash_of_key2=hashnr;
 	}
 	else
 	{
@@ -303,11 +319,13 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  {
 	    /* Change link of previous upper-list key and save */
 	    gpos2->ptr_to_rec=ptr_to_rec2;
+	    hp_set_hash_of_key(share, gpos2, hash_of_key2);
 	    gpos2->next_key=pos;
 	    flag= (flag & LOWFIND) | (HIGHFIND | HIGHUSED);
 	  }
 	  gpos2=pos;
 	  ptr_to_rec2=pos->ptr_to_rec;
+	  hash_of_key2=hashnr;
 	}
       }
     }
@@ -325,40 +343,46 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     if ((flag & (LOWFIND | LOWUSED)) == LOWFIND)
     {
       gpos->ptr_to_rec=ptr_to_rec;
+      hp_set_hash_of_key(share, gpos, hash_of_key);
       gpos->next_key=0;
     }
     if ((flag & (HIGHFIND | HIGHUSED)) == HIGHFIND)
     {
       gpos2->ptr_to_rec=ptr_to_rec2;
+      hp_set_hash_of_key(share, gpos2, hash_of_key2);
       gpos2->next_key=0;
     }
   }
   /* Check if we are at the empty position */
 
-  pos=hp_find_hash(&keyinfo->block, hp_mask(hp_rec_hashnr(keyinfo, record),
+  rec_hashnr= hp_rec_hashnr(keyinfo, record);
+  pos=hp_find_hash(&keyinfo->block, hp_mask(rec_hashnr,
 					 share->blength, share->records + 1));
   if (pos == empty)
   {
     pos->ptr_to_rec=recpos;
+    hp_set_hash_of_key(share, pos, rec_hashnr);
     pos->next_key=0;
     keyinfo->hash_buckets++;
   }
   else
   {
     /* Check if more records in same hash-nr family */
-    empty[0]=pos[0];
+    hp_copy_hash_info(share, empty, pos);
     gpos=hp_find_hash(&keyinfo->block,
-		      hp_mask(hp_rec_hashnr(keyinfo, pos->ptr_to_rec),
+		      hp_mask(hp_hash_of_key(share, keyinfo, pos),
 			      share->blength, share->records + 1));
     if (pos == gpos)
     {
       pos->ptr_to_rec=recpos;
+      hp_set_hash_of_key(share, pos, rec_hashnr);
       pos->next_key=empty;
     }
     else
     {
       keyinfo->hash_buckets++;
       pos->ptr_to_rec=recpos;
+      hp_set_hash_of_key(share, pos, rec_hashnr);
       pos->next_key=0;
       hp_movelink(pos, gpos, empty);
     }
@@ -371,7 +395,8 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
       pos=empty;
       do
       {
-	if (! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 1))
+	if (hp_same_hash_of_key(share, pos, rec_hashnr) &&
+	    ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 1))
 	{
 	  DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
 	}
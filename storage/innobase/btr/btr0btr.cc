@@ -1526,6 +1526,81 @@ btr_page_empty(
 	block->check_index_page_at_flush = TRUE;
 }
 
+/** Empty an index tree, for the rollback of a bulk insert into an empty
+table. The root page is emptied first, so that the tree is consistent
+between the mini-transactions that free the other pages.
+@param[in,out]	index	index tree
+@param[in]	trx_id	transaction that did the bulk insert */
+void
+btr_empty_index(
+	dict_index_t*	index,
+	trx_id_t	trx_id)
+{
+	const ulint	space = dict_index_get_space(index);
+	buf_block_t*	block;
+	page_t*		root;
+	ibool		finished;
+	mtr_t		mtr;
+
+	ut_ad(!dict_index_is_ibuf(index));
+	ut_ad(!dict_table_is_temporary(index->table));
+
+	mtr_start(&mtr);
+	mtr.set_named_space(space);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	block = btr_root_block_get(index, RW_X_LATCH, &mtr);
+
+	btr_page_empty(block, buf_block_get_page_zip(block), index, 0, &mtr);
+
+	if (!dict_index_is_clust(index)) {
+		ibuf_reset_free_bits(block);
+
+		page_set_max_trx_id(block, buf_block_get_page_zip(block),
+				    trx_id, &mtr);
+	}
+
+	mtr_commit(&mtr);
+
+	/* Free the non-leaf pages other than the root. */
+	do {
+		mtr_start(&mtr);
+		mtr.set_named_space(space);
+		mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+		root = btr_root_get(index, &mtr);
+
+		finished = fseg_free_step_not_header(
+			root + PAGE_HEADER + PAGE_BTR_SEG_TOP, true, &mtr);
+
+		mtr_commit(&mtr);
+	} while (!finished);
+
+	/* Free the leaf segment. It is created again in the same
+	mini-transaction that frees its inode, so that this function
+	can be executed again if the rollback is interrupted. */
+	do {
+		mtr_start(&mtr);
+		mtr.set_named_space(space);
+		mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+		root = btr_root_get(index, &mtr);
+
+		finished = fseg_free_step(
+			root + PAGE_HEADER + PAGE_BTR_SEG_LEAF, true, &mtr);
+
+		if (finished) {
+			block = fseg_create(space, dict_index_get_page(index),
+					    PAGE_HEADER + PAGE_BTR_SEG_LEAF,
+					    &mtr);
+			/* All pages but the root were just freed. */
+			ut_a(block != NULL);
+		}
+
+		mtr_commit(&mtr);
+	} while (!finished);
+}
+
 /*************************************************************//**
 Makes tree one level higher by splitting the root, and inserts
 the tuple. It is assumed that mtr contains an x-latch on the tree.
@@ -111,7 +111,9 @@ PageBulk::init()
         if (dict_index_is_sec_or_ibuf(m_index)
             && !dict_table_is_temporary(m_index->table)
 	    && page_is_leaf(new_page)) {
-		page_update_max_trx_id(new_block, NULL, m_trx_id, mtr);
+		/* The records may come from clustered index records
+		that were modified by other transactions. */
+		page_inherit_max_trx_id(new_block, NULL, m_trx_id, mtr);
 	}
 
 	m_mtr = mtr;
@@ -46,9 +46,12 @@ Created 2/17/1996 Heikki Tuuri
 #include "sync0sync.h"
 
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by all of btr_search_latches. */
 char		btr_search_enabled	= TRUE;
 
+/** Number of adaptive hash index partitions */
+ulong		btr_ahi_parts		= 8;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint		btr_search_n_succ	= 0;
@@ -56,24 +59,20 @@ ulint		btr_search_n_succ	= 0;
 ulint		btr_search_n_hash_fail	= 0;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-/** padding to prevent other memory update
-hotspots from residing on the same memory
-cache line as btr_search_latch */
-byte		btr_sea_pad1[64];
-
-/** The latch protecting the adaptive search system: this latch protects the
+/** The latches protecting the adaptive search system partitions: the
+latch of a partition protects the
 (1) positions of records on those pages where a hash index has been built.
 NOTE: It does not protect values of non-ordering fields within a record from
 being updated in-place! We can use fact (1) to perform unique searches to
 indexes. */
 
-/* We will allocate the latch from dynamic memory to get it to the
-same DRAM page as other hotspot semaphores */
-rw_lock_t*		btr_search_latch_temp;
+/* We will allocate the latches from dynamic memory, aligned and padded
+to the cache line size, so that the partitions do not share cache lines */
+rw_lock_t**		btr_search_latches;
 
-/** padding to prevent other memory update hotspots from residing on
-the same memory cache line */
-byte		btr_sea_pad2[64];
+/** Memory of the btr_search_latches, of which every latch starts on a
+cache line of its own */
+static void*		btr_search_latches_mem;
 
 /** The adaptive hash index */
 btr_search_sys_t*	btr_search_sys;
@@ -114,18 +113,21 @@ allocate a new node to the hash table, it will succeed. However, the check
 will not guarantee success. */
 static
 void
-btr_search_check_free_space_in_heap(void)
-/*=====================================*/
+btr_search_check_free_space_in_heap(
+/*================================*/
+	const dict_index_t*	index)	/*!< in: index whose adaptive hash
+					index partition is checked */
 {
 	hash_table_t*	table;
 	mem_heap_t*	heap;
+	rw_lock_t*	latch	= btr_get_search_latch(index);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_S));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 
 	heap = table->heap;
 
@@ -136,7 +138,7 @@ btr_search_check_free_space_in_heap(void)
 	if (heap->free_block == NULL) {
 		buf_block_t*	block = buf_block_alloc(NULL);
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		if (btr_search_enabled
 		    && heap->free_block == NULL) {
@@ -145,7 +147,37 @@ btr_search_check_free_space_in_heap(void)
 			buf_block_free(block);
 		}
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
+	}
+}
+
+/** Creates the hash tables of the adaptive hash index partitions.
+@param[in]	hash_size	total hash table size of all the partitions */
+static
+void
+btr_search_sys_create_tables(
+	ulint	hash_size)
+{
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		btr_search_sys->hash_tables[i] = ib_create(
+			hash_size / btr_ahi_parts, "hash_table_mutex", 0,
+			MEM_HEAP_FOR_BTR_SEARCH);
+
+#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
+		btr_search_sys->hash_tables[i]->adaptive = TRUE;
+#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+	}
+}
+
+/** Frees the hash tables of the adaptive hash index partitions. */
+static
+void
+btr_search_sys_free_tables()
+{
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		mem_heap_free(btr_search_sys->hash_tables[i]->heap);
+		hash_table_free(btr_search_sys->hash_tables[i]);
+		btr_search_sys->hash_tables[i] = NULL;
 	}
 }
 
@@ -157,24 +189,41 @@ btr_search_sys_create(
 /*==================*/
 	ulint	hash_size)	/*!< in: hash index hash table size */
 {
-	/* We allocate the search latch from dynamic memory:
+	/* We allocate the search latches from dynamic memory:
 	see above at the global variable definition */
 
-	btr_search_latch_temp = reinterpret_cast<rw_lock_t*>(
-		ut_malloc_nokey(sizeof(rw_lock_t)));
+	btr_search_latches = reinterpret_cast<rw_lock_t**>(
+		ut_malloc_nokey(btr_ahi_parts * sizeof(rw_lock_t*)));
 
-	rw_lock_create(
-		btr_search_latch_key, &btr_search_latch, SYNC_SEARCH_SYS);
+	const ulint	latch_size = ut_calc_align(
+		sizeof(rw_lock_t), CACHE_LINE_SIZE);
+
+	btr_search_latches_mem = ut_malloc_nokey(
+		(btr_ahi_parts + 1) * latch_size);
+
+	byte*	latch_mem = static_cast<byte*>(
+		ut_align(btr_search_latches_mem, CACHE_LINE_SIZE));
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		btr_search_latches[i] = reinterpret_cast<rw_lock_t*>(
+			latch_mem + i * latch_size);
+
+		rw_lock_create(btr_search_latch_key,
+			       btr_search_latches[i], SYNC_SEARCH_SYS);
+	}
 
 	btr_search_sys = reinterpret_cast<btr_search_sys_t*>(
 		ut_malloc_nokey(sizeof(btr_search_sys_t)));
 
-	btr_search_sys->hash_index = ib_create(
-		hash_size, "hash_table_mutex", 0, MEM_HEAP_FOR_BTR_SEARCH);
+	btr_search_sys->hash_tables = reinterpret_cast<hash_table_t**>(
+		ut_malloc_nokey(btr_ahi_parts * sizeof(hash_table_t*)));
 
-#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
-	btr_search_sys->hash_index->adaptive = TRUE;
-#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+	btr_search_sys->part_stats_mem = ut_zalloc_nokey(
+		(btr_ahi_parts + 1) * sizeof(btr_search_part_stats_t));
+	btr_search_sys->part_stats = static_cast<btr_search_part_stats_t*>(
+		ut_align(btr_search_sys->part_stats_mem, CACHE_LINE_SIZE));
+
+	btr_search_sys_create_tables(hash_size);
 }
 
 /** Resize hash index hash table.
@@ -184,23 +233,21 @@ void
 btr_search_sys_resize(
 	ulint	hash_size)
 {
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	if (btr_search_enabled) {
-		rw_lock_x_unlock(&btr_search_latch);
+		btr_search_x_unlock_all();
 		ib::error() << "btr_search_sys_resize failed because"
 			" hash index hash table is not empty.";
 		ut_ad(0);
 		return;
 	}
 
-	mem_heap_free(btr_search_sys->hash_index->heap);
-	hash_table_free(btr_search_sys->hash_index);
+	btr_search_sys_free_tables();
 
-	btr_search_sys->hash_index = ib_create(
-		hash_size, "hash_table_mutex", 0, MEM_HEAP_FOR_BTR_SEARCH);
+	btr_search_sys_create_tables(hash_size);
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /*****************************************************************//**
@@ -210,11 +257,20 @@ void
 btr_search_sys_free(void)
 /*=====================*/
 {
-	rw_lock_free(&btr_search_latch);
-	ut_free(btr_search_latch_temp);
-	btr_search_latch_temp = NULL;
-	mem_heap_free(btr_search_sys->hash_index->heap);
-	hash_table_free(btr_search_sys->hash_index);
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		rw_lock_free(btr_search_latches[i]);
+	}
+
+	ut_free(btr_search_latches);
+	btr_search_latches = NULL;
+
+	ut_free(btr_search_latches_mem);
+	btr_search_latches_mem = NULL;
+
+	btr_search_sys_free_tables();
+
+	ut_free(btr_search_sys->hash_tables);
+	ut_free(btr_search_sys->part_stats_mem);
 	ut_free(btr_search_sys);
 	btr_search_sys = NULL;
 }
@@ -231,7 +287,7 @@ btr_search_disable_ref_count(
 
 	ut_ad(mutex_own(&dict_sys->mutex));
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_all(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	for (index = dict_table_get_first_index(table); index;
@@ -251,11 +307,11 @@ btr_search_disable(void)
 	dict_table_t*	table;
 
 	mutex_enter(&dict_sys->mutex);
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	if (!btr_search_enabled) {
 		mutex_exit(&dict_sys->mutex);
-		rw_lock_x_unlock(&btr_search_latch);
+		btr_search_x_unlock_all();
 		return;
 	}
 
@@ -281,10 +337,12 @@ btr_search_disable(void)
 	buf_pool_clear_hash_index();
 
 	/* Clear the adaptive hash index. */
-	hash_table_clear(btr_search_sys->hash_index);
-	mem_heap_empty(btr_search_sys->hash_index->heap);
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		hash_table_clear(btr_search_sys->hash_tables[i]);
+		mem_heap_empty(btr_search_sys->hash_tables[i]->heap);
+	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /********************************************************************//**
@@ -301,11 +359,11 @@ btr_search_enable(void)
 	}
 	buf_pool_mutex_exit_all();
 
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	btr_search_enabled = TRUE;
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /*****************************************************************//**
@@ -350,27 +408,29 @@ btr_search_info_create(
 }
 
 /*****************************************************************//**
-Returns the value of ref_count. The value is protected by
-btr_search_latch.
+Returns the value of ref_count. The value is protected by the
+adaptive hash index partition latch of the index.
 @return ref_count value. */
 
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info)	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index)	/*!< in: index */
 {
-	ulint ret;
+	ulint		ret;
+	rw_lock_t*	latch	= btr_get_search_latch(index);
 
 	ut_ad(info);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_S));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 	ret = info->ref_count;
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	return(ret);
 }
@@ -390,8 +450,8 @@ btr_search_info_update_hash(
 	ulint		n_unique;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_S));
+	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	index = cursor->index;
@@ -489,8 +549,8 @@ btr_search_update_block_hash_info(
 				/*!< in: cursor */
 {
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_S));
+	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
 	ut_ad(rw_lock_own(&block->lock, RW_LOCK_S)
 	      || rw_lock_own(&block->lock, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
@@ -570,7 +630,7 @@ btr_search_update_hash_ref(
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
@@ -610,10 +670,10 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 #ifdef UNIV_SYNC_DEBUG
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-		ha_insert_for_fold(btr_search_sys->hash_index, fold,
+		ha_insert_for_fold(btr_get_search_table(index), fold,
 				   block, rec);
 
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
@@ -631,10 +691,11 @@ btr_search_info_update_slow(
 {
 	buf_block_t*	block;
 	ibool		build_index;
+	rw_lock_t*	latch	= btr_get_search_latch(cursor->index);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_S));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	block = btr_cur_get_block(cursor);
@@ -650,7 +711,7 @@ btr_search_info_update_slow(
 
 	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
 
-		btr_search_check_free_space_in_heap();
+		btr_search_check_free_space_in_heap(cursor->index);
 	}
 
 	if (cursor->flag == BTR_CUR_HASH_FAIL) {
@@ -660,11 +721,11 @@ btr_search_info_update_slow(
 		btr_search_n_hash_fail++;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 
 	if (build_index) {
@@ -689,8 +750,9 @@ btr_search_check_guess(
 	btr_cur_t*	cursor,	/*!< in: guessed cursor position */
 	ibool		can_only_compare_to_cursor_rec,
 				/*!< in: if we do not have a latch on the page
-				of cursor, but only a latch on
-				btr_search_latch, then ONLY the columns
+				of cursor, but only a latch on the
+				adaptive hash index partition, then ONLY
+				the columns
 				of the record UNDER the cursor are
 				protected, not the next or previous record
 				in the chain: we cannot look at the next or
@@ -819,12 +881,18 @@ exit_func:
 	return(success);
 }
 
+/** Notes a failed adaptive hash index search.
+@param[in,out]	info	index search info
+@param[in,out]	cursor	tree cursor
+@param[in]	part	adaptive hash index partition of the index */
 static
 void
-btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
+btr_search_failure(btr_search_t* info, btr_cur_t* cursor, ulint part)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	++btr_search_sys->part_stats[part].n_hash_fail;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -858,13 +926,16 @@ btr_search_guess_on_hash(
 					to protect the record! */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive hash
+					index partition latch of the index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	const rec_t*	rec;
 	ulint		fold;
 	index_id_t	index_id;
+	const ulint	part	= btr_search_get_part(index);
+	rw_lock_t*	latch	= btr_search_latches[part];
 #ifdef notdefined
 	btr_cur_t	cursor2;
 	btr_pcur_t	pcur;
@@ -903,29 +974,30 @@ btr_search_guess_on_hash(
 	cursor->flag = BTR_CUR_HASH;
 
 	if (!has_search_latch) {
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(latch);
 
 		if (!btr_search_enabled) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
 
-			btr_search_failure(info, cursor);
+			btr_search_failure(info, cursor, part);
 
 			return(FALSE);
 		}
 	}
 
-	ut_ad(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_X);
-	ut_ad(rw_lock_get_reader_count(&btr_search_latch) > 0);
+	ut_ad(rw_lock_get_writer(latch) != RW_LOCK_X);
+	ut_ad(rw_lock_get_reader_count(latch) > 0);
 
-	rec = (rec_t*) ha_search_and_get_data(btr_search_sys->hash_index, fold);
+	rec = (rec_t*) ha_search_and_get_data(
+		btr_search_sys->hash_tables[part], fold);
 
 	if (rec == NULL) {
 
 		if (!has_search_latch) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(info, cursor, part);
 
 		return(FALSE);
 	}
@@ -939,15 +1011,15 @@ btr_search_guess_on_hash(
 			__FILE__, __LINE__, mtr)) {
 
 			if (!has_search_latch) {
-				rw_lock_s_unlock(&btr_search_latch);
+				rw_lock_s_unlock(latch);
 			}
 
-			btr_search_failure(info, cursor);
+			btr_search_failure(info, cursor, part);
 
 			return(FALSE);
 		}
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 	}
@@ -961,7 +1033,7 @@ btr_search_guess_on_hash(
 			btr_leaf_page_release(block, latch_mode, mtr);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(info, cursor, part);
 
 		return(FALSE);
 	}
@@ -972,8 +1044,8 @@ btr_search_guess_on_hash(
 
 	/* Check the validity of the guess within the page */
 
-	/* If we only have the latch on btr_search_latch, not on the
-	page, it only protects the columns of the record the cursor
+	/* If we only have the latch on the adaptive hash index partition,
+	not on the page, it only protects the columns of the record the cursor
 	is positioned on. We cannot look at the next of the previous
 	record to determine if our guess for the cursor position is
 	right. */
@@ -986,7 +1058,7 @@ btr_search_guess_on_hash(
 			btr_leaf_page_release(block, latch_mode, mtr);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(info, cursor, part);
 
 		return(FALSE);
 	}
@@ -1033,6 +1105,8 @@ btr_search_guess_on_hash(
 #endif
 	info->last_hash_succ = TRUE;
 
+	++btr_search_sys->part_stats[part].n_hash_succ;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
 #endif
@@ -1083,30 +1157,39 @@ btr_search_drop_page_hash_index(
 	const dict_index_t*	index;
 	ulint*			offsets;
 	btr_search_t*		info;
+	rw_lock_t*		latch;
 
 	/* Do a dirty check on block->index, return if the block is
 	not in the adaptive hash index. This is to avoid acquiring
-	shared btr_search_latch for performance consideration. */
-	if (!block->index || block->index->disable_ahi) {
+	the adaptive hash index latch for performance consideration. */
+	index = block->index;
+
+	if (!index || index->disable_ahi) {
 		return;
 	}
 
+	/* The page belongs to a single index, so block->index can only
+	change between NULL and this index while we hold the page latch
+	or the block is unreachable; the partition is therefore stable. */
+	latch = btr_get_search_latch(index);
+
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 retry:
-	rw_lock_s_lock(&btr_search_latch);
-	index = block->index;
+	rw_lock_s_lock(latch);
 
-	if (UNIV_LIKELY(!index)) {
+	if (UNIV_LIKELY(!block->index)) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		return;
 	}
 
+	ut_a(block->index == index);
+
 	ut_ad(block->page.id.space() == index->space);
 	ut_a(!dict_index_is_ibuf(index));
 #ifdef UNIV_DEBUG
@@ -1130,7 +1213,7 @@ retry:
 	}
 #endif /* UNIV_DEBUG */
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
@@ -1142,10 +1225,10 @@ retry:
 	n_fields = block->curr_n_fields;
 
 	/* NOTE: The fields of block must not be accessed after
-	releasing btr_search_latch, as the index page might only
-	be s-latched! */
+	releasing the adaptive hash index latch, as the index page
+	might only be s-latched! */
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	ut_a(n_fields > 0);
 
@@ -1196,7 +1279,7 @@ next_rec:
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1211,7 +1294,7 @@ next_rec:
 		/* Someone else has meanwhile built a new hash index on the
 		page, with different parameters */
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		ut_free(folds);
 		goto retry;
@@ -1240,14 +1323,14 @@ cleanup:
 			<< ut_get_name(NULL, FALSE, index->name)
 			<< ", still " << block->n_pointers
 			<< " hash nodes remain.";
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		ut_ad(btr_search_validate());
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 #else /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
 	ut_free(folds);
@@ -1328,29 +1411,29 @@ btr_search_build_page_hash_index(
 	ut_a(!dict_index_is_ibuf(index));
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(btr_get_search_latch(index));
 
 	if (!btr_search_enabled) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 		return;
 	}
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 	page = buf_block_get_frame(block);
 
 	if (block->index && ((block->curr_n_fields != n_fields)
 			     || (block->curr_left_side != left_side))) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 
 		btr_search_drop_page_hash_index(block);
 	} else {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 	}
 
 	n_recs = page_get_n_recs(page);
@@ -1437,9 +1520,9 @@ btr_search_build_page_hash_index(
 		fold = next_fold;
 	}
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(index);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_get_search_latch(index));
 
 	if (UNIV_UNLIKELY(!btr_search_enabled)) {
 		goto exit_func;
@@ -1473,7 +1556,7 @@ btr_search_build_page_hash_index(
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(btr_get_search_latch(index));
 
 	ut_free(folds);
 	ut_free(recs);
@@ -1514,7 +1597,7 @@ btr_search_move_or_delete_hash_entries(
 	ut_ad(rw_lock_own(&(new_block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(btr_get_search_latch(index));
 
 	ut_a(!new_block->index || new_block->index == index);
 	ut_a(!block->index || block->index == index);
@@ -1523,7 +1606,7 @@ btr_search_move_or_delete_hash_entries(
 
 	if (new_block->index) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 
 		btr_search_drop_page_hash_index(block);
 
@@ -1537,7 +1620,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_fields = block->curr_n_fields;
 		new_block->left_side = left_side;
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 
 		ut_a(n_fields > 0);
 
@@ -1548,7 +1631,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(btr_get_search_latch(index));
 }
 
 /********************************************************************//**
@@ -1592,7 +1675,7 @@ btr_search_update_hash_on_delete(
 	ut_a(block->curr_n_fields > 0);
 	ut_a(!dict_index_is_ibuf(index));
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1603,7 +1686,7 @@ btr_search_update_hash_on_delete(
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_get_search_latch(index));
 
 	if (block->index) {
 		ut_a(block->index == index);
@@ -1616,7 +1699,7 @@ btr_search_update_hash_on_delete(
 		}
 	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(btr_get_search_latch(index));
 }
 
 /********************************************************************//**
@@ -1657,7 +1740,7 @@ btr_search_update_hash_node_on_insert(
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_get_search_latch(index));
 
 	if (!block->index) {
 
@@ -1670,7 +1753,7 @@ btr_search_update_hash_node_on_insert(
 	    && (cursor->n_fields == block->curr_n_fields)
 	    && !block->curr_left_side) {
 
-		table = btr_search_sys->hash_index;
+		table = btr_get_search_table(index);
 
 		if (ha_search_and_update_if_found(
 			table, cursor->fold, rec, block,
@@ -1679,9 +1762,9 @@ btr_search_update_hash_node_on_insert(
 		}
 
 func_exit:
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_get_search_latch(index));
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_get_search_latch(index));
 
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -1733,9 +1816,9 @@ btr_search_update_hash_on_insert(
 	}
 
 	ut_ad(block->page.id.space() == index->space);
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(index);
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1766,7 +1849,7 @@ btr_search_update_hash_on_insert(
 	} else {
 		if (left_side) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(btr_get_search_latch(index));
 
 			locked = TRUE;
 
@@ -1784,7 +1867,7 @@ btr_search_update_hash_on_insert(
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(btr_get_search_latch(index));
 
 			locked = TRUE;
 
@@ -1806,7 +1889,7 @@ check_next_rec:
 		if (!left_side) {
 
 			if (!locked) {
-				rw_lock_x_lock(&btr_search_latch);
+				rw_lock_x_lock(btr_get_search_latch(index));
 
 				locked = TRUE;
 
@@ -1825,7 +1908,7 @@ check_next_rec:
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(btr_get_search_latch(index));
 
 			locked = TRUE;
 
@@ -1854,18 +1937,57 @@ function_exit:
 		mem_heap_free(heap);
 	}
 	if (locked) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_get_search_latch(index));
+	}
+}
+
+/** Get the number of failed hash searches of all the adaptive hash
+index partitions.
+@return number of failed hash searches */
+
+ulint
+btr_search_get_n_hash_fail()
+{
+	ulint	n_hash_fail = 0;
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		n_hash_fail += btr_search_sys->part_stats[i].n_hash_fail;
+	}
+
+	return(n_hash_fail);
+}
+
+/** Prints info of the adaptive hash index partitions to the InnoDB
+monitor output.
+@param[in,out]	file	output stream */
+void
+btr_search_print_info(
+	FILE*	file)
+{
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		rw_lock_s_lock(btr_search_latches[i]);
+
+		fprintf(file, "AHI partition %lu: ", (ulong) i);
+		ha_print_info(file, btr_search_sys->hash_tables[i]);
+
+		rw_lock_s_unlock(btr_search_latches[i]);
+
+		fprintf(file,
+			"AHI partition %lu: %lu hash hits, %lu hash misses\n",
+			(ulong) i,
+			(ulong) btr_search_sys->part_stats[i].n_hash_succ,
+			(ulong) btr_search_sys->part_stats[i].n_hash_fail);
 	}
 }
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
-/********************************************************************//**
-Validates the search system.
+/** Validates one partition of the search system.
+@param[in]	part	adaptive hash index partition
 @return TRUE if ok */
-
+static
 ibool
-btr_search_validate(void)
-/*=====================*/
+btr_search_validate_part(
+	ulint	part)
 {
 	ha_node_t*	node;
 	ulint		n_page_dumps	= 0;
@@ -1877,31 +1999,31 @@ btr_search_validate(void)
 	ulint*		offsets		= offsets_;
 
 	/* How many cells to check before temporarily releasing
-	btr_search_latch. */
+	the partition latch. */
 	ulint		chunk_size = 10000;
 
 	rec_offs_init(offsets_);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_search_latches[part]);
 	buf_pool_mutex_enter_all();
 
-	cell_count = hash_get_n_cells(btr_search_sys->hash_index);
+	cell_count = hash_get_n_cells(btr_search_sys->hash_tables[part]);
 
 	for (i = 0; i < cell_count; i++) {
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if ((i != 0) && ((i % chunk_size) == 0)) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(btr_search_latches[part]);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(btr_search_latches[part]);
 			buf_pool_mutex_enter_all();
 
 			if (cell_count != hash_get_n_cells(
-				btr_search_sys->hash_index)) {
+				btr_search_sys->hash_tables[part])) {
 
 				cell_count = hash_get_n_cells(
-					btr_search_sys->hash_index);
+					btr_search_sys->hash_tables[part]);
 
 				if (i >= cell_count) {
 					break;
@@ -1910,7 +2032,7 @@ btr_search_validate(void)
 		}
 
 		node = (ha_node_t*)
-			hash_get_nth_cell(btr_search_sys->hash_index, i)->node;
+			hash_get_nth_cell(btr_search_sys->hash_tables[part], i)->node;
 
 		for (; node != NULL; node = node->next) {
 			const buf_block_t*	block
@@ -1946,8 +2068,8 @@ btr_search_validate(void)
 				buf_LRU_block_remove_hashed_page().
 				After that, it invokes
 				btr_search_drop_page_hash_index() to
-				remove the block from
-				btr_search_sys->hash_index. */
+				remove the block from the adaptive
+				hash index. */
 
 				ut_a(buf_block_get_state(block)
 				     == BUF_BLOCK_REMOVE_HASH);
@@ -2005,20 +2127,20 @@ btr_search_validate(void)
 	}
 
 	for (i = 0; i < cell_count; i += chunk_size) {
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if (i != 0) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(btr_search_latches[part]);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(btr_search_latches[part]);
 			buf_pool_mutex_enter_all();
 
 			if (cell_count != hash_get_n_cells(
-				btr_search_sys->hash_index)) {
+				btr_search_sys->hash_tables[part])) {
 
 				cell_count = hash_get_n_cells(
-					btr_search_sys->hash_index);
+					btr_search_sys->hash_tables[part]);
 
 				if (i >= cell_count) {
 					break;
@@ -2028,17 +2150,34 @@ btr_search_validate(void)
 
 		ulint end_index = ut_min(i + chunk_size - 1, cell_count - 1);
 
-		if (!ha_validate(btr_search_sys->hash_index, i, end_index)) {
+		if (!ha_validate(btr_search_sys->hash_tables[part],
+				 i, end_index)) {
 			ok = FALSE;
 		}
 	}
 
 	buf_pool_mutex_exit_all();
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(btr_search_latches[part]);
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
 	}
 
 	return(ok);
 }
+
+/** Validates the search system.
+@return TRUE if ok */
+ibool
+btr_search_validate()
+{
+	ibool	ok = TRUE;
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		if (!btr_search_validate_part(i)) {
+			ok = FALSE;
+		}
+	}
+
+	return(ok);
+}
 #endif /* defined UNIV_AHI_DEBUG || defined UNIV_DEBUG */
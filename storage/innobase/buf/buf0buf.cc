@@ -1662,6 +1662,30 @@ buf_pool_free_instance(
 	buf_pool->allocator.~ut_allocator();
 }
 
+/** Register the memory of all buffer pool chunks with the asynchronous
+I/O subsystem, for reading and writing pages through fixed buffers. */
+static
+void
+buf_pool_register_chunks()
+{
+	std::vector<byte*>	mem;
+	std::vector<ulint>	size;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		const buf_chunk_t*	chunk = buf_pool->chunks;
+
+		for (ulint j = 0; j < buf_pool->n_chunks; ++j, ++chunk) {
+			mem.push_back(chunk->mem);
+			size.push_back(chunk->mem_pfx.m_size);
+		}
+	}
+
+	if (!mem.empty()) {
+		os_aio_register_buffers(&mem[0], &size[0], mem.size());
+	}
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -1707,6 +1731,8 @@ buf_pool_init(
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_pool_register_chunks();
+
 	return(DB_SUCCESS);
 }
 
@@ -1719,6 +1745,8 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances)	/*!< in: numbere of instances to free */
 {
+	os_aio_unregister_buffers();
+
 	for (ulint i = 0; i < n_instances; i++) {
 		buf_pool_free_instance(buf_pool_from_array(i));
 	}
@@ -2295,12 +2323,14 @@ buf_pool_resize()
 
 	buf_resize_status("Disabling adaptive hash index.");
 
-	rw_lock_s_lock(&btr_search_latch);
+	/* btr_search_enabled is protected by all of the adaptive hash
+	index latches, so any one of them suffices for reading it. */
+	rw_lock_s_lock(btr_search_latches[0]);
 	if (btr_search_enabled) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_latches[0]);
 		btr_search_disabled = true;
 	} else {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_latches[0]);
 	}
 
 	btr_search_disable();
@@ -2434,6 +2464,9 @@ withdraw_retry:
 		return;
 	}
 
+	/* The chunks may be freed or allocated below */
+	os_aio_unregister_buffers();
+
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
@@ -2638,6 +2671,8 @@ withdraw_retry:
 	UT_DELETE(chunk_map_old);
 	buf_pool_resizing = false;
 
+	buf_pool_register_chunks();
+
 	/* Normalize other components, if the new size is too different */
 	if (srv_buf_pool_base_size > srv_buf_pool_size * 2
 	    || srv_buf_pool_base_size * 2 < srv_buf_pool_size) {
@@ -2748,7 +2783,7 @@ buf_pool_clear_hash_index(void)
 	ulint	p;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_all(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(!buf_pool_resizing);
 	ut_ad(!btr_search_enabled);
@@ -2766,7 +2801,8 @@ buf_pool_clear_hash_index(void)
 				dict_index_t*	index	= block->index;
 
 				/* We can set block->index = NULL
-				when we have an x-latch on btr_search_latch;
+				when we have x-latches on all of
+				btr_search_latches;
 				see the comment in buf0buf.h */
 
 				if (!index) {
@@ -3469,6 +3505,9 @@ buf_block_init_low(
 	block->index		= NULL;
 	block->made_dirty_with_no_latch = false;
 
+	block->mod_min_trx_id	= 0;
+	block->mod_max_trx_id	= 0;
+
 	block->n_hash_helps	= 0;
 	block->n_fields		= 1;
 	block->left_side	= TRUE;
@@ -4341,7 +4380,16 @@ got_block:
 	}
 
 	if (mode != BUF_PEEK_IF_IN_POOL) {
-		buf_page_make_young_if_needed(&fix_block->page);
+		buf_scan_ring_t*	ring = mtr->get_scan_ring();
+
+		if (ring == NULL) {
+			buf_page_make_young_if_needed(&fix_block->page);
+		} else if (access_time == 0) {
+			/* A scan does not make pages young. The pages
+			that it brings into the buffer pool are
+			recycled. */
+			buf_LRU_scan_ring_add(ring, &fix_block->page);
+		}
 	}
 
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
@@ -37,6 +37,8 @@ Created 2011/12/19
 #include "page0zip.h"
 #include "trx0sys.h"
 
+#include <map>
+
 #ifndef UNIV_HOTBACKUP
 
 /** The doublewrite buffer */
@@ -117,53 +119,216 @@ buf_dblwr_sync_datafiles()
 }
 
 /****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+Builds the path of the doublewrite file of a buffer pool instance. */
 static
 void
+buf_dblwr_file_path(
+/*================*/
+	ulint	instance_no,	/*!< in: buffer pool instance */
+	char*	path,		/*!< out: path of the file */
+	ulint	size)		/*!< in: size of path */
+{
+	ut_snprintf(path, size, "%s%c%s%lu", srv_data_home,
+		    OS_PATH_SEPARATOR, BUF_DBLWR_FILE_PREFIX, instance_no);
+}
+
+/****************************************************************//**
+Gets the size of a doublewrite file: a batch segment for each of
+BUF_FLUSH_LRU and BUF_FLUSH_LIST, and the single page flush slots.
+@return number of pages in the file */
+static
+ulint
+buf_dblwr_file_n_pages(void)
+/*========================*/
+{
+	return(2 * srv_doublewrite_batch_size
+	       + (2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE
+		  - srv_doublewrite_batch_size));
+}
+
+/****************************************************************//**
+Opens or creates the doublewrite file of a buffer pool instance and
+initializes its memory structure. An existing file is never overwritten
+here, because it can contain pages that are needed by crash recovery.
+@return true if successful */
+static
+bool
+buf_dblwr_file_init(
+/*================*/
+	buf_dblwr_file_t*	file,		/*!< out: doublewrite file */
+	ulint			instance_no)	/*!< in: buffer pool
+						instance */
+{
+	char		path[OS_FILE_MAX_PATH];
+	bool		exists;
+	os_file_type_t	type;
+	bool		success;
+	const ulint	n_pages = buf_dblwr_file_n_pages();
+	const ulint	n_slots = n_pages - 2 * srv_doublewrite_batch_size;
+
+	buf_dblwr_file_path(instance_no, path, sizeof(path));
+
+	if (!os_file_status(path, &exists, &type)) {
+		return(false);
+	}
+
+	file->handle = os_file_create(
+		innodb_data_file_key, path,
+		exists ? OS_FILE_OPEN : OS_FILE_CREATE,
+		OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+
+	if (!success) {
+		ib::error() << "Cannot open doublewrite file '" << path << "'";
+		return(false);
+	}
+
+	file->path = mem_strdup(path);
+
+	file->write_buf_unaligned = static_cast<byte*>(
+		ut_zalloc_nokey((1 + n_pages) * UNIV_PAGE_SIZE));
+
+	file->write_buf = static_cast<byte*>(
+		ut_align(file->write_buf_unaligned, UNIV_PAGE_SIZE));
+
+	/* Extend a new or smaller file with zeros, leaving the
+	existing pages intact. */
+	os_offset_t	size = os_file_get_size(file->handle);
+
+	if (size == static_cast<os_offset_t>(-1)) {
+		return(false);
+	}
+
+	ulint	page_no = static_cast<ulint>(size / UNIV_PAGE_SIZE);
+
+	if (page_no < n_pages) {
+
+		if (!os_file_write(path, file->handle,
+				   file->write_buf + page_no * UNIV_PAGE_SIZE,
+				   page_no * UNIV_PAGE_SIZE,
+				   (n_pages - page_no) * UNIV_PAGE_SIZE)
+		    || !os_file_flush(file->handle)) {
+
+			ib::error() << "Cannot extend doublewrite file '"
+				<< path << "'";
+			return(false);
+		}
+	}
+
+	for (ulint i = 0; i <= BUF_FLUSH_LIST; i++) {
+		buf_dblwr_seg_t*	seg = &file->segs[i];
+
+		mutex_create("buf_dblwr", &seg->mutex);
+
+		seg->b_event = os_event_create("dblwr_batch_event");
+		seg->first_page = i * srv_doublewrite_batch_size;
+		seg->first_free = 0;
+		seg->b_reserved = 0;
+		seg->batch_running = false;
+		seg->write_buf = file->write_buf
+			+ seg->first_page * UNIV_PAGE_SIZE;
+		seg->buf_block_arr = static_cast<buf_page_t**>(
+			ut_zalloc_nokey(srv_doublewrite_batch_size
+					* sizeof(void*)));
+	}
+
+	mutex_create("buf_dblwr", &file->mutex);
+
+	file->s_event = os_event_create("dblwr_single_event");
+	file->s_first_page = 2 * srv_doublewrite_batch_size;
+	file->s_reserved = 0;
+
+	file->in_use = static_cast<bool*>(
+		ut_zalloc_nokey(n_slots * sizeof(bool)));
+
+	file->s_block_arr = static_cast<buf_page_t**>(
+		ut_zalloc_nokey(n_slots * sizeof(void*)));
+
+	return(true);
+}
+
+/****************************************************************//**
+Frees the memory structure of a doublewrite file and closes it. */
+static
+void
+buf_dblwr_file_free(
+/*================*/
+	buf_dblwr_file_t*	file)	/*!< in/out: doublewrite file */
+{
+	if (file->path == NULL) {
+		/* buf_dblwr_file_init() failed before allocating
+		anything. */
+		return;
+	}
+
+	if (file->in_use != NULL) {
+		ut_ad(file->s_reserved == 0);
+
+		for (ulint i = 0; i <= BUF_FLUSH_LIST; i++) {
+			buf_dblwr_seg_t*	seg = &file->segs[i];
+
+			ut_ad(seg->b_reserved == 0);
+
+			os_event_destroy(seg->b_event);
+			ut_free(seg->buf_block_arr);
+			mutex_free(&seg->mutex);
+		}
+
+		os_event_destroy(file->s_event);
+		ut_free(file->in_use);
+		ut_free(file->s_block_arr);
+		mutex_free(&file->mutex);
+	}
+
+	ut_free(file->write_buf_unaligned);
+
+	os_file_close(file->handle);
+
+	ut_free(file->path);
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start.
+@return true if successful */
+static
+bool
 buf_dblwr_init(
 /*===========*/
 	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
 				header on trx sys page */
 {
-	ulint	buf_size;
-
 	buf_dblwr = static_cast<buf_dblwr_t*>(
 		ut_zalloc_nokey(sizeof(buf_dblwr_t)));
 
-	/* There are two blocks of same size in the doublewrite
-	buffer. */
-	buf_size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-
 	/* There must be atleast one buffer for single page writes
 	and one buffer for batch writes. */
 	ut_a(srv_doublewrite_batch_size > 0
-	     && srv_doublewrite_batch_size < buf_size);
-
-	mutex_create("buf_dblwr", &buf_dblwr->mutex);
-
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
-	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+	     && srv_doublewrite_batch_size
+	     < 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	buf_dblwr->block2 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
 
-	buf_dblwr->in_use = static_cast<bool*>(
-		ut_zalloc_nokey(buf_size * sizeof(bool)));
+	if (!srv_use_doublewrite_buf || srv_read_only_mode) {
+		return(true);
+	}
+
+	buf_dblwr->files = static_cast<buf_dblwr_file_t*>(
+		ut_zalloc_nokey(srv_buf_pool_instances
+				* sizeof(buf_dblwr_file_t)));
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
-		ut_malloc_nokey((1 + buf_size) * UNIV_PAGE_SIZE));
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
-			 UNIV_PAGE_SIZE));
+		++buf_dblwr->n_files;
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
-		ut_zalloc_nokey(buf_size * sizeof(void*)));
+		if (!buf_dblwr_file_init(&buf_dblwr->files[i], i)) {
+			buf_dblwr_free();
+			return(false);
+		}
+	}
+
+	return(true);
 }
 
 /****************************************************************//**
@@ -201,11 +366,11 @@ start_again:
 		/* The doublewrite buffer has already been created:
 		just read in some numbers */
 
-		buf_dblwr_init(doublewrite);
+		bool	success = buf_dblwr_init(doublewrite);
 
 		mtr_commit(&mtr);
 		buf_dblwr_being_created = FALSE;
-		return(true);
+		return(success);
 	}
 
 	ib::info() << "Doublewrite buffer not found: creating new";
@@ -340,14 +505,83 @@ start_again:
 	goto start_again;
 }
 
+/****************************************************************//**
+Reads the pages of the doublewrite files of all buffer pool instances
+into recv_sys->dblwr. Pages that were never written are skipped.
+@return number of doublewrite files found */
+static
+ulint
+buf_dblwr_load_files(void)
+/*======================*/
+{
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+	ulint		i;
+
+	/* The number of buffer pool instances may have been changed
+	since the files were written: read all of them. */
+	for (i = 0; i < MAX_BUFFER_POOLS; i++) {
+		char		path[OS_FILE_MAX_PATH];
+		bool		exists;
+		os_file_type_t	type;
+		bool		success;
+
+		buf_dblwr_file_path(i, path, sizeof(path));
+
+		if (!os_file_status(path, &exists, &type) || !exists) {
+			break;
+		}
+
+		os_file_t	file = os_file_create_simple_no_error_handling(
+			innodb_data_file_key, path, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, true, &success);
+
+		if (!success) {
+			ib::warn() << "Cannot open doublewrite file '"
+				<< path << "'";
+			break;
+		}
+
+		os_offset_t	size = os_file_get_size(file);
+		ulint		n_pages = 0;
+
+		if (size != static_cast<os_offset_t>(-1)) {
+			n_pages = static_cast<ulint>(size / UNIV_PAGE_SIZE);
+		}
+
+		if (n_pages > 0) {
+			byte*	buf = recv_dblwr.alloc(n_pages);
+
+			if (!os_file_read(file, buf, 0,
+					  n_pages * UNIV_PAGE_SIZE)) {
+				n_pages = 0;
+			}
+
+			for (ulint j = 0; j < n_pages; j++) {
+				const byte*	page = buf + j * UNIV_PAGE_SIZE;
+
+				if (!buf_page_is_zeroes(page, univ_page_size)) {
+					recv_dblwr.add(page);
+				}
+			}
+		}
+
+		os_file_close(file);
+	}
+
+	return(i);
+}
+
 /****************************************************************//**
 At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory. */
+recovery, this function loads the pages from the doublewrite files, or
+from the doublewrite buffer in the system tablespace if the files do not
+exist yet, into memory.
+@return DB_SUCCESS, or DB_ERROR if a doublewrite file cannot be opened */
 
-void
+dberr_t
 buf_dblwr_init_or_load_pages(
 /*=========================*/
 	os_file_t	file,
@@ -363,6 +597,7 @@ buf_dblwr_init_or_load_pages(
 	byte*		doublewrite;
 	ulint		space_id;
 	ulint		i;
+	bool		success;
 	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
 
 	/* We do the file i/o past the buffer pool */
@@ -381,20 +616,26 @@ buf_dblwr_init_or_load_pages(
 	doublewrite = read_buf + TRX_SYS_DOUBLEWRITE;
 
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_MAGIC)
-	    == TRX_SYS_DOUBLEWRITE_MAGIC_N) {
-		/* The doublewrite buffer has been created */
+	    != TRX_SYS_DOUBLEWRITE_MAGIC_N) {
 
-		buf_dblwr_init(doublewrite);
+		ut_free(unaligned_read_buf);
+		return(DB_SUCCESS);
+	}
 
-		block1 = buf_dblwr->block1;
-		block2 = buf_dblwr->block2;
+	/* The doublewrite buffer has been created. The files must be
+	read before buf_dblwr_init() opens them for writing. */
 
-		buf = buf_dblwr->write_buf;
-	} else {
-		ut_free(unaligned_read_buf);
-		return;
+	if (buf_dblwr_load_files() > 0) {
+		/* The doublewrite buffer in the system tablespace
+		is no longer written to. */
+		goto func_exit;
 	}
 
+	block1 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
+	block2 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+
+	buf = recv_dblwr.alloc(2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
+
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED)
 	    != TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED_N) {
 
@@ -457,7 +698,12 @@ buf_dblwr_init_or_load_pages(
 		os_file_flush(file);
 	}
 
+func_exit:
+	success = buf_dblwr_init(doublewrite);
+
 	ut_free(unaligned_read_buf);
+
+	return(success ? DB_SUCCESS : DB_ERROR);
 }
 
 /** Process and remove the double write buffer pages for all tablespaces. */
@@ -465,6 +711,8 @@ buf_dblwr_init_or_load_pages(
 void
 buf_dblwr_process(void)
 {
+	typedef std::map<std::pair<ulint, ulint>, const byte*>	newest_t;
+
 	ulint		page_no_dblwr	= 0;
 	byte*		read_buf;
 	byte*		unaligned_read_buf;
@@ -476,6 +724,27 @@ buf_dblwr_process(void)
 	read_buf = static_cast<byte*>(
 		ut_align(unaligned_read_buf, UNIV_PAGE_SIZE));
 
+	/* A page can have been written to the doublewrite files of
+	several buffer pool instances or flush types. Only the copy with
+	the highest LSN may be used for restoring it. */
+	newest_t	newest;
+
+	for (recv_dblwr_t::list::iterator i = recv_dblwr.pages.begin();
+	     i != recv_dblwr.pages.end();
+	     ++i) {
+
+		const byte*	page = *i;
+		const byte*&	copy = newest[newest_t::key_type(
+			page_get_space_id(page), page_get_page_no(page))];
+
+		if (copy == NULL
+		    || mach_read_from_8(page + FIL_PAGE_LSN)
+		    > mach_read_from_8(copy + FIL_PAGE_LSN)) {
+
+			copy = page;
+		}
+	}
+
 	for (recv_dblwr_t::list::iterator i = recv_dblwr.pages.begin();
 	     i != recv_dblwr.pages.end();
 	     ++i, ++page_no_dblwr) {
@@ -484,7 +753,9 @@ buf_dblwr_process(void)
 		ulint		page_no		= page_get_page_no(page);
 		ulint		space_id	= page_get_space_id(page);
 
-		if (!fil_tablespace_exists_in_mem(space_id)) {
+		if (newest[newest_t::key_type(space_id, page_no)] != page) {
+			/* An older copy of the page */
+		} else if (!fil_tablespace_exists_in_mem(space_id)) {
 			/* Maybe we have dropped the single-table tablespace
 			and this page once belonged to it: do nothing */
 		} else if (!fil_check_adress_in_tablespace(space_id,
@@ -585,21 +856,12 @@ buf_dblwr_free(void)
 {
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
-
-	os_event_destroy(buf_dblwr->b_event);
-	os_event_destroy(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
 
-	ut_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
-
-	ut_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	for (ulint i = 0; i < buf_dblwr->n_files; i++) {
+		buf_dblwr_file_free(&buf_dblwr->files[i]);
+	}
 
-	mutex_free(&buf_dblwr->mutex);
+	ut_free(buf_dblwr->files);
 	ut_free(buf_dblwr);
 	buf_dblwr = NULL;
 }
@@ -620,43 +882,52 @@ buf_dblwr_update(
 	}
 
 	ut_ad(!srv_read_only_mode);
+	ut_ad(bpage->buf_pool_index < buf_dblwr->n_files);
+
+	buf_dblwr_file_t*	file = &buf_dblwr->files[bpage->buf_pool_index];
 
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		{
+			buf_dblwr_seg_t*	seg = &file->segs[flush_type];
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+			mutex_enter(&seg->mutex);
 
-		buf_dblwr->b_reserved--;
+			ut_ad(seg->batch_running);
+			ut_ad(seg->b_reserved > 0);
+			ut_ad(seg->b_reserved <= seg->first_free);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
-			/* This will finish the batch. Sync data files
-			to the disk. */
-			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			seg->b_reserved--;
 
-			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
-		}
+			if (seg->b_reserved == 0) {
+				mutex_exit(&seg->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. */
+				fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+				mutex_enter(&seg->mutex);
+
+				/* We can now reuse the doublewrite memory
+				buffer: */
+				seg->first_free = 0;
+				seg->batch_running = false;
+				os_event_set(seg->b_event);
+			}
 
-		mutex_exit(&buf_dblwr->mutex);
+			mutex_exit(&seg->mutex);
+		}
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
-			const ulint size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			const ulint size = buf_dblwr_file_n_pages()
+				- file->s_first_page;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
-			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+			mutex_enter(&file->mutex);
+			for (i = 0; i < size; ++i) {
+				if (file->s_block_arr[i] == bpage) {
+					file->s_reserved--;
+					file->s_block_arr[i] = NULL;
+					file->in_use[i] = false;
 					break;
 				}
 			}
@@ -665,8 +936,8 @@ buf_dblwr_update(
 			reserved block. */
 			ut_a(i < size);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(file->s_event);
+		mutex_exit(&file->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -788,19 +1059,20 @@ buf_dblwr_write_block_to_datafile(
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
+Flushes possible buffered writes from a doublewrite batch segment to disk,
 and also wakes up the aio thread if simulated aio is used. It is very
 important to call this function after a batch of writes has been posted,
 and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
 
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	ulint		instance_no,	/*!< in: buffer pool instance */
+	buf_flush_t	flush_type)	/*!< in: BUF_FLUSH_LRU or
+					BUF_FLUSH_LIST */
 {
-	byte*		write_buf;
 	ulint		first_free;
-	ulint		len;
 
 	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
 		/* Sync the writes to the disk. */
@@ -809,17 +1081,22 @@ buf_dblwr_flush_buffered_writes(void)
 	}
 
 	ut_ad(!srv_read_only_mode);
+	ut_ad(instance_no < buf_dblwr->n_files);
+	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
+
+	buf_dblwr_file_t*	file = &buf_dblwr->files[instance_no];
+	buf_dblwr_seg_t*	seg = &file->segs[flush_type];
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	/* Write first to doublewrite buffer blocks. We use synchronous
-	aio and thus know that file write has been completed when the
+	/* Write first to the doublewrite file. We use synchronous
+	i/o and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (seg->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&seg->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -830,39 +1107,37 @@ try_again:
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
 
-	/* Disallow anyone else to post to doublewrite buffer or to
-	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	/* Disallow anyone else to post to this segment or to start
+	another batch of flushing in it. */
+	seg->batch_running = true;
+	first_free = seg->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
-
-	write_buf = buf_dblwr->write_buf;
+	mutex_exit(&seg->mutex);
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) seg->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -877,60 +1152,43 @@ try_again:
 
 		/* Check that the page as written to the doublewrite
 		buffer has sane LSN values. */
-		buf_dblwr_check_page_lsn(write_buf + len2);
+		buf_dblwr_check_page_lsn(seg->write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
+	/* Write out the whole batch with one write to the segment,
+	and flush it to disk. */
+	if (!os_file_write(file->path, file->handle, seg->write_buf,
+			   seg->first_page * UNIV_PAGE_SIZE,
+			   first_free * UNIV_PAGE_SIZE)
+	    || !os_file_flush(file->handle)) {
 
-	fil_io(OS_FILE_WRITE, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
+		ib::fatal() << "Cannot write to doublewrite file '"
+			<< file->path << "'";
 	}
 
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
-
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-
-	fil_io(OS_FILE_WRITE, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the writes have been flushed to disk now
-	and in recovery we will find them in the doublewrite buffer
-	blocks. Next do the writes to the intended positions. */
+	and in recovery we will find them in the doublewrite file.
+	Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and seg->first_free are
+	same because we have set the seg->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access seg->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting seg->first_free to a higher value.
+	If this happens and we are using seg->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == seg->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			seg->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -952,36 +1210,43 @@ buf_dblwr_add_to_batch(
 {
 	ut_a(buf_page_in_file(bpage));
 
+	const ulint		instance_no = bpage->buf_pool_index;
+	const buf_flush_t	flush_type = buf_page_get_flush_type(bpage);
+
+	ut_ad(instance_no < buf_dblwr->n_files);
+	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
+
+	buf_dblwr_seg_t*	seg
+		= &buf_dblwr->files[instance_no].segs[flush_type];
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(seg->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 
-		/* This not nearly as bad as it looks. There is only
-		page_cleaner thread which does background flushing
-		in batches therefore it is unlikely to be a contention
-		point. The only exception is when a user thread is
-		forced to do a flush batch because of a sync
-		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		/* Only the thread that runs the flush batch of this
+		type in this buffer pool instance posts to the segment,
+		so we only get here when a batch that it has written out
+		is still being completed by the IO helper threads. */
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(instance_no, flush_type);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+	byte*	p = seg->write_buf
+		+ univ_page_size.physical() * seg->first_free;
 
 	if (bpage->size.is_compressed()) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, bpage->size.physical());
@@ -1000,24 +1265,24 @@ try_again:
 		memcpy(p, ((buf_block_t*) bpage)->frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	seg->buf_block_arr[seg->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	seg->first_free++;
+	seg->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
+	ut_ad(seg->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(instance_no, flush_type);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&seg->mutex);
 }
 
 /********************************************************************//**
@@ -1036,20 +1301,18 @@ buf_dblwr_write_single_page(
 	bool		sync)	/*!< in: true if sync IO requested */
 {
 	ulint		n_slots;
-	ulint		size;
-	ulint		offset;
 	ulint		i;
 
 	ut_a(buf_page_in_file(bpage));
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
+	ut_ad(bpage->buf_pool_index < buf_dblwr->n_files);
+
+	buf_dblwr_file_t*	file = &buf_dblwr->files[bpage->buf_pool_index];
 
-	/* total number of slots available for single page flushes
-	starts from srv_doublewrite_batch_size to the end of the
-	buffer. */
-	size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	ut_a(size > srv_doublewrite_batch_size);
-	n_slots = size - srv_doublewrite_batch_size;
+	/* The slots for single page flushes follow the two batch
+	segments in the doublewrite file of the buffer pool instance. */
+	n_slots = buf_dblwr_file_n_pages() - file->s_first_page;
 
 	if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE) {
 
@@ -1066,86 +1329,78 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&file->mutex);
+	if (file->s_reserved == n_slots) {
 
 		/* All slots are reserved. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+		int64_t	sig_count = os_event_reset(file->s_event);
+		mutex_exit(&file->mutex);
+		os_event_wait_low(file->s_event, sig_count);
 
 		goto retry;
 	}
 
-	for (i = srv_doublewrite_batch_size; i < size; ++i) {
+	for (i = 0; i < n_slots; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!file->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
-	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	ut_a(i < n_slots);
+	file->in_use[i] = true;
+	file->s_reserved++;
+	file->s_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&file->mutex);
 
-	/* Lets see if we are going to write in the first or second
-	block of the doublewrite buffer. */
-	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
-	} else {
-		offset = buf_dblwr->block2 + i
-			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	}
+	const os_offset_t	offset = (file->s_first_page + i)
+		* UNIV_PAGE_SIZE;
 
 	/* We deal with compressed and uncompressed pages a little
 	differently here. In case of uncompressed pages we can
 	directly write the block to the allocated slot in the
-	doublewrite buffer in the system tablespace and then after
-	syncing the system table space we can proceed to write the page
-	in the datafile.
+	doublewrite file and then after syncing the file we can
+	proceed to write the page in the datafile.
 	In case of compressed page we first do a memcpy of the block
 	to the in-memory buffer of doublewrite before proceeding to
 	write it. This is so because we want to pad the remaining
 	bytes in the doublewrite page with zeros. */
 
+	const byte*	frame;
+
 	if (bpage->size.is_compressed()) {
-		memcpy(buf_dblwr->write_buf + univ_page_size.physical() * i,
-		       bpage->zip.data, bpage->size.physical());
+		byte*	p = file->write_buf + offset;
 
-		memset(buf_dblwr->write_buf + univ_page_size.physical() * i
-		       + bpage->size.physical(), 0x0,
+		memcpy(p, bpage->zip.data, bpage->size.physical());
+
+		memset(p + bpage->size.physical(), 0x0,
 		       univ_page_size.physical() - bpage->size.physical());
 
-		fil_io(OS_FILE_WRITE, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) (buf_dblwr->write_buf
-				+ univ_page_size.physical() * i),
-		       NULL);
+		frame = p;
 	} else {
 		/* It is a regular page. Write it directly to the
-		doublewrite buffer */
-		fil_io(OS_FILE_WRITE, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) ((buf_block_t*) bpage)->frame,
-		       NULL);
+		doublewrite file */
+		frame = ((buf_block_t*) bpage)->frame;
 	}
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	/* Now write and flush the doublewrite slot to disk */
+	if (!os_file_write(file->path, file->handle, frame, offset,
+			   univ_page_size.physical())
+	    || !os_file_flush(file->handle)) {
+
+		ib::fatal() << "Cannot write to doublewrite file '"
+			<< file->path << "'";
+	}
 
 	/* We know that the write has been flushed to disk now
-	and during recovery we will find it in the doublewrite buffer
-	blocks. Next do the write to the intended position. */
+	and during recovery we will find it in the doublewrite file.
+	Next do the write to the intended position. */
 	buf_dblwr_write_block_to_datafile(bpage, sync);
 }
 #endif /* !UNIV_HOTBACKUP */
@@ -27,7 +27,9 @@ Created April 08, 2011 Vasil Dimov
 
 #include "buf0buf.h"
 #include "buf0dump.h"
+#include "buf0rea.h"
 #include "dict0dict.h"
+#include "mach0data.h"
 #include "os0file.h"
 #include "os0thread.h"
 #include "srv0srv.h"
@@ -36,6 +38,7 @@ Created April 08, 2011 Vasil Dimov
 #include "ut0byte.h"
 
 #include <algorithm>
+#include <vector>
 
 enum status_severity {
 	STATUS_INFO,
@@ -44,6 +47,7 @@ enum status_severity {
 };
 
 #define SHUTTING_DOWN()	(srv_shutdown_state != SRV_SHUTDOWN_NONE)
+#define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
 /* Flags that tell the buffer pool dump/load thread which action should it
 take after being waked up. */
@@ -63,6 +67,26 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/* A binary dump starts with a header of BUF_DUMP_HEADER_SIZE bytes: the
+magic number BUF_DUMP_MAGIC ("IBPD") and BUF_DUMP_VERSION in 4 bytes each,
+and the number of entries in 8 bytes. Each entry is a buf_dump_t in 8
+bytes. All numbers are stored most significant byte first. */
+#define BUF_DUMP_MAGIC			0x49425044UL
+#define BUF_DUMP_VERSION		1
+#define BUF_DUMP_HEADER_SIZE		16
+
+/* Number of entries that are converted at a time when writing a
+binary dump */
+#define BUF_DUMP_BINARY_BATCH		1024UL
+
+/* Maximum number of pages in a batch read by one buffer pool load
+thread */
+#define BUF_LOAD_TASK_PAGES		256
+
+/* Fingerprint of the file name and the pages of the last successful
+periodic dump, or 0 */
+static ib_uint64_t	buf_dump_last_fingerprint = 0;
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -162,27 +186,104 @@ buf_load_status(
 	va_end(ap);
 }
 
+/*****************************************************************//**
+Write the entries of a buffer pool dump in the text format, one
+"space,page" line per page.
+@return 0 or errno */
+static
+int
+buf_dump_write_text(
+/*================*/
+	FILE*			f,	/*!< in/out: dump file */
+	const buf_dump_t*	dump,	/*!< in: entries of one buffer pool */
+	ulint			n_pages,/*!< in: number of entries */
+	ulint			pool,	/*!< in: buffer pool instance */
+	ibool			obey_shutdown)/*!< in: quit if we are in a
+					shutting down state */
+{
+	for (ulint j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
+		if (fprintf(f, ULINTPF "," ULINTPF "\n",
+			    BUF_DUMP_SPACE(dump[j]),
+			    BUF_DUMP_PAGE(dump[j])) < 0) {
+			return(errno);
+		}
+
+		if (j % 128 == 0) {
+			buf_dump_status(
+				STATUS_INFO,
+				"Dumping buffer pool"
+				" " ULINTPF "/" ULINTPF ","
+				" page " ULINTPF "/" ULINTPF,
+				pool + 1, srv_buf_pool_instances,
+				j + 1, n_pages);
+		}
+	}
+
+	return(0);
+}
+
+/*****************************************************************//**
+Write the entries of a buffer pool dump in the binary format, 8 bytes
+per page, most significant byte first.
+@return 0 or errno */
+static
+int
+buf_dump_write_binary(
+/*==================*/
+	FILE*			f,	/*!< in/out: dump file */
+	const buf_dump_t*	dump,	/*!< in: entries of one buffer pool */
+	ulint			n_pages,/*!< in: number of entries */
+	ibool			obey_shutdown)/*!< in: quit if we are in a
+					shutting down state */
+{
+	byte	buf[BUF_DUMP_BINARY_BATCH * 8];
+
+	for (ulint j = 0; j < n_pages && !SHOULD_QUIT();
+	     j += BUF_DUMP_BINARY_BATCH) {
+
+		ulint	n = ut_min(n_pages - j, BUF_DUMP_BINARY_BATCH);
+
+		for (ulint k = 0; k < n; k++) {
+			mach_write_to_8(buf + k * 8, dump[j + k]);
+		}
+
+		if (fwrite(buf, 8, n, f) != n) {
+			return(errno);
+		}
+	}
+
+	return(0);
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_dump_status will be set accordingly, see buf_dump_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+A periodic dump is written in the binary format, and it is skipped if the
+same pages were dumped to the same file by the previous periodic dump. */
 static
 void
 buf_dump(
 /*=====*/
-	ibool	obey_shutdown)	/*!< in: quit if we are in a shutting down
+	ibool	obey_shutdown,	/*!< in: quit if we are in a shutting down
 				state */
+	bool	periodic)	/*!< in: whether this is a periodic dump
+				requested by innodb_buffer_pool_dump_interval */
 {
-#define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
-
-	char	full_filename[OS_FILE_MAX_PATH];
-	char	tmp_filename[OS_FILE_MAX_PATH];
-	char	now[32];
-	FILE*	f;
-	ulint	i;
-	int	ret;
+	char		full_filename[OS_FILE_MAX_PATH];
+	char		tmp_filename[OS_FILE_MAX_PATH];
+	char		now[32];
+	FILE*		f;
+	ulint		i;
+	int		ret;
+	buf_dump_t*	dumps[MAX_BUFFER_POOLS];
+	ulint		n_dumped[MAX_BUFFER_POOLS];
+	ulint		n_total = 0;
+	ib_uint64_t	fingerprint;
+	const status_severity	done_severity
+		= periodic ? STATUS_INFO : STATUS_NOTICE;
 
 	ut_snprintf(full_filename, sizeof(full_filename),
 		    "%s%c%s", srv_data_home, OS_PATH_SEPARATOR,
@@ -191,19 +292,13 @@ buf_dump(
 	ut_snprintf(tmp_filename, sizeof(tmp_filename),
 		    "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_NOTICE, "Dumping buffer pool(s) to %s",
-			full_filename);
+	fingerprint = ut_fold_string(full_filename);
 
-	f = fopen(tmp_filename, "w");
-	if (f == NULL) {
-		buf_dump_status(STATUS_ERR,
-				"Cannot open '%s' for writing: %s",
-				tmp_filename, strerror(errno));
-		return;
-	}
-	/* else */
+	memset(dumps, 0, sizeof dumps);
+	memset(n_dumped, 0, sizeof n_dumped);
 
-	/* walk through each buffer pool */
+	/* Collect the hottest pages of each buffer pool first, so that
+	an unchanged periodic dump can be skipped without writing. */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
@@ -240,13 +335,11 @@ buf_dump(
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
-			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
 					(ulint) (n_pages * sizeof(*dump)),
 					strerror(errno));
-			/* leave tmp_filename to exist */
-			return;
+			goto func_exit;
 		}
 
 		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
@@ -263,32 +356,79 @@ buf_dump(
 
 		buf_pool_mutex_exit(buf_pool);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
-			if (ret < 0) {
-				ut_free(dump);
-				fclose(f);
-				buf_dump_status(STATUS_ERR,
-						"Cannot write to '%s': %s",
-						tmp_filename, strerror(errno));
-				/* leave tmp_filename to exist */
-				return;
-			}
+		/* The order within the LRU list changes all the time,
+		so the fingerprint only depends on the set of pages. */
+		for (j = 0; j < n_pages; j++) {
+			fingerprint += ut_fold_ull(dump[j]);
+		}
 
-			if (j % 128 == 0) {
-				buf_dump_status(
-					STATUS_INFO,
-					"Dumping buffer pool"
-					" " ULINTPF "/" ULINTPF ","
-					" page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
-			}
+		dumps[i] = dump;
+		n_dumped[i] = n_pages;
+		n_total += n_pages;
+	}
+
+	if (SHOULD_QUIT()) {
+		goto func_exit;
+	}
+
+	if (periodic) {
+		if (fingerprint == buf_dump_last_fingerprint) {
+			buf_dump_status(STATUS_INFO,
+					"Buffer pool(s) unchanged since"
+					" the last dump to %s",
+					full_filename);
+			goto func_exit;
 		}
+	} else {
+		/* The next periodic dump must rewrite the file in
+		the binary format. */
+		buf_dump_last_fingerprint = 0;
+	}
 
-		ut_free(dump);
+	buf_dump_status(done_severity, "Dumping buffer pool(s) to %s",
+			full_filename);
+
+	f = fopen(tmp_filename, periodic ? "wb" : "w");
+	if (f == NULL) {
+		buf_dump_status(STATUS_ERR,
+				"Cannot open '%s' for writing: %s",
+				tmp_filename, strerror(errno));
+		goto func_exit;
+	}
+	/* else */
+
+	ret = 0;
+
+	if (periodic) {
+		byte	header[BUF_DUMP_HEADER_SIZE];
+
+		mach_write_to_4(header, BUF_DUMP_MAGIC);
+		mach_write_to_4(header + 4, BUF_DUMP_VERSION);
+		mach_write_to_8(header + 8, n_total);
+
+		if (fwrite(header, sizeof header, 1, f) != 1) {
+			ret = errno;
+		}
+	}
+
+	/* walk through each buffer pool */
+	for (i = 0; i < srv_buf_pool_instances && ret == 0
+		     && !SHOULD_QUIT(); i++) {
+
+		ret = periodic
+			? buf_dump_write_binary(
+				f, dumps[i], n_dumped[i], obey_shutdown)
+			: buf_dump_write_text(
+				f, dumps[i], n_dumped[i], i, obey_shutdown);
+	}
+
+	if (ret != 0) {
+		fclose(f);
+		buf_dump_status(STATUS_ERR,
+				"Cannot write to '%s': %s",
+				tmp_filename, strerror(ret));
+		/* leave tmp_filename to exist */
+		goto func_exit;
 	}
 
 	ret = fclose(f);
@@ -296,17 +436,22 @@ buf_dump(
 		buf_dump_status(STATUS_ERR,
 				"Cannot close '%s': %s",
 				tmp_filename, strerror(errno));
-		return;
+		goto func_exit;
 	}
 	/* else */
 
+	if (SHOULD_QUIT()) {
+		/* leave tmp_filename to exist */
+		goto func_exit;
+	}
+
 	ret = unlink(full_filename);
 	if (ret != 0 && errno != ENOENT) {
 		buf_dump_status(STATUS_ERR,
 				"Cannot delete '%s': %s",
 				full_filename, strerror(errno));
 		/* leave tmp_filename to exist */
-		return;
+		goto func_exit;
 	}
 	/* else */
 
@@ -317,23 +462,33 @@ buf_dump(
 				tmp_filename, full_filename,
 				strerror(errno));
 		/* leave tmp_filename to exist */
-		return;
+		goto func_exit;
 	}
 	/* else */
 
 	/* success */
 
+	if (periodic) {
+		buf_dump_last_fingerprint = fingerprint;
+	}
+
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_NOTICE,
+	buf_dump_status(done_severity,
 			"Buffer pool(s) dump completed at %s", now);
+
+func_exit:
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		ut_free(dumps[i]);
+	}
 }
 
 /*****************************************************************//**
 Artificially delay the buffer pool loading if necessary. The idea of
 this function is to prevent hogging the server with IO and slowing down
-too much normal client queries. */
-UNIV_INLINE
+too much normal client queries. The caller must serialize the calls
+when several threads are loading. */
+static
 void
 buf_load_throttle_if_needed(
 /*========================*/
@@ -342,10 +497,13 @@ buf_load_throttle_if_needed(
 					throttling is needed, we do the check
 					every srv_io_capacity IO ops. */
 	ulint*	last_activity_count,
+	ulint	n_io_before,		/*!< in: number of IO ops done since
+					buffer pool load has started, before
+					the last batch */
 	ulint	n_io)			/*!< in: number of IO ops done since
 					buffer pool load has started */
 {
-	if (n_io % srv_io_capacity < srv_io_capacity - 1) {
+	if (n_io_before / srv_io_capacity == n_io / srv_io_capacity) {
 		return;
 	}
 
@@ -395,9 +553,234 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** A batch of pages of one tablespace that belong to one buffer pool
+instance, to be read by one of the buffer pool load threads */
+struct buf_load_task_t {
+	/** space id */
+	ulint		space;
+	/** index of the first page number in buf_load_ctx_t::page_nos */
+	ulint		first;
+	/** number of pages */
+	ulint		n_pages;
+};
+
+typedef std::vector<buf_load_task_t> buf_load_tasks_t;
+
+/** Shared state of the threads of a buffer pool load */
+struct buf_load_ctx_t {
+	/** page numbers, sorted by space id, buffer pool instance and
+	page number */
+	const ulint*		page_nos;
+	/** batches of page_nos to read */
+	const buf_load_tasks_t*	tasks;
+	/** number of pages to load */
+	ulint			n_pages;
+	/** index of the next task to pick, incremented atomically */
+	ulint			next;
+	/** number of pages processed, incremented atomically */
+	ulint			n_done;
+	/** whether the load was aborted on request */
+	bool			aborted;
+	/** mutex protecting the throttling state below */
+	ib_mutex_t		mutex;
+	/** throttling state, see buf_load_throttle_if_needed() */
+	ulint			last_check_time;
+	ulint			last_activity_count;
+	ulint			n_io;
+};
+
+/** A thread of a buffer pool load, other than the dump/load thread */
+struct buf_load_thread_t {
+	/** shared state */
+	buf_load_ctx_t*		ctx;
+	/** event set when the thread has finished */
+	os_event_t		event;
+};
+
+/** Compare dump entries by space id, buffer pool instance and page
+number, so that pages of one tablespace that belong to the same buffer
+pool instance are adjacent. A 64-page extent always maps to one
+instance, so runs of adjacent pages are preserved. */
+struct buf_load_cmp_t {
+	bool operator()(buf_dump_t a, buf_dump_t b) const
+	{
+		if (BUF_DUMP_SPACE(a) != BUF_DUMP_SPACE(b)) {
+			return(a < b);
+		}
+
+		ulint	pool_a = buf_pool_index(buf_pool_get(page_id_t(
+			BUF_DUMP_SPACE(a), BUF_DUMP_PAGE(a))));
+		ulint	pool_b = buf_pool_index(buf_pool_get(page_id_t(
+			BUF_DUMP_SPACE(b), BUF_DUMP_PAGE(b))));
+
+		return(pool_a != pool_b ? pool_a < pool_b : a < b);
+	}
+};
+
+/** Read the pages of buffer pool load tasks until there are no more
+tasks, or the load is aborted or the server is shutting down.
+@param[in,out]	ctx		shared state of the load
+@param[in]	report		whether to update
+innodb_buffer_pool_load_status */
+static
+void
+buf_load_worker(
+	buf_load_ctx_t*	ctx,
+	bool		report)
+{
+	while (!ctx->aborted && !SHUTTING_DOWN()) {
+
+		if (buf_load_abort_flag) {
+			ctx->aborted = true;
+			break;
+		}
+
+		ulint	i = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (i >= ctx->tasks->size()) {
+			break;
+		}
+
+		const buf_load_task_t&	task = (*ctx->tasks)[i];
+
+		buf_read_load_pages(task.space, ctx->page_nos + task.first,
+				    task.n_pages);
+
+		ulint	n_done = os_atomic_increment_ulint(
+			&ctx->n_done, task.n_pages);
+
+		if (report) {
+			buf_load_status(STATUS_INFO,
+					"Loaded " ULINTPF "/" ULINTPF " pages",
+					n_done, ctx->n_pages);
+		}
+
+		mutex_enter(&ctx->mutex);
+
+		ulint	n_io_before = ctx->n_io;
+
+		ctx->n_io += task.n_pages;
+
+		buf_load_throttle_if_needed(
+			&ctx->last_check_time, &ctx->last_activity_count,
+			n_io_before, ctx->n_io);
+
+		mutex_exit(&ctx->mutex);
+	}
+}
+
+/*****************************************************************//**
+Function run by a thread of a buffer pool load, other than the
+dump/load thread.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+buf_load_thread(
+/*============*/
+	void*	arg)	/*!< in/out: buf_load_thread_t */
+{
+	buf_load_thread_t*	thr = static_cast<buf_load_thread_t*>(arg);
+
+	buf_load_worker(thr->ctx, false);
+
+	os_event_set(thr->event);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Read the pages of a sorted buffer pool dump using
+innodb_buffer_pool_load_threads threads, including the calling one.
+@param[in]	dump	dump entries, sorted with buf_load_cmp_t
+@param[in]	dump_n	number of entries
+@return true if the load was aborted on request */
+static
+bool
+buf_load_pages(
+	const buf_dump_t*	dump,
+	ulint			dump_n)
+{
+	buf_load_ctx_t		ctx;
+	buf_load_tasks_t	tasks;
+	buf_load_thread_t*	thr;
+	ulint*			page_nos;
+	ulint			n_threads;
+
+	page_nos = static_cast<ulint*>(
+		ut_malloc_nokey(dump_n * sizeof *page_nos));
+
+	/* Split the dump into batches of pages of one tablespace
+	and one buffer pool instance. */
+	for (ulint i = 0; i < dump_n; i++) {
+		const ulint	space = BUF_DUMP_SPACE(dump[i]);
+		const ulint	page_no = BUF_DUMP_PAGE(dump[i]);
+
+		page_nos[i] = page_no;
+
+		if (i > 0
+		    && space == tasks.back().space
+		    && tasks.back().n_pages < BUF_LOAD_TASK_PAGES
+		    && buf_pool_get(page_id_t(space, page_no))
+		    == buf_pool_get(page_id_t(
+			    space, page_nos[i - 1]))) {
+
+			tasks.back().n_pages++;
+		} else {
+			buf_load_task_t	task;
+
+			task.space = space;
+			task.first = i;
+			task.n_pages = 1;
+
+			tasks.push_back(task);
+		}
+	}
+
+	ctx.page_nos = page_nos;
+	ctx.tasks = &tasks;
+	ctx.n_pages = dump_n;
+	ctx.next = 0;
+	ctx.n_done = 0;
+	ctx.aborted = false;
+	ctx.last_check_time = 0;
+	ctx.last_activity_count = 0;
+	ctx.n_io = 0;
+
+	mutex_create("buf_load_mutex", &ctx.mutex);
+
+	n_threads = ut_min(static_cast<ulint>(srv_buf_pool_load_threads),
+			   tasks.size());
+
+	thr = static_cast<buf_load_thread_t*>(
+		ut_zalloc_nokey(n_threads * sizeof *thr));
+
+	for (ulint k = 1; k < n_threads; k++) {
+		thr[k].ctx = &ctx;
+		thr[k].event = os_event_create(0);
+
+		os_thread_create(buf_load_thread, &thr[k], NULL);
+	}
+
+	buf_load_worker(&ctx, true);
+
+	for (ulint k = 1; k < n_threads; k++) {
+		os_event_wait(thr[k].event);
+		os_event_destroy(thr[k].event);
+	}
+
+	ut_free(thr);
+	mutex_free(&ctx.mutex);
+	ut_free(page_nos);
+
+	return(ctx.aborted);
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
-innodb_buffer_pool_filename. If any errors occur then the value of
+innodb_buffer_pool_filename. The file can be in the text format written
+by innodb_buffer_pool_dump_now and at shutdown, or in the binary format
+written by the periodic dumps. If any errors occur then the value of
 innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
 The dump filename can be specified by (relative to srv_data_home):
 SET GLOBAL innodb_buffer_pool_filename='filename'; */
@@ -416,6 +799,8 @@ buf_load()
 	ulint		space_id;
 	ulint		page_no;
 	int		fscanf_ret;
+	byte		header[BUF_DUMP_HEADER_SIZE];
+	bool		binary;
 
 	/* Ignore any leftovers from before */
 	buf_load_abort_flag = FALSE;
@@ -427,7 +812,7 @@ buf_load()
 	buf_load_status(STATUS_NOTICE,
 			"Loading buffer pool(s) from %s", full_filename);
 
-	f = fopen(full_filename, "r");
+	f = fopen(full_filename, "rb");
 	if (f == NULL) {
 		buf_load_status(STATUS_ERR,
 				"Cannot open '%s' for reading: %s",
@@ -436,28 +821,49 @@ buf_load()
 	}
 	/* else */
 
-	/* First scan the file to estimate how many entries are in it.
-	This file is tiny (approx 500KB per 1GB buffer pool), reading it
-	two times is fine. */
-	dump_n = 0;
-	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
-	       && !SHUTTING_DOWN()) {
-		dump_n++;
-	}
+	binary = fread(header, sizeof header, 1, f) == 1
+		&& mach_read_from_4(header) == BUF_DUMP_MAGIC;
 
-	if (!SHUTTING_DOWN() && !feof(f)) {
-		/* fscanf() returned != 2 */
-		const char*	what;
-		if (ferror(f)) {
-			what = "reading";
-		} else {
-			what = "parsing";
+	if (binary) {
+		if (mach_read_from_4(header + 4) != BUF_DUMP_VERSION) {
+			fclose(f);
+			buf_load_status(STATUS_ERR,
+					"Unknown format version " ULINTPF
+					" of '%s', unable to load buffer pool",
+					mach_read_from_4(header + 4),
+					full_filename);
+			return;
 		}
-		fclose(f);
-		buf_load_status(STATUS_ERR, "Error %s '%s',"
-				" unable to load buffer pool (stage 1)",
-				what, full_filename);
-		return;
+
+		dump_n = static_cast<ulint>(mach_read_from_8(header + 8));
+	} else {
+		rewind(f);
+
+		/* First scan the file to estimate how many entries are
+		in it. This file is tiny (approx 500KB per 1GB buffer
+		pool), reading it two times is fine. */
+		dump_n = 0;
+		while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no)
+		       == 2 && !SHUTTING_DOWN()) {
+			dump_n++;
+		}
+
+		if (!SHUTTING_DOWN() && !feof(f)) {
+			/* fscanf() returned != 2 */
+			const char*	what;
+			if (ferror(f)) {
+				what = "reading";
+			} else {
+				what = "parsing";
+			}
+			fclose(f);
+			buf_load_status(STATUS_ERR, "Error %s '%s',"
+					" unable to load buffer pool (stage 1)",
+					what, full_filename);
+			return;
+		}
+
+		rewind(f);
 	}
 
 	/* If dump is larger than the buffer pool(s), then we ignore the
@@ -481,9 +887,28 @@ buf_load()
 		return;
 	}
 
-	rewind(f);
-
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+		if (binary) {
+			byte	entry[8];
+
+			if (fread(entry, sizeof entry, 1, f) != 1) {
+				if (feof(f)) {
+					break;
+				}
+
+				ut_free(dump);
+				fclose(f);
+				buf_load_status(STATUS_ERR,
+						"Error reading '%s', unable"
+						" to load buffer pool",
+						full_filename);
+				return;
+			}
+
+			dump[i] = mach_read_from_8(entry);
+			continue;
+		}
+
 		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
 				    &space_id, &page_no);
 
@@ -535,70 +960,24 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
+	if (SHUTTING_DOWN()) {
+		ut_free(dump);
+		return;
 	}
 
-	ulint		last_check_time = 0;
-	ulint		last_activity_cnt = 0;
-
-	/* Avoid calling the expensive fil_space_get_page_size() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
-	bool		found;
-	page_size_t	page_size(fil_space_get_page_size(
-					cur_space_id, &found));
+	std::sort(dump, dump + dump_n, buf_load_cmp_t());
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-
-		/* space_id for this iteration of the loop */
-		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
-
-		if (this_space_id != cur_space_id) {
-			cur_space_id = this_space_id;
-
-			const page_size_t	cur_page_size(
-				fil_space_get_page_size(cur_space_id, &found));
-
-			if (found) {
-				page_size.copy_from(cur_page_size);
-			}
-		}
+	bool	aborted = buf_load_pages(dump, dump_n);
 
-		if (!found) {
-			continue;
-		}
-
-		buf_read_page_background(
-			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
-
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
-
-		if (i % 128 == 0) {
-			buf_load_status(STATUS_INFO,
-					"Loaded " ULINTPF "/" ULINTPF " pages",
-					i + 1, dump_n);
-		}
+	ut_free(dump);
 
-		if (buf_load_abort_flag) {
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_NOTICE,
+	if (aborted) {
+		buf_load_abort_flag = FALSE;
+		buf_load_status(STATUS_NOTICE,
 				"Buffer pool(s) load aborted on request");
-			return;
-		}
-
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
+		return;
 	}
 
-	ut_free(dump);
-
 	ut_sprintf_timestamp(now);
 
 	buf_load_status(STATUS_NOTICE,
@@ -644,13 +1023,34 @@ DECLARE_THREAD(buf_dump_thread)(
 		buf_load();
 	}
 
+	ulint	last_dump_time = ut_time_ms();
+
 	while (!SHUTTING_DOWN()) {
 
-		os_event_wait(srv_buf_dump_event);
+		ulint	interval = srv_buf_pool_dump_interval * 1000;
+
+		if (interval == 0) {
+			os_event_wait(srv_buf_dump_event);
+		} else {
+			ulint	elapsed = ut_time_ms() - last_dump_time;
+
+			if (elapsed < interval) {
+				os_event_wait_time(
+					srv_buf_dump_event,
+					(interval - elapsed) * 1000);
+			}
+
+			if (!SHUTTING_DOWN()
+			    && ut_time_ms() - last_dump_time >= interval) {
+				buf_dump(TRUE /* quit on shutdown */,
+					 true /* periodic */);
+				last_dump_time = ut_time_ms();
+			}
+		}
 
 		if (buf_dump_should_start) {
 			buf_dump_should_start = FALSE;
-			buf_dump(TRUE /* quit on shutdown */);
+			buf_dump(TRUE /* quit on shutdown */, false);
 		}
 
 		if (buf_load_should_start) {
@@ -663,7 +1063,7 @@ DECLARE_THREAD(buf_dump_thread)(
 
 	if (srv_buffer_pool_dump_at_shutdown && srv_fast_shutdown != 2) {
 		buf_dump(FALSE /* ignore shutdown down flag,
-		keep going even if we are in a shutdown state */);
+		keep going even if we are in a shutdown state */, false);
 	}
 
 	srv_buf_dump_thread_active = FALSE;
@@ -67,6 +67,12 @@ mysql_pfs_key_t page_cleaner_thread_key;
 /** Event to synchronise with the flushing. */
 os_event_t	buf_flush_event;
 
+#ifdef UNIV_DEBUG
+/** Value of innodb_page_cleaner_disabled_debug: whether the page cleaner
+leaves the dirty pages alone */
+my_bool		innodb_page_cleaner_disabled_debug;
+#endif /* UNIV_DEBUG */
+
 /** State for page cleaner array slot */
 enum page_cleaner_state_t {
 	/** Not requested any yet.
@@ -1088,7 +1094,9 @@ buf_flush_page(
 				/* avoiding deadlock possibility involves
 				doublewrite buffer, should flush it, because
 				it might hold the another block->lock. */
-				buf_dblwr_flush_buffered_writes();
+				buf_dblwr_flush_buffered_writes(
+					buf_pool_index(buf_pool),
+					BUF_FLUSH_LIST);
 			} else {
 				buf_dblwr_sync_datafiles();
 			}
@@ -1830,7 +1838,8 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(
+			buf_pool_index(buf_pool), flush_type);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2698,6 +2707,15 @@ DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
 	int64_t		sig_count = os_event_reset(buf_flush_event);
 	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 
+#ifdef UNIV_DEBUG
+		if (innodb_page_cleaner_disabled_debug) {
+			/* Keep the pages dirty, so that a test can
+			have them recovered from the redo log. */
+			os_thread_sleep(100000);
+			continue;
+		}
+#endif /* UNIV_DEBUG */
+
 		/* The page_cleaner skips sleep if the server is
 		idle and there are no pending IOs in the buffer pool
 		and there is work to do. */
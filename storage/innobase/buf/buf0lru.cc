@@ -1776,6 +1776,131 @@ buf_LRU_make_block_young(
 	buf_LRU_add_block_low(bpage, FALSE);
 }
 
+/** Pages that a scan has accessed for the first time */
+struct buf_scan_ring_t {
+	/** maximum number of pages in the ring */
+	ulint		size;
+	/** number of pages in the ring */
+	ulint		n_pages;
+	/** position of the oldest page, once the ring is full */
+	ulint		oldest;
+	/** space id in the high 32 bits and page number in the low
+	32 bits of each page */
+	ib_uint64_t*	pages;
+};
+
+/** Create a scan ring. The pages that a scan accesses for the first
+time are recorded in the ring, and once the ring is full, the oldest of
+them is evicted from the buffer pool if nobody else has made it young
+in the meantime. A large scan thus keeps recycling about n_pages
+buffer pool blocks instead of pushing other pages out of the LRU list.
+@param[in]	n_pages		number of pages in the ring
+@return scan ring, to be freed with buf_LRU_scan_ring_free() */
+buf_scan_ring_t*
+buf_LRU_scan_ring_create(
+	ulint		n_pages)
+{
+	ut_ad(n_pages > 0);
+
+	buf_scan_ring_t*	ring = static_cast<buf_scan_ring_t*>(
+		ut_malloc_nokey(sizeof *ring));
+
+	ring->size = n_pages;
+	ring->n_pages = 0;
+	ring->oldest = 0;
+	ring->pages = static_cast<ib_uint64_t*>(
+		ut_malloc_nokey(n_pages * sizeof *ring->pages));
+
+	return(ring);
+}
+
+/** Evict a page that was recorded in a scan ring, unless it has been
+made young, is dirty or is in use.
+@param[in]	page	space id and page number
+@return whether the page was evicted */
+static
+bool
+buf_LRU_scan_ring_evict(
+	ib_uint64_t	page)
+{
+	const page_id_t	page_id(ulint(page >> 32), ulint(page & 0xFFFFFFFF));
+	buf_pool_t*	buf_pool = buf_pool_get(page_id);
+	rw_lock_t*	hash_lock;
+	bool		freed = false;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	buf_page_t*	bpage = buf_page_hash_get_s_locked(
+		buf_pool, page_id, &hash_lock);
+
+	if (bpage != NULL) {
+		BPageMutex*	mutex = buf_page_get_mutex(bpage);
+
+		mutex_enter(mutex);
+
+		rw_lock_s_unlock(hash_lock);
+
+		/* If another thread has accessed the page often enough
+		to make it young, it belongs to the working set. While
+		the LRU list is too short to have an old part, no page
+		is old. */
+		bool	evict = (buf_page_is_old(bpage)
+				 || buf_pool->LRU_old == NULL)
+			&& buf_flush_ready_for_replace(bpage);
+
+		mutex_exit(mutex);
+
+		if (evict) {
+			freed = buf_LRU_free_page(bpage, true);
+		}
+	}
+
+	buf_pool_mutex_exit(buf_pool);
+
+	return(freed);
+}
+
+/** Evict the pages remaining in a scan ring, and free the ring.
+@param[in,out]	ring	scan ring created by buf_LRU_scan_ring_create() */
+void
+buf_LRU_scan_ring_free(
+	buf_scan_ring_t*	ring)
+{
+	for (ulint i = 0; i < ring->n_pages; i++) {
+		buf_LRU_scan_ring_evict(ring->pages[i]);
+	}
+
+	ut_free(ring->pages);
+	ut_free(ring);
+}
+
+/** Record the first access to a page by a scan. If the ring is full,
+evict the oldest page of the ring. The caller must not hold any buffer
+pool mutex.
+@param[in,out]	ring	scan ring
+@param[in]	bpage	page that was accessed for the first time */
+void
+buf_LRU_scan_ring_add(
+	buf_scan_ring_t*	ring,
+	const buf_page_t*	bpage)
+{
+	const ib_uint64_t	page = ut_ull_create(
+		bpage->id.space(), bpage->id.page_no());
+
+	if (ring->n_pages < ring->size) {
+		ring->pages[ring->n_pages++] = page;
+		return;
+	}
+
+	buf_LRU_scan_ring_evict(ring->pages[ring->oldest]);
+
+	ring->pages[ring->oldest] = page;
+
+	if (++ring->oldest == ring->size) {
+		ring->oldest = 0;
+	}
+}
+
 /******************************************************************//**
 Moves a block to the end of the LRU list. */
 
@@ -458,6 +458,77 @@ buf_read_page_background(
 	return(count > 0);
 }
 
+/** Issues background read requests for pages of one tablespace that a
+buffer pool load wants to read in. The requests are posted without waking
+the i/o handler threads until the whole batch has been queued, so that
+requests for adjacent pages can be merged or submitted together.
+@param[in]	space		space id
+@param[in]	page_nos	array of page numbers to read, in ascending
+order
+@param[in]	n_pages		number of page numbers in the array
+@return number of page read requests issued */
+ulint
+buf_read_load_pages(
+	ulint		space,
+	const ulint*	page_nos,
+	ulint		n_pages)
+{
+	int64_t			tablespace_version;
+	ulint			count = 0;
+	bool			found;
+	const page_size_t	page_size(fil_space_get_page_size(space,
+								  &found));
+
+	if (!found) {
+		/* The tablespace was dropped after the dump was made */
+		return(0);
+	}
+
+	tablespace_version = fil_space_get_version(space);
+
+	/* The dump may be older than the latest truncation of the
+	tablespace. An asynchronous read of a page in the system
+	tablespace consults the ibuf bitmap page of that page, which
+	must exist. */
+	const ulint	space_size = fil_space_get_size(space);
+
+	for (ulint i = 0; i < n_pages && page_nos[i] < space_size; i++) {
+		const page_id_t	page_id(space, page_nos[i]);
+		buf_pool_t*	buf_pool = buf_pool_get(page_id);
+		dberr_t		err;
+
+		/* Do not flood the buffer pool with pending reads;
+		the batch posted so far must be submitted before we
+		can wait for it. */
+		while (buf_pool->n_pend_reads
+		       > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+			os_aio_simulated_wake_handler_threads();
+			os_thread_sleep(10000);
+		}
+
+		count += buf_read_page_low(
+			&err, false, BUF_READ_ANY_PAGE
+			| OS_AIO_SIMULATED_WAKE_LATER
+			| BUF_READ_IGNORE_NONEXISTENT_PAGES,
+			page_id, page_size, FALSE, tablespace_version);
+
+		if (err == DB_TABLESPACE_DELETED) {
+			break;
+		}
+	}
+
+	os_aio_simulated_wake_handler_threads();
+
+	/* As in buf_read_page_background(), these reads are not counted
+	in the LRU policy heuristics. */
+	srv_stats.buf_pool_reads.add(count);
+
+	DBUG_PRINT("ib_buf", ("buffer pool load %u pages, space %u",
+			      unsigned(count), unsigned(space)));
+
+	return(count);
+}
+
 /** Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
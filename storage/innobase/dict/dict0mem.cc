@@ -645,6 +645,8 @@ dict_mem_index_free(
 		UT_DELETE(index->rtr_track->rtr_active);
 	}
 
+	ut_free(index->stat_dives);
+
 	mem_heap_free(index->heap);
 }
 
@@ -31,6 +31,7 @@ Created Jan 06, 2010 Vasil Dimov
 #include "ut0rnd.h"
 #include "dyn0buf.h"
 #include "row0sel.h"
+#include "srv0mon.h"
 #include "trx0trx.h"
 #include "pars0pars.h"
 #include "dict0stats.h"
@@ -105,6 +106,20 @@ See REF01 for the implementation.
 The above describes how to calculate the cardinality of an index.
 This algorithm is executed for each n-prefix of a multi-column index
 where n=1..n_uniq.
+
+The A dives are independent of each other and are performed by up to
+innodb_stats_persistent_threads threads, while the level LA is kept
+latched. The indexes of a table are analyzed in parallel too.
+
+With innodb_stats_persistent_incremental=ON the middle record of each group
+is picked instead of a random one, and the analyzed leaf pages are
+remembered in dict_index_t::stat_dives together with their modification
+LSN and the one of their parent page. The next calculation reuses the
+result of a leaf page that is below the same, unmodified parent, and that
+was not modified itself. A leaf page that is in the buffer pool is checked
+by its LSN. A leaf page that is not in the buffer pool is not read, unless
+many rows were modified since the previous calculation, in which case it
+may have been modified and flushed since (DICT_STATS_REUSE_EVICTED_MAX).
 @} */
 
 /* names of the tables from the persistent statistics storage */
@@ -131,6 +146,12 @@ descending to lower levels and fetch N_SAMPLE_PAGES(index) records
 from that level */
 #define N_DIFF_REQUIRED(index)	(N_SAMPLE_PAGES(index) * 10)
 
+/* with innodb_stats_persistent_incremental, the samples of leaf pages that
+are not in the buffer pool are reused without reading the pages only while
+at most 1/DICT_STATS_REUSE_EVICTED_MAX of the rows of the table have been
+modified since the previous calculation */
+#define DICT_STATS_REUSE_EVICTED_MAX	16
+
 /* A dynamic array where we store the boundaries of each distinct group
 of keys. For example if a btree level is:
 index: 0,1,2,3,4,5,6,7,8,9,10,11,12
@@ -949,8 +970,9 @@ dict_stats_analyze_index()
     we have found a good enough level here
     dict_stats_analyze_index_for_n_prefix(that level, stats collected above)
       // full scan of the level in one mtr
-      dive below some records and analyze the leaf page there:
-      dict_stats_analyze_index_below_cur()
+      pick some records and, in up to innodb_stats_persistent_threads
+      threads, dive below them and analyze the leaf page there:
+      dict_stats_analyze_index_below_page()
 @} */
 
 /*********************************************************************//**
@@ -1416,27 +1438,122 @@ dict_stats_scan_page(
 	return(offsets_rec);
 }
 
-/** Dive below the current position of a cursor and calculate the number of
+/** A dive from a record on the sampled level to a leaf page. The leaf pages
+that were analyzed are kept in dict_index_t::stat_dives, so that the next
+calculation can reuse their results while the subtree is not modified, see
+innodb_stats_persistent_incremental. */
+struct dict_stats_dive_t {
+	/** Number of columns to compare */
+	ulint		n_prefix;
+
+	/** Page to descend from, and after the dive the analyzed leaf
+	page, or FIL_NULL if the dive stopped above the leaf level */
+	ulint		page_no;
+
+	/** Page that contains the node pointer to page_no */
+	ulint		parent_page_no;
+
+	/** Modification LSN of parent_page_no. It changes whenever a node
+	pointer is added or removed because a page below it was split or
+	merged. */
+	lsn_t		parent_lsn;
+
+	/** Modification LSN of the analyzed leaf page */
+	lsn_t		leaf_lsn;
+
+	/** Number of distinct records on the leaf page */
+	ib_uint64_t	n_diff;
+
+	/** Number of external pages pointed to by the leaf page */
+	ib_uint64_t	n_external_pages;
+};
+
+/** Order dict_stats_dive_t by n_prefix and page_no.
+@param[in]	a	a dive
+@param[in]	b	another dive
+@return true if a is smaller than b */
+static
+bool
+dict_stats_dive_less(
+	const dict_stats_dive_t&	a,
+	const dict_stats_dive_t&	b)
+{
+	return(a.n_prefix < b.n_prefix
+	       || (a.n_prefix == b.n_prefix && a.page_no < b.page_no));
+}
+
+typedef std::vector<dict_stats_dive_t, ut_allocator<dict_stats_dive_t> >
+	dict_stats_dives_t;
+
+/** Find the sample of a leaf page from the previous statistics calculation.
+@param[in]	index		index
+@param[in]	n_prefix	number of columns to compare
+@param[in]	page_no		leaf page
+@return the sample, or NULL if the page was not analyzed */
+static
+const dict_stats_dive_t*
+dict_stats_dive_find(
+	const dict_index_t*	index,
+	ulint			n_prefix,
+	ulint			page_no)
+{
+	const dict_stats_dive_t*	end
+		= index->stat_dives + index->stat_n_dives;
+	dict_stats_dive_t		key;
+
+	key.n_prefix = n_prefix;
+	key.page_no = page_no;
+
+	const dict_stats_dive_t*	dive = std::lower_bound(
+		static_cast<const dict_stats_dive_t*>(index->stat_dives),
+		end, key, dict_stats_dive_less);
+
+	if (dive == end || dive->n_prefix != n_prefix
+	    || dive->page_no != page_no) {
+
+		return(NULL);
+	}
+
+	return(dive);
+}
+
+/** Get the LSN of the latest modification of a page.
+@param[in]	block	buffer block
+@return LSN */
+static
+lsn_t
+dict_stats_page_lsn(
+	const buf_block_t*	block)
+{
+	/* FIL_PAGE_LSN is only written when the page is flushed. */
+	return(std::max(
+		mach_read_from_8(buf_block_get_frame(block) + FIL_PAGE_LSN),
+		buf_page_get_newest_modification(&block->page)));
+}
+
+/** Dive below a record on a non-leaf level and calculate the number of
 distinct records on the leaf page, when looking at the fist n_prefix
 columns. Also calculate the number of external pages pointed by records
-on the leaf page.
-@param[in]	cur			cursor
-@param[in]	n_prefix		look at the first n_prefix columns
-when comparing records
-@param[out]	n_diff			number of distinct records
-@param[out]	n_external_pages	number of external pages
-@param[in,out]	mtr			mini-transaction
-@return number of distinct records on the leaf page */
+on the leaf page. The caller must hold an SX-latch on the index tree, so
+that the pages cannot be freed. This may be called from several threads at
+once.
+@param[in]	index		index
+@param[in]	level		level of dive->page_no
+@param[in]	reuse		whether to reuse the sample of the previous
+calculation if neither the leaf page nor its parent have been modified since
+@param[in]	reuse_evicted	whether to reuse the sample of a leaf page
+that is not in the buffer pool without reading it
+@param[in,out]	dive		dive; n_prefix, page_no and the parent must be
+set by the caller, the rest is set by this function */
 static
 void
-dict_stats_analyze_index_below_cur(
-	const btr_cur_t*	cur,
-	ulint			n_prefix,
-	ib_uint64_t*		n_diff,
-	ib_uint64_t*		n_external_pages,
-	mtr_t*			mtr)
+dict_stats_analyze_index_below_page(
+	dict_index_t*		index,
+	ulint			level,
+	bool			reuse,
+	bool			reuse_evicted,
+	dict_stats_dive_t*	dive)
 {
-	dict_index_t*	index;
 	buf_block_t*	block;
 	const page_t*	page;
 	mem_heap_t*	heap;
@@ -1445,8 +1562,7 @@ dict_stats_analyze_index_below_cur(
 	ulint*		offsets2;
 	ulint*		offsets_rec;
 	ulint		size;
-
-	index = btr_cur_get_index(cur);
+	mtr_t		mtr;
 
 	/* Allocate offsets for the record and the node pointer, for
 	node pointer records. In a secondary index, the node pointer
@@ -1469,30 +1585,67 @@ dict_stats_analyze_index_below_cur(
 	rec_offs_set_n_alloc(offsets1, size);
 	rec_offs_set_n_alloc(offsets2, size);
 
-	rec = btr_cur_get_rec(cur);
-
-	offsets_rec = rec_get_offsets(rec, index, offsets1,
-				      ULINT_UNDEFINED, &heap);
-
 	page_id_t		page_id(dict_index_get_space(index),
-					btr_node_ptr_get_child_page_no(
-						rec, offsets_rec));
+					dive->page_no);
 	const page_size_t	page_size(dict_table_page_size(index->table));
 
 	/* assume no external pages by default - in case we quit from this
 	function without analyzing any leaf pages */
-	*n_external_pages = 0;
+	dive->n_external_pages = 0;
+
+	mtr_start(&mtr);
 
 	/* descend to the leaf level on the B-tree */
 	for (;;) {
 
-		block = buf_page_get_gen(page_id, page_size, RW_S_LATCH,
-					 NULL /* no guessed block */,
-					 BUF_GET, __FILE__, __LINE__, mtr);
+		block = NULL;
+
+		if (level == 0 && reuse) {
+			const dict_stats_dive_t*	prev = dict_stats_dive_find(
+				index, dive->n_prefix, page_id.page_no());
+
+			if (prev != NULL
+			    && prev->parent_page_no == dive->parent_page_no
+			    && prev->parent_lsn == dive->parent_lsn) {
+
+				/* No page in the subtree was split or
+				merged since the previous sample. Check
+				that the leaf page itself was not modified,
+				if it is in the buffer pool. */
+				block = buf_page_get_gen(
+					page_id, page_size, RW_S_LATCH,
+					NULL, BUF_PEEK_IF_IN_POOL,
+					__FILE__, __LINE__, &mtr);
+
+				if (block == NULL
+				    ? reuse_evicted
+				    : dict_stats_page_lsn(block)
+				    == prev->leaf_lsn) {
+
+					dive->page_no = prev->page_no;
+					dive->leaf_lsn = prev->leaf_lsn;
+					dive->n_diff = prev->n_diff;
+					dive->n_external_pages
+						= prev->n_external_pages;
+
+					MONITOR_INC(
+						MONITOR_STATS_REUSED_PAGES);
+
+					goto func_exit;
+				}
+			}
+		}
+
+		if (block == NULL) {
+			block = buf_page_get_gen(
+				page_id, page_size, RW_S_LATCH,
+				NULL /* no guessed block */,
+				BUF_GET, __FILE__, __LINE__, &mtr);
+		}
 
 		page = buf_block_get_frame(block);
 
-		if (btr_page_get_level(page, mtr) == 0) {
+		if (btr_page_get_level(page, &mtr) == 0) {
 			/* leaf level */
 			break;
 		}
@@ -1500,25 +1653,25 @@ dict_stats_analyze_index_below_cur(
 
 		/* search for the first non-boring record on the page */
 		offsets_rec = dict_stats_scan_page(
-			&rec, offsets1, offsets2, index, page, n_prefix,
-			QUIT_ON_FIRST_NON_BORING, n_diff, NULL);
+			&rec, offsets1, offsets2, index, page, dive->n_prefix,
+			QUIT_ON_FIRST_NON_BORING, &dive->n_diff, NULL);
 
 		/* pages on level > 0 are not allowed to be empty */
 		ut_a(offsets_rec != NULL);
 		/* if page is not empty (offsets_rec != NULL) then n_diff must
 		be > 0, otherwise there is a bug in dict_stats_scan_page() */
-		ut_a(*n_diff > 0);
+		ut_a(dive->n_diff > 0);
 
-		if (*n_diff == 1) {
+		if (dive->n_diff == 1) {
 			/* page has all keys equal and the end of the page
 			was reached by dict_stats_scan_page(), no need to
 			descend to the leaf level */
-			mem_heap_free(heap);
+			dive->page_no = FIL_NULL;
 			/* can't get an estimate for n_external_pages here
 			because we do not dive to the leaf level, assume no
-			external pages (*n_external_pages was assigned to 0
+			external pages (n_external_pages was assigned to 0
 			above). */
-			return;
+			goto func_exit;
 		}
 		/* else */
 
@@ -1526,16 +1679,25 @@ dict_stats_analyze_index_below_cur(
 		first non-boring record it finds, then the returned n_diff
 		can either be 0 (empty page), 1 (page has all keys equal) or
 		2 (non-boring record was found) */
-		ut_a(*n_diff == 2);
+		ut_a(dive->n_diff == 2);
 
 		/* we have a non-boring record in rec, descend below it */
 
+		dive->parent_page_no = page_id.page_no();
+		dive->parent_lsn = dict_stats_page_lsn(block);
+
 		page_id.set_page_no(
 			btr_node_ptr_get_child_page_no(rec, offsets_rec));
+
+		ut_ad(level > 0);
+		level--;
 	}
 
 	/* make sure we got a leaf page as a result from the above loop */
-	ut_ad(btr_page_get_level(page, mtr) == 0);
+	ut_ad(btr_page_get_level(page, &mtr) == 0);
+
+	dive->page_no = page_id.page_no();
+	dive->leaf_lsn = dict_stats_page_lsn(block);
 
 	/* scan the leaf page and find the number of distinct keys,
 	when looking only at the first n_prefix columns; also estimate
@@ -1543,18 +1705,161 @@ dict_stats_analyze_index_below_cur(
 	page */
 
 	offsets_rec = dict_stats_scan_page(
-		&rec, offsets1, offsets2, index, page, n_prefix,
-		COUNT_ALL_NON_BORING_AND_SKIP_DEL_MARKED, n_diff,
-		n_external_pages);
+		&rec, offsets1, offsets2, index, page, dive->n_prefix,
+		COUNT_ALL_NON_BORING_AND_SKIP_DEL_MARKED, &dive->n_diff,
+		&dive->n_external_pages);
+
+	MONITOR_INC(MONITOR_STATS_SAMPLED_PAGES);
 
 #if 0
 	DEBUG_PRINTF("      %s(): n_diff below page_no=%lu: " UINT64PF "\n",
 		     __func__, page_no, n_diff);
 #endif
 
+func_exit:
+	mtr_commit(&mtr);
+
 	mem_heap_free(heap);
 }
 
+/** Function that processes one work item of dict_stats_parallel()
+@param[in]	i	number of the work item
+@param[in,out]	arg	argument of dict_stats_parallel() */
+typedef void (*dict_stats_work_fn_t)(ulint i, void* arg);
+
+/** Work items of dict_stats_parallel(), shared by the threads */
+struct dict_stats_work_t {
+	ulint			n_items;/*!< number of work items */
+	ulint			next;	/*!< next work item to process;
+					incremented atomically */
+	dict_stats_work_fn_t	fn;	/*!< function to process an item */
+	void*			arg;	/*!< argument of fn */
+};
+
+/** A thread of dict_stats_parallel(), other than the calling one */
+struct dict_stats_thread_t {
+	dict_stats_work_t*	work;	/*!< shared work items */
+	os_event_t		event;	/*!< set when the thread is done */
+};
+
+/** Process work items of dict_stats_parallel() until none are left.
+@param[in,out]	work	work items */
+static
+void
+dict_stats_work(
+	dict_stats_work_t*	work)
+{
+	for (;;) {
+		ulint	i = os_atomic_increment_ulint(&work->next, 1) - 1;
+
+		if (i >= work->n_items) {
+			return;
+		}
+
+		work->fn(i, work->arg);
+	}
+}
+
+/*********************************************************************//**
+Function run by a thread of dict_stats_parallel(), other than the calling
+one.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+dict_stats_thread(
+/*==============*/
+	void*		arg)		/*!< in/out: dict_stats_thread_t */
+{
+	dict_stats_thread_t*	thr = static_cast<dict_stats_thread_t*>(arg);
+
+	dict_stats_work(thr->work);
+
+	os_event_set(thr->event);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Process work items in parallel. The calling thread processes items too
+and returns when all of them have been processed.
+@param[in]	n_threads	number of threads to use, including the
+calling thread
+@param[in]	n_items		number of work items
+@param[in]	fn		function to process an item
+@param[in,out]	arg		argument of fn */
+static
+void
+dict_stats_parallel(
+	ulint			n_threads,
+	ulint			n_items,
+	dict_stats_work_fn_t	fn,
+	void*			arg)
+{
+	dict_stats_work_t	work;
+
+	work.n_items = n_items;
+	work.next = 0;
+	work.fn = fn;
+	work.arg = arg;
+
+	n_threads = ut_min(n_threads, n_items);
+
+	if (n_threads <= 1) {
+		dict_stats_work(&work);
+		return;
+	}
+
+	dict_stats_thread_t*	thr = static_cast<dict_stats_thread_t*>(
+		ut_zalloc_nokey(n_threads * sizeof *thr));
+
+	for (ulint k = 1; k < n_threads; k++) {
+		thr[k].work = &work;
+		thr[k].event = os_event_create(0);
+
+		os_thread_create(dict_stats_thread, &thr[k], NULL);
+	}
+
+	dict_stats_work(&work);
+
+	for (ulint k = 1; k < n_threads; k++) {
+		os_event_wait(thr[k].event);
+		os_event_destroy(thr[k].event);
+	}
+
+	ut_free(thr);
+}
+
+/** Dives of dict_stats_analyze_index_for_n_prefix() */
+struct dict_stats_dive_work_t {
+	dict_index_t*		index;	/*!< index */
+	ulint			level;	/*!< level below the sampled level */
+	bool			reuse;	/*!< whether to reuse the samples
+					of the previous calculation */
+	bool			reuse_evicted;
+					/*!< whether to reuse the samples
+					of leaf pages that are not in the
+					buffer pool without reading them */
+	dict_stats_dive_t*	dives;	/*!< dives */
+};
+
+/** Perform a dive of dict_stats_analyze_index_for_n_prefix().
+@param[in]	i	number of the dive
+@param[in,out]	arg	dict_stats_dive_work_t */
+static
+void
+dict_stats_dive(
+	ulint	i,
+	void*	arg)
+{
+	dict_stats_dive_work_t*	work
+		= static_cast<dict_stats_dive_work_t*>(arg);
+
+	dict_stats_analyze_index_below_page(
+		work->index, work->level, work->reuse, work->reuse_evicted,
+		&work->dives[i]);
+}
+
 /** Input data that is used to calculate dict_index_t::stat_n_diff_key_vals[]
 for each n-columns prefix (n from 1 to n_uniq). */
 struct n_diff_data_t {
@@ -1608,6 +1913,11 @@ last record from each group of distinct keys
 n_external_pages_sum in this structure will be set by this function. The
 members level, n_diff_on_level and n_leaf_pages_to_analyze must be set by the
 caller in advance - they are used by some calculations inside this function
+@param[in]	n_threads		number of threads to dive with
+@param[in]	incremental		whether to reuse the samples of the
+previous calculation, see innodb_stats_persistent_incremental
+@param[in,out]	leaf_dives		the analyzed leaf pages are appended
+to this
 @param[in,out]	mtr			mini-transaction */
 static
 void
@@ -1616,12 +1926,16 @@ dict_stats_analyze_index_for_n_prefix(
 	ulint			n_prefix,
 	const boundaries_t*	boundaries,
 	n_diff_data_t*		n_diff_data,
+	ulint			n_threads,
+	bool			incremental,
+	dict_stats_dives_t*	leaf_dives,
 	mtr_t*			mtr)
 {
 	btr_pcur_t	pcur;
 	const page_t*	page;
 	ib_uint64_t	rec_idx;
 	ib_uint64_t	i;
+	dict_stats_dives_t	dives;
 
 #if 0
 	DEBUG_PRINTF("    %s(table=%s, index=%s, level=%lu, n_prefix=%lu,"
@@ -1674,6 +1988,9 @@ dict_stats_analyze_index_for_n_prefix(
 	n_diff_data->n_diff_all_analyzed_pages = 0;
 	n_diff_data->n_external_pages_sum = 0;
 
+	dives.reserve(static_cast<size_t>(
+		n_diff_data->n_leaf_pages_to_analyze));
+
 	for (i = 0; i < n_diff_data->n_leaf_pages_to_analyze; i++) {
 		/* there are n_diff_on_level elements
 		in 'boundaries' and we divide those elements
@@ -1702,7 +2019,9 @@ dict_stats_analyze_index_for_n_prefix(
 		segment i=6: [11, 12]
 
 		then we select a random record from each segment and dive
-		below it */
+		below it; in incremental mode we select the middle record,
+		so that the same leaf pages are picked again as long as the
+		level does not change */
 		const ib_uint64_t	n_diff = n_diff_data->n_diff_on_level;
 		const ib_uint64_t	n_pick
 			= n_diff_data->n_leaf_pages_to_analyze;
@@ -1716,8 +2035,9 @@ dict_stats_analyze_index_for_n_prefix(
 		/* we do not pass (left, right) because we do not want to ask
 		ut_rnd_interval() to work with too big numbers since
 		ib_uint64_t could be bigger than ulint */
-		const ulint	rnd = ut_rnd_interval(
-			0, static_cast<ulint>(right - left));
+		const ulint	rnd = incremental
+			? static_cast<ulint>((right - left) / 2)
+			: ut_rnd_interval(0, static_cast<ulint>(right - left));
 
 		const ib_uint64_t	dive_below_idx
 			= boundaries->at(static_cast<unsigned>(left + rnd));
@@ -1755,14 +2075,56 @@ dict_stats_analyze_index_for_n_prefix(
 
 		ut_a(rec_idx == dive_below_idx);
 
-		ib_uint64_t	n_diff_on_leaf_page;
-		ib_uint64_t	n_external_pages;
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+		mem_heap_t*	heap = NULL;
+		ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+		ulint*		offsets = offsets_;
+		dict_stats_dive_t	dive;
+
+		rec_offs_init(offsets_);
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		dive.n_prefix = n_prefix;
+		dive.page_no = btr_node_ptr_get_child_page_no(rec, offsets);
+		dive.parent_page_no = btr_pcur_get_block(&pcur)->page.id
+			.page_no();
+		dive.parent_lsn = dict_stats_page_lsn(
+			btr_pcur_get_block(&pcur));
+
+		if (heap != NULL) {
+			mem_heap_free(heap);
+		}
+
+		dives.push_back(dive);
+	}
+
+	btr_pcur_close(&pcur);
 
-		dict_stats_analyze_index_below_cur(btr_pcur_get_btr_cur(&pcur),
-						   n_prefix,
-						   &n_diff_on_leaf_page,
-						   &n_external_pages,
-						   mtr);
+	/* Dive below the picked records. The pages on the level are kept
+	latched by mtr and the SX-latch on the index prevents any page
+	below them from being split or merged. */
+	dict_stats_dive_work_t	work;
+
+	work.index = index;
+	work.level = n_diff_data->level - 1;
+	work.reuse = incremental && index->stat_dives != NULL;
+	work.reuse_evicted = work.reuse
+		&& index->table->stat_modified_counter
+		<= index->table->stat_n_rows / DICT_STATS_REUSE_EVICTED_MAX;
+	work.dives = dives.empty() ? NULL : &dives[0];
+
+	dict_stats_parallel(n_threads, dives.size(), dict_stats_dive, &work);
+
+	for (dict_stats_dives_t::const_iterator it = dives.begin();
+	     it != dives.end(); ++it) {
+
+		ib_uint64_t	n_diff_on_leaf_page = it->n_diff;
+
+		if (it->page_no != FIL_NULL) {
+			leaf_dives->push_back(*it);
+		}
 
 		/* We adjust n_diff_on_leaf_page here to avoid counting
 		one value twice - once as the last on some page and once
@@ -1784,10 +2146,8 @@ dict_stats_analyze_index_for_n_prefix(
 
 		n_diff_data->n_diff_all_analyzed_pages += n_diff_on_leaf_page;
 
-		n_diff_data->n_external_pages_sum += n_external_pages;
+		n_diff_data->n_external_pages_sum += it->n_external_pages;
 	}
-
-	btr_pcur_close(&pcur);
 }
 
 /** Set dict_index_t::stat_n_diff_key_vals[] and stat_n_sample_sizes[].
@@ -1864,6 +2224,33 @@ dict_stats_index_set_n_diff(
 	}
 }
 
+/** Replace the samples of leaf pages that the next statistics calculation
+may reuse.
+@param[in,out]	index	index
+@param[in]	dives	new samples, or NULL to discard the old ones */
+static
+void
+dict_stats_set_dives(
+	dict_index_t*		index,
+	dict_stats_dives_t*	dives)
+{
+	ut_free(index->stat_dives);
+	index->stat_dives = NULL;
+	index->stat_n_dives = 0;
+
+	if (dives == NULL || dives->empty()) {
+		return;
+	}
+
+	std::sort(dives->begin(), dives->end(), dict_stats_dive_less);
+
+	index->stat_dives = static_cast<dict_stats_dive_t*>(
+		ut_malloc_nokey(dives->size() * sizeof *index->stat_dives));
+
+	std::copy(dives->begin(), dives->end(), index->stat_dives);
+	index->stat_n_dives = dives->size();
+}
+
 /*********************************************************************//**
 Calculates new statistics for a given index and saves them to the index
 members stat_n_diff_key_vals[], stat_n_sample_sizes[], stat_index_size and
@@ -1872,7 +2259,9 @@ static
 void
 dict_stats_analyze_index(
 /*=====================*/
-	dict_index_t*	index)	/*!< in/out: index to analyze */
+	dict_index_t*	index,		/*!< in/out: index to analyze */
+	ulint		n_threads)	/*!< in: number of threads to dive
+					below the sampled level with */
 {
 	ulint		root_level;
 	ulint		level;
@@ -1883,6 +2272,7 @@ dict_stats_analyze_index(
 	ib_uint64_t	total_pages;
 	mtr_t		mtr;
 	ulint		size;
+	const bool	incremental = srv_stats_persistent_incremental;
 	DBUG_ENTER("dict_stats_analyze_index");
 
 	DBUG_PRINT("info", ("index: %s, online status: %d", index->name,
@@ -1897,6 +2287,10 @@ dict_stats_analyze_index(
 
 	dict_stats_empty_index(index);
 
+	if (!incremental) {
+		dict_stats_set_dives(index, NULL);
+	}
+
 	mtr_start(&mtr);
 
 	mtr_s_lock(dict_index_get_lock(index), &mtr);
@@ -1967,6 +2361,8 @@ dict_stats_analyze_index(
 
 		mtr_commit(&mtr);
 
+		dict_stats_set_dives(index, NULL);
+
 		dict_stats_assert_initialized_index(index);
 		DBUG_VOID_RETURN;
 	}
@@ -1986,6 +2382,9 @@ dict_stats_analyze_index(
 	used to calculate dict_index_t::stat_n_diff_key_vals[]. */
 	n_diff_data_t*	n_diff_data = UT_NEW_ARRAY_NOKEY(n_diff_data_t, n_uniq);
 
+	/* The leaf pages that were analyzed, for all n-column prefixes */
+	dict_stats_dives_t	leaf_dives;
+
 	/* total_recs is also used to estimate the number of pages on one
 	level below, so at the start we have 1 page (the root) */
 	total_recs = 1;
@@ -2147,7 +2546,7 @@ found_level:
 
 		dict_stats_analyze_index_for_n_prefix(
 			index, n_prefix, &n_diff_boundaries[n_prefix - 1],
-			data, &mtr);
+			data, n_threads, incremental, &leaf_dives, &mtr);
 	}
 
 	mtr_commit(&mtr);
@@ -2160,6 +2559,12 @@ found_level:
 	due to tree being changed and so n_diff_data[] is set up. */
 	if (n_prefix == 0) {
 		dict_stats_index_set_n_diff(n_diff_data, index);
+
+		if (incremental) {
+			dict_stats_set_dives(index, &leaf_dives);
+		}
+	} else {
+		dict_stats_set_dives(index, NULL);
 	}
 
 	UT_DELETE_ARRAY(n_diff_data);
@@ -2168,10 +2573,36 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** Indexes of dict_stats_update_persistent() */
+struct dict_stats_indexes_t {
+	dict_index_t**	indexes;	/*!< indexes to analyze */
+	ulint		n_threads;	/*!< number of threads to dive
+					with in each index */
+	dict_table_t*	table;		/*!< table of the indexes */
+};
+
+/** Analyze an index of dict_stats_update_persistent().
+@param[in]	i	number of the index
+@param[in,out]	arg	dict_stats_indexes_t */
+static
+void
+dict_stats_analyze_nth_index(
+	ulint	i,
+	void*	arg)
+{
+	dict_stats_indexes_t*	work = static_cast<dict_stats_indexes_t*>(arg);
+
+	/* The clustered index is always analyzed. */
+	if (i == 0 || !(work->table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
+		dict_stats_analyze_index(work->indexes[i], work->n_threads);
+	}
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
-will be saved on disk.
+will be saved on disk. The indexes are analyzed in parallel by up to
+innodb_stats_persistent_threads threads.
 @return DB_SUCCESS or error code */
 static
 dberr_t
@@ -2202,17 +2633,15 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_univ(index));
 
-	dict_stats_analyze_index(index);
-
-	ulint	n_unique = dict_index_get_n_unique(index);
-
-	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
-
-	table->stat_clustered_index_size = index->stat_index_size;
+	/* collect the clustered index and the other indexes to analyze */
 
-	/* analyze other indexes from the table, if any */
+	const ulint	n_threads = srv_stats_persistent_threads;
+	ulint		n_indexes = 0;
+	dict_index_t**	indexes = static_cast<dict_index_t**>(
+		ut_malloc_nokey(UT_LIST_GET_LEN(table->indexes)
+				* sizeof *indexes));
 
-	table->stat_sum_of_other_index_sizes = 0;
+	indexes[n_indexes++] = index;
 
 	for (index = dict_table_get_next_index(index);
 	     index != NULL;
@@ -2230,14 +2659,38 @@ dict_stats_update_persistent(
 			continue;
 		}
 
-		if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-			dict_stats_analyze_index(index);
-		}
+		indexes[n_indexes++] = index;
+	}
+
+	/* Analyze the indexes in parallel. The threads that are left
+	over dive below the sampled level of each index. */
+	dict_stats_indexes_t	work;
+	const ulint		n_index_threads = ut_min(n_threads, n_indexes);
+
+	work.indexes = indexes;
+	work.n_threads = std::max<ulint>(n_threads / n_index_threads, 1);
+	work.table = table;
 
+	dict_stats_parallel(n_index_threads, n_indexes,
+			    dict_stats_analyze_nth_index, &work);
+
+	index = indexes[0];
+
+	ulint	n_unique = dict_index_get_n_unique(index);
+
+	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+
+	table->stat_clustered_index_size = index->stat_index_size;
+
+	table->stat_sum_of_other_index_sizes = 0;
+
+	for (ulint i = 1; i < n_indexes; i++) {
 		table->stat_sum_of_other_index_sizes
-			+= index->stat_index_size;
+			+= indexes[i]->stat_index_size;
 	}
 
+	ut_free(indexes);
+
 	table->stats_last_recalc = ut_time();
 
 	table->stat_modified_counter = 0;
@@ -3024,7 +3477,8 @@ dict_stats_update_for_index(
 
 		if (dict_stats_persistent_storage_check(false)) {
 			dict_table_stats_lock(index->table, RW_X_LATCH);
-			dict_stats_analyze_index(index);
+			dict_stats_analyze_index(
+				index, srv_stats_persistent_threads);
 			dict_table_stats_unlock(index->table, RW_X_LATCH);
 			dict_stats_save(index->table, &index->id);
 			DBUG_VOID_RETURN;
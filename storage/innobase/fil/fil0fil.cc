@@ -146,6 +146,11 @@ struct fil_node_t {
 				serialize calls to fsync */
 	bool		is_raw_disk;/*!< true if the 'file' is actually a raw
 				device or a raw disk partition */
+	bool		punch_hole;/*!< true if the file system supports
+				releasing the storage of a range of the
+				file; set when the file is opened */
+	ulint		block_size;/*!< file system block size; set when
+				the file is opened */
 	ulint		size;	/*!< size of the file in database pages, 0 if
 				not known yet; the possible last incomplete
 				megabyte may be ignored if space == 0 */
@@ -539,6 +544,49 @@ fil_space_set_imported(
 
 	mutex_exit(&fil_system->mutex);
 }
+
+/** Set the transparent page compression algorithm of a tablespace.
+Only pages that are written afterwards are affected.
+@param[in]	id		tablespace identifier
+@param[in]	algorithm	compression algorithm
+@return false if algorithm is not OS_COMP_NONE and the tablespace does
+not exist or cannot use transparent page compression */
+bool
+fil_space_set_compression(
+	ulint		id,
+	os_comp_t	algorithm)
+{
+	ut_ad(algorithm < OS_COMP_MAX);
+
+	mutex_enter(&fil_system->mutex);
+
+	fil_space_t*	space = fil_space_get_by_id(id);
+
+	bool	success = space != NULL
+		&& fil_is_user_tablespace_id(id)
+		&& space->purpose != FIL_TYPE_TEMPORARY
+		&& !page_size_t(space->flags).is_compressed();
+
+	if (success) {
+		space->compression = algorithm;
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	return(success || algorithm == OS_COMP_NONE);
+}
+
+/** Get the file system block size of a file of a tablespace.
+@param[in]	node	file node of a data file
+@return block size */
+ulint
+fil_node_get_block_size(
+	const fil_node_t*	node)
+{
+	ut_ad(node->magic_n == FIL_NODE_MAGIC_N);
+
+	return(node->block_size);
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /**********************************************************************//**
@@ -812,6 +860,20 @@ add_size:
 
 	ut_a(success);
 
+	node->block_size = os_file_get_block_size(node->handle);
+
+	/* Transparent page compression needs to release the unused
+	tail of the compressed pages. Probe for the support by punching
+	a hole beyond the end of the file. */
+	node->punch_hole = space->purpose == FIL_TYPE_TABLESPACE
+		&& fil_is_user_tablespace_id(space->id)
+		&& !read_only_mode
+		&& !node->is_raw_disk
+		&& node->block_size < UNIV_PAGE_SIZE
+		&& os_file_punch_hole(
+			node->handle, os_file_get_size(node->handle),
+			node->block_size);
+
 	node->is_open = true;
 
 	system->n_open++;
@@ -5036,6 +5098,7 @@ fil_io(
 	ulint		wake_later;
 	os_offset_t	offset;
 	ulint		ignore_nonexistent_pages;
+	ulint		os_type;
 
 	is_log = type & OS_FILE_LOG;
 	type = type & ~OS_FILE_LOG;
@@ -5200,6 +5263,31 @@ fil_io(
 		ut_error;
 	}
 
+	/* Whole pages of single-table tablespaces can be in the
+	transparently compressed format in the file. */
+	os_type = type;
+
+	if (!is_log
+	    && byte_offset == 0
+	    && len == UNIV_PAGE_SIZE
+	    && !page_size.is_compressed()
+	    && fil_is_user_tablespace_id(space->id)
+	    && space->purpose != FIL_TYPE_TEMPORARY) {
+
+		os_type |= OS_FILE_PAGE;
+
+		/* The first page is read without decompression when
+		the file is opened. */
+		if (type == OS_FILE_WRITE
+		    && space->compression != OS_COMP_NONE
+		    && node->punch_hole
+		    && page_id.page_no() != 0) {
+
+			os_type |= space->compression
+				<< OS_FILE_COMPRESS_SHIFT;
+		}
+	}
+
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
@@ -5249,7 +5337,7 @@ fil_io(
 	}
 #else
 	/* Queue the aio request */
-	ret = os_aio(type, mode | wake_later, node->name,
+	ret = os_aio(os_type, mode | wake_later, node->name,
 		     node->handle, buf, offset, len,
 		     fsp_is_system_temporary(page_id.space())
 		     ? false : srv_read_only_mode,
@@ -5298,7 +5386,7 @@ fil_aio_wait(
 #ifdef WIN_ASYNC_IO
 		ret = os_aio_windows_handle(
 			segment, 0, &fil_node, &message, &type);
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 		ret = os_aio_linux_handle(
 			segment, &fil_node, &message, &type);
 #else
@@ -5502,6 +5590,143 @@ skip_flush:
 	mutex_exit(&fil_system->mutex);
 }
 
+/** A data file whose writes are flushed by fil_flush_spaces_batch() */
+struct fil_flush_node_t {
+	/** the tablespace or log group */
+	fil_space_t*	space;
+	/** the data file */
+	fil_node_t*	node;
+	/** modification_counter of the file when the flush started */
+	int64_t		mod_counter;
+};
+
+/** Flush to disk the writes in several file spaces possibly cached by
+the OS, issuing the flushes of all files at once.
+Spaces with a flush in progress are flushed with fil_flush().
+@param[in]	space_ids	ids of the spaces to flush
+@param[in]	n_space_ids	number of space_ids */
+static
+void
+fil_flush_spaces_batch(
+	const ulint*	space_ids,
+	ulint		n_space_ids)
+{
+	std::vector<fil_flush_node_t>	nodes;
+	std::vector<os_file_t>		files;
+	std::vector<ulint>		busy;
+
+	mutex_enter(&fil_system->mutex);
+
+	for (ulint i = 0; i < n_space_ids; i++) {
+		fil_space_t*	space = fil_space_get_by_id(space_ids[i]);
+		fil_node_t*	node;
+
+		if (space == NULL
+		    || space->purpose == FIL_TYPE_TEMPORARY
+		    || space->stop_new_ops
+		    || space->is_being_truncated
+		    || fil_buffering_disabled(space)) {
+
+			continue;
+		}
+
+		for (node = UT_LIST_GET_FIRST(space->chain);
+		     node != NULL;
+		     node = UT_LIST_GET_NEXT(chain, node)) {
+
+			if (node->modification_counter > node->flush_counter
+			    && node->n_pending_flushes > 0) {
+				break;
+			}
+		}
+
+		if (node != NULL) {
+			/* fil_flush() waits for the pending flush */
+			busy.push_back(space->id);
+			continue;
+		}
+
+		for (node = UT_LIST_GET_FIRST(space->chain);
+		     node != NULL;
+		     node = UT_LIST_GET_NEXT(chain, node)) {
+
+			if (node->modification_counter
+			    <= node->flush_counter) {
+
+				continue;
+			}
+
+			ut_a(node->is_open);
+
+			fil_flush_node_t	flush_node;
+
+			flush_node.space = space;
+			flush_node.node = node;
+			flush_node.mod_counter = node->modification_counter;
+
+			nodes.push_back(flush_node);
+			files.push_back(node->handle);
+
+			/* Prevent dropping of the space and concurrent
+			flushes of the file */
+			space->n_pending_flushes++;
+			node->n_pending_flushes++;
+
+			if (space->purpose == FIL_TYPE_LOG) {
+				fil_n_pending_log_flushes++;
+				fil_n_log_flushes++;
+			} else {
+				fil_n_pending_tablespace_flushes++;
+			}
+		}
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	if (!files.empty()) {
+		os_file_flush_files(&files[0], files.size());
+	}
+
+	mutex_enter(&fil_system->mutex);
+
+	for (ulint i = 0; i < nodes.size(); i++) {
+		fil_space_t*	space = nodes[i].space;
+		fil_node_t*	node = nodes[i].node;
+
+		os_event_set(node->sync_event);
+
+		node->n_pending_flushes--;
+
+		if (node->flush_counter < nodes[i].mod_counter) {
+			node->flush_counter = nodes[i].mod_counter;
+
+			if (space->is_in_unflushed_spaces
+			    && fil_space_is_flushed(space)) {
+
+				space->is_in_unflushed_spaces = false;
+
+				UT_LIST_REMOVE(
+					fil_system->unflushed_spaces,
+					space);
+			}
+		}
+
+		if (space->purpose == FIL_TYPE_LOG) {
+			fil_n_pending_log_flushes--;
+		} else {
+			fil_n_pending_tablespace_flushes--;
+		}
+
+		space->n_pending_flushes--;
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	for (ulint i = 0; i < busy.size(); i++) {
+		fil_flush(busy[i]);
+	}
+}
+
 /** Flush to disk the writes in file spaces of the given type
 possibly cached by the OS.
 @param[in]	purpose	FIL_TYPE_TABLESPACE or FIL_TYPE_LOG */
@@ -5548,11 +5773,16 @@ fil_flush_file_spaces(
 
 	mutex_exit(&fil_system->mutex);
 
-	/* Flush the spaces.  It will not hurt to call fil_flush() on
-	a non-existing space id. */
-	for (ulint i = 0; i < n_space_ids; i++) {
+	if (srv_use_native_aio && srv_use_io_uring) {
+		/* Let the files be flushed concurrently */
+		fil_flush_spaces_batch(space_ids, n_space_ids);
+	} else {
+		/* Flush the spaces.  It will not hurt to call fil_flush()
+		on a non-existing space id. */
+		for (ulint i = 0; i < n_space_ids; i++) {
 
-		fil_flush(space_ids[i]);
+			fil_flush(space_ids[i]);
+		}
 	}
 
 	ut_free(space_ids);
@@ -5831,6 +6061,25 @@ fil_iterate(
 			return(DB_IO_ERROR);
 		}
 
+		/* Decompress the pages that were written with transparent
+		page compression. If they are updated, they are written
+		back uncompressed. */
+		for (ulint i = 0;
+		     !callback.get_page_size().is_compressed()
+		     && i < n_bytes / iter.page_size;
+		     ++i) {
+
+			if (!os_comp_page_decompress(
+				    io_buffer + i * iter.page_size, NULL)) {
+
+				ib_logf(IB_LOG_LEVEL_ERROR,
+					"Cannot decompress page %lu",
+					(ulong) (page_no + i));
+
+				return(DB_CORRUPTION);
+			}
+		}
+
 		bool		updated = false;
 		os_offset_t	page_off = offset;
 		ulint		n_pages_read = (ulint) n_bytes / iter.page_size;
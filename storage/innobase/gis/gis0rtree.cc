@@ -915,9 +915,9 @@ rtr_split_page_move_rec_list(
 	if (dict_index_is_sec_or_ibuf(index)
 	    && page_is_leaf(page)
 	    && !dict_table_is_temporary(index->table)) {
-		page_update_max_trx_id(new_block, NULL,
-				       page_get_max_trx_id(page),
-				       mtr);
+		page_inherit_max_trx_id(new_block, NULL,
+					page_get_max_trx_id(page),
+					mtr);
 	}
 
 	if (new_page_zip) {
@@ -384,11 +384,11 @@ rtr_pcur_getnext_from_path(
 
 			trx_t*		trx = thr_get_trx(
 						btr_cur->rtr_info->thr);
-			lock_mutex_enter();
+			trx_mutex_enter(trx);
 			lock_init_prdt_from_mbr(
 				&prdt, &btr_cur->rtr_info->mbr,
 				mode, trx->lock.lock_heap);
-			lock_mutex_exit();
+			trx_mutex_exit(trx);
 
 			if (rw_latch == RW_NO_LATCH) {
 				rw_lock_s_lock(&(block->lock));
@@ -151,7 +151,7 @@ ha_clear(
 {
 	ut_ad(table->magic_n == HASH_TABLE_MAGIC_N);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!table->adaptive || rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!table->adaptive || btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	for (ulint i = 0; i < table->n_sync_obj; i++) {
@@ -314,7 +314,7 @@ ha_delete_hash_node(
 	ut_ad(table);
 	ut_ad(table->magic_n == HASH_TABLE_MAGIC_N);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(btr_search_enabled);
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
@@ -353,7 +353,7 @@ ha_search_and_update_if_found_func(
 	ut_a(new_block->frame == page_align(new_data));
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	if (!btr_search_enabled) {
@@ -87,6 +87,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0trunc.h"
@@ -221,6 +222,22 @@ static TYPELIB innodb_checksum_algorithm_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_deadlock_detect". */
+static const char* innodb_deadlock_detect_names[] = {
+	"immediate",
+	"background",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_deadlock_detect. */
+static TYPELIB innodb_deadlock_detect_typelib = {
+	array_elements(innodb_deadlock_detect_names) - 1,
+	"innodb_deadlock_detect_typelib",
+	innodb_deadlock_detect_names,
+	NULL
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in case of normal DML ops it is not
 sensible to call srv_active_wake_master_thread after each
@@ -330,6 +347,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(srv_sys_mutex),
 	PSI_KEY(lock_mutex),
 	PSI_KEY(lock_wait_mutex),
+	PSI_KEY(lock_rec_shard_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
 #  ifndef PFS_SKIP_EVENT_MUTEX
@@ -346,6 +364,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(rtr_path_mutex),
 	PSI_KEY(rtr_ssn_mutex),
 	PSI_KEY(trx_sys_mutex),
+	PSI_KEY(mvcc_mutex),
 	PSI_KEY(zip_pad_mutex),
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -369,6 +388,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
 	PSI_RWLOCK_KEY(trx_i_s_cache_lock),
 	PSI_RWLOCK_KEY(trx_purge_latch),
+	PSI_RWLOCK_KEY(lock_sys_latch),
 	PSI_RWLOCK_KEY(index_tree_rw_lock),
 	PSI_RWLOCK_KEY(index_online_log),
 	PSI_RWLOCK_KEY(dict_table_stats),
@@ -383,12 +403,14 @@ is defined */
 static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(buf_dump_thread),
 	PSI_KEY(dict_stats_thread),
+	PSI_KEY(ibuf_merge_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(io_ibuf_thread),
 	PSI_KEY(io_log_thread),
 	PSI_KEY(io_read_thread),
 	PSI_KEY(io_write_thread),
 	PSI_KEY(page_cleaner_thread),
+	PSI_KEY(recv_apply_thread),
 	PSI_KEY(recv_writer_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
@@ -558,11 +580,22 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 1, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_ULONG(scan_ring_size, PLUGIN_VAR_RQCMDARG,
+  "Number of buffer pool pages that a full table or index scan recycles for the pages it reads, so that the scan does not push other pages out of the buffer pool. 0 (the default) disables the scan ring.",
+  NULL, NULL, 0, 0, 1024 * 1024, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
   innodb_stopword_table_validate, NULL, NULL);
 
+static MYSQL_THDVAR_BOOL(bulk_load, PLUGIN_VAR_OPCMDARG,
+  "Load an empty table in bulk in INSERT ... SELECT, CREATE TABLE ... SELECT"
+  " and LOAD DATA, with a single undo log record for the whole statement."
+  " The table is locked exclusively until the end of the transaction"
+  " (disabled by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_THDVAR_BOOL(optimize_point_storage, PLUGIN_VAR_OPCMDARG,
   "Optimize POINT storage as fixed length, rather than variable length"
   " (disabled by default)", NULL, NULL, FALSE);
@@ -2340,6 +2373,68 @@ innobase_copy_frm_flags_from_table_share(
 		table_share->stats_auto_recalc == HA_STATS_AUTO_RECALC_OFF);
 
 	innodb_table->stats_sample_pages = table_share->stats_sample_pages;
+
+	os_comp_t	algorithm;
+
+	if (!innobase_parse_page_compression(
+		    table_share->comment, &algorithm)) {
+
+		ib::warn() << "Unknown COMPRESSION in the COMMENT of table "
+			<< innodb_table->name << "; the pages will be"
+			" written uncompressed.";
+
+		algorithm = OS_COMP_NONE;
+	}
+
+	if (!dict_table_is_discarded(innodb_table)
+	    && !innodb_table->ibd_file_missing) {
+
+		fil_space_set_compression(innodb_table->space, algorithm);
+	}
+}
+
+/** Parse the transparent page compression algorithm from a table
+COMMENT that contains COMPRESSION=<algorithm>, for example
+COMMENT='COMPRESSION=zlib'.
+@param[in]	comment		table comment
+@param[out]	algorithm	compression algorithm, or OS_COMP_NONE if
+the comment does not specify one
+@return false if the comment specifies an unknown algorithm */
+bool
+innobase_parse_page_compression(
+	const LEX_STRING&	comment,
+	os_comp_t*		algorithm)
+{
+	static const char	key[] = "COMPRESSION=";
+	const size_t		key_len = sizeof key - 1;
+	const char*		end = comment.str + comment.length;
+
+	*algorithm = OS_COMP_NONE;
+
+	for (const char* p = comment.str;
+	     p != NULL && p + key_len <= end;
+	     p++) {
+
+		if (native_strncasecmp(p, key, key_len)
+		    || (p > comment.str && my_isalnum(system_charset_info,
+						       p[-1]))) {
+			continue;
+		}
+
+		const char*	name = p + key_len;
+		const char*	name_end = name;
+
+		while (name_end < end
+		       && my_isalnum(system_charset_info, *name_end)) {
+			name_end++;
+		}
+
+		*algorithm = os_comp_find(name, name_end - name);
+
+		return(*algorithm != OS_COMP_MAX);
+	}
+
+	return(true);
 }
 
 /*********************************************************************//**
@@ -2372,7 +2467,9 @@ ha_innobase::ha_innobase(
 			  | HA_ATTACHABLE_TRX_COMPATIBLE
 		  ),
 	m_start_of_scan(),
-	m_num_write_row()
+	m_num_write_row(),
+	m_bulk_insert_pending(),
+	m_ignore_dup_key()
 {}
 
 /*********************************************************************//**
@@ -6751,6 +6848,17 @@ no_commit:
 
 	innobase_srv_conc_enter_innodb(m_prebuilt);
 
+	if (m_bulk_insert_pending) {
+		m_bulk_insert_pending = false;
+
+		error = row_insert_bulk_start(m_prebuilt, table);
+
+		if (error != DB_SUCCESS) {
+			innobase_srv_conc_exit_innodb(m_prebuilt);
+			goto report_error;
+		}
+	}
+
 	/* Step-5: Execute insert graph that will result in actual insert. */
 	error = row_insert_for_mysql((byte*) record, m_prebuilt);
 
@@ -6867,6 +6975,66 @@ func_exit:
 	DBUG_RETURN(error_result);
 }
 
+/** Prepare for inserting many rows. If innodb_bulk_load is set, the
+first write_row() of INSERT ... SELECT, CREATE TABLE ... SELECT or
+LOAD DATA starts a bulk insert if the table is empty.
+@param[in]	rows	estimated number of rows, or 0 if unknown */
+
+void
+ha_innobase::start_bulk_insert(
+	ha_rows	rows)
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+
+	m_bulk_insert_pending = false;
+
+	if (!THDVAR(m_user_thd, bulk_load) || m_ignore_dup_key) {
+		DBUG_VOID_RETURN;
+	}
+
+	switch (thd_sql_command(m_user_thd)) {
+	case SQLCOM_INSERT_SELECT:
+	case SQLCOM_CREATE_TABLE:
+	case SQLCOM_LOAD:
+		m_bulk_insert_pending = true;
+		break;
+	default:
+		break;
+	}
+
+	DBUG_VOID_RETURN;
+}
+
+/** Finish inserting many rows. A bulk insert that was started by
+write_row() completes the indexes here.
+@return 0 or error number */
+
+int
+ha_innobase::end_bulk_insert()
+{
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	m_bulk_insert_pending = false;
+
+	if (m_prebuilt->bulk == NULL) {
+		DBUG_RETURN(0);
+	}
+
+	TrxInInnoDB	trx_in_innodb(m_prebuilt->trx);
+
+	dberr_t	error = row_insert_bulk_end(m_prebuilt);
+
+	if (error == DB_SUCCESS) {
+		DBUG_RETURN(0);
+	}
+
+	/* LOAD DATA reports my_errno. */
+	my_errno = convert_error_code_to_mysql(
+		error, m_prebuilt->table->flags, m_user_thd);
+
+	DBUG_RETURN(my_errno);
+}
+
 /**********************************************************************//**
 Checks which fields have changed in a row and stores information
 of them to an update vector.
@@ -7513,6 +7681,11 @@ ha_innobase::index_end(void)
 
 	m_prebuilt->index->last_sel_cur->release();
 
+	if (m_prebuilt->scan_ring != NULL) {
+		buf_LRU_scan_ring_free(m_prebuilt->scan_ring);
+		m_prebuilt->scan_ring = NULL;
+	}
+
 	active_index = MAX_KEY;
 
 	in_range_check_pushed_down = FALSE;
@@ -8166,6 +8339,16 @@ ha_innobase::index_first(
 
 	ha_statistic_increment(&SSV::ha_read_first_count);
 
+	/* Both table scans and full index scans start here. The pages
+	that the scan reads into the buffer pool are recycled through
+	a ring of innodb_scan_ring_size pages. */
+	if (m_prebuilt->scan_ring == NULL
+	    && THDVAR(m_user_thd, scan_ring_size) > 0) {
+
+		m_prebuilt->scan_ring = buf_LRU_scan_ring_create(
+			THDVAR(m_user_thd, scan_ring_size));
+	}
+
 	int	error = index_read(buf, NULL, 0, HA_READ_AFTER_KEY);
 
 	/* MySQL does not seem to allow this to return HA_ERR_KEY_NOT_FOUND */
@@ -10021,6 +10204,30 @@ ha_innobase::create(
 		DBUG_RETURN(-1);
 	}
 
+	/* Validate the transparent page compression in the COMMENT. */
+	os_comp_t	algorithm;
+
+	if (!innobase_parse_page_compression(form->s->comment, &algorithm)) {
+		push_warning(
+			thd, Sql_condition::SL_WARNING,
+			ER_ILLEGAL_HA_CREATE_OPTION,
+			"InnoDB: unknown COMPRESSION algorithm.");
+		DBUG_RETURN(HA_WRONG_CREATE_OPTION);
+	}
+
+	if (algorithm != OS_COMP_NONE
+	    && (!(flags2 & DICT_TF2_USE_FILE_PER_TABLE)
+		|| (flags2 & DICT_TF2_TEMPORARY)
+		|| DICT_TF_GET_ZIP_SSIZE(flags))) {
+		push_warning(
+			thd, Sql_condition::SL_WARNING,
+			ER_ILLEGAL_HA_CREATE_OPTION,
+			"InnoDB: COMPRESSION requires innodb_file_per_table"
+			" and cannot be used with TEMPORARY tables or"
+			" ROW_FORMAT=COMPRESSED.");
+		DBUG_RETURN(HA_WRONG_CREATE_OPTION);
+	}
+
 	bool		is_intrinsic_temp_table
 		= (flags2 & DICT_TF2_TEMPORARY)
 		  && (flags2 & DICT_TF2_INTRINSIC);
@@ -11026,16 +11233,43 @@ ha_innobase::records(
 		DBUG_RETURN(HA_ERR_TABLE_DEF_CHANGED);
 	}
 
-	/* (Re)Build the m_prebuilt->mysql_template if it is null to use
-	the clustered index and just the key, no off-record data. */
-	m_prebuilt->index = index;
-	dtuple_set_n_fields(m_prebuilt->search_tuple, 0);
-	m_prebuilt->read_just_key = 1;
-	build_template(false);
+	if (srv_parallel_read_threads > 1
+	    && m_prebuilt->select_lock_type == LOCK_NONE
+	    && m_prebuilt->trx->isolation_level > TRX_ISO_READ_UNCOMMITTED
+	    && !dict_table_is_intrinsic(m_prebuilt->table)) {
+
+		trx_t*	trx = m_prebuilt->trx;
+
+		/* A consistent read can be split between threads. Assign
+		the read view as row_search_mvcc() would. */
+		trx_start_if_not_started(trx, false);
+
+		if (m_prebuilt->sql_stat_start) {
+			if (!srv_read_only_mode) {
+				trx_assign_read_view(trx);
+			}
+
+			m_prebuilt->sql_stat_start = FALSE;
+		}
+
+		/* Count the records in the clustered index in parallel */
+		ret = row_pread_count(
+			trx, index, srv_parallel_read_threads, &n_rows);
+	} else {
+		/* (Re)Build the m_prebuilt->mysql_template if it is null
+		to use the clustered index and just the key, no off-record
+		data. */
+		m_prebuilt->index = index;
+		dtuple_set_n_fields(m_prebuilt->search_tuple, 0);
+		m_prebuilt->read_just_key = 1;
+		build_template(false);
+
+		/* Count the records in the clustered index */
+		ret = row_scan_index_for_mysql(
+			m_prebuilt, index, false, &n_rows);
+		reset_template();
+	}
 
-	/* Count the records in the clustered index */
-	ret = row_scan_index_for_mysql(m_prebuilt, index, false, &n_rows);
-	reset_template();
 	switch (ret) {
 	case DB_SUCCESS:
 		break;
@@ -11049,7 +11283,8 @@ ha_innobase::records(
 		DBUG_RETURN(HA_ERR_QUERY_INTERRUPTED);
 	default:
 		/* No other error besides the three below is returned from
-		row_scan_index_for_mysql(). Make a debug catch. */
+		row_scan_index_for_mysql() or row_pread_count(). Make a
+		debug catch. */
 		*num_rows = HA_POS_ERROR;
 		ut_ad(0);
 		DBUG_RETURN(-1);
@@ -12681,8 +12916,12 @@ ha_innobase::extra(
 	case HA_EXTRA_INSERT_WITH_UPDATE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_IGNORE;
 		break;
+	case HA_EXTRA_IGNORE_DUP_KEY:
+		m_ignore_dup_key = true;
+		break;
 	case HA_EXTRA_NO_IGNORE_DUP_KEY:
 		thd_to_trx(ha_thd())->duplicates &= ~TRX_DUP_IGNORE;
+		m_ignore_dup_key = false;
 		break;
 	case HA_EXTRA_WRITE_CAN_REPLACE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_REPLACE;
@@ -12709,6 +12948,16 @@ ha_innobase::reset()
 		row_mysql_prebuilt_free_blob_heap(m_prebuilt);
 	}
 
+	if (m_prebuilt->bulk != NULL) {
+		/* end_bulk_insert() was not called; the statement
+		was rolled back. */
+		row_merge_bulk_free(m_prebuilt->bulk);
+		m_prebuilt->bulk = NULL;
+	}
+
+	m_bulk_insert_pending = false;
+	m_ignore_dup_key = false;
+
 	reset_template();
 	m_ds_mrr.reset();
 
@@ -13082,11 +13331,7 @@ ha_innobase::external_lock(
 		} else if (trx->isolation_level <= TRX_ISO_READ_COMMITTED
 			   && MVCC::is_view_active(trx->read_view)) {
 
-			mutex_enter(&trx_sys->mutex);
-
 			trx_sys->mvcc->view_close(trx->read_view, true);
-
-			mutex_exit(&trx_sys->mutex);
 		}
 	}
 
@@ -13517,11 +13762,7 @@ ha_innobase::store_lock(
 			/* At low transaction isolation levels we let
 			each consistent read set its own snapshot */
 
-			mutex_enter(&trx_sys->mutex);
-
 			trx_sys->mvcc->view_close(trx->read_view, true);
-
-			mutex_exit(&trx_sys->mutex);
 		}
 	}
 
@@ -16256,6 +16497,29 @@ buffer_pool_load_abort(
 	}
 }
 
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_dump_interval using the
+"saved" value, and wake up the dump/load thread so that it uses the new
+interval. This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_dump_interval_update(
+/*====================================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	srv_buf_pool_dump_interval = *static_cast<const ulong*>(save);
+
+	if (!srv_read_only_mode) {
+		os_event_set(srv_buf_dump_event);
+	}
+}
+
 /****************************************************************//**
 Update the system variable innodb_log_write_ahead_size using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -16409,6 +16673,12 @@ static MYSQL_SYSVAR_BOOL(buf_flush_list_now, innodb_buf_flush_list_now,
   PLUGIN_VAR_OPCMDARG,
   "Force dirty page flush now",
   NULL, buf_flush_list_now_set, FALSE);
+
+static MYSQL_SYSVAR_BOOL(page_cleaner_disabled_debug,
+  innodb_page_cleaner_disabled_debug,
+  PLUGIN_VAR_OPCMDARG,
+  "Disable the flushing of dirty pages by the page cleaner",
+  NULL, NULL, FALSE);
 #endif /* UNIV_DEBUG */
 
 static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
@@ -16612,12 +16882,34 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   " statistics (by ANALYZE, default 20)",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(stats_persistent_threads,
+  srv_stats_persistent_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "The number of threads that calculate persistent statistics of a table;"
+  " the indexes are analyzed and their leaf pages sampled concurrently"
+  " (default 1)",
+  NULL, NULL, 1, 1, 32, 0);
+
+static MYSQL_SYSVAR_BOOL(stats_persistent_incremental,
+  srv_stats_persistent_incremental,
+  PLUGIN_VAR_OPCMDARG,
+  "When calculating persistent statistics, reuse the samples of leaf pages"
+  " that have not been modified, split or merged since the previous"
+  " calculation (disabled by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default). "
   " Disable with --skip-innodb-adaptive-hash-index.",
   NULL, innodb_adaptive_hash_index_update, TRUE);
 
+static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of InnoDB adaptive hash index partitions, each protected by"
+  " its own latch (default 8).",
+  NULL, NULL, 8, 1, 512, 0);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if"
@@ -16702,6 +16994,16 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   "Dump only the hottest N% of each buffer pool, defaults to 100",
   NULL, NULL, 100, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_pool_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the hottest innodb_buffer_pool_dump_pct of each buffer pool in a binary format every N seconds, 0 (the default) disables periodic dumps",
+  NULL, innodb_buffer_pool_dump_interval_update, 0, 0, 86400, 0);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_pool_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that issue page reads during a buffer pool load",
+  NULL, NULL, 4, 1, 64, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -16814,6 +17116,18 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(parallel_ddl_threads, srv_parallel_ddl_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that sort and merge the entries of each index"
+  " in index creation. Each thread allocates 3 sort buffers.",
+  NULL, NULL, 1, 1, 16, 0);
+
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index for SELECT COUNT(*)"
+  " in a consistent read. 1 (the default) disables the parallel scan.",
+  NULL, NULL, 1, 1, ROW_PREAD_MAX_THREADS, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -16834,6 +17148,20 @@ static MYSQL_SYSVAR_ULONG(write_io_threads, innobase_write_io_threads,
   "Number of background write I/O threads in InnoDB.",
   NULL, NULL, 4, 1, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_threads,
+  srv_n_ibuf_merge_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of background threads merging the change buffer, in batches"
+  " of the pages with the most buffered changes. 0 leaves the merge to"
+  " the master thread. Default is 0.",
+  NULL, NULL, 0, 0, 32, 0);
+
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records in parallel during crash"
+  " recovery. 0 applies them in the recovery thread. Default is 0.",
+  NULL, NULL, 0, 0, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(force_recovery, srv_force_recovery,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Helps to save your data in case the disk image of the database becomes corrupt.",
@@ -17007,6 +17335,12 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO on Linux, if supported."
+  " The buffer pool is registered with the kernel for page I/O.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(api_enable_binlog, ib_binlog_enabled,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable binlog for applications direct access InnoDB through InnoDB APIs",
@@ -17122,6 +17456,14 @@ static MYSQL_SYSVAR_BOOL(print_all_deadlocks, srv_print_all_deadlocks,
   "Print all deadlocks to MySQL error log (off by default)",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ENUM(deadlock_detect, srv_deadlock_detect,
+  PLUGIN_VAR_RQCMDARG,
+  "When to search for deadlocks. IMMEDIATE (the default) searches"
+  " whenever a lock wait begins, BACKGROUND lets the lock wait timeout"
+  " thread search a snapshot of the lock waits every 100 milliseconds.",
+  NULL, NULL, SRV_DEADLOCK_DETECT_IMMEDIATE,
+  &innodb_deadlock_detect_typelib);
+
 static MYSQL_SYSVAR_ULONG(compression_failure_threshold_pct,
   zip_failure_threshold_pct, PLUGIN_VAR_OPCMDARG,
   "If the compression failure rate of a table is greater than this number"
@@ -17186,6 +17528,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -17218,6 +17562,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(flush_log_at_trx_commit),
   MYSQL_SYSVAR(flush_method),
   MYSQL_SYSVAR(force_recovery),
+  MYSQL_SYSVAR(recovery_apply_threads),
 #ifndef DBUG_OFF
   MYSQL_SYSVAR(force_recovery_crash),
 #endif /* !DBUG_OFF */
@@ -17234,6 +17579,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(scan_ring_size),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
@@ -17263,8 +17609,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_transient_sample_pages),
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(stats_persistent_threads),
+  MYSQL_SYSVAR(stats_persistent_incremental),
   MYSQL_SYSVAR(stats_auto_recalc),
   MYSQL_SYSVAR(adaptive_hash_index),
+  MYSQL_SYSVAR(adaptive_hash_index_parts),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
@@ -17272,6 +17621,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(create_intrinsic),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(parallel_ddl_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -17284,8 +17635,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_merge_threads),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
   MYSQL_SYSVAR(disable_background_merge),
@@ -17307,6 +17660,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(purge_stop_now),
   MYSQL_SYSVAR(log_checkpoint_now),
   MYSQL_SYSVAR(buf_flush_list_now),
+  MYSQL_SYSVAR(page_cleaner_disabled_debug),
 #endif /* UNIV_DEBUG */
 #if defined UNIV_DEBUG || defined UNIV_PERF_DEBUG
   MYSQL_SYSVAR(page_hash_locks),
@@ -17315,6 +17669,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(status_output),
   MYSQL_SYSVAR(status_output_locks),
   MYSQL_SYSVAR(print_all_deadlocks),
+  MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(bulk_load),
   MYSQL_SYSVAR(cmp_per_index_enabled),
   MYSQL_SYSVAR(undo_logs),
   MYSQL_SYSVAR(max_undo_log_size),
@@ -97,6 +97,10 @@ class ha_innobase: public handler
 
 	longlong get_memory_buffer_size() const;
 
+	void start_bulk_insert(ha_rows rows);
+
+	int end_bulk_insert();
+
 	int write_row(uchar * buf);
 
 	int update_row(const uchar * old_data, uchar * new_data);
@@ -492,6 +496,14 @@ private:
 
 	/** number of write_row() calls */
 	uint			m_num_write_row;
+
+	/** whether the next write_row() should try to start a bulk
+	insert into an empty table, see innodb_bulk_load */
+	bool			m_bulk_insert_pending;
+
+	/** whether duplicate key errors are ignored by the statement,
+	which rules out a bulk insert */
+	bool			m_ignore_dup_key;
 };
 
 /* Some accessor functions which the InnoDB plugin needs, but which
@@ -736,6 +748,19 @@ innobase_copy_frm_flags_from_create_info(
 	dict_table_t*		innodb_table,	/*!< in/out: InnoDB table */
 	const HA_CREATE_INFO*	create_info);	/*!< in: create info */
 
+/** Parse the transparent page compression algorithm from a table
+COMMENT that contains COMPRESSION=<algorithm>, for example
+COMMENT='COMPRESSION=zlib'.
+@param[in]	comment		table comment
+@param[out]	algorithm	compression algorithm, or OS_COMP_NONE if
+the comment does not specify one
+@return false if the comment specifies an unknown algorithm */
+bool
+innobase_parse_page_compression(
+	const LEX_STRING&	comment,
+	os_comp_t*		algorithm)
+	__attribute__((warn_unused_result));
+
 /**
 Copy table flags from MySQL's TABLE_SHARE into an InnoDB table object.
 Those flags are stored in .frm file and end up in the MySQL table object,
@@ -3826,6 +3826,15 @@ ha_innobase::prepare_inplace_alter_table(
 				 table_type(), invalid_opt);
 			goto err_exit_no_heap;
 		}
+
+		os_comp_t	algorithm;
+
+		if (!innobase_parse_page_compression(
+			    altered_table->s->comment, &algorithm)) {
+			my_error(ER_ILLEGAL_HA_CREATE_OPTION, MYF(0),
+				 table_type(), "COMPRESSION");
+			goto err_exit_no_heap;
+		}
 	}
 
 	/* Check if any index name is reserved. */
@@ -62,9 +62,13 @@ my_bool	srv_ibuf_disable_background_merge;
 #include "log0recv.h"
 #include "que0que.h"
 #include "srv0start.h" /* srv_shutdown_state */
+#include "srv0mon.h"
 #include "fsp0sysspace.h"
 #include "rem0cmp.h"
 
+#include <algorithm>
+#include <vector>
+
 /*	STRUCTURE OF AN INSERT BUFFER RECORD
 
 In versions < 4.1.x:
@@ -304,6 +308,29 @@ const ulint		IBUF_MERGE_THRESHOLD = 4;
 batch, in order to merge the entries for them in the insert buffer */
 const ulint		IBUF_MAX_N_PAGES_MERGED = IBUF_MERGE_AREA;
 
+/** Number of pages that a change buffer merge thread reads at most in
+one batch */
+const ulint		IBUF_MERGE_THREAD_BATCH = 64;
+
+/** Number of distinct pages whose buffered changes a change buffer merge
+thread looks at for choosing the pages of a batch */
+const ulint		IBUF_MERGE_THREAD_SCAN = 4 * IBUF_MERGE_THREAD_BATCH;
+
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t		ibuf_merge_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Set when pages are requested from the change buffer merge threads,
+and at shutdown */
+static os_event_t	ibuf_merge_event;
+
+/** Number of pages requested from the change buffer merge threads and
+not yet claimed by any of them */
+static ulint		ibuf_merge_n_pages;
+
+/** Number of change buffer merge threads that have not exited */
+static ulint		ibuf_merge_n_threads;
+
 /** If the combined size of the ibuf trees exceeds ibuf->max_size by this
 many pages, we start to contract it in connection to inserts there, using
 non-synchronous contract */
@@ -468,6 +495,8 @@ ibuf_close(void)
 	mutex_free(&ibuf_bitmap_mutex);
 	memset(&ibuf_bitmap_mutex, 0x0, sizeof(ibuf_mutex));
 
+	os_event_destroy(ibuf_merge_event);
+
 	ut_free(ibuf);
 	ibuf = NULL;
 }
@@ -512,6 +541,8 @@ ibuf_init_at_db_start(void)
 
 	ibuf = static_cast<ibuf_t*>(ut_zalloc_nokey(sizeof(ibuf_t)));
 
+	ibuf_merge_event = os_event_create(0);
+
 	/* At startup we intialize ibuf to have a maximum of
 	CHANGE_BUFFER_DEFAULT_SIZE in terms of percentage of the
 	buffer pool size. Once ibuf struct is initialized this
@@ -2765,6 +2796,304 @@ ibuf_contract(
 	return(ibuf_merge(0, &n_pages, sync));
 }
 
+/** A page with buffered changes, a candidate for a merge batch */
+struct ibuf_merge_page_t {
+	ulint		space;		/*!< tablespace id */
+	ulint		page_no;	/*!< page number */
+	int64_t		version;	/*!< tablespace version */
+	ulint		n_recs;		/*!< number of buffered changes */
+};
+
+/** Orders merge candidates by descending number of buffered changes */
+struct ibuf_merge_page_more_recs {
+	bool operator()(
+		const ibuf_merge_page_t&	a,
+		const ibuf_merge_page_t&	b) const
+	{
+		return(a.n_recs > b.n_recs);
+	}
+};
+
+/** Orders merge candidates by tablespace and page number */
+struct ibuf_merge_page_less_addr {
+	bool operator()(
+		const ibuf_merge_page_t&	a,
+		const ibuf_merge_page_t&	b) const
+	{
+		return(a.space < b.space
+		       || (a.space == b.space && a.page_no < b.page_no));
+	}
+};
+
+typedef std::vector<ibuf_merge_page_t, ut_allocator<ibuf_merge_page_t> >
+	ibuf_merge_pages_t;
+
+/** Merge a batch of pages in a change buffer merge thread. The buffered
+changes of up to IBUF_MERGE_THREAD_SCAN pages are looked at, starting
+from a random leaf page of the ibuf tree, and the pages with the most
+buffered changes are read asynchronously, in one batch per tablespace.
+The changes are merged when the reads complete.
+@param[in]	limit	maximum number of pages to read
+@param[in,out]	pages	work area
+@return number of pages read, or 0 if the ibuf tree is empty */
+static
+ulint
+ibuf_merge_batch(
+	ulint			limit,
+	ibuf_merge_pages_t&	pages)
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+
+	pages.clear();
+
+	if (ibuf->empty) {
+		return(0);
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+	} else if (ibuf_debug) {
+		return(0);
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+	}
+
+	ibuf_mtr_start(&mtr);
+
+	btr_pcur_open_at_rnd_pos(ibuf->index, BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	if (page_is_empty(btr_pcur_get_page(&pcur))) {
+		/* The whole B-tree is empty, see ibuf_merge_pages(). */
+		ibuf_mtr_commit(&mtr);
+		btr_pcur_close(&pcur);
+
+		return(0);
+	}
+
+	/* Start from the first record of the leaf page, so that the
+	changes of the first page are counted from the start. */
+	btr_pcur_move_before_first_on_page(&pcur);
+
+	const rec_t*	rec;
+
+	while ((rec = ibuf_get_user_rec(&pcur, &mtr)) != NULL) {
+		ulint	space = ibuf_rec_get_space(&mtr, rec);
+		ulint	page_no = ibuf_rec_get_page_no(&mtr, rec);
+
+		if (pages.empty()
+		    || pages.back().space != space
+		    || pages.back().page_no != page_no) {
+
+			if (pages.size() == IBUF_MERGE_THREAD_SCAN) {
+				break;
+			}
+
+			ibuf_merge_page_t	page;
+
+			page.space = space;
+			page.page_no = page_no;
+			page.version = !pages.empty()
+				&& pages.back().space == space
+				? pages.back().version
+				: fil_space_get_version(space);
+			page.n_recs = 0;
+
+			pages.push_back(page);
+		}
+
+		pages.back().n_recs++;
+
+		if (!btr_pcur_move_to_next(&pcur, &mtr)) {
+			break;
+		}
+	}
+
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	if (pages.empty()) {
+		/* There was nothing after the random position. */
+		return(1);
+	}
+
+	if (pages.size() > limit) {
+		std::nth_element(pages.begin(), pages.begin() + limit,
+				 pages.end(), ibuf_merge_page_more_recs());
+		pages.resize(limit);
+	}
+
+	std::sort(pages.begin(), pages.end(), ibuf_merge_page_less_addr());
+
+	ulint	spaces[IBUF_MERGE_THREAD_BATCH];
+	int64_t	versions[IBUF_MERGE_THREAD_BATCH];
+	ulint	page_nos[IBUF_MERGE_THREAD_BATCH];
+	ulint	n = 0;
+
+	ut_ad(pages.size() <= IBUF_MERGE_THREAD_BATCH);
+
+	for (ulint i = 0; i < pages.size(); i++) {
+		spaces[n] = pages[i].space;
+		versions[n] = pages[i].version;
+		page_nos[n] = pages[i].page_no;
+		n++;
+
+		if (i + 1 == pages.size()
+		    || pages[i + 1].space != pages[i].space) {
+
+			buf_read_ibuf_merge_pages(
+				false, spaces, versions, page_nos, n);
+
+			MONITOR_INC(MONITOR_IBUF_MERGE_BATCHES);
+			MONITOR_INC_VALUE(MONITOR_IBUF_MERGE_BATCH_PAGES, n);
+
+			n = 0;
+		}
+	}
+
+	return(pages.size());
+}
+
+/** Request pages to be merged by the change buffer merge threads.
+@param[in]	n_pages	number of pages */
+static
+void
+ibuf_merge_threads_request(
+	ulint	n_pages)
+{
+	if (n_pages > 0) {
+		os_atomic_increment_ulint(&ibuf_merge_n_pages, n_pages);
+		os_event_set(ibuf_merge_event);
+	}
+}
+
+/** Claim a share of the pages that were requested from the change buffer
+merge threads.
+@return number of pages to merge, or 0 if none were requested */
+static
+ulint
+ibuf_merge_threads_claim(void)
+{
+	for (;;) {
+		ulint	n = ibuf_merge_n_pages;
+
+		if (n == 0) {
+			return(0);
+		}
+
+		ulint	share = ut_min(n, IBUF_MERGE_THREAD_BATCH);
+
+		if (os_compare_and_swap_ulint(
+			    &ibuf_merge_n_pages, n, n - share)) {
+			return(share);
+		}
+	}
+}
+
+/** Number of pages to contract the change buffer by in a second, beyond
+PCT_IO(5), when it is more than half full.
+@return number of pages */
+static
+ulint
+ibuf_merge_extra_pages(void)
+{
+	ulint	n_pages = 0;
+
+	mutex_enter(&ibuf_mutex);
+
+	/* +1 is to avoid division by zero. */
+	if (ibuf->size > ibuf->max_size / 2) {
+		ulint diff = ibuf->size - ibuf->max_size / 2;
+		n_pages = PCT_IO((diff * 100) / (ibuf->max_size + 1));
+	}
+
+	mutex_exit(&ibuf_mutex);
+
+	return(n_pages);
+}
+
+/** A change buffer merge thread. The pages that the master thread
+requests in ibuf_contract_in_background() are merged in batches of up to
+IBUF_MERGE_THREAD_BATCH pages. While the change buffer is more than half
+full, the first thread also requests more pages every 100 milliseconds,
+in proportion to the excess.
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(ibuf_merge_thread)(
+	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(ibuf_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	const bool		first = os_atomic_increment_ulint(
+		&ibuf_merge_n_threads, 1) == 1;
+	ibuf_merge_pages_t	pages;
+
+	pages.reserve(IBUF_MERGE_THREAD_SCAN);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		int64_t	sig_count = os_event_reset(ibuf_merge_event);
+		ulint	n_pages = ibuf_merge_threads_claim();
+
+		if (n_pages == 0) {
+			bool	busy = first && ibuf->size > ibuf->max_size / 2;
+
+			os_event_wait_time_low(
+				ibuf_merge_event, busy ? 100000 : 1000000,
+				sig_count);
+
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+			if (srv_ibuf_disable_background_merge) {
+				continue;
+			}
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+
+			if (busy && ibuf_merge_n_pages == 0) {
+				ibuf_merge_threads_request(
+					ut_max(ibuf_merge_extra_pages() / 10,
+					       ulint(1)));
+			}
+
+			continue;
+		}
+
+		while (n_pages > 0 && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+			ulint	n = ibuf_merge_batch(n_pages, pages);
+
+			if (n == 0) {
+				/* The change buffer is empty. */
+				break;
+			}
+
+			n_pages -= ut_min(n, n_pages);
+		}
+	}
+
+	os_atomic_decrement_ulint(&ibuf_merge_n_threads, 1);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Wake up the change buffer merge threads, so that they notice a
+shutdown.
+@return whether any change buffer merge thread has not exited yet */
+
+bool
+ibuf_merge_threads_active(void)
+{
+	if (ibuf_merge_event != NULL) {
+		os_event_set(ibuf_merge_event);
+	}
+
+	return(ibuf_merge_n_threads > 0);
+}
+
 /*********************************************************************//**
 Contracts insert buffer trees by reading pages to the buffer pool.
 @return a lower limit for the combined size in bytes of entries which
@@ -2794,25 +3123,25 @@ ibuf_contract_in_background(
 	}
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
 
+	if (table_id == 0
+	    && srv_n_ibuf_merge_threads > 0
+	    && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		/* Leave the merge to the change buffer merge threads,
+		unless this is the slow shutdown. They contract a change
+		buffer that is more than half full by themselves. */
+		ibuf_merge_threads_request(full ? PCT_IO(100) : PCT_IO(5));
+
+		return(0);
+	}
+
 	if (full) {
 		/* Caller has requested a full batch */
 		n_pages = PCT_IO(100);
 	} else {
-		/* By default we do a batch of 5% of the io_capacity */
-		n_pages = PCT_IO(5);
-
-		mutex_enter(&ibuf_mutex);
-
-		/* If the ibuf->size is more than half the max_size
-		then we make more agreesive contraction.
-		+1 is to avoid division by zero. */
-		if (ibuf->size > ibuf->max_size / 2) {
-			ulint diff = ibuf->size - ibuf->max_size / 2;
-			n_pages += PCT_IO((diff * 100)
-					   / (ibuf->max_size + 1));
-		}
-
-		mutex_exit(&ibuf_mutex);
+		/* By default we do a batch of 5% of the io_capacity.
+		If the ibuf->size is more than half the max_size
+		then we make more agreesive contraction. */
+		n_pages = PCT_IO(5) + ibuf_merge_extra_pages();
 	}
 
 	while (sum_pages < n_pages) {
@@ -4753,8 +5082,8 @@ loop:
 			ibuf_op_t	op = ibuf_rec_get_op_type(&mtr, rec);
 
 			max_trx_id = page_get_max_trx_id(page_align(rec));
-			page_update_max_trx_id(block, page_zip, max_trx_id,
-					       &mtr);
+			page_inherit_max_trx_id(block, page_zip, max_trx_id,
+						&mtr);
 
 			ut_ad(page_validate(page_align(rec), ibuf->index));
 
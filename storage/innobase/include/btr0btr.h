@@ -351,6 +351,15 @@ btr_free_root(
 	const page_size_t&	page_size,
 	mtr_t*			mtr);
 
+/** Empty an index tree, for the rollback of a bulk insert into an empty
+table.
+@param[in,out]	index	index tree
+@param[in]	trx_id	transaction that did the bulk insert */
+void
+btr_empty_index(
+	dict_index_t*	index,
+	trx_id_t	trx_id);
+
 /*************************************************************//**
 Makes tree one level higher by splitting the root, and inserts
 the tuple. It is assumed that mtr contains an x-latch on the tree.
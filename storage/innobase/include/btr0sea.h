@@ -86,14 +86,15 @@ btr_search_info_create(
 /*===================*/
 	mem_heap_t*	heap);	/*!< in: heap where created */
 /*****************************************************************//**
-Returns the value of ref_count. The value is protected by
-btr_search_latch.
+Returns the value of ref_count. The value is protected by the
+adaptive hash index partition latch of the index.
 @return ref_count value. */
 
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info);	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index);	/*!< in: index */
 /*********************************************************************//**
 Updates the search info. */
 UNIV_INLINE
@@ -119,7 +120,8 @@ btr_search_guess_on_hash(
 	ulint		latch_mode,	/*!< in: BTR_SEARCH_LEAF, ... */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive hash
+					index partition latch of the index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr);		/*!< in: mtr */
 /********************************************************************//**
@@ -195,12 +197,76 @@ ibool
 btr_search_validate(void);
 /*======================*/
 
+/** Prints the sizes and the hit counts of the adaptive hash index
+partitions.
+@param[in,out]	file	output stream */
+
+void
+btr_search_print_info(
+	FILE*	file);
+
+/** Get the adaptive hash index partition of an index.
+@param[in]	index	index
+@return partition number, less than btr_ahi_parts */
+UNIV_INLINE
+ulint
+btr_search_get_part(
+	const dict_index_t*	index);
+
+/** Get the latch protecting the adaptive hash index partition of
+an index.
+@param[in]	index	index
+@return adaptive hash index partition latch */
+UNIV_INLINE
+rw_lock_t*
+btr_get_search_latch(
+	const dict_index_t*	index);
+
+/** Get the hash table of the adaptive hash index partition of an index.
+@param[in]	index	index
+@return adaptive hash index partition hash table */
+UNIV_INLINE
+hash_table_t*
+btr_get_search_table(
+	const dict_index_t*	index);
+
+/** X-latch all the adaptive hash index partitions. */
+UNIV_INLINE
+void
+btr_search_x_lock_all();
+
+/** X-unlatch all the adaptive hash index partitions. */
+UNIV_INLINE
+void
+btr_search_x_unlock_all();
+
+#ifdef UNIV_SYNC_DEBUG
+/** Check if the current thread holds all the adaptive hash index
+partition latches in the given mode.
+@param[in]	mode	RW_LOCK_S or RW_LOCK_X
+@return true if all the latches are owned in the mode */
+UNIV_INLINE
+bool
+btr_search_own_all(
+	ulint	mode);
+
+/** Check if the current thread holds any adaptive hash index
+partition latch in the given mode.
+@param[in]	mode	RW_LOCK_S or RW_LOCK_X
+@return true if some latch is owned in the mode */
+UNIV_INLINE
+bool
+btr_search_own_any(
+	ulint	mode);
+#endif /* UNIV_SYNC_DEBUG */
+
 /** The search info struct in an index */
 struct btr_search_t{
 	ulint	ref_count;	/*!< Number of blocks in this index tree
 				that have search index built
 				i.e. block->index points to this index.
-				Protected by btr_search_latch except
+				Protected by the adaptive hash index
+				partition latch of the index except
 				when during initialization in
 				btr_search_info_create(). */
 
@@ -249,13 +315,39 @@ struct btr_search_t{
 #endif /* UNIV_DEBUG */
 };
 
+/** Hash search counters of an adaptive hash index partition. They are
+not protected by any latch. Each partition has a cache line of its own,
+so that searches in neighbouring partitions do not write to the same
+line. */
+struct btr_search_part_stats_t{
+	ulint		n_hash_succ;	/*!< number of successful hash
+					searches */
+	ulint		n_hash_fail;	/*!< number of failed hash
+					searches */
+	byte		pad[CACHE_LINE_SIZE - 2 * sizeof(ulint)];
+					/*!< padding to CACHE_LINE_SIZE */
+};
+
 /** The hash index system */
 struct btr_search_sys_t{
-	hash_table_t*	hash_index;	/*!< the adaptive hash index,
-					mapping dtuple_fold values
-					to rec_t pointers on index pages */
+	hash_table_t**	hash_tables;	/*!< the adaptive hash index
+					partitions, mapping dtuple_fold
+					values to rec_t pointers on
+					index pages */
+	btr_search_part_stats_t*
+			part_stats;	/*!< hash search counters per
+					partition, aligned to
+					CACHE_LINE_SIZE */
+	void*		part_stats_mem;	/*!< memory of part_stats */
 };
 
+/** Get the number of failed hash searches of all the adaptive hash
+index partitions.
+@return number of failed hash searches */
+
+ulint
+btr_search_get_n_hash_fail();
+
 /** The adaptive hash index */
 extern btr_search_sys_t*	btr_search_sys;
 
@@ -41,9 +41,14 @@ struct btr_search_t;
 
 #ifndef UNIV_HOTBACKUP
 
-/** @brief The latch protecting the adaptive search system
+/** Number of adaptive hash index partitions */
+extern ulong	btr_ahi_parts;
 
-This latch protects the
+/** @brief The latches protecting the adaptive search system
+
+The adaptive hash index is split into btr_ahi_parts partitions, and
+the indexes are assigned to the partitions by btr_get_search_latch().
+The latch of a partition protects, for the indexes of the partition, the
 (1) hash index;
 (2) columns of a record to which we have a pointer in the hash index;
 
@@ -54,15 +59,12 @@ but does NOT protect:
 
 Bear in mind (3) and (4) when using the hash index.
 */
-extern rw_lock_t*	btr_search_latch_temp;
+extern rw_lock_t**	btr_search_latches;
 
 #endif /* UNIV_HOTBACKUP */
 
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
-
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by all of btr_search_latches. */
 extern char	btr_search_enabled;
 
 /** The size of a reference to data stored on a different page.
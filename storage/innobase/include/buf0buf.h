@@ -1792,6 +1792,21 @@ struct buf_block_t{
 					bufferfixed, or (2) the thread has an
 					x-latch on the block */
 	/* @} */
+	/** @name Secondary index visibility fields
+	These fields are protected by buf_block_t::lock, see
+	page_update_max_trx_id() and page_get_min_trx_id(). */
+	/* @{ */
+
+	trx_id_t	mod_min_trx_id;	/*!< smallest id of a transaction
+					that may have modified this secondary
+					index leaf page after its
+					PAGE_MAX_TRX_ID was last seen by all
+					read views */
+	trx_id_t	mod_max_trx_id;	/*!< PAGE_MAX_TRX_ID when
+					mod_min_trx_id was last updated;
+					mod_min_trx_id is only valid while the
+					page carries this value, 0 if unknown */
+	/* @} */
 	/** @name Hash search fields (unprotected)
 	NOTE that these fields are NOT protected by any semaphore! */
 	/* @{ */
@@ -1808,7 +1823,8 @@ struct buf_block_t{
 
 	/** @name Hash search fields
 	These 5 fields may only be modified when we have
-	an x-latch on btr_search_latch AND
+	an x-latch on the adaptive hash index partition latch of
+	the index (see btr_get_search_latch()) AND
 	- we are holding an s-latch or x-latch on buf_block_t::lock or
 	- we know that buf_block_t::buf_fix_count == 0.
 
@@ -1816,7 +1832,8 @@ struct buf_block_t{
 	in the buffer pool in buf0buf.cc.
 
 	Another exception is that assigning block->index = NULL
-	is allowed whenever holding an x-latch on btr_search_latch. */
+	is allowed whenever holding x-latches on all of
+	btr_search_latches. */
 
 	/* @{ */
 
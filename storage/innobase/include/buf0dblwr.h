@@ -31,9 +31,14 @@ Created 2011/12/19 Inaam Rana
 #include "log0log.h"
 #include "buf0types.h"
 #include "log0recv.h"
+#include "os0file.h"
 
 #ifndef UNIV_HOTBACKUP
 
+/** Name prefix of the doublewrite files, which are created in the data
+home directory, one for each buffer pool instance */
+#define BUF_DBLWR_FILE_PREFIX	"ib_doublewrite_"
+
 /** Doublewrite system */
 extern buf_dblwr_t*	buf_dblwr;
 /** Set to TRUE when the doublewrite buffer is being created */
@@ -53,9 +58,12 @@ At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory. */
+recovery, this function loads the pages from the doublewrite files, or
+from the doublewrite buffer in the system tablespace if the files do not
+exist yet, into memory.
+@return DB_SUCCESS, or DB_ERROR if a doublewrite file cannot be opened */
 
-void
+dberr_t
 buf_dblwr_init_or_load_pages(
 	os_file_t	file,
 	const char*	path);
@@ -106,15 +114,18 @@ void
 buf_dblwr_sync_datafiles();
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
+Flushes possible buffered writes from a doublewrite batch segment to disk,
 and also wakes up the aio thread if simulated aio is used. It is very
 important to call this function after a batch of writes has been posted,
 and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
 
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	ulint		instance_no,	/*!< in: buffer pool instance */
+	buf_flush_t	flush_type);	/*!< in: BUF_FLUSH_LRU or
+					BUF_FLUSH_LIST */
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -130,38 +141,71 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
+/** Doublewrite batch segment of a buffer pool instance for one flush
+type. Only one batch of a flush type runs in a buffer pool instance at a
+time, so each segment is filled by one thread. */
+struct buf_dblwr_seg_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
 				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
+	ulint		first_page;/*!< page number of the segment in
+				the doublewrite file */
 	ulint		first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
 				for batch flush. */
 	os_event_t	b_event;/*!< event where threads wait for a
 				batch flush to end. */
+	bool		batch_running;/*!< set to TRUE if currently a batch
+				is being written from the doublewrite
+				buffer. */
+	byte*		write_buf;/*!< srv_doublewrite_batch_size pages
+				of the write_buf of the file */
+	buf_page_t**	buf_block_arr;/*!< array to store pointers to
+				the buffer blocks which have been
+				cached to write_buf */
+};
+
+/** Doublewrite file of a buffer pool instance. It consists of a batch
+segment for BUF_FLUSH_LRU, one for BUF_FLUSH_LIST and the slots for
+single page flushes, in this order. */
+struct buf_dblwr_file_t{
+	char*		path;	/*!< path of the file */
+	os_file_t	handle;	/*!< file handle */
+	buf_dblwr_seg_t	segs[BUF_FLUSH_LIST + 1];
+				/*!< batch segments, indexed by the
+				flush type */
+	ib_mutex_t	mutex;	/*!< mutex protecting the single page
+				flush slots */
+	ulint		s_first_page;/*!< page number of the first single
+				page flush slot in the file */
 	ulint		s_reserved;/*!< number of slots currently
 				reserved for single page flushes. */
 	os_event_t	s_event;/*!< event where threads wait for a
 				single page flush slot. */
-	bool*		in_use;	/*!< flag used to indicate if a slot is
-				in use. Only used for single page
-				flushes. */
-	bool		batch_running;/*!< set to TRUE if currently a batch
-				is being written from the doublewrite
-				buffer. */
+	bool*		in_use;	/*!< flag used to indicate if a single
+				page flush slot is in use. */
+	buf_page_t**	s_block_arr;/*!< blocks in the single page
+				flush slots */
 	byte*		write_buf;/*!< write buffer used in writing to the
-				doublewrite buffer, aligned to an
+				doublewrite file, aligned to an
 				address divisible by UNIV_PAGE_SIZE
 				(which is required by Windows aio) */
 	byte*		write_buf_unaligned;/*!< pointer to write_buf,
 				but unaligned */
-	buf_page_t**	buf_block_arr;/*!< array to store pointers to
-				the buffer blocks which have been
-				cached to write_buf */
+};
+
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) in the
+				system tablespace. It is only read at
+				recovery from an older version. */
+	ulint		block2;	/*!< page number of the second block */
+	ulint		n_files;/*!< number of doublewrite files; 0 if
+				the doublewrite buffer is not in use */
+	buf_dblwr_file_t*
+			files;	/*!< doublewrite files, indexed by the
+				buffer pool instance */
 };
 
 
@@ -38,6 +38,12 @@ extern ibool buf_page_cleaner_is_active;
 /** Event to synchronise with the flushing. */
 extern os_event_t	buf_flush_event;
 
+#ifdef UNIV_DEBUG
+/** Value of innodb_page_cleaner_disabled_debug: whether the page cleaner
+leaves the dirty pages alone */
+extern my_bool		innodb_page_cleaner_disabled_debug;
+#endif /* UNIV_DEBUG */
+
 /********************************************************************//**
 Remove a block from the flush list of modified blocks. */
 
@@ -190,6 +190,33 @@ void
 buf_LRU_make_block_young(
 /*=====================*/
 	buf_page_t*	bpage);	/*!< in: control block */
+/** Create a scan ring. The pages that a scan accesses for the first
+time are recorded in the ring, and once the ring is full, the oldest of
+them is evicted from the buffer pool if nobody else has made it young
+in the meantime. A large scan thus keeps recycling about n_pages
+buffer pool blocks instead of pushing other pages out of the LRU list.
+@param[in]	n_pages		number of pages in the ring
+@return scan ring, to be freed with buf_LRU_scan_ring_free() */
+buf_scan_ring_t*
+buf_LRU_scan_ring_create(
+	ulint		n_pages);
+
+/** Evict the pages remaining in a scan ring, and free the ring.
+@param[in,out]	ring	scan ring created by buf_LRU_scan_ring_create() */
+void
+buf_LRU_scan_ring_free(
+	buf_scan_ring_t*	ring);
+
+/** Record the first access to a page by a scan. If the ring is full,
+evict the oldest page of the ring. The caller must not hold any buffer
+pool mutex.
+@param[in,out]	ring	scan ring
+@param[in]	bpage	page that was accessed for the first time */
+void
+buf_LRU_scan_ring_add(
+	buf_scan_ring_t*	ring,
+	const buf_page_t*	bpage);
+
 /******************************************************************//**
 Moves a block to the end of the LRU list. */
 
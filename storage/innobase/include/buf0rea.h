@@ -56,6 +56,21 @@ buf_read_page_background(
 	const page_size_t&	page_size,
 	bool			sync);
 
+/** Issues background read requests for pages of one tablespace that a
+buffer pool load wants to read in. The requests are posted without waking
+the i/o handler threads until the whole batch has been queued, so that
+requests for adjacent pages can be merged or submitted together.
+@param[in]	space		space id
+@param[in]	page_nos	array of page numbers to read, in ascending
+order
+@param[in]	n_pages		number of page numbers in the array
+@return number of page read requests issued */
+ulint
+buf_read_load_pages(
+	ulint		space,
+	const ulint*	page_nos,
+	ulint		n_pages);
+
 /** Applies a random read-ahead in buf_pool if there are at least a threshold
 value of accessed pages from the random read-ahead area. Does not read any
 page, not even the one at the position (space, offset), if the read-ahead
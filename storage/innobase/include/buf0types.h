@@ -44,6 +44,8 @@ struct buf_pool_stat_t;
 struct buf_buddy_stat_t;
 /** Doublewrite memory struct */
 struct buf_dblwr_t;
+/** Pages recycled by a scan, see buf_LRU_scan_ring_create() */
+struct buf_scan_ring_t;
 
 /** A buffer frame. @see page_t */
 typedef	byte	buf_frame_t;
@@ -1877,6 +1877,23 @@ trx_id_t
 dict_table_get_curr_table_sess_trx_id(
 	const dict_table_t*	table);
 
+/** Note that an undo log record that purge will have to process was
+written for a table.
+@param[in,out]	table	table */
+UNIV_INLINE
+void
+dict_table_purge_lag_inc(
+	dict_table_t*		table);
+
+/** Note that undo log records of a table were purged or rolled back.
+@param[in,out]	table	table
+@param[in]	n	number of undo log records */
+UNIV_INLINE
+void
+dict_table_purge_lag_sub(
+	dict_table_t*		table,
+	ulint			n);
+
 #ifndef UNIV_HOTBACKUP
 /*********************************************************************//**
 This function should be called whenever a page is successfully
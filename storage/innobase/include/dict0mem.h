@@ -56,6 +56,7 @@ Created 1/8/1996 Heikki Tuuri
 
 /* Forward declaration. */
 struct ib_rbt_t;
+struct dict_stats_dive_t;
 
 /** Type flags of an index: OR'ing of the flags is allowed to define a
 combination of types */
@@ -781,6 +782,15 @@ struct dict_index_t{
 	ulint		stat_n_leaf_pages;
 				/*!< approximate number of leaf pages in the
 				index tree */
+	dict_stats_dive_t*
+			stat_dives;
+				/*!< leaf page samples of the previous
+				persistent statistics calculation, sorted
+				by n_prefix and page number, allocated with
+				ut_malloc(), or NULL; see
+				innodb_stats_persistent_incremental */
+	ulint		stat_n_dives;
+				/*!< number of elements in stat_dives */
 	/* @} */
 	last_ops_cur_t*	last_ins_cur;
 				/*!< cache the last insert position.
@@ -1361,6 +1371,12 @@ struct dict_table_t {
 	itself check the number of open handles at DROP. */
 	ulint					n_ref_count;
 
+	/** Approximate number of undo log records of this table that purge
+	has not processed yet. Incremented when a modification is logged,
+	decremented when purge or rollback has consumed the records. It is
+	not persistent. Updated with atomic operations where available. */
+	volatile ulint				n_purge_pending;
+
 	/** List of locks on the table. Protected by lock_sys->mutex. */
 	table_lock_list_t			locks;
 
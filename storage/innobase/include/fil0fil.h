@@ -35,6 +35,7 @@ Created 10/25/1995 Heikki Tuuri
 #include "hash0hash.h"
 #include "page0size.h"
 #include "mtr0types.h"
+#include "os0comp.h"
 #include "ut0new.h"
 #ifndef UNIV_HOTBACKUP
 #include "ibuf0types.h"
@@ -141,6 +142,10 @@ struct fil_space_t {
 	ulint		flags;	/*!< tablespace flags; see
 				fsp_flags_is_valid(),
 				page_size_t(ulint) (constructor) */
+	os_comp_t	compression;
+				/*!< transparent page compression
+				algorithm of page writes; protected
+				by fil_system->mutex */
 	ulint		n_reserved_extents;
 				/*!< number of reserved free extents for
 				ongoing operations like B-tree page split */
@@ -303,6 +308,9 @@ extern fil_addr_t	fil_addr_null;
 #define FIL_PAGE_TYPE_ZBLOB2	12	/*!< Subsequent compressed BLOB page */
 #define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_ZBLOB2
 					/*!< Last page type */
+#define FIL_PAGE_COMPRESSED	14	/*!< Transparently compressed
+					page; only exists in data files,
+					never in the buffer pool */
 /* @} */
 
 /** macro to check whether the page type is index (Btree or Rtree) type */
@@ -366,6 +374,24 @@ void
 fil_space_set_imported(
 	ulint	id);
 
+/** Set the transparent page compression algorithm of a tablespace.
+Only pages that are written afterwards are affected.
+@param[in]	id		tablespace identifier
+@param[in]	algorithm	compression algorithm
+@return false if algorithm is not OS_COMP_NONE and the tablespace does
+not exist or cannot use transparent page compression */
+bool
+fil_space_set_compression(
+	ulint		id,
+	os_comp_t	algorithm);
+
+/** Get the file system block size of a file of a tablespace.
+@param[in]	node	file node of a data file
+@return block size */
+ulint
+fil_node_get_block_size(
+	const fil_node_t*	node);
+
 # ifdef UNIV_DEBUG
 /** Determine if a tablespace is temporary.
 @param[in]	id	tablespace identifier
@@ -383,6 +383,23 @@ ibuf_contract_in_background(
 					If FALSE then the size of contract
 					batch is determined based on the
 					current size of the ibuf tree. */
+
+/** A change buffer merge thread, see innodb_change_buffer_merge_threads.
+The pages that ibuf_contract_in_background() requests are merged in
+batches, preferring the pages with the most buffered changes.
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(ibuf_merge_thread)(
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/** Wake up the change buffer merge threads, so that they notice a
+shutdown.
+@return whether any change buffer merge thread has not exited yet */
+
+bool
+ibuf_merge_threads_active(void);
 #endif /* !UNIV_HOTBACKUP */
 /*********************************************************************//**
 Parses a redo log record of an ibuf bitmap page init.
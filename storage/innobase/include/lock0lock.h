@@ -535,6 +535,7 @@ lock_sec_rec_cons_read_sees(
 	const rec_t*		rec,	/*!< in: user record which
 					should be read or passed over
 					by a read cursor */
+	const buf_block_t*	block,	/*!< in: buffer block of rec */
 	const dict_index_t*     index,  /*!< in: index */
 	const ReadView*	view)	/*!< in: consistent read view */
 	__attribute__((warn_unused_result));
@@ -554,13 +555,16 @@ lock_table(
 	que_thr_t*	thr)	/*!< in: query thread */
 	__attribute__((warn_unused_result));
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table lock object for a resurrected transaction. */
 
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode);	/*!< in: LOCK_IX, or LOCK_X if the
+				transaction did a bulk insert into
+				the empty table */
 /*************************************************************//**
 Removes a granted record lock of a transaction from the queue and grants
 locks to other transactions waiting in the queue if they now are entitled
@@ -870,6 +874,15 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/*********************************************************************//**
+Searches the waits-for graph of the suspended lock waits for deadlocks
+and resolves them. This is done by the lock wait timeout thread when
+innodb_deadlock_detect=background. */
+
+void
+lock_wait_resolve_deadlocks(void);
+/*=============================*/
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -1063,10 +1076,37 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
+/** Number of record lock hash shards */
+#define LOCK_REC_N_SHARDS	64
+
+/** A record lock hash shard. The lock_sys->rec_hash cells that map to
+the shard, that is, the record lock queues of the pages in those cells,
+may be accessed either by X-latching latch while holding lock_sys->mutex,
+or by S-latching latch and then acquiring mutex. */
+struct lock_rec_shard_t{
+	rw_lock_t	latch;			/*!< X-latched by holders of
+						lock_sys->mutex that access
+						the record lock queues of
+						the shard. Record lock
+						requests that need not wait
+						S-latch it, and then acquire
+						only mutex */
+	LockMutex	mutex;			/*!< Mutex protecting the
+						record lock queues of
+						the shard */
+	byte		pad[CACHE_LINE_SIZE];	/*!< Padding to avoid false
+						sharing between shards */
+};
+
 /** The lock system struct */
 struct lock_sys_t{
 	LockMutex	mutex;			/*!< Mutex protecting the
 						locks */
+	lock_rec_shard_t
+			rec_shards[LOCK_REC_N_SHARDS];
+						/*!< Latches and mutexes
+						protecting the rec_hash
+						cells */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -1188,14 +1228,55 @@ lock_rec_trx_wait(
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
-#define lock_mutex_enter_nowait() 		\
-	(lock_sys->mutex.trylock(__FILE__, __LINE__))
+/** X-latch the latch of the record lock shard of a page, so that the
+record lock queue of the page may be accessed. The caller must hold
+lock_sys->mutex and no trx_t::mutex. The latch may be X-latched more
+than once.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number */
+
+void
+lock_rec_shard_x_lock(
+	ulint	space,
+	ulint	page_no);
+
+/** Release a latch X-latched by lock_rec_shard_x_lock().
+@param[in]	space	tablespace id
+@param[in]	page_no	page number */
+
+void
+lock_rec_shard_x_unlock(
+	ulint	space,
+	ulint	page_no);
+
+/** X-latch the latches of all the record lock shards, excluding all
+record lock shard users. This is needed where the record locks of
+several pages are accessed at once, such as in deadlock detection or
+when printing all locks. The caller must hold lock_sys->mutex and no
+trx_t::mutex. */
+
+void
+lock_rec_shards_x_lock();
+
+/** Release the latches X-latched by lock_rec_shards_x_lock(). */
+
+void
+lock_rec_shards_x_unlock();
+
+/** Acquire the lock_sys->mutex and X-latch the latches of all the record
+lock shards, if that can be done without waiting.
+@return 0 if the mutex was acquired */
+
+ulint
+lock_mutex_enter_nowait();
 
 /** Test if lock_sys->mutex is owned. */
 #define lock_mutex_own() (lock_sys->mutex.is_owned())
 
-/** Acquire the lock_sys->mutex. */
+/** Acquire the lock_sys->mutex. It protects the table locks, the
+predicate locks and the lock waits. The record lock queues of
+lock_sys->rec_hash also need the record lock shard: see
+lock_rec_shard_x_lock() and lock_mutex_enter_all(). */
 #define lock_mutex_enter() do {			\
 	mutex_enter(&lock_sys->mutex);		\
 } while (0)
@@ -1205,6 +1286,49 @@ extern lock_sys_t*	lock_sys;
 	lock_sys->mutex.exit();			\
 } while (0)
 
+/** Acquire the lock_sys->mutex and X-latch the latches of all the record
+lock shards, excluding all record lock shard users. */
+#define lock_mutex_enter_all() do {		\
+	lock_mutex_enter();			\
+	lock_rec_shards_x_lock();		\
+} while (0)
+
+/** Release the record lock shard latches and the lock_sys->mutex. */
+#define lock_mutex_exit_all() do {		\
+	lock_rec_shards_x_unlock();		\
+	lock_mutex_exit();			\
+} while (0)
+
+/** Get the record lock hash shard of a lock_sys->rec_hash cell.
+@param[in]	cell	lock_rec_hash() of the page
+@return the shard */
+#define lock_rec_shard_get(cell)		\
+	(&lock_sys->rec_shards[(cell) % LOCK_REC_N_SHARDS])
+
+#ifdef UNIV_DEBUG
+/** Test if the lock queue of a page may be accessed: the caller must
+hold either the lock_sys->mutex, or the record lock shard of the page
+if the queue is in lock_sys->rec_hash.
+@param[in]	hash	lock hash table
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return true if the queue is latched by the current thread */
+
+bool
+lock_rec_queue_own(
+	const hash_table_t*	hash,
+	ulint			space,
+	ulint			page_no);
+
+/** Test if the lock queue that a record lock is in may be accessed.
+@param[in]	lock	record lock
+@return true if the queue is latched by the current thread */
+# define lock_rec_own_queue(lock)				\
+	lock_rec_queue_own(lock_hash_get((lock)->type_mode),	\
+			   (lock)->un_member.rec_lock.space,	\
+			   (lock)->un_member.rec_lock.page_no)
+#endif /* UNIV_DEBUG */
+
 /** Test if lock_sys->wait_mutex is owned. */
 #define lock_wait_mutex_own() (lock_sys->wait_mutex.is_owned())
 
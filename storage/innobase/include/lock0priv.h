@@ -95,6 +95,10 @@ static const ulint	LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK = 1000000;
 transactions */
 static const ulint	LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK = 200;
 
+/** Minimum interval in microseconds between searches of the waits-for
+graph by the lock wait timeout thread, with innodb_deadlock_detect=background */
+static const ulint	LOCK_DEADLOCK_CHECK_INTERVAL = 100000;
+
 /** When releasing transaction locks, this specifies how often we release
 the lock mutex for a moment to give also others access to it */
 static const ulint	LOCK_RELEASE_INTERVAL = 1000;
@@ -118,6 +118,38 @@ log_write_low(
 /*==========*/
 	const byte*	str,		/*!< in: string */
 	ulint		str_len);	/*!< in: string length */
+
+/** Reserves space for a string in the log buffer without copying it,
+like log_write_low() would write it. The caller must hold the log mutex,
+and must copy the string with log_write_reserved() and then call
+log_write_reserved_complete(), which can be done after the log mutex
+has been released.
+@param[in]	str_len	string length
+@return offset in log_sys->buf where the string is to be copied */
+
+ulint
+log_reserve_low(
+	ulint	str_len);
+
+/** Copies (a part of) a string to log buffer space that was reserved
+with log_reserve_low(). The caller need not hold the log mutex.
+@param[in]	offset	offset in log_sys->buf where to copy
+@param[in]	str	string
+@param[in]	str_len	string length
+@return offset in log_sys->buf following the copied string */
+
+ulint
+log_write_reserved(
+	ulint		offset,
+	const byte*	str,
+	ulint		str_len);
+
+/** Notes that a string has been completely copied to log buffer space
+that was reserved with log_reserve_low(). */
+
+void
+log_write_reserved_complete();
+
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -699,6 +731,15 @@ struct log_t{
 					groups */
 	volatile bool	is_extending;	/*!< this is set to true during extend
 					the log buffer size */
+	volatile ulint	n_pending_copies;/*!< number of strings for which
+					space was reserved in the log buffer
+					with log_reserve_low() but which have
+					not been copied there yet; the log
+					buffer may only be written or moved
+					while this is 0 and the log mutex is
+					held */
+	os_event_t	copies_event;	/*!< set when n_pending_copies
+					drops to 0 */
 	lsn_t		write_lsn;	/*!< last written lsn */
 	ulint		write_end_offset;/*!< the data in buffer has
 					been written up to this offset
@@ -35,6 +35,7 @@ Created 9/20/1997 Heikki Tuuri
 #include "ut0new.h"
 
 #include <list>
+#include <vector>
 
 #ifdef UNIV_HOTBACKUP
 extern ibool	recv_replay_file_ops;
@@ -289,10 +290,15 @@ struct recv_dblwr_t {
 		pages.push_back(page);
 	}
 
-	/** Clear the list of pages (invoked by ut_when_dtor) */
-	void operator() () {
-		pages.clear();
-	}
+	/** Allocate a buffer for reading doublewrite pages. It is freed
+	together with the list of pages.
+	@param[in]	n_pages	number of pages
+	@return buffer aligned to UNIV_PAGE_SIZE */
+	byte* alloc(ulint n_pages);
+
+	/** Clear the list of pages and free the buffers
+	(invoked by ut_when_dtor) */
+	void operator() ();
 
 	/** Find a doublewrite copy of a page.
 	@param[in]	space_id	tablespace identifier
@@ -305,8 +311,15 @@ struct recv_dblwr_t {
 
 	/** Recovered doublewrite buffer page frames */
 	list	pages;
+
+	typedef std::vector<byte*, ut_allocator<byte*> >	bufs_t;
+
+	/** Buffers that the page frames were read to */
+	bufs_t	bufs;
 };
 
+struct recv_apply_workers_t;
+
 /** Recovery system data structure */
 struct recv_sys_t{
 #ifndef UNIV_HOTBACKUP
@@ -323,6 +336,9 @@ struct recv_sys_t{
 	buf_flush_t		flush_type;/*!< type of the flush request.
 				BUF_FLUSH_LRU: flush end of LRU, keeping free blocks.
 				BUF_FLUSH_LIST: flush all of blocks. */
+	recv_apply_workers_t*	apply_workers;/*!< the threads applying
+				the current batch in parallel, or NULL
+				if innodb_recovery_apply_threads=0 */
 #endif /* !UNIV_HOTBACKUP */
 	ibool		apply_log_recs;
 				/*!< this is TRUE when log rec application to
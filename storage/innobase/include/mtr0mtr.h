@@ -189,6 +189,10 @@ struct mtr_t {
 		/** State of the transaction */
 		mtr_state_t	m_state;
 
+		/** Ring of pages that the pages accessed for the first
+		time are recycled through, or NULL for normal LRU policy */
+		buf_scan_ring_t*	m_scan_ring;
+
 #ifdef UNIV_DEBUG
 		/** For checking corruption. */
 		ulint		m_magic_n;
@@ -365,6 +369,21 @@ struct mtr_t {
 		return(m_impl.m_inside_ibuf);
 	}
 
+	/** Make the pages accessed for the first time in this
+	mini-transaction recycle through a scan ring instead of
+	staying in the buffer pool LRU list.
+	@param ring	scan ring, or NULL for normal LRU policy */
+	void set_scan_ring(buf_scan_ring_t* ring)
+	{
+		m_impl.m_scan_ring = ring;
+	}
+
+	/** @return the scan ring, or NULL */
+	buf_scan_ring_t* get_scan_ring() const
+	{
+		return(m_impl.m_scan_ring);
+	}
+
 	/*
 	@return true if the mini-transaction is active */
 	bool is_active() const
@@ -0,0 +1,131 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/os0comp.h
+Transparent page compression in the i/o layer
+
+A page of a tablespace that uses transparent page compression is
+compressed when it is written to the data file and decompressed when
+it is read back. The buffer pool only ever holds uncompressed pages.
+The compressed image is written at the start of the page slot in the
+file, and the unused tail of the slot is released with a hole punch,
+so that the file keeps its logical size and page offsets.
+
+The on-disk format of a compressed page is:
+[0, FIL_PAGE_TYPE)	the original page header, unchanged
+FIL_PAGE_TYPE		FIL_PAGE_COMPRESSED
+OS_COMP_ALGORITHM	the algorithm, 1 byte
+OS_COMP_LEN		the length of the compressed payload, 2 bytes
+FIL_PAGE_SPACE_ID	the space id, unchanged
+FIL_PAGE_DATA		the payload: bytes [FIL_PAGE_TYPE, UNIV_PAGE_SIZE)
+			of the original page, compressed
+*******************************************************/
+
+#ifndef os0comp_h
+#define os0comp_h
+
+#include "univ.i"
+
+/** Transparent page compression algorithms. These values are stored
+in the compressed pages and must not be changed. */
+enum os_comp_t {
+	OS_COMP_NONE = 0,	/*!< no compression */
+	OS_COMP_ZLIB = 1,	/*!< zlib deflate */
+	OS_COMP_LZ = 2,		/*!< built-in LZ77 codec */
+	OS_COMP_MAX		/*!< number of algorithms */
+};
+
+/** Offset of the algorithm of a compressed page */
+#define OS_COMP_ALGORITHM	26
+/** Offset of the payload length of a compressed page */
+#define OS_COMP_LEN		28
+
+/** A codec for transparent page compression */
+struct os_comp_codec_t {
+	/** name of the codec, as given in the table COMMENT */
+	const char*	name;
+
+	/** Compress a buffer.
+	@param[in]	in	data to compress
+	@param[in]	in_len	length of in
+	@param[out]	out	compressed data
+	@param[in]	out_len	size of out
+	@return length of the compressed data, or 0 if it would not
+	fit in out_len bytes */
+	ulint		(*compress)(
+		const byte*	in,
+		ulint		in_len,
+		byte*		out,
+		ulint		out_len);
+
+	/** Decompress a buffer.
+	@param[in]	in	compressed data
+	@param[in]	in_len	length of in
+	@param[out]	out	decompressed data
+	@param[in]	out_len	expected length of the decompressed data
+	@return true if exactly out_len bytes were decompressed */
+	bool		(*decompress)(
+		const byte*	in,
+		ulint		in_len,
+		byte*		out,
+		ulint		out_len);
+};
+
+/** Look up a compression algorithm by name.
+@param[in]	name	codec name, case insensitive
+@param[in]	len	length of name
+@return algorithm, or OS_COMP_MAX if there is no such codec */
+os_comp_t
+os_comp_find(
+	const char*	name,
+	ulint		len);
+
+/** Get the name of a compression algorithm.
+@param[in]	algorithm	compression algorithm
+@return name of the codec */
+const char*
+os_comp_name(
+	os_comp_t	algorithm);
+
+/** Compress a page for writing it to a data file.
+@param[in]	algorithm	compression algorithm
+@param[in]	page		uncompressed page of UNIV_PAGE_SIZE bytes
+@param[in]	block_size	file system block size
+@param[out]	out		buffer of UNIV_PAGE_SIZE bytes
+@return number of bytes to write, a multiple of block_size, or 0 if
+the page should be written uncompressed */
+ulint
+os_comp_page_compress(
+	os_comp_t	algorithm,
+	const byte*	page,
+	ulint		block_size,
+	byte*		out);
+
+/** Decompress a page that was read from a data file, in place. Pages
+that are not compressed are left alone.
+@param[in,out]	page		page of UNIV_PAGE_SIZE bytes
+@param[in,out]	scratch		buffer of UNIV_PAGE_SIZE bytes, or NULL
+to allocate one
+@return false if the page is compressed and could not be decompressed */
+bool
+os_comp_page_decompress(
+	byte*		page,
+	byte*		scratch);
+
+#endif /* os0comp_h */
@@ -162,6 +162,18 @@ enum os_file_create_t {
 #define OS_FILE_WRITE	11
 
 #define OS_FILE_LOG	256	/* This can be ORed to type */
+
+#define OS_FILE_PAGE	2048	/* This can be ORed to type: the i/o is
+				of a whole page of a data file, which
+				may be in the transparently compressed
+				format of os0comp.h */
+#define OS_FILE_COMPRESS_SHIFT	12
+				/* The os_comp_t algorithm of a write
+				of an OS_FILE_PAGE is ORed to type,
+				shifted left by this many bits */
+#define OS_FILE_TYPE_MASK	255
+				/* Mask of OS_FILE_READ or
+				OS_FILE_WRITE in type */
 /* @} */
 
 #define OS_AIO_N_PENDING_IOS_PER_THREAD 32	/*!< Win NT does not allow more
@@ -765,7 +777,10 @@ UNIV_INLINE
 bool
 pfs_os_aio_func(
 /*============*/
-	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE,
+				possibly ORed to OS_FILE_PAGE and
+				the compression algorithm of a page
+				write, see OS_FILE_COMPRESS_SHIFT */
 	ulint		mode,	/*!< in: OS_AIO_NORMAL etc. I/O mode */
 	const char*	name,	/*!< in: name of the file or path as a
 				null-terminated string */
@@ -890,6 +905,26 @@ os_file_get_size(
 /*=============*/
 	os_file_t	file)	/*!< in: handle to a file */
 	__attribute__((warn_unused_result));
+/** Get the block size of the file system of a file.
+@param[in]	file	handle to a file
+@return block size, a power of 2 between 512 and UNIV_PAGE_SIZE */
+ulint
+os_file_get_block_size(
+	os_file_t	file);
+
+/** Free the storage of a range of a file, keeping the file size.
+The range reads back as zeros.
+@param[in]	file	handle to a file
+@param[in]	offset	start of the range
+@param[in]	len	length of the range
+@return true if successful, false if the file system does not
+support it or there was an error */
+bool
+os_file_punch_hole(
+	os_file_t	file,
+	os_offset_t	offset,
+	os_offset_t	len);
+
 /***********************************************************************//**
 Write the specified number of zeros to a newly created file.
 @return TRUE if success */
@@ -1117,7 +1152,10 @@ Requests an asynchronous i/o operation.
 bool
 os_aio_func(
 /*========*/
-	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE,
+				possibly ORed to OS_FILE_PAGE and
+				the compression algorithm of a page
+				write, see OS_FILE_COMPRESS_SHIFT */
 	ulint		mode,	/*!< in: OS_AIO_NORMAL, ..., possibly ORed
 				to OS_AIO_SIMULATED_WAKE_LATER: the
 				last flag advises this function not to wake
@@ -1179,6 +1217,37 @@ void
 os_aio_simulated_put_read_threads_to_sleep(void);
 /*============================================*/
 
+/** Register the buffer pool memory with the io_uring instances, so that
+page reads and writes do not need to map the pages for each request.
+Any previously registered buffers are unregistered first. This is a
+no-op unless innodb_use_io_uring is in effect.
+@param[in]	mem	start addresses of the memory chunks
+@param[in]	size	sizes of the memory chunks in bytes
+@param[in]	n	number of memory chunks */
+
+void
+os_aio_register_buffers(
+	byte* const*	mem,
+	const ulint*	size,
+	ulint		n);
+
+/** Unregister the buffers registered by os_aio_register_buffers(). This
+must be called before the buffer pool memory is freed. */
+
+void
+os_aio_unregister_buffers();
+
+/** Flush the write buffers of several files to the disk. With io_uring
+the files are flushed concurrently; otherwise one after another with
+os_file_flush(). As with os_file_flush(), a failure is fatal.
+@param[in]	files	handles to the files
+@param[in]	n	number of files */
+
+void
+os_file_flush_files(
+	const os_file_t*	files,
+	ulint			n);
+
 #ifdef WIN_ASYNC_IO
 /**********************************************************************//**
 This function is only used in Windows asynchronous i/o.
@@ -1297,7 +1366,7 @@ innobase_mysql_tmpfile(void);
 #endif /* !UNIV_HOTBACKUP */
 
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 /**************************************************************************
 This function is only used in Linux native asynchronous i/o.
 Waits for an aio operation to complete. This function is used to wait the
@@ -1322,7 +1391,7 @@ os_aio_linux_handle(
 				parameters are valid and can be used to
 				restart the operation. */
 	ulint*	type);		/*!< out: OS_FILE_WRITE or ..._READ */
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 
 /** Normalizes a directory path for Windows: converts '/' to '\'.
 @param[in,out] str A null-terminated Windows directory and file path */
@@ -0,0 +1,168 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/os0uring.h
+A minimal interface to the Linux io_uring system calls
+
+The submission queue of a ring has a single producer: the caller must
+serialize os_uring_get_sqe() and os_uring_submit() on a ring. The
+completion queue has a single consumer: os_uring_wait_cqe() and
+os_uring_cqe_seen() must only be called by one thread at a time.
+Submitting and reaping may run concurrently.
+*******************************************************/
+
+#ifndef os0uring_h
+#define os0uring_h
+
+#include "univ.i"
+
+#ifdef LINUX_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+/** An io_uring instance, with its rings mapped to user space */
+struct os_uring_t {
+	/** file descriptor of the ring, or -1 */
+	int			fd;
+
+	/** number of submission queue entries */
+	unsigned		sq_entries;
+	/** head of the submission queue, advanced by the kernel */
+	unsigned*		sq_khead;
+	/** tail of the submission queue, advanced by us */
+	unsigned*		sq_ktail;
+	/** mask of the submission queue indexes */
+	unsigned		sq_mask;
+	/** indirection array of the submission queue */
+	unsigned*		sq_array;
+	/** submission queue entries */
+	struct io_uring_sqe*	sqes;
+	/** next submission queue entry to hand out */
+	unsigned		sqe_tail;
+	/** first submission queue entry not yet made visible
+	to the kernel */
+	unsigned		sqe_head;
+
+	/** head of the completion queue, advanced by us */
+	unsigned*		cq_khead;
+	/** tail of the completion queue, advanced by the kernel */
+	unsigned*		cq_ktail;
+	/** mask of the completion queue indexes */
+	unsigned		cq_mask;
+	/** completion queue entries */
+	struct io_uring_cqe*	cqes;
+
+	/** mapping of the submission queue ring */
+	void*			sq_ring;
+	/** size of sq_ring */
+	size_t			sq_ring_size;
+	/** mapping of the completion queue ring, or NULL if it
+	is shared with sq_ring */
+	void*			cq_ring;
+	/** size of cq_ring */
+	size_t			cq_ring_size;
+	/** size of the mapping of sqes */
+	size_t			sqes_size;
+};
+
+/** Create an io_uring instance.
+@param[out]	ring	ring to initialize
+@param[in]	entries	minimum number of submission queue entries
+@return 0 or -errno */
+int
+os_uring_create(
+	os_uring_t*	ring,
+	ulint		entries);
+
+/** Free an io_uring instance. Pending requests are cancelled.
+@param[in,out]	ring	ring created by os_uring_create() */
+void
+os_uring_free(
+	os_uring_t*	ring);
+
+/** Get a free submission queue entry. It is not visible to the kernel
+before os_uring_submit() is called.
+@param[in,out]	ring	ring
+@return zero-filled entry, or NULL if the submission queue is full */
+struct io_uring_sqe*
+os_uring_get_sqe(
+	os_uring_t*	ring);
+
+/** Get the number of submission queue entries that were handed out
+but not submitted yet.
+@param[in]	ring	ring
+@return number of unsubmitted entries */
+UNIV_INLINE
+unsigned
+os_uring_n_queued(
+	const os_uring_t*	ring)
+{
+	return(ring->sqe_tail - ring->sqe_head);
+}
+
+/** Submit the entries that were handed out by os_uring_get_sqe(), and
+any entries that an earlier call failed to submit.
+@param[in,out]	ring	ring
+@return number of submitted entries, or -errno; on error, the entries
+that were not submitted remain in the submission queue */
+int
+os_uring_submit(
+	os_uring_t*	ring);
+
+/** Wait for a completion.
+@param[in,out]	ring	ring
+@param[in]	wait	whether to wait for a completion if there is
+none
+@return completion that must be released with os_uring_cqe_seen(), or
+NULL if wait == false and there is none, or if the wait was
+interrupted */
+struct io_uring_cqe*
+os_uring_wait_cqe(
+	os_uring_t*	ring,
+	bool		wait);
+
+/** Release a completion returned by os_uring_wait_cqe().
+@param[in,out]	ring	ring */
+void
+os_uring_cqe_seen(
+	os_uring_t*	ring);
+
+/** Register buffers for IORING_OP_READ_FIXED and IORING_OP_WRITE_FIXED.
+@param[in,out]	ring	ring
+@param[in]	iov	buffers
+@param[in]	n	number of buffers
+@return 0 or -errno */
+int
+os_uring_register_buffers(
+	os_uring_t*		ring,
+	const struct iovec*	iov,
+	ulint			n);
+
+/** Unregister the buffers registered with os_uring_register_buffers().
+Requests that use them may still be in flight.
+@param[in,out]	ring	ring
+@return 0 or -errno */
+int
+os_uring_unregister_buffers(
+	os_uring_t*	ring);
+
+#endif /* LINUX_IO_URING */
+
+#endif /* os0uring_h */
@@ -201,7 +201,7 @@ page_set_max_trx_id(
 	mtr_t*		mtr);	/*!< in/out: mini-transaction, or NULL */
 /*************************************************************//**
 Sets the max trx id field value if trx_id is bigger than the previous
-value. */
+value, and records that the transaction modified the page. */
 UNIV_INLINE
 void
 page_update_max_trx_id(
@@ -209,8 +209,49 @@ page_update_max_trx_id(
 	buf_block_t*	block,	/*!< in/out: page */
 	page_zip_des_t*	page_zip,/*!< in/out: compressed page whose
 				uncompressed part will be updated, or NULL */
-	trx_id_t	trx_id,	/*!< in: transaction id */
+	trx_id_t	trx_id,	/*!< in: id of the transaction that
+				modified the page */
+	mtr_t*		mtr);	/*!< in/out: mini-transaction */
+/*************************************************************//**
+Sets the max trx id field value if max_trx_id is bigger than the previous
+value, when the page receives records that were modified by unknown
+transactions, such as records copied from another page or merged from
+the change buffer. */
+UNIV_INLINE
+void
+page_inherit_max_trx_id(
+/*====================*/
+	buf_block_t*	block,	/*!< in/out: page */
+	page_zip_des_t*	page_zip,/*!< in/out: compressed page whose
+				uncompressed part will be updated, or NULL */
+	trx_id_t	max_trx_id,/*!< in: PAGE_MAX_TRX_ID of the
+				records */
 	mtr_t*		mtr);	/*!< in/out: mini-transaction */
+#ifndef UNIV_HOTBACKUP
+/*************************************************************//**
+Records that a transaction modified a secondary index leaf page, so that
+consistent reads can tell whether they see all changes on the page even
+when PAGE_MAX_TRX_ID is not older than their read view. The record is
+kept in the buffer pool only; it restarts whenever all modifications of
+the page have become visible to the purge view. */
+
+void
+page_track_trx_id(
+/*==============*/
+	buf_block_t*	block,	/*!< in/out: X-latched page */
+	trx_id_t	trx_id);/*!< in: id of the transaction that
+				modified the page */
+/*************************************************************//**
+Returns the smallest id of a transaction that may have modified a
+secondary index leaf page after all older modifications of the page
+became visible to every read view.
+@return the smallest transaction id, or 0 if not known */
+UNIV_INLINE
+trx_id_t
+page_get_min_trx_id(
+/*================*/
+	const buf_block_t*	block);	/*!< in: latched page */
+#endif /* !UNIV_HOTBACKUP */
 /*************************************************************//**
 Returns the RTREE SPLIT SEQUENCE NUMBER (FIL_RTREE_SPLIT_SEQ_NUM).
 @return SPLIT SEQUENCE NUMBER */
@@ -53,15 +53,25 @@ public:
 	/**
 	Close a view created by the above function.
 	@para view		view allocated by trx_open.
-	@param own_mutex	true if caller owns trx_sys_t::mutex */
-	void view_close(ReadView*& view, bool own_mutex);
+	@param free_view	true if the view should be returned to the
+				free list, false if it should only be marked
+				as closed (AC-NL-RO transactions) */
+	void view_close(ReadView*& view, bool free_view);
 
 	/**
-	Release a view that is inactive but not closed. Caller must own
-	the trx_sys_t::mutex.
+	Release a view that is inactive but not closed.
 	@param view		View to release */
 	void view_release(ReadView*& view);
 
+	/**
+	Publish the state that read views are created from: the active
+	read-write transaction ids, the transaction id high water mark
+	and the smallest serialisation number. Readers copy it without
+	acquiring the trx_sys_t::mutex. Caller must own the
+	trx_sys_t::mutex and must call this after every change to
+	trx_sys_t::rw_trx_ids. */
+	void snapshot_publish();
+
 	/** Clones the oldest view and stores it in view. No need to
 	call view_close(). The caller owns the view that is passed in.
 	It will also move the closed views from the m_views list to the
@@ -71,7 +81,7 @@ public:
 
 	/**
 	@return the number of active views */
-	ulint size() const;
+	ulint size();
 
 	/**
 	@return true if the view is active and valid */
@@ -85,7 +95,7 @@ public:
 	/**
 	Set the view creator transaction id. Note: This shouldbe set only
 	for views created by RW transactions. */
-	static void set_view_creator_trx_id(ReadView* view, trx_id_t id);
+	void set_view_creator_trx_id(ReadView* view, trx_id_t id);
 
 private:
 
@@ -106,6 +116,12 @@ private:
 	@return oldest view if found or NULL */
 	inline ReadView* get_oldest_view() const;
 
+	/**
+	Copy the last published snapshot to the view. Retries if the
+	snapshot is republished while it is being copied.
+	@param view		view to copy the snapshot to */
+	inline void snapshot_copy(ReadView* view) const;
+
 private:
 	// Prevent copying
 	MVCC(const MVCC&);
@@ -114,12 +130,63 @@ private:
 private:
 	typedef UT_LIST_BASE_NODE_T(ReadView) view_list_t;
 
+	/** Array of transaction ids published by snapshot_publish() */
+	struct ids_array_t {
+		/** Number of elements that m_ids can hold */
+		ulint		m_capacity;
+
+		/** The array that this one replaced. A reader may still
+		be copying from it, therefore arrays are only freed in
+		the destructor. */
+		ids_array_t*	m_prev;
+
+		/** Transaction ids in ascending order */
+		trx_id_t	m_ids[1];
+	};
+
+	/** Allocate an array of transaction ids.
+	@param capacity		number of elements
+	@param prev		the array being replaced, or NULL
+	@return new array */
+	static ids_array_t* ids_array_create(ulint capacity, ids_array_t* prev);
+
+	/** Mutex protecting m_free, m_views and m_purge_version */
+	ib_mutex_t		m_mutex;
+
 	/** Free views ready for reuse. */
 	view_list_t		m_free;
 
 	/** Active and closed views, the closed views will have the
-	creator trx id set to TRX_ID_MAX */
+	creator trx id set to TRX_ID_MAX. The list is not ordered, a
+	view is registered after its snapshot has been copied. */
 	view_list_t		m_views;
+
+	/** Snapshot version of the last view cloned by purge. A view
+	with an older snapshot must copy the snapshot again before it
+	is registered, otherwise purge could already have removed
+	versions that the view needs. */
+	ulint			m_purge_version;
+
+	/** To avoid false sharing with the view lists */
+	byte			m_pad[64];
+
+	/** Snapshot version, odd while snapshot_publish() is
+	updating the fields below. Protected by trx_sys_t::mutex
+	for writing; read without any latch. */
+	volatile ulint		m_version;
+
+	/** Published copy of trx_sys_t::rw_trx_ids */
+	ids_array_t* volatile	m_ids;
+
+	/** Number of elements in m_ids */
+	volatile ulint		m_n_ids;
+
+	/** Published value of trx_sys_t::max_trx_id */
+	volatile trx_id_t	m_low_limit_id;
+
+	/** Published smallest serialisation number of the committing
+	transactions, or m_low_limit_id */
+	volatile trx_id_t	m_low_limit_no;
 };
 
 #endif /* read0read_h */
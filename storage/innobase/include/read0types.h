@@ -182,6 +182,35 @@ public:
 		return(id < m_up_limit_id);
 	}
 
+	/**
+	Check whether the changes by all transactions whose ids are in
+	the range [low, high] are visible.
+	@param low		smallest transaction id to check
+	@param high		largest transaction id to check
+	@return true if the view sees the modifications of every id */
+	bool sees_range(trx_id_t low, trx_id_t high) const
+	{
+		ut_ad(low <= high);
+
+		if (high < m_up_limit_id) {
+
+			return(true);
+
+		} else if (high >= m_low_limit_id) {
+
+			return(false);
+		}
+
+		const ids_t::value_type*	p = m_ids.data();
+		const ids_t::value_type*	end = p + m_ids.size();
+
+		/* No transaction that was active when the view was
+		created may fall in the range. */
+		p = std::lower_bound(p, end, low);
+
+		return(p == end || *p > high);
+	}
+
 	/**
 	Mark the view as closed */
 	void close()
@@ -229,6 +258,13 @@ public:
 		return(m_ids.empty());
 	}
 
+	/**
+	@return the up limit id */
+	trx_id_t up_limit_id() const
+	{
+		return(m_up_limit_id);
+	}
+
 #ifdef UNIV_DEBUG
 	/**
 	@param rhs		view to compare with
@@ -238,19 +274,24 @@ public:
 		return(m_low_limit_no <= rhs->m_low_limit_no);
 	}
 
-	trx_id_t up_limit_id() const
+	/**
+	@return the version of the snapshot that the view was created from */
+	ulint version() const
 	{
-		return(m_up_limit_id);
+		return(m_version);
 	}
 #endif /* UNIV_DEBUG */
 private:
 	/**
-	Copy the transaction ids from the source vector */
-	inline void copy_trx_ids(const trx_ids_t& trx_ids);
+	Copy the transaction ids from the published snapshot
+	@param ids		transaction ids, in ascending order
+	@param n		number of elements in ids */
+	inline void copy_trx_ids(const trx_id_t* ids, ulint n);
 
 	/**
 	Opens a read view where exactly the transactions serialized before this
-	point in time are seen in the view.
+	point in time are seen in the view. The snapshot must have been
+	copied by MVCC::snapshot_copy().
 	@param id		Creator transaction id */
 	inline void prepare(trx_id_t id);
 
@@ -306,6 +347,10 @@ private:
 	they can be removed in purge if not needed by other views */
 	trx_id_t	m_low_limit_no;
 
+	/** Version of the published snapshot that the view was
+	created from, see MVCC::snapshot_publish() */
+	ulint		m_version;
+
 	/** AC-NL-RO transaction view that has been "closed". */
 	bool		m_closed;
 
@@ -118,6 +118,11 @@ struct row_merge_dup_t {
 					(index->table), or NULL if not
 					rebuilding table */
 	ulint			n_dup;	/*!< number of duplicates */
+	mem_heap_t*		heap;	/*!< NULL, or the heap where a merge
+					sort thread copies the first
+					duplicate instead of reporting it
+					to table */
+	const dtuple_t*		entry;	/*!< the copied duplicate, or NULL */
 };
 
 /*************************************************************//**
@@ -368,7 +373,7 @@ dberr_t
 row_merge_sort(
 /*===========*/
 	trx_t*			trx,	/*!< in: transaction */
-	const row_merge_dup_t*	dup,	/*!< in: descriptor of
+	row_merge_dup_t*	dup,	/*!< in/out: descriptor of
 					index being created */
 	merge_file_t*		file,	/*!< in/out: file containing
 					index entries */
@@ -430,4 +435,60 @@ row_merge_read_rec(
 					(non-NULL on I/O error) */
 	ulint*			offsets)/*!< out: offsets of mrec */
 	__attribute__((nonnull, warn_unused_result));
+/** Check whether all indexes of a table are empty.
+@param[in]	table	table
+@return whether the table is empty */
+bool
+row_merge_bulk_table_is_empty(
+	const dict_table_t*	table)
+	__attribute__((warn_unused_result));
+
+/** Start a bulk insert into an empty table. A single TRX_UNDO_EMPTY
+record is written, whose rollback empties the table, instead of an undo
+log record for each row. The caller must hold an exclusive lock on the
+table, and all inserts into the table until row_merge_bulk_finish() must
+go through row_merge_bulk_insert().
+@param[in,out]	trx		transaction
+@param[in]	thr		query thread of the insert graph
+@param[in,out]	table		table to load
+@param[in,out]	mysql_table	MySQL table, for reporting duplicate keys
+@param[out]	bulk		bulk insert, or NULL if the table is not
+empty
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_create(
+	trx_t*			trx,
+	que_thr_t*		thr,
+	dict_table_t*		table,
+	struct TABLE*		mysql_table,
+	row_merge_bulk_t**	bulk)
+	__attribute__((warn_unused_result));
+
+/** Insert a row in bulk mode.
+@param[in,out]	bulk	bulk insert
+@param[in,out]	node	insert node, with the row converted from the
+MySQL format and DB_TRX_ID written
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_insert(
+	row_merge_bulk_t*	bulk,
+	ins_node_t*		node)
+	__attribute__((warn_unused_result));
+
+/** Finish a bulk insert: complete the clustered index, build the
+secondary indexes from the sorted entries, and make the loaded pages
+durable by a checkpoint.
+@param[in,out]	bulk	bulk insert, freed by row_merge_bulk_free()
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_finish(
+	row_merge_bulk_t*	bulk)
+	__attribute__((warn_unused_result));
+
+/** Free a bulk insert. If row_merge_bulk_finish() was not called, the
+loaded pages are abandoned; the statement must then be rolled back.
+@param[in,out]	bulk	bulk insert */
+void
+row_merge_bulk_free(
+	row_merge_bulk_t*	bulk);
 #endif /* row0merge.h */
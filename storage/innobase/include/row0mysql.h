@@ -211,6 +211,14 @@ row_create_prebuilt(
 	ulint		mysql_row_len);	/*!< in: length in bytes of a row in
 					the MySQL format */
 /********************************************************************//**
+Free the fetch cache of a prebuilt struct, after checking the magic numbers
+around the cached rows. */
+
+void
+row_prebuilt_free_fetch_cache(
+/*==========================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct */
+/********************************************************************//**
 Free a prebuilt struct for a MySQL table handle. */
 
 void
@@ -259,6 +267,29 @@ row_lock_table_for_mysql(
 					(ignored if table==NULL) */
 	__attribute__((nonnull(1)));
 
+/** Start a bulk insert into an empty table. If the table is empty, it is
+locked exclusively, and if it is still empty, the following
+row_insert_for_mysql() calls load it in bulk until row_insert_bulk_end().
+Nothing is done for tables that the bulk insert does not support.
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in,out]	mysql_table	MySQL table, for reporting duplicate keys
+@return error code or DB_SUCCESS */
+
+dberr_t
+row_insert_bulk_start(
+	row_prebuilt_t*	prebuilt,
+	struct TABLE*	mysql_table)
+	__attribute__((warn_unused_result));
+
+/** End a bulk insert that was started by row_insert_bulk_start().
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@return error code or DB_SUCCESS */
+
+dberr_t
+row_insert_bulk_end(
+	row_prebuilt_t*	prebuilt)
+	__attribute__((warn_unused_result));
+
 /** Does an insert for MySQL.
 @param[in]	mysql_rec	row in the MySQL format
 @param[in,out]	prebuilt	prebuilt struct in MySQL handle
@@ -674,7 +705,13 @@ struct mysql_row_templ_t {
 					it is an unsigned integer type */
 };
 
+/** Initial number of rows in fetch_cache. The number of rows grows with
+the number of rows fetched from the cursor, up to
+MYSQL_FETCH_CACHE_MAX_BYTES. */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/** Maximum size of fetch_cache in bytes, unless MYSQL_FETCH_CACHE_SIZE
+rows take more space */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(128 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -855,7 +892,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -865,6 +902,12 @@ struct row_prebuilt_t {
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_size;/*!< number of rows allocated in
+					fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows that are
+					fetched to fetch_cache in one batch;
+					it grows with n_rows_fetched up to
+					MYSQL_FETCH_CACHE_MAX_BYTES */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -873,6 +916,13 @@ struct row_prebuilt_t {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	buf_scan_ring_t*scan_ring;	/*!< if not NULL, the pages that
+					this handle reads into the buffer
+					pool are recycled through this ring,
+					see innodb_scan_ring_size */
+	row_merge_bulk_t*bulk;		/*!< if not NULL, the rows are
+					inserted into an empty table in bulk,
+					see row_insert_bulk_start() */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	old_vers_heap;	/*!< memory heap where a previous
@@ -0,0 +1,87 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel consistent read of a clustered index
+
+The clustered index is split into key ranges at the node pointers of
+one of its upper levels. The ranges are scanned by a number of threads,
+each of which passes the records that are visible in the read view of
+the transaction to a callback.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "db0err.h"
+#include "dict0types.h"
+#include "rem0types.h"
+#include "trx0types.h"
+
+/** Maximum number of threads of a parallel read */
+#define ROW_PREAD_MAX_THREADS	64
+
+/** Callback for a record that is visible in the read view.
+@param[in]	rec		clustered index record, or an old version
+@param[in]	offsets		rec_get_offsets(rec, index)
+@param[in]	thread_no	number of the calling thread,
+0 .. n_threads - 1
+@param[in,out]	arg		argument passed to row_pread_scan()
+@return DB_SUCCESS, or an error code that stops the scan */
+typedef dberr_t (*row_pread_fn_t)(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	ulint		thread_no,
+	void*		arg);
+
+/** Scan a clustered index in parallel, in the read view of a transaction.
+The callback is invoked for each record that exists and is not
+delete-marked in the read view, in no particular order between the
+threads. The read view must have been assigned.
+@param[in]	trx		transaction
+@param[in]	index		clustered index
+@param[in]	n_threads	number of threads to use, including
+the calling thread
+@param[in]	fn		callback for each visible record
+@param[in,out]	arg		argument to fn
+@return DB_SUCCESS or error code */
+dberr_t
+row_pread_scan(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	row_pread_fn_t	fn,
+	void*		arg);
+
+/** Count the records of a clustered index that are visible in the
+read view of a transaction, using parallel threads.
+@param[in]	trx		transaction
+@param[in]	index		clustered index
+@param[in]	n_threads	number of threads to use
+@param[out]	n_rows		number of records
+@return DB_SUCCESS or error code */
+dberr_t
+row_pread_count(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	ulint*		n_rows);
+
+#endif /* row0pread_h */
@@ -301,6 +301,8 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_OVLD_RECV_APPLY_BATCHES,
+	MONITOR_OVLD_RECV_APPLY_PAGES,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -317,11 +319,15 @@ enum monitor_id_t {
 	MONITOR_INDEX_REORG_ATTEMPTS,
 	MONITOR_INDEX_REORG_SUCCESSFUL,
 	MONITOR_INDEX_DISCARD,
+	MONITOR_SEC_REC_PAGE_VISIBLE,
+	MONITOR_STATS_SAMPLED_PAGES,
+	MONITOR_STATS_REUSED_PAGES,
 
 	/* Adaptive Hash Index related counters */
 	MONITOR_MODULE_ADAPTIVE_HASH,
 	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH,
 	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_FAIL,
 	MONITOR_ADAPTIVE_HASH_PAGE_ADDED,
 	MONITOR_ADAPTIVE_HASH_PAGE_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_ADDED,
@@ -343,6 +349,8 @@ enum monitor_id_t {
 	MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE,
 	MONITOR_OVLD_IBUF_MERGES,
 	MONITOR_OVLD_IBUF_SIZE,
+	MONITOR_IBUF_MERGE_BATCHES,
+	MONITOR_IBUF_MERGE_BATCH_PAGES,
 
 	/* Counters for server operations */
 	MONITOR_MODULE_SERVER,
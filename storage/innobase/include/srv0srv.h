@@ -129,6 +129,13 @@ struct srv_stats_t {
 
 	/** Number of rows inserted */
 	ulint_ctr_64_t		n_rows_inserted;
+
+	/** Number of page batches handed to the recovery apply threads */
+	ulint_ctr_1_t		recv_apply_batches;
+
+	/** Number of pages that the recovery apply threads applied redo
+	log records to, or read in for applying them */
+	ulint_ctr_64_t		recv_apply_pages;
 };
 
 extern const char*	srv_main_thread_op_info;
@@ -213,6 +220,12 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads that sort and merge the entries of each
+index in index creation */
+extern ulong	srv_parallel_ddl_threads;
+/** Number of threads that count the records of a table in a
+consistent read */
+extern ulong	srv_parallel_read_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -221,6 +234,10 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+
+/** If this flag is TRUE, Linux native aio is done with io_uring instead
+of libaio (provided we compiled Innobase with it in) */
+extern my_bool	srv_use_io_uring;
 #ifdef _WIN32
 extern bool	srv_use_native_conditions;
 #endif /* _WIN32 */
@@ -297,6 +314,10 @@ extern ulint	srv_buf_pool_base_size;
 extern ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong	srv_buf_pool_dump_pct;
+/** Seconds between periodic buffer pool dumps, 0 if disabled */
+extern ulong	srv_buf_pool_dump_interval;
+/** Number of threads that read pages during a buffer pool load */
+extern ulong	srv_buf_pool_load_threads;
 /** Lock table size in bytes */
 extern ulint	srv_lock_table_size;
 
@@ -308,6 +329,10 @@ extern ulint	srv_n_write_io_threads;
 
 extern uint	srv_change_buffer_max_size;
 
+/** Number of change buffer merge threads, innodb_change_buffer_merge_threads.
+0 leaves the change buffer merge to the master thread. */
+extern ulong	srv_n_ibuf_merge_threads;
+
 /* Number of IO operations per second the server can do */
 extern ulong    srv_io_capacity;
 
@@ -332,6 +357,10 @@ extern ulint	srv_max_n_open_files;
 
 extern ulong	srv_n_page_cleaners;
 
+/** Number of threads applying redo log records in parallel during
+crash recovery, or 0 to apply them in the recovery thread */
+extern ulong	srv_n_recv_apply_threads;
+
 extern double	srv_max_dirty_pages_pct;
 extern double	srv_max_dirty_pages_pct_lwm;
 
@@ -355,6 +384,8 @@ extern ibool	srv_innodb_status;
 extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
+extern ulong			srv_stats_persistent_threads;
+extern my_bool			srv_stats_persistent_incremental;
 extern my_bool			srv_stats_auto_recalc;
 
 extern ibool	srv_use_doublewrite_buf;
@@ -424,6 +455,9 @@ extern ulong srv_sync_array_size;
 /* print all user-level transactions deadlocks to mysqld stderr */
 extern my_bool srv_print_all_deadlocks;
 
+/** When to search for deadlocks, innodb_deadlock_detect */
+extern ulong	srv_deadlock_detect;
+
 extern my_bool	srv_cmp_per_index_enabled;
 
 /** Status variables to be passed to MySQL */
@@ -436,6 +470,7 @@ extern srv_stats_t	srv_stats;
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	buf_dump_thread_key;
 extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	ibuf_merge_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
@@ -443,6 +478,7 @@ extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
 extern mysql_pfs_key_t	page_cleaner_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
@@ -538,6 +574,17 @@ enum srv_stats_method_name_enum {
 
 typedef enum srv_stats_method_name_enum		srv_stats_method_name_t;
 
+/** Alternatives for srv_deadlock_detect, which could be changed by
+setting innodb_deadlock_detect */
+enum srv_deadlock_detect_t {
+	SRV_DEADLOCK_DETECT_IMMEDIATE,	/*!< The waits-for graph is
+					searched whenever a lock wait is
+					enqueued. This is the default. */
+	SRV_DEADLOCK_DETECT_BACKGROUND	/*!< The lock wait timeout thread
+					periodically searches a snapshot
+					of the waits-for graph */
+};
+
 #ifndef UNIV_HOTBACKUP
 /** Types of threads existing in the system. */
 enum srv_thread_type {
@@ -886,6 +933,7 @@ struct srv_slot_t{
 #else /* !UNIV_HOTBACKUP */
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
 # define srv_reset_io_thread_op_info()		((void) 0)
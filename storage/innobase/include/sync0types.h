@@ -243,7 +243,10 @@ enum latch_level_t {
 	SYNC_REC_LOCK,
 	SYNC_THREADS,
 	SYNC_TRX,
+	SYNC_MVCC,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_REC_SHARD,
+	SYNC_LOCK_SYS_LATCH,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -28,6 +28,7 @@ Created 3/26/1996 Heikki Tuuri
 
 #include "univ.i"
 #include "trx0types.h"
+#include "dict0types.h"
 #include "mtr0mtr.h"
 #include "trx0sys.h"
 #include "que0types.h"
@@ -126,6 +127,16 @@ purge_state_t
 trx_purge_state(void);
 /*=================*/
 
+/*******************************************************************//**
+Determines whether every read view, present or future, sees the changes
+of all transactions whose id is not bigger than trx_id.
+@return true if the changes are visible to all read views */
+
+bool
+trx_purge_all_visible(
+/*==================*/
+	trx_id_t	trx_id);	/*!< in: transaction id */
+
 // Forward declaration
 struct TrxUndoRsegsIterator;
 
@@ -367,6 +378,27 @@ namespace undo {
 	};	/* class Truncate */
 };	/* namespace undo */
 
+/** The share of a purge batch that belongs to one table. The records
+of a table are handed to one worker at a time, so that the workers do
+not contend for the same index pages and latches. */
+struct purge_table_batch_t {
+	ulint		worker;		/*!< index of the worker thread that
+					the records of the table currently
+					go to */
+	ulint		n_chunk;	/*!< number of records handed to the
+					worker since it was chosen */
+	ulint		n_recs;		/*!< number of records of the table
+					in the batch */
+};
+
+/** The tables of a purge batch, indexed by table id */
+typedef std::map<
+	table_id_t,
+	purge_table_batch_t,
+	std::less<table_id_t>,
+	ut_allocator<std::pair<const table_id_t, purge_table_batch_t> > >
+	purge_table_map_t;
+
 /** The control structure used in the purge operation */
 struct trx_purge_t{
 	sess_t*		sess;		/*!< System session running the purge
@@ -394,6 +426,12 @@ struct trx_purge_t{
 	ReadView	view;		/*!< The purge will not remove undo logs
 					which are >= this view (purge view) */
 	bool		view_active;	/*!< true if view is active */
+	volatile trx_id_t view_up_limit_id;
+					/*!< Every read view sees the changes
+					of the transactions whose id is smaller
+					than this; the up limit id of the view,
+					which never decreases. We check this
+					without the latch */
 	volatile ulint	n_submitted;	/*!< Count of total tasks submitted
 					to the task queue */
 	volatile ulint	n_completed;	/*!< Count of total tasks completed */
@@ -445,6 +483,15 @@ struct trx_purge_t{
 
 	undo::Truncate	undo_trunc;	/*!< Track UNDO tablespace marked
 					for truncate. */
+
+	purge_table_map_t*
+			tables;		/*!< The tables of the current purge
+					batch. Only accessed by the purge
+					coordinator thread. */
+	mem_heap_t*	heap;		/*!< The undo log records of the
+					current purge batch are copied here.
+					Emptied by the purge coordinator
+					thread at the start of a batch. */
 };
 
 /** Info required to purge a record */
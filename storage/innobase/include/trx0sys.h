@@ -620,7 +620,9 @@ struct trx_sys_t {
 					transactions that have not yet been
 					started in InnoDB. */
 
-	trx_ids_t	rw_trx_ids;	/*!< Read write transaction IDs */
+	trx_ids_t	rw_trx_ids;	/*!< Read write transaction IDs, any
+					change must be published with
+					MVCC::snapshot_publish() */
 
 	char		pad3[64];	/*!< To avoid false sharing */
 	trx_rseg_t*	rseg_array[TRX_SYS_N_RSEGS];
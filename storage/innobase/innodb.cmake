@@ -29,6 +29,21 @@ IF(UNIX)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
     ENDIF()
+    CHECK_C_SOURCE_COMPILES("
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    int main()
+    {
+      struct io_uring_params p;
+      p.features = IORING_FEAT_SINGLE_MMAP;
+      return(__NR_io_uring_setup + __NR_io_uring_enter
+             + __NR_io_uring_register + IORING_OP_READ_FIXED
+             + IORING_OP_FSYNC + p.features);
+    }"
+    HAVE_IO_URING)
+    IF(HAVE_IO_URING)
+      ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+    ENDIF()
   ELSEIF(CMAKE_SYSTEM_NAME STREQUAL "SunOS")
     ADD_DEFINITIONS("-DUNIV_SOLARIS")
   ENDIF()
@@ -41,11 +41,14 @@ Created 5/7/1996 Heikki Tuuri
 #include "trx0sys.h"
 #include "srv0mon.h"
 #include "ut0vec.h"
+#include "sync0sync.h"
 #include "btr0btr.h"
 #include "dict0boot.h"
 #include "ut0new.h"
 
+#include <algorithm>
 #include <set>
+#include <vector>
 
 /** Total number of cached record locks */
 static const ulint	REC_LOCK_CACHE = 8;
@@ -78,7 +81,76 @@ public:
 		const lock_t*	lock,
 		const trx_t*	trx);
 
+	/** Searches a snapshot of the waits-for graph of the suspended
+	lock waits for cycles, and rolls back the lightest transaction of
+	each cycle. Only the snapshot is taken under lock_sys->mutex. */
+	static void check_and_resolve_waits();
+
 private:
+	/** A waiting transaction in a snapshot of the waits-for graph */
+	struct wait_node_t {
+		const trx_t*	m_trx;		/*!< Waiting transaction */
+		trx_id_t	m_trx_id;	/*!< m_trx->id when the
+						snapshot was taken */
+		const lock_t*	m_wait_lock;	/*!< Lock that m_trx waits
+						for */
+		bool		m_nontrans;	/*!< Whether m_trx has edited
+						non-transactional tables */
+		ib_uint64_t	m_weight;	/*!< TRX_WEIGHT(m_trx) */
+		ulint		m_first_edge;	/*!< Position of the first
+						outgoing edge */
+		ulint		m_n_edges;	/*!< Number of outgoing
+						edges */
+
+		/** Order by transaction, for looking up edge targets */
+		bool operator<(const wait_node_t& other) const
+		{
+			return(std::less<const trx_t*>()(m_trx, other.m_trx));
+		}
+	};
+
+	typedef std::vector<wait_node_t, ut_allocator<wait_node_t> >
+		wait_nodes_t;
+
+	typedef std::vector<const trx_t*, ut_allocator<const trx_t*> >
+		wait_trxs_t;
+
+	typedef std::vector<ulint, ut_allocator<ulint> >	wait_ids_t;
+
+	/** Append the transactions that own or request a conflicting
+	lock ahead of a waiting lock request in its queue.
+	@param[in]	wait_lock	waiting lock request
+	@param[in,out]	blockers	transactions that wait_lock has to
+	wait for */
+	static void get_blockers(
+		const lock_t*	wait_lock,
+		wait_trxs_t&	blockers);
+
+	/** Search for a cycle in a waits-for graph snapshot.
+	@param[in]	nodes	waiting transactions, ordered by m_trx
+	@param[in]	targets	node of each edge, or ULINT_UNDEFINED if
+	the transaction at the end of the edge is not waiting
+	@param[in,out]	removed	nodes of earlier victims; the victim of
+	the found cycle is added
+	@param[out]	cycle	nodes of the cycle, in waits-for order,
+	the victim first
+	@return whether a cycle was found */
+	static bool search_snapshot(
+		const wait_nodes_t&	nodes,
+		const wait_ids_t&	targets,
+		std::vector<bool>&	removed,
+		wait_ids_t&		cycle);
+
+	/** Roll back the victim of a cycle of a waits-for graph snapshot
+	if all the transactions of the cycle are still waiting for the
+	same locks.
+	@param[in]	nodes	waiting transactions
+	@param[in]	cycle	nodes of the cycle, in waits-for order,
+	the victim first */
+	static void resolve_snapshot(
+		const wait_nodes_t&	nodes,
+		const wait_ids_t&	cycle);
+
 	/** Do a shallow copy. Default destructor OK.
 	@param trx the start transaction (start node)
 	@param wait_lock lock that a transaction wants
@@ -394,10 +466,12 @@ lock_sec_rec_cons_read_sees(
 	const rec_t*		rec,	/*!< in: user record which
 					should be read or passed over
 					by a read cursor */
+	const buf_block_t*	block,	/*!< in: buffer block of rec */
 	const dict_index_t*	index,	/*!< in: index */
 	const ReadView*	view)	/*!< in: consistent read view */
 {
 	ut_ad(page_rec_is_user_rec(rec));
+	ut_ad(buf_block_get_frame(block) == page_align(rec));
 
 	/* NOTE that we might call this function while holding the search
 	system latch. */
@@ -420,7 +494,25 @@ lock_sec_rec_cons_read_sees(
 
 	ut_ad(max_trx_id > 0);
 
-	return(view->sees(max_trx_id));
+	if (view->sees(max_trx_id)) {
+
+		return(true);
+	}
+
+	/* The view may still see all modifications of the page, if
+	we know that none of them was made by a transaction that was
+	active when the view was created. */
+
+	trx_id_t	min_trx_id = page_get_min_trx_id(block);
+
+	if (min_trx_id == 0 || !view->sees_range(min_trx_id, max_trx_id)) {
+
+		return(false);
+	}
+
+	MONITOR_INC(MONITOR_SEC_REC_PAGE_VISIBLE);
+
+	return(true);
 }
 
 /*********************************************************************//**
@@ -445,6 +537,14 @@ lock_sys_create(
 
 	mutex_create("lock_sys", &lock_sys->mutex);
 
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; ++i) {
+		rw_lock_create(lock_sys_latch_key,
+			       &lock_sys->rec_shards[i].latch,
+			       SYNC_LOCK_SYS_LATCH);
+
+		mutex_create("lock_rec_shard", &lock_sys->rec_shards[i].mutex);
+	}
+
 	mutex_create("lock_sys_wait", &lock_sys->wait_mutex);
 
 	lock_sys->timeout_event = os_event_create(0);
@@ -459,6 +559,220 @@ lock_sys_create(
 	}
 }
 
+#ifdef UNIV_DEBUG
+/** Test if the lock queue of a page may be accessed: the caller must
+hold the lock_sys->mutex, and if the queue is in lock_sys->rec_hash,
+the record lock shard of the page, either X-latched or its mutex.
+@param[in]	hash	lock hash table
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return true if the queue is latched by the current thread */
+
+bool
+lock_rec_queue_own(
+	const hash_table_t*	hash,
+	ulint			space,
+	ulint			page_no)
+{
+	if (hash != lock_sys->rec_hash) {
+		return(lock_mutex_own());
+	}
+
+	lock_rec_shard_t*	shard = lock_rec_shard_get(
+		lock_rec_hash(space, page_no));
+
+	/* Only the lock_sys->mutex holder may X-latch a shard. */
+	return(shard->mutex.is_owned()
+	       || (lock_mutex_own()
+		   && rw_lock_get_writer(&shard->latch) == RW_LOCK_X));
+}
+#endif /* UNIV_DEBUG */
+
+/** Latch the record lock queue of a page without acquiring the
+lock_sys->mutex: S-latch the latch of the record lock shard of the hash
+cell of the page, which excludes the lock_sys->mutex holders that access
+the cell, and then acquire the mutex of the shard. Only granted locks
+may be added to or removed from the queue in this mode, as waiting
+requests need the lock_sys->mutex. Each shard has its own latch, so that
+requests on different shards do not write to a shared cache line.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return the shard, to be released with lock_rec_shard_exit() */
+static
+lock_rec_shard_t*
+lock_rec_shard_enter(
+	ulint	space,
+	ulint	page_no)
+{
+	ut_ad(!lock_mutex_own());
+
+	lock_rec_shard_t*	shard = lock_rec_shard_get(
+		lock_rec_hash(space, page_no));
+
+	rw_lock_s_lock(&shard->latch);
+
+	/* lock_sys_resize() may have changed the cell of the page
+	before we got the latch. */
+	for (lock_rec_shard_t* cur;
+	     (cur = lock_rec_shard_get(lock_rec_hash(space, page_no)))
+	     != shard;
+	     shard = cur) {
+
+		rw_lock_s_unlock(&shard->latch);
+
+		rw_lock_s_lock(&cur->latch);
+	}
+
+	mutex_enter(&shard->mutex);
+
+	return(shard);
+}
+
+/** Release a record lock shard acquired with lock_rec_shard_enter().
+@param[in,out]	shard	record lock shard */
+static
+void
+lock_rec_shard_exit(
+	lock_rec_shard_t*	shard)
+{
+	shard->mutex.exit();
+
+	rw_lock_s_unlock(&shard->latch);
+}
+
+/** X-latch the latch of the record lock shard of a page, so that the
+record lock queue of the page may be accessed. The caller must hold
+lock_sys->mutex and no trx_t::mutex. The latch may be X-latched more
+than once.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number */
+
+void
+lock_rec_shard_x_lock(
+	ulint	space,
+	ulint	page_no)
+{
+	ut_ad(lock_mutex_own());
+
+	rw_lock_x_lock(&lock_rec_shard_get(lock_rec_hash(space, page_no))
+		       ->latch);
+}
+
+/** Release a latch X-latched by lock_rec_shard_x_lock().
+@param[in]	space	tablespace id
+@param[in]	page_no	page number */
+
+void
+lock_rec_shard_x_unlock(
+	ulint	space,
+	ulint	page_no)
+{
+	ut_ad(lock_mutex_own());
+
+	rw_lock_x_unlock(&lock_rec_shard_get(lock_rec_hash(space, page_no))
+			 ->latch);
+}
+
+/** Acquire the lock_sys->mutex and X-latch the record lock shard of a
+page, and of another page if one is given, so that their record lock
+queues may be accessed.
+@param[in]	block	page
+@param[in]	block2	another page, or NULL */
+static
+void
+lock_mutex_enter_page(
+	const buf_block_t*	block,
+	const buf_block_t*	block2 = NULL)
+{
+	lock_mutex_enter();
+
+	lock_rec_shard_x_lock(block->page.id.space(),
+			      block->page.id.page_no());
+
+	if (block2 != NULL) {
+		lock_rec_shard_x_lock(block2->page.id.space(),
+				      block2->page.id.page_no());
+	}
+}
+
+/** Release the latches and the mutex acquired by lock_mutex_enter_page().
+@param[in]	block	page
+@param[in]	block2	another page, or NULL */
+static
+void
+lock_mutex_exit_page(
+	const buf_block_t*	block,
+	const buf_block_t*	block2 = NULL)
+{
+	if (block2 != NULL) {
+		lock_rec_shard_x_unlock(block2->page.id.space(),
+					block2->page.id.page_no());
+	}
+
+	lock_rec_shard_x_unlock(block->page.id.space(),
+				block->page.id.page_no());
+
+	lock_mutex_exit();
+}
+
+/** X-latch the latches of all the record lock shards, excluding all
+record lock shard users. This is needed where the record locks of
+several pages are accessed at once, such as in deadlock detection or
+when printing all locks. The caller must hold lock_sys->mutex and no
+trx_t::mutex. */
+
+void
+lock_rec_shards_x_lock()
+{
+	ut_ad(lock_mutex_own());
+
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; ++i) {
+		rw_lock_x_lock(&lock_sys->rec_shards[i].latch);
+	}
+}
+
+/** Release the latches X-latched by lock_rec_shards_x_lock(). */
+
+void
+lock_rec_shards_x_unlock()
+{
+	ut_ad(lock_mutex_own());
+
+	for (ulint i = LOCK_REC_N_SHARDS; i > 0; --i) {
+		rw_lock_x_unlock(&lock_sys->rec_shards[i - 1].latch);
+	}
+}
+
+/** Acquire the lock_sys->mutex and X-latch the latches of all the record
+lock shards, if that can be done without waiting.
+@return 0 if the mutex was acquired */
+
+ulint
+lock_mutex_enter_nowait()
+{
+	if (lock_sys->mutex.trylock(__FILE__, __LINE__)) {
+		return(1);
+	}
+
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; ++i) {
+
+		if (!rw_lock_x_lock_nowait(&lock_sys->rec_shards[i].latch)) {
+
+			while (i > 0) {
+				--i;
+				rw_lock_x_unlock(
+					&lock_sys->rec_shards[i].latch);
+			}
+
+			lock_sys->mutex.exit();
+
+			return(1);
+		}
+	}
+
+	return(0);
+}
+
 /** Calculates the fold value of a lock: used in migrating the hash table.
 @param[in]	lock	record lock object
 @return	folded value */
@@ -480,7 +794,7 @@ lock_sys_resize(
 {
 	hash_table_t*	old_hash;
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 
 	old_hash = lock_sys->rec_hash;
 	lock_sys->rec_hash = hash_create(n_cells);
@@ -525,7 +839,7 @@ lock_sys_resize(
 		buf_pool_mutex_exit(buf_pool);
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 }
 
 /*********************************************************************//**
@@ -547,6 +861,12 @@ lock_sys_close(void)
 	os_event_destroy(lock_sys->timeout_event);
 
 	mutex_destroy(&lock_sys->mutex);
+
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; ++i) {
+		rw_lock_free(&lock_sys->rec_shards[i].latch);
+		mutex_destroy(&lock_sys->rec_shards[i].mutex);
+	}
+
 	mutex_destroy(&lock_sys->wait_mutex);
 
 	srv_slot_t*	slot = lock_sys->waiting_threads;
@@ -966,7 +1286,7 @@ lock_rec_reset_nth_bit(
 
 	if (bit != 0) {
 		ut_ad(lock->trx->lock.n_rec_locks > 0);
-		--lock->trx->lock.n_rec_locks;
+		os_atomic_decrement_ulint(&lock->trx->lock.n_rec_locks, 1);
 	}
 
 	return(bit);
@@ -1003,9 +1323,11 @@ lock_rec_expl_exist_on_page(
 	lock_t*	lock;
 
 	lock_mutex_enter();
+	lock_rec_shard_x_lock(space, page_no);
 	/* Only used in ibuf pages, so rec_hash is good enough */
 	lock = lock_rec_get_first_on_page_addr(lock_sys->rec_hash,
 					       space, page_no);
+	lock_rec_shard_x_unlock(space, page_no);
 	lock_mutex_exit();
 
 	return(lock);
@@ -1118,7 +1440,8 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_sys->rec_hash, block->page.id.space(),
+				  block->page.id.page_no()));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1167,7 +1490,8 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_sys->rec_hash, block->page.id.space(),
+				  block->page.id.page_no()));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1213,7 +1537,8 @@ lock_rec_other_has_conflicting(
 {
 	const lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_sys->rec_hash, block->page.id.space(),
+				  block->page.id.page_no()));
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1304,7 +1629,7 @@ lock_rec_other_trx_holds_expl(
 {
 	trx_t* holds = NULL;
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 
 	if (trx_t* impl_trx = trx_rw_is_active(trx->id, NULL, false)) {
 		ulint heap_no = page_rec_get_heap_no(rec);
@@ -1328,7 +1653,7 @@ lock_rec_other_trx_holds_expl(
 		mutex_exit(&trx_sys->mutex);
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 
 	return(holds);
 }
@@ -1403,7 +1728,7 @@ lock_rec_create_low(
 	ulint		n_bytes;
 	bool		is_predicate_lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_hash_get(type_mode), space, page_no));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 	ut_ad(!trx->is_dd_trx);
@@ -1455,6 +1780,13 @@ lock_rec_create_low(
 		}
 	}
 
+	/* The lock memory of trx is protected by the trx mutex, because
+	an implicit lock of trx may be converted by another thread that
+	holds a different record lock shard. */
+	if (!caller_owns_trx_mutex) {
+		trx_mutex_enter(trx);
+	}
+
 	if (trx->lock.rec_cached >= trx->lock.rec_pool.size()
 	    || sizeof(lock_t) + n_bytes > REC_LOCK_SIZE) {
 
@@ -1496,17 +1828,13 @@ lock_rec_create_low(
 	/* Set the bit corresponding to rec */
 	lock_rec_set_nth_bit(lock, heap_no);
 
-	index->table->n_rec_locks++;
+	os_atomic_increment_ulint(&index->table->n_rec_locks, 1);
 
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
 	HASH_INSERT(lock_t, hash, lock_hash_get(type_mode),
 		    lock_rec_fold(space, page_no), lock);
 
-	if (!caller_owns_trx_mutex) {
-		trx_mutex_enter(trx);
-	}
-
 	ut_ad(trx_mutex_own(trx));
 
 	if (type_mode & LOCK_WAIT) {
@@ -1520,8 +1848,8 @@ lock_rec_create_low(
 		trx_mutex_exit(trx);
 	}
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return(lock);
 }
@@ -1598,21 +1926,27 @@ lock_rec_enqueue_waiting(
 		lock_prdt_set_prdt(lock, prdt);
 	}
 
-	/* Release the mutex to obey the latching order.
-	This is safe, because DeadlockChecker::check_and_resolve()
-	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because trx is a running transaction
-	(it is not currently suspended because of a lock wait),
-	its state can only be changed by this thread, which is
-	currently associated with the transaction. */
+	const trx_t*	victim_trx = NULL;
 
-	trx_mutex_exit(trx);
+	/* With innodb_deadlock_detect=background, the lock wait timeout
+	thread will find the deadlock if there is one. */
 
-	const trx_t*	victim_trx;
+	if (srv_deadlock_detect == SRV_DEADLOCK_DETECT_IMMEDIATE) {
 
-	victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+		/* Release the mutex to obey the latching order.
+		This is safe, because DeadlockChecker::check_and_resolve()
+		is invoked when a lock wait is enqueued for the currently
+		running transaction. Because trx is a running transaction
+		(it is not currently suspended because of a lock wait),
+		its state can only be changed by this thread, which is
+		currently associated with the transaction. */
 
-	trx_mutex_enter(trx);
+		trx_mutex_exit(trx);
+
+		victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+
+		trx_mutex_enter(trx);
+	}
 
 	if (victim_trx != 0) {
 
@@ -1674,7 +2008,9 @@ lock_rec_add_to_queue(
 					transaction mutex */
 {
 #ifdef UNIV_DEBUG
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_hash_get(type_mode),
+				  block->page.id.space(),
+				  block->page.id.page_no()));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -1776,7 +2112,8 @@ lock_rec_lock_fast(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_sys->rec_hash, block->page.id.space(),
+				  block->page.id.page_no()));
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1914,12 +2251,78 @@ lock_rec_lock_slow(
 	return(err);
 }
 
+/*********************************************************************//**
+Tries to lock a record when lock_rec_lock_fast() failed, without waiting.
+This is the counterpart of lock_rec_lock_slow() for a caller that only
+holds the record lock shard of the page, which does not allow enqueueing
+a waiting lock request.
+@return DB_SUCCESS or DB_SUCCESS_LOCKED_REC, or DB_LOCK_WAIT if the lock
+cannot be granted immediately and the caller must retry while holding
+the lock_sys->mutex */
+static
+dberr_t
+lock_rec_lock_nowait(
+/*=================*/
+	bool			impl,	/*!< in: if TRUE, no lock is set
+					if no wait is necessary: we
+					assume that the caller will
+					set an implicit lock */
+	ulint			mode,	/*!< in: lock mode: LOCK_X or
+					LOCK_S possibly ORed to either
+					LOCK_GAP or LOCK_REC_NOT_GAP */
+	const buf_block_t*	block,	/*!< in: buffer block containing
+					the record */
+	ulint			heap_no,/*!< in: heap number of record */
+	dict_index_t*		index,	/*!< in: index of record */
+	que_thr_t*		thr)	/*!< in: query thread */
+{
+	ut_ad(!lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_sys->rec_hash, block->page.id.space(),
+				  block->page.id.page_no()));
+
+	DBUG_EXECUTE_IF("innodb_report_deadlock", return(DB_LOCK_WAIT););
+
+	dberr_t	err;
+	trx_t*	trx = thr_get_trx(thr);
+
+	trx_mutex_enter(trx);
+
+	if (lock_rec_has_expl(mode, block, heap_no, trx)) {
+
+		err = DB_SUCCESS;
+
+	} else if (lock_rec_other_has_conflicting(
+			static_cast<enum lock_mode>(mode),
+			block, heap_no, trx)) {
+
+		err = DB_LOCK_WAIT;
+
+	} else if (!impl) {
+
+		lock_rec_add_to_queue(
+			LOCK_REC | mode, block, heap_no, index, trx, TRUE);
+
+		err = DB_SUCCESS_LOCKED_REC;
+
+	} else {
+		err = DB_SUCCESS;
+	}
+
+	trx_mutex_exit(trx);
+
+	return(err);
+}
+
 /*********************************************************************//**
 Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
 of a page supremum record, a gap type lock.
+
+The lock is first attempted while holding only the record lock shard of
+the page. Only if the request has to wait, it is retried under the
+lock_sys->mutex, which is needed for the wait and the deadlock check.
 @return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -1939,7 +2342,7 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(!lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1952,20 +2355,52 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
+	dberr_t			err = DB_ERROR;
+	lock_rec_shard_t*	shard = lock_rec_shard_enter(
+		block->page.id.space(), block->page.id.page_no());
+
 	/* We try a simplified and faster subroutine for the most
 	common cases */
 	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
 	case LOCK_REC_SUCCESS:
-		return(DB_SUCCESS);
+		err = DB_SUCCESS;
+		break;
 	case LOCK_REC_SUCCESS_CREATED:
-		return(DB_SUCCESS_LOCKED_REC);
+		err = DB_SUCCESS_LOCKED_REC;
+		break;
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		err = lock_rec_lock_nowait(impl, mode, block,
+					   heap_no, index, thr);
+		break;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	lock_rec_shard_exit(shard);
+
+	if (err != DB_LOCK_WAIT) {
+		ut_ad(err != DB_ERROR);
+		return(err);
+	}
+
+	/* The queue may have changed after the shard was released:
+	start over. */
+	lock_mutex_enter_page(block);
+
+	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	case LOCK_REC_SUCCESS:
+		err = DB_SUCCESS;
+		break;
+	case LOCK_REC_SUCCESS_CREATED:
+		err = DB_SUCCESS_LOCKED_REC;
+		break;
+	case LOCK_REC_FAIL:
+		err = lock_rec_lock_slow(impl, mode, block,
+					 heap_no, index, thr);
+		break;
+	}
+
+	lock_mutex_exit_page(block);
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2129,7 +2564,7 @@ lock_rec_dequeue_from_page(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	lock_hash = lock_hash_get(in_lock->type_mode);
 
@@ -2138,8 +2573,8 @@ lock_rec_dequeue_from_page(
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 
 	/* Check if waiting locks in the queue can now be granted: grant
 	locks if there are no conflicting locks ahead. Stop at the first
@@ -2173,7 +2608,7 @@ lock_rec_discard(
 	ulint		page_no;
 	trx_lock_t*	trx_lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own_queue(in_lock));
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 
 	trx_lock = &in_lock->trx->lock;
@@ -2181,15 +2616,15 @@ lock_rec_discard(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_hash_get(in_lock->type_mode),
 			    lock_rec_fold(space, page_no), in_lock);
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 }
 
 /*************************************************************//**
@@ -2215,8 +2650,14 @@ lock_rec_free_all_from_discard_page_low(
 
 		next_lock = lock_rec_get_next_on_page(lock);
 
+		/* An implicit lock of lock->trx may be converted to an
+		explicit one on a page of another shard meanwhile. */
+		trx_mutex_enter(lock->trx);
+
 		lock_rec_discard(lock);
 
+		trx_mutex_exit(lock->trx);
+
 		lock = next_lock;
 	}
 }
@@ -2239,8 +2680,13 @@ lock_rec_free_all_from_discard_page(
 	space = block->page.id.space();
 	page_no = block->page.id.page_no();
 
+	lock_rec_shard_x_lock(space, page_no);
+
 	lock_rec_free_all_from_discard_page_low(
 		space, page_no, lock_sys->rec_hash);
+
+	lock_rec_shard_x_unlock(space, page_no);
+
 	lock_rec_free_all_from_discard_page_low(
 		space, page_no, lock_sys->prdt_hash);
 	lock_rec_free_all_from_discard_page_low(
@@ -2363,7 +2809,7 @@ lock_rec_inherit_to_gap_if_gap_lock(
 {
 	lock_t*	lock;
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 
 	for (lock = lock_rec_get_first(lock_sys->rec_hash, block, heap_no);
 	     lock != NULL;
@@ -2380,7 +2826,7 @@ lock_rec_inherit_to_gap_if_gap_lock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 }
 
 /*************************************************************//**
@@ -2456,13 +2902,13 @@ lock_move_reorganize_page(
 	mem_heap_t*	heap		= NULL;
 	ulint		comp;
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 
 	/* FIXME: This needs to deal with predicate lock too */
 	lock = lock_rec_get_first_on_page(lock_sys->rec_hash, block);
 
 	if (lock == NULL) {
-		lock_mutex_exit();
+		lock_mutex_exit_page(block);
 
 		return;
 	}
@@ -2559,7 +3005,7 @@ lock_move_reorganize_page(
 #endif /* UNIV_DEBUG */
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 
 	mem_heap_free(heap);
 
@@ -2586,7 +3032,7 @@ lock_move_rec_list_end(
 	ut_ad(buf_block_get_frame(block) == page_align(rec));
 	ut_ad(comp == page_is_comp(buf_block_get_frame(new_block)));
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(new_block, block);
 
 	/* Note: when we move locks from record to record, waiting locks
 	and possible granted gap type locks behind them are enqueued in
@@ -2664,7 +3110,7 @@ lock_move_rec_list_end(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(new_block, block);
 
 #ifdef UNIV_DEBUG_LOCK_VALIDATE
 	ut_ad(lock_rec_validate_page(block));
@@ -2698,7 +3144,7 @@ lock_move_rec_list_start(
 	ut_ad(new_block->frame == page_align(old_end));
 	ut_ad(comp == page_rec_is_comp(old_end));
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(new_block, block);
 
 	for (lock = lock_rec_get_first_on_page(lock_sys->rec_hash, block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -2772,7 +3218,7 @@ lock_move_rec_list_start(
 #endif /* UNIV_DEBUG */
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(new_block, block);
 
 #ifdef UNIV_DEBUG_LOCK_VALIDATE
 	ut_ad(lock_rec_validate_page(block));
@@ -2806,7 +3252,7 @@ lock_rtr_move_rec_list(
 	ut_ad(new_block->frame == page_align(rec_move[0].new_rec));
 	ut_ad(comp == page_rec_is_comp(rec_move[0].new_rec));
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(new_block, block);
 
 	for (lock = lock_rec_get_first_on_page(lock_sys->rec_hash, block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -2854,7 +3300,7 @@ lock_rtr_move_rec_list(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(new_block, block);
 
 #ifdef UNIV_DEBUG_LOCK_VALIDATE
 	ut_ad(lock_rec_validate_page(block));
@@ -2871,7 +3317,7 @@ lock_update_split_right(
 {
 	ulint	heap_no = lock_get_min_heap_no(right_block);
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(right_block, left_block);
 
 	/* Move the locks on the supremum of the left page to the supremum
 	of the right page */
@@ -2885,7 +3331,7 @@ lock_update_split_right(
 	lock_rec_inherit_to_gap(left_block, right_block,
 				PAGE_HEAP_NO_SUPREMUM, heap_no);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(right_block, left_block);
 }
 
 /*************************************************************//**
@@ -2904,7 +3350,7 @@ lock_update_merge_right(
 						page which will be
 						discarded */
 {
-	lock_mutex_enter();
+	lock_mutex_enter_page(right_block, left_block);
 
 	/* Inherit the locks from the supremum of the left page to the
 	original successor of infimum on the right page, to which the left
@@ -2931,7 +3377,7 @@ lock_update_merge_right(
 
 	lock_rec_free_all_from_discard_page(left_block);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(right_block, left_block);
 
 }
 
@@ -2949,14 +3395,14 @@ lock_update_root_raise(
 	const buf_block_t*	block,	/*!< in: index page to which copied */
 	const buf_block_t*	root)	/*!< in: root page */
 {
-	lock_mutex_enter();
+	lock_mutex_enter_page(block, root);
 
 	/* Move the locks on the supremum of the root to the supremum
 	of block */
 
 	lock_rec_move(block, root,
 		      PAGE_HEAP_NO_SUPREMUM, PAGE_HEAP_NO_SUPREMUM);
-	lock_mutex_exit();
+	lock_mutex_exit_page(block, root);
 }
 
 /*************************************************************//**
@@ -2971,7 +3417,7 @@ lock_update_copy_and_discard(
 	const buf_block_t*	block)		/*!< in: index page;
 						NOT the root! */
 {
-	lock_mutex_enter();
+	lock_mutex_enter_page(new_block, block);
 
 	/* Move the locks on the supremum of the old page to the supremum
 	of new_page */
@@ -2980,7 +3426,7 @@ lock_update_copy_and_discard(
 		      PAGE_HEAP_NO_SUPREMUM, PAGE_HEAP_NO_SUPREMUM);
 	lock_rec_free_all_from_discard_page(block);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(new_block, block);
 }
 
 /*************************************************************//**
@@ -2994,7 +3440,7 @@ lock_update_split_left(
 {
 	ulint	heap_no = lock_get_min_heap_no(right_block);
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(right_block, left_block);
 
 	/* Inherit the locks to the supremum of the left page from the
 	successor of the infimum on the right page */
@@ -3002,7 +3448,7 @@ lock_update_split_left(
 	lock_rec_inherit_to_gap(left_block, right_block,
 				PAGE_HEAP_NO_SUPREMUM, heap_no);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(right_block, left_block);
 }
 
 /*************************************************************//**
@@ -3023,7 +3469,7 @@ lock_update_merge_left(
 
 	ut_ad(left_block->frame == page_align(orig_pred));
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(left_block, right_block);
 
 	left_next_rec = page_rec_get_next_const(orig_pred);
 
@@ -3061,7 +3507,7 @@ lock_update_merge_left(
 
 	lock_rec_free_all_from_discard_page(right_block);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(left_block, right_block);
 }
 
 /*************************************************************//**
@@ -3082,13 +3528,13 @@ lock_rec_reset_and_inherit_gap_locks(
 	ulint			heap_no)	/*!< in: heap_no of the
 						donating record */
 {
-	lock_mutex_enter();
+	lock_mutex_enter_page(heir_block, block);
 
 	lock_rec_reset_and_release_wait(heir_block, heir_heap_no);
 
 	lock_rec_inherit_to_gap(heir_block, block, heir_heap_no, heap_no);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(heir_block, block);
 }
 
 /*************************************************************//**
@@ -3108,13 +3554,13 @@ lock_update_discard(
 	const rec_t*	rec;
 	ulint		heap_no;
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(heir_block, block);
 
 	if (!lock_rec_get_first_on_page(lock_sys->rec_hash, block)
 	    && (!lock_rec_get_first_on_page(lock_sys->prdt_hash, block))) {
 		/* No locks exist on page, nothing to do */
 
-		lock_mutex_exit();
+		lock_mutex_exit_page(heir_block, block);
 
 		return;
 	}
@@ -3152,7 +3598,7 @@ lock_update_discard(
 
 	lock_rec_free_all_from_discard_page(block);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(heir_block, block);
 }
 
 /*************************************************************//**
@@ -3213,7 +3659,7 @@ lock_update_delete(
 								       FALSE));
 	}
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 
 	/* Let the next record inherit the locks from rec, in gap mode */
 
@@ -3223,7 +3669,7 @@ lock_update_delete(
 
 	lock_rec_reset_and_release_wait(block, heap_no);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 }
 
 /*********************************************************************//**
@@ -3248,11 +3694,11 @@ lock_rec_store_on_page_infimum(
 
 	ut_ad(block->frame == page_align(rec));
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 
 	lock_rec_move(block, block, PAGE_HEAP_NO_INFIMUM, heap_no);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 }
 
 /*********************************************************************//**
@@ -3273,11 +3719,11 @@ lock_rec_restore_from_page_infimum(
 {
 	ulint	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block, donator);
 
 	lock_rec_move(block, donator, heap_no, PAGE_HEAP_NO_INFIMUM);
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block, donator);
 }
 
 /*========================= TABLE LOCKS ==============================*/
@@ -3543,21 +3989,27 @@ lock_table_enqueue_waiting(
 
 	lock = lock_table_create(table, mode | LOCK_WAIT, trx);
 
-	/* Release the mutex to obey the latching order.
-	This is safe, because DeadlockChecker::check_and_resolve()
-	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because trx is a running transaction
-	(it is not currently suspended because of a lock wait),
-	its state can only be changed by this thread, which is
-	currently associated with the transaction. */
+	const trx_t*	victim_trx = NULL;
 
-	trx_mutex_exit(trx);
+	/* With innodb_deadlock_detect=background, the lock wait timeout
+	thread will find the deadlock if there is one. */
 
-	const trx_t*	victim_trx;
+	if (srv_deadlock_detect == SRV_DEADLOCK_DETECT_IMMEDIATE) {
 
-	victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+		/* Release the mutex to obey the latching order.
+		This is safe, because DeadlockChecker::check_and_resolve()
+		is invoked when a lock wait is enqueued for the currently
+		running transaction. Because trx is a running transaction
+		(it is not currently suspended because of a lock wait),
+		its state can only be changed by this thread, which is
+		currently associated with the transaction. */
 
-	trx_mutex_enter(trx);
+		trx_mutex_exit(trx);
+
+		victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+
+		trx_mutex_enter(trx);
+	}
 
 	if (victim_trx != 0) {
 		ut_ad(victim_trx == trx);
@@ -3710,17 +4162,21 @@ lock_table(
 }
 
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table lock object for a resurrected transaction. */
 
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode)	/*!< in: LOCK_IX, or LOCK_X if the
+				transaction did a bulk insert into
+				the empty table */
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_IX || mode == LOCK_X);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -3730,10 +4186,10 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	trx_mutex_enter(trx);
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
@@ -3834,7 +4290,7 @@ lock_rec_unlock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 	trx_mutex_enter(trx);
 
 	first_lock = lock_rec_get_first(lock_sys->rec_hash, block, heap_no);
@@ -3849,7 +4305,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 	trx_mutex_exit(trx);
 
 	stmt = innobase_get_stmt_unsafe(trx->mysql_thd, &stmt_len);
@@ -3878,7 +4334,7 @@ released:
 		}
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 	trx_mutex_exit(trx);
 }
 
@@ -3947,8 +4403,14 @@ lock_release(
 		ut_d(lock_check_dict_lock(lock));
 
 		if (lock_get_type_low(lock) == LOCK_REC) {
+			ulint	space = lock->un_member.rec_lock.space;
+			ulint	page_no = lock->un_member.rec_lock.page_no;
+
+			lock_rec_shard_x_lock(space, page_no);
 
 			lock_rec_dequeue_from_page(lock);
+
+			lock_rec_shard_x_unlock(space, page_no);
 		} else {
 			dict_table_t*	table;
 
@@ -4172,7 +4634,7 @@ lock_remove_all_on_table(
 {
 	lock_t*		lock;
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 
 	for (lock = UT_LIST_GET_FIRST(table->locks);
 	     lock != NULL;
@@ -4229,7 +4691,7 @@ lock_remove_all_on_table(
 		lock_sys->rollback_complete = TRUE;
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 }
 
 /*===================== VALIDATION AND DEBUGGING  ====================*/
@@ -4421,7 +4883,7 @@ lock_print_info_summary(
 	otherwise return immediately if fail to obtain the
 	mutex. */
 	if (!nowait) {
-		lock_mutex_enter();
+		lock_mutex_enter_all();
 	} else if (lock_mutex_enter_nowait()) {
 		fputs("FAIL TO OBTAIN LOCK MUTEX,"
 		      " SKIP LOCK INFO PRINTING\n", file);
@@ -4686,7 +5148,7 @@ lock_rec_fetch_page(
 	if (found) {
 		mtr_t	mtr;
 
-		lock_mutex_exit();
+		lock_mutex_exit_all();
 
 		mutex_exit(&trx_sys->mutex);
 
@@ -4697,7 +5159,7 @@ lock_rec_fetch_page(
 
 		mtr_commit(&mtr);
 
-		lock_mutex_enter();
+		lock_mutex_enter_all();
 
 		mutex_enter(&trx_sys->mutex);
 
@@ -4856,7 +5318,7 @@ lock_print_info_all_transactions(
 		trx_iter.next();
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 	mutex_exit(&trx_sys->mutex);
 
 	ut_ad(lock_validate());
@@ -4977,7 +5439,7 @@ lock_rec_queue_validate(
 	heap_no = page_rec_get_heap_no(rec);
 
 	if (!locked_lock_trx_sys) {
-		lock_mutex_enter();
+		lock_mutex_enter_all();
 		mutex_enter(&trx_sys->mutex);
 	}
 
@@ -5054,7 +5516,7 @@ lock_rec_queue_validate(
 
 func_exit:
 	if (!locked_lock_trx_sys) {
-		lock_mutex_exit();
+		lock_mutex_exit_all();
 		mutex_exit(&trx_sys->mutex);
 	}
 
@@ -5082,7 +5544,7 @@ lock_rec_validate_page(
 
 	ut_ad(!lock_mutex_own());
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 	mutex_enter(&trx_sys->mutex);
 loop:
 	lock = lock_rec_get_first_on_page_addr(
@@ -5144,7 +5606,7 @@ loop:
 	goto loop;
 
 function_exit:
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 	mutex_exit(&trx_sys->mutex);
 
 	if (heap != NULL) {
@@ -5289,7 +5751,7 @@ lock_validate()
 
 	page_addr_set	pages;
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 	mutex_enter(&trx_sys->mutex);
 
 	ut_a(lock_validate_table_locks(&trx_sys->rw_trx_list));
@@ -5312,7 +5774,7 @@ lock_validate()
 	}
 
 	mutex_exit(&trx_sys->mutex);
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 
 	for (page_addr_set::const_iterator it = pages.begin();
 	     it != pages.end();
@@ -5368,7 +5830,12 @@ lock_rec_insert_check_and_lock(
 	const rec_t*	next_rec = page_rec_get_next_const(rec);
 	ulint		heap_no = page_rec_get_heap_no(next_rec);
 
-	lock_mutex_enter();
+	/* The common cases, where nobody has locked the successor or
+	where no lock request conflicts with the insert, are checked
+	while holding only the record lock shard of the page. */
+	lock_rec_shard_t*	shard = lock_rec_shard_enter(
+		block->page.id.space(), block->page.id.page_no());
+
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -5383,7 +5850,7 @@ lock_rec_insert_check_and_lock(
 	if (lock == NULL) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
+		lock_rec_shard_exit(shard);
 
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -5400,6 +5867,7 @@ lock_rec_insert_check_and_lock(
 	/* Spatial index does not use GAP lock protection. It uses
 	"predicate lock" to protect the "range" */
 	if (dict_index_is_spatial(index)) {
+		lock_rec_shard_exit(shard);
 		return(DB_SUCCESS);
 	}
 
@@ -5420,21 +5888,33 @@ lock_rec_insert_check_and_lock(
 	const lock_t*	wait_for = lock_rec_other_has_conflicting(
 		type_mode, block, heap_no, trx);
 
-	if (wait_for != NULL) {
-
-		/* Note that we may get DB_SUCCESS also here! */
-		trx_mutex_enter(trx);
+	lock_rec_shard_exit(shard);
 
-		err = lock_rec_enqueue_waiting(
-			type_mode, block, heap_no, index, thr, NULL);
+	if (wait_for == NULL) {
 
-		trx_mutex_exit(trx);
+		err = DB_SUCCESS;
 
 	} else {
-		err = DB_SUCCESS;
-	}
+		/* Enqueueing a waiting request needs the lock_sys->mutex.
+		The conflicting request may be gone by now. */
+		lock_mutex_enter_page(block);
 
-	lock_mutex_exit();
+		if (lock_rec_other_has_conflicting(
+			    type_mode, block, heap_no, trx)) {
+
+			/* Note that we may get DB_SUCCESS also here! */
+			trx_mutex_enter(trx);
+
+			err = lock_rec_enqueue_waiting(
+				type_mode, block, heap_no, index, thr, NULL);
+
+			trx_mutex_exit(trx);
+		} else {
+			err = DB_SUCCESS;
+		}
+
+		lock_mutex_exit_page(block);
+	}
 
 	switch (err) {
 	case DB_SUCCESS_LOCKED_REC:
@@ -5495,7 +5975,12 @@ lock_rec_convert_impl_to_expl_for_trx(
 
 	DEBUG_SYNC_C("before_lock_rec_convert_impl_to_expl_for_trx");
 
-	lock_mutex_enter();
+	/* The granted lock can be added while holding only the record
+	lock shard of the page. The reference to trx keeps
+	lock_trx_release_locks() from releasing the locks of trx until
+	we are done. */
+	lock_rec_shard_t*	shard = lock_rec_shard_enter(
+		block->page.id.space(), block->page.id.page_no());
 
 	ut_ad(!trx_state_eq(trx, TRX_STATE_NOT_STARTED));
 
@@ -5511,7 +5996,7 @@ lock_rec_convert_impl_to_expl_for_trx(
 			type_mode, block, heap_no, index, trx, FALSE);
 	}
 
-	lock_mutex_exit();
+	lock_rec_shard_exit(shard);
 
 	trx_release_reference(trx);
 
@@ -5609,16 +6094,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -5671,16 +6152,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -5772,8 +6249,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -5782,9 +6257,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -5846,8 +6319,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -5855,9 +6326,7 @@ lock_clust_rec_read_check_and_lock(
 
 	err = lock_rec_lock(FALSE, mode | gap_mode, block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6265,14 +6734,19 @@ lock_unlock_table_autoinc(
 	      || !trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY));
 
 	/* This function is invoked for a running transaction by the
-	thread that is serving the transaction. Therefore it is not
-	necessary to hold trx->mutex here. */
+	thread that is serving the transaction. The trx->mutex is only
+	needed for removing the locks from trx->lock.trx_locks, to which
+	an implicit lock of trx may be appended meanwhile. */
 
 	if (lock_trx_holds_autoinc_locks(trx)) {
 		lock_mutex_enter();
 
+		trx_mutex_enter(trx);
+
 		lock_release_autoinc_locks(trx);
 
+		trx_mutex_exit(trx);
+
 		lock_mutex_exit();
 	}
 }
@@ -6403,7 +6877,7 @@ lock_trx_handle_wait(
 {
 	dberr_t	err;
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 
 	trx_mutex_enter(trx);
 
@@ -6417,7 +6891,7 @@ lock_trx_handle_wait(
 		err = DB_SUCCESS;
 	}
 
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 
 	trx_mutex_exit(trx);
 
@@ -6513,11 +6987,17 @@ lock_table_has_locks(
 
 #ifdef UNIV_DEBUG
 	if (!has_locks) {
+		/* Exclude the implicit to explicit lock conversions,
+		which append to the trx_locks lists. */
+		lock_rec_shards_x_lock();
+
 		mutex_enter(&trx_sys->mutex);
 
 		ut_ad(!lock_table_locks_lookup(table, &trx_sys->rw_trx_list));
 
 		mutex_exit(&trx_sys->mutex);
+
+		lock_rec_shards_x_unlock();
 	}
 #endif /* UNIV_DEBUG */
 
@@ -6639,13 +7119,13 @@ lock_trx_has_rec_x_lock(
 {
 	ut_ad(heap_no > PAGE_HEAP_NO_SUPREMUM);
 
-	lock_mutex_enter();
+	lock_mutex_enter_page(block);
 	ut_a(lock_table_has(trx, table, LOCK_IX)
 	     || dict_table_is_temporary(table));
 	ut_a(lock_rec_has_expl(LOCK_X | LOCK_REC_NOT_GAP,
 			       block, heap_no, trx)
 	     || dict_table_is_temporary(table));
-	lock_mutex_exit();
+	lock_mutex_exit_page(block);
 	return(true);
 }
 #endif /* UNIV_DEBUG */
@@ -7049,6 +7529,10 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, const trx_t* trx)
 
 	const trx_t*	victim_trx;
 
+	/* The search follows the waits-for graph through the record lock
+	queues of any pages. */
+	lock_rec_shards_x_lock();
+
 	/* Try and resolve as many deadlocks as possible. */
 	do {
 		DeadlockChecker	checker(trx, lock, s_lock_mark_counter);
@@ -7086,9 +7570,360 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, const trx_t* trx)
 		lock_deadlock_found = true;
 	}
 
+	lock_rec_shards_x_unlock();
+
 	return(victim_trx);
 }
 
+/** Append the transactions that own or request a conflicting lock ahead
+of a waiting lock request in its queue.
+@param[in]	wait_lock	waiting lock request
+@param[in,out]	blockers	transactions that wait_lock has to wait for */
+void
+DeadlockChecker::get_blockers(
+	const lock_t*	wait_lock,
+	wait_trxs_t&	blockers)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	const lock_t*	lock;
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		hash_table_t*	lock_hash;
+		ulint		heap_no;
+
+		lock_hash = wait_lock->type_mode & LOCK_PREDICATE
+			? lock_sys->prdt_hash
+			: lock_sys->rec_hash;
+
+		heap_no = lock_rec_find_set_bit(wait_lock);
+
+		lock = lock_rec_get_first_on_page_addr(
+			lock_hash,
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
+
+		if (!lock_rec_get_nth_bit(lock, heap_no)) {
+			lock = lock_rec_get_next_const(heap_no, lock);
+		}
+
+		/* The record locks ahead of wait_lock in the queue */
+		for (; lock != NULL && lock != wait_lock;
+		     lock = lock_rec_get_next_const(heap_no, lock)) {
+
+			if (lock_has_to_wait(wait_lock, lock)) {
+				blockers.push_back(lock->trx);
+			}
+		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
+
+		for (lock = UT_LIST_GET_PREV(un_member.tab_lock.locks,
+					     wait_lock);
+		     lock != NULL;
+		     lock = UT_LIST_GET_PREV(un_member.tab_lock.locks, lock)) {
+
+			if (lock_has_to_wait(wait_lock, lock)) {
+				blockers.push_back(lock->trx);
+			}
+		}
+	}
+}
+
+/** Search for a cycle in a waits-for graph snapshot.
+@param[in]	nodes	waiting transactions, ordered by m_trx
+@param[in]	targets	node of each edge, or ULINT_UNDEFINED if the
+transaction at the end of the edge is not waiting
+@param[in,out]	removed	nodes of earlier victims; the victim of the
+found cycle is added
+@param[out]	cycle	nodes of the cycle, in waits-for order, the victim
+first
+@return whether a cycle was found */
+bool
+DeadlockChecker::search_snapshot(
+	const wait_nodes_t&	nodes,
+	const wait_ids_t&	targets,
+	std::vector<bool>&	removed,
+	wait_ids_t&		cycle)
+{
+	ut_ad(!lock_mutex_own());
+
+	/* Nodes on the DFS stack, and nodes whose sub-tree has been
+	searched without finding a cycle. */
+	std::vector<bool>	on_stack(nodes.size());
+	std::vector<bool>	searched(removed);
+
+	/* The DFS stack: node and the position of its next edge */
+	wait_ids_t		stack_nodes;
+	wait_ids_t		stack_edges;
+
+	for (ulint root = 0; root < nodes.size(); ++root) {
+
+		if (searched[root]) {
+			continue;
+		}
+
+		stack_nodes.push_back(root);
+		stack_edges.push_back(0);
+		on_stack[root] = true;
+
+		while (!stack_nodes.empty()) {
+			ulint			top = stack_nodes.back();
+			const wait_node_t&	node = nodes[top];
+
+			if (stack_edges.back() == node.m_n_edges) {
+
+				/* Backtrack */
+				on_stack[top] = false;
+				searched[top] = true;
+
+				stack_nodes.pop_back();
+				stack_edges.pop_back();
+
+				continue;
+			}
+
+			ulint	next = targets[node.m_first_edge
+					       + stack_edges.back()++];
+
+			if (next == ULINT_UNDEFINED || searched[next]) {
+
+				continue;
+
+			} else if (!on_stack[next]) {
+
+				stack_nodes.push_back(next);
+				stack_edges.push_back(0);
+				on_stack[next] = true;
+
+				continue;
+			}
+
+			/* Found a cycle: the stack from next upwards. */
+
+			wait_ids_t::iterator	it = std::find(
+				stack_nodes.begin(), stack_nodes.end(), next);
+
+			cycle.assign(it, stack_nodes.end());
+
+			/* Roll back the lightest transaction of the cycle,
+			like select_victim() does. */
+
+			ulint	victim = 0;
+
+			for (ulint i = 1; i < cycle.size(); ++i) {
+				const wait_node_t&	a = nodes[cycle[i]];
+				const wait_node_t&	b = nodes[cycle[victim]];
+
+				if (a.m_nontrans != b.m_nontrans
+				    ? b.m_nontrans
+				    : a.m_weight < b.m_weight) {
+
+					victim = i;
+				}
+			}
+
+			/* Keep the victim first. */
+			std::rotate(cycle.begin(), cycle.begin() + victim,
+				    cycle.end());
+
+			removed[cycle[0]] = true;
+
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/** Roll back the victim of a cycle of a waits-for graph snapshot if all
+the transactions of the cycle are still waiting for the same locks.
+@param[in]	nodes	waiting transactions
+@param[in]	cycle	nodes of the cycle, in waits-for order, the victim
+first */
+void
+DeadlockChecker::resolve_snapshot(
+	const wait_nodes_t&	nodes,
+	const wait_ids_t&	cycle)
+{
+	ut_ad(lock_mutex_own());
+
+	/* A transaction that still waits for the same lock request has
+	not released any of its locks, so the cycle still exists. */
+
+	for (wait_ids_t::const_iterator it = cycle.begin();
+	     it != cycle.end();
+	     ++it) {
+
+		const wait_node_t&	node = nodes[*it];
+
+		if (node.m_trx->id != node.m_trx_id
+		    || node.m_trx->lock.wait_lock != node.m_wait_lock) {
+
+			return;
+		}
+	}
+
+	start_print();
+
+	for (ulint i = 0; i < cycle.size(); ++i) {
+		const wait_node_t&	node = nodes[cycle[i]];
+		char			buf[80];
+
+		snprintf(buf, sizeof(buf),
+			 "\n*** (" ULINTPF ") TRANSACTION:\n", i + 1);
+		print(buf);
+
+		print(node.m_trx, 3000);
+
+		snprintf(buf, sizeof(buf),
+			 "*** (" ULINTPF ") WAITING FOR THIS LOCK TO BE"
+			 " GRANTED:\n", i + 1);
+		print(buf);
+
+		print(node.m_wait_lock);
+	}
+
+	print("*** WE ROLL BACK TRANSACTION (1)\n");
+
+	trx_t*	trx = const_cast<trx_t*>(nodes[cycle[0]].m_trx);
+
+	trx_mutex_enter(trx);
+
+	trx->lock.was_chosen_as_deadlock_victim = true;
+
+	lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+	trx_mutex_exit(trx);
+
+	lock_deadlock_found = true;
+
+	MONITOR_INC(MONITOR_DEADLOCK);
+}
+
+/** Searches a snapshot of the waits-for graph of the suspended lock waits
+for cycles, and rolls back the lightest transaction of each cycle. Only the
+snapshot is taken under lock_sys->mutex. */
+void
+DeadlockChecker::check_and_resolve_waits()
+{
+	ut_ad(!lock_mutex_own());
+	ut_ad(!srv_read_only_mode);
+
+	wait_nodes_t	nodes;
+	wait_trxs_t	blockers;
+
+	/* Copy the edges of the waits-for graph. A transaction that
+	has enqueued a waiting lock request but not yet suspended its
+	thread is left to the next search. */
+
+	lock_wait_mutex_enter();
+
+	lock_mutex_enter_all();
+
+	for (const srv_slot_t* slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		if (!slot->in_use) {
+			continue;
+		}
+
+		const trx_t*	trx = thr_get_trx(slot->thr);
+		const lock_t*	wait_lock = trx->lock.wait_lock;
+
+		if (wait_lock == NULL) {
+			continue;
+		}
+
+		wait_node_t	node;
+
+		node.m_trx = trx;
+		node.m_trx_id = trx->id;
+		node.m_wait_lock = wait_lock;
+		node.m_nontrans = trx->mysql_thd != NULL
+			&& thd_has_edited_nontrans_tables(trx->mysql_thd);
+		node.m_weight = TRX_WEIGHT(trx);
+		node.m_first_edge = blockers.size();
+
+		get_blockers(wait_lock, blockers);
+
+		node.m_n_edges = blockers.size() - node.m_first_edge;
+
+		nodes.push_back(node);
+	}
+
+	lock_mutex_exit_all();
+
+	lock_wait_mutex_exit();
+
+	if (nodes.size() < 2) {
+		return;
+	}
+
+	/* Only waiting transactions can be part of a cycle. Map each
+	edge to the node of the transaction it ends at, if any. */
+
+	std::sort(nodes.begin(), nodes.end());
+
+	wait_ids_t	targets(blockers.size(), ULINT_UNDEFINED);
+
+	for (ulint i = 0; i < blockers.size(); ++i) {
+		wait_node_t	key;
+
+		key.m_trx = blockers[i];
+
+		wait_nodes_t::const_iterator	it = std::lower_bound(
+			nodes.begin(), nodes.end(), key);
+
+		if (it != nodes.end() && it->m_trx == blockers[i]) {
+			targets[i] = it - nodes.begin();
+		}
+	}
+
+	/* Find the cycles one at a time. The victim of each cycle is
+	removed from the graph before searching again. */
+
+	std::vector<bool>	removed(nodes.size());
+	wait_ids_t		cycles;
+	wait_ids_t		cycle;
+
+	while (search_snapshot(nodes, targets, removed, cycle)) {
+		cycles.push_back(cycle.size());
+		cycles.insert(cycles.end(), cycle.begin(), cycle.end());
+	}
+
+	if (cycles.empty()) {
+		return;
+	}
+
+	lock_mutex_enter_all();
+
+	for (wait_ids_t::const_iterator it = cycles.begin();
+	     it != cycles.end();
+	     it += 1 + *it) {
+
+		cycle.assign(it + 1, it + 1 + *it);
+
+		resolve_snapshot(nodes, cycle);
+	}
+
+	lock_mutex_exit_all();
+}
+
+/*********************************************************************//**
+Searches the waits-for graph of the suspended lock waits for deadlocks
+and resolves them. This is done by the lock wait timeout thread when
+innodb_deadlock_detect=background. */
+
+void
+lock_wait_resolve_deadlocks(void)
+/*=============================*/
+{
+	DeadlockChecker::check_and_resolve_waits();
+}
+
 /**
 Allocate cached locks for the transaction.
 @param trx		allocate cached record locks for this transaction */
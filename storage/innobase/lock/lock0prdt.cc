@@ -534,13 +534,13 @@ lock_prdt_insert_check_and_lock(
 		    block, prdt, trx)) {
 		rtr_mbr_t*	my_mbr = prdt_get_mbr_from_prdt(prdt);
 
+		/* Note that we may get DB_SUCCESS also here! */
+		trx_mutex_enter(trx);
+
 		/* allocate MBR on lock heap */
 		lock_init_prdt_from_mbr(prdt, my_mbr, 0,
 					trx->lock.lock_heap);
 
-		/* Note that we may get DB_SUCCESS also here! */
-		trx_mutex_enter(trx);
-
 		err = lock_rec_enqueue_waiting(
 			LOCK_X | LOCK_PREDICATE | LOCK_INSERT_INTENTION,
 			block, PRDT_HEAPNO, index, thr, prdt);
@@ -1061,8 +1061,12 @@ lock_prdt_free_from_discard_page(
 	while (lock != NULL) {
 		next_lock = lock_rec_get_next_on_page(lock);
 
+		trx_mutex_enter(lock->trx);
+
 		lock_rec_discard(lock);
 
+		trx_mutex_exit(lock->trx);
+
 		lock = next_lock;
 	}
 }
@@ -451,7 +451,7 @@ lock_wait_check_and_cancel(
 		possible that the lock has already been
 		granted: in that case do nothing */
 
-		lock_mutex_enter();
+		lock_mutex_enter_all();
 
 		trx_mutex_enter(trx);
 
@@ -462,7 +462,7 @@ lock_wait_check_and_cancel(
 			lock_cancel_waiting_and_release(trx->lock.wait_lock);
 		}
 
-		lock_mutex_exit();
+		lock_mutex_exit_all();
 
 		trx_mutex_exit(trx);
 	}
@@ -482,6 +482,7 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 {
 	int64_t		sig_count = 0;
 	os_event_t	event = lock_sys->timeout_event;
+	uintmax_t	last_deadlock_check = 0;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -495,9 +496,17 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 		srv_slot_t*	slot;
 
 		/* When someone is waiting for a lock, we wake up every second
-		and check if a timeout has passed for a lock wait */
+		and check if a timeout has passed for a lock wait. With
+		innodb_deadlock_detect=background, we also search for
+		deadlocks at most every LOCK_DEADLOCK_CHECK_INTERVAL. */
 
-		os_event_wait_time_low(event, 1000000, sig_count);
+		bool	background = srv_deadlock_detect
+			== SRV_DEADLOCK_DETECT_BACKGROUND;
+
+		os_event_wait_time_low(
+			event,
+			background ? LOCK_DEADLOCK_CHECK_INTERVAL : 1000000,
+			sig_count);
 		sig_count = os_event_reset(event);
 
 		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
@@ -527,6 +536,18 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 
 		lock_wait_mutex_exit();
 
+		if (background) {
+			uintmax_t	now = ut_time_us(NULL);
+
+			if (now - last_deadlock_check
+			    >= LOCK_DEADLOCK_CHECK_INTERVAL) {
+
+				last_deadlock_check = now;
+
+				lock_wait_resolve_deadlocks();
+			}
+		}
+
 	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
 
 	lock_sys->timeout_thread_active = false;
@@ -146,6 +146,43 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+/** Waits until all the strings for which space was reserved with
+log_reserve_low() have been copied to the log buffer. The caller must
+hold the log mutex, so that no more space can be reserved. The log mutex
+is released while waiting, and it is held again on return, with no
+pending copies.
+@return whether the log mutex was released */
+static
+bool
+log_wait_for_pending_copies()
+{
+	bool	released = false;
+
+	ut_ad(log_mutex_own());
+
+	while (log_sys->n_pending_copies > 0) {
+		/* Reset the event before checking the count again,
+		so that the completion of the last copy is not missed. */
+		int64_t	sig_count = os_event_reset(log_sys->copies_event);
+
+		if (log_sys->n_pending_copies == 0) {
+			break;
+		}
+
+		log_mutex_exit();
+
+		os_event_wait_low(log_sys->copies_event, sig_count);
+
+		log_mutex_enter();
+
+		released = true;
+	}
+
+	os_rmb;
+
+	return(released);
+}
+
 /** Extends the log buffer.
 @param[in]	len	requested minimum size in bytes */
 
@@ -189,17 +226,21 @@ log_buffer_extend(
 
 	log_sys->is_extending = true;
 
-	while (ut_calc_align_down(log_sys->buf_free,
-				  OS_FILE_LOG_BLOCK_SIZE)
-	       != ut_calc_align_down(log_sys->buf_next_to_write,
-				     OS_FILE_LOG_BLOCK_SIZE)) {
-		/* Buffer might have >1 blocks to write still. */
-		log_mutex_exit();
+	/* More space may be reserved while the log mutex is released
+	for waiting for the pending copies. */
+	do {
+		while (ut_calc_align_down(log_sys->buf_free,
+					  OS_FILE_LOG_BLOCK_SIZE)
+		       != ut_calc_align_down(log_sys->buf_next_to_write,
+					     OS_FILE_LOG_BLOCK_SIZE)) {
+			/* Buffer might have >1 blocks to write still. */
+			log_mutex_exit();
 
-		log_buffer_flush_to_disk();
+			log_buffer_flush_to_disk();
 
-		log_mutex_enter();
-	}
+			log_mutex_enter();
+		}
+	} while (log_wait_for_pending_copies());
 
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
@@ -364,6 +405,141 @@ part_loop:
 	srv_stats.log_write_requests.inc();
 }
 
+/** Reserves space for a string in the log buffer without copying it,
+like log_write_low() would write it. The caller must hold the log mutex,
+and must copy the string with log_write_reserved() and then call
+log_write_reserved_complete(), which can be done after the log mutex
+has been released.
+@param[in]	str_len	string length
+@return offset in log_sys->buf where the string is to be copied */
+
+ulint
+log_reserve_low(
+	ulint	str_len)
+{
+	log_t*	log	= log_sys;
+	ulint	offset	= log->buf_free;
+
+	ut_ad(log_mutex_own());
+	ut_ad(str_len > 0);
+
+	do {
+		ut_ad(!recv_no_log_write);
+
+		ulint	data_len = (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
+			+ str_len;
+		ulint	len;
+
+		if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			len = str_len;
+		} else {
+			data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
+
+			len = OS_FILE_LOG_BLOCK_SIZE
+				- (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
+				- LOG_BLOCK_TRL_SIZE;
+		}
+
+		str_len -= len;
+
+		byte*	log_block = static_cast<byte*>(
+			ut_align_down(
+				log->buf + log->buf_free,
+				OS_FILE_LOG_BLOCK_SIZE));
+
+		/* Only the block header and trailer are written here.
+		They do not overlap with the bytes that other threads
+		may be concurrently copying to the same block in
+		log_write_reserved(). */
+		log_block_set_data_len(log_block, data_len);
+
+		if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* This block became full */
+			log_block_set_data_len(
+				log_block, OS_FILE_LOG_BLOCK_SIZE);
+			log_block_set_checkpoint_no(
+				log_block, log_sys->next_checkpoint_no);
+			len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+
+			log->lsn += len;
+
+			/* Initialize the next block header */
+			log_block_init(
+				log_block + OS_FILE_LOG_BLOCK_SIZE, log->lsn);
+		} else {
+			log->lsn += len;
+		}
+
+		log->buf_free += len;
+
+		ut_ad(log->buf_free <= log->buf_size);
+	} while (str_len > 0);
+
+	os_atomic_increment_ulint(&log->n_pending_copies, 1);
+
+	srv_stats.log_write_requests.inc();
+
+	return(offset);
+}
+
+/** Copies (a part of) a string to log buffer space that was reserved
+with log_reserve_low(). The caller need not hold the log mutex.
+@param[in]	offset	offset in log_sys->buf where to copy
+@param[in]	str	string
+@param[in]	str_len	string length
+@return offset in log_sys->buf following the copied string */
+
+ulint
+log_write_reserved(
+	ulint		offset,
+	const byte*	str,
+	ulint		str_len)
+{
+	ut_ad(log_sys->n_pending_copies > 0);
+
+	while (str_len > 0) {
+		ulint	block_offset = offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (block_offset
+		    >= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the
+			header of the next block. */
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+			continue;
+		}
+
+		ut_ad(block_offset >= LOG_BLOCK_HDR_SIZE);
+
+		ulint	len = ut_min(
+			str_len,
+			OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- block_offset);
+
+		ut_memcpy(log_sys->buf + offset, str, len);
+
+		offset += len;
+		str += len;
+		str_len -= len;
+	}
+
+	return(offset);
+}
+
+/** Notes that a string has been completely copied to log buffer space
+that was reserved with log_reserve_low(). */
+
+void
+log_write_reserved_complete()
+{
+	ut_ad(log_sys->n_pending_copies > 0);
+
+	/* This is a full memory barrier: the copied bytes will be
+	visible to log_wait_for_pending_copies(). */
+	if (os_atomic_decrement_ulint(&log_sys->n_pending_copies, 1) == 0) {
+		os_event_set(log_sys->copies_event);
+	}
+}
+
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -722,6 +898,8 @@ log_init(void)
 
 	os_event_set(log_sys->flush_event);
 
+	log_sys->copies_event = os_event_create(0);
+
 	/*----------------------------*/
 
 	log_sys->last_checkpoint_lsn = log_sys->lsn;
@@ -1111,6 +1289,11 @@ loop:
 	log_mutex_enter();
 	ut_ad(!recv_no_log_write);
 
+	/* The log buffer contents up to log_sys->buf_free must be
+	complete before we write them. This may release the log mutex,
+	so it must be done before the checks below. */
+	log_wait_for_pending_copies();
+
 	lsn_t	limit_lsn = flush_to_disk
 		? log_sys->flushed_to_disk_lsn
 		: log_sys->write_lsn;
@@ -1172,6 +1355,8 @@ loop:
 			      log_sys->write_lsn,
 			      log_sys->lsn));
 
+	ut_ad(log_sys->n_pending_copies == 0);
+
 	if (flush_to_disk) {
 		log_sys->n_pending_flushes++;
 		log_sys->current_flush_lsn = log_sys->lsn;
@@ -2410,6 +2595,7 @@ log_shutdown(void)
 	log_sys->checkpoint_buf = NULL;
 
 	os_event_destroy(log_sys->flush_event);
+	os_event_destroy(log_sys->copies_event);
 
 	rw_lock_free(&log_sys->checkpoint_lock);
 
@@ -58,6 +58,7 @@ Created 9/20/1997 Heikki Tuuri
 # include "trx0roll.h"
 # include "row0merge.h"
 # include "sync0mutex.h"
+# include "ut0wqueue.h"
 #else /* !UNIV_HOTBACKUP */
 /** This is set to FALSE if the backup was originally taken with the
 mysqlbackup --include regexp option: then we do not want to create tables in
@@ -146,6 +147,7 @@ mysql_pfs_key_t	trx_rollback_clean_thread_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 /** Flag indicating if recv_writer thread is active. */
@@ -1909,6 +1911,234 @@ recv_read_in_area(
 	return(n);
 }
 
+/** Number of pages handed to a recovery apply worker at a time. */
+#define RECV_APPLY_BATCH_SIZE	64
+
+/** A batch of hashed page addresses handed to a recovery apply worker. */
+struct recv_apply_batch_t {
+	recv_addr_t*	addrs[RECV_APPLY_BATCH_SIZE];
+					/*!< page addresses to apply */
+	ulint		n_addrs;	/*!< number of used slots in addrs */
+};
+
+/** State of the recovery apply workers of the current apply batch. */
+struct recv_apply_workers_t {
+	ulint			n_workers;
+					/*!< number of worker threads */
+	ib_wqueue_t**		queues;	/*!< one work queue per worker;
+					a NULL item tells the worker to exit */
+	recv_apply_batch_t**	batches;
+					/*!< batch being filled per worker,
+					or NULL */
+	volatile ulint		n_active;
+					/*!< number of workers still running */
+	os_event_t		exited;	/*!< set when n_active drops to 0 */
+	mem_heap_t*		heap;	/*!< heap for the batches and the
+					work queue list nodes; only accessed
+					by the dispatching thread */
+};
+
+/** Applies the hashed log records to one page, reading the page in
+if it is not resident in the buffer pool. If the page must be read, the
+whole read-ahead area around it is read asynchronously and the records
+are applied by the i/o handler thread in buf_page_io_complete().
+@param[in]	recv_addr	hashed page address */
+static
+void
+recv_apply_page(
+	recv_addr_t*	recv_addr)
+{
+	const page_id_t		page_id(recv_addr->space, recv_addr->page_no);
+	bool			found;
+	const page_size_t&	page_size
+		= fil_space_get_page_size(recv_addr->space, &found);
+
+	ut_ad(found);
+
+	if (buf_page_peek(page_id)) {
+		buf_block_t*	block;
+		mtr_t		mtr;
+
+		mtr_start(&mtr);
+
+		block = buf_page_get(page_id, page_size, RW_X_LATCH, &mtr);
+
+		buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
+
+		recv_recover_page(FALSE, block);
+		mtr_commit(&mtr);
+	} else {
+		recv_read_in_area(page_id);
+	}
+}
+
+/******************************************************************//**
+Recovery apply worker thread. Applies the batches of hashed log records
+that recv_apply_hashed_log_recs() dispatches to its work queue, until it
+receives a NULL item.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: work queue of this worker */
+{
+	ib_wqueue_t*	wq = static_cast<ib_wqueue_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (recv_apply_batch_t* batch = static_cast<recv_apply_batch_t*>(
+		       ib_wqueue_wait(wq))) {
+
+		ulint	n_pages = 0;
+
+		for (ulint i = 0; i < batch->n_addrs; i++) {
+			recv_addr_t*	recv_addr = batch->addrs[i];
+
+			/* A dirty read: pages that were already read in
+			as a part of an earlier read-ahead area are skipped
+			here, and recv_recover_page() rechecks the state
+			under recv_sys->mutex anyway. */
+			if (recv_addr->state == RECV_NOT_PROCESSED) {
+				recv_apply_page(recv_addr);
+				n_pages++;
+			}
+		}
+
+		srv_stats.recv_apply_pages.add(n_pages);
+	}
+
+	recv_apply_workers_t*	workers = recv_sys->apply_workers;
+
+	if (os_atomic_decrement_ulint(&workers->n_active, 1) == 0) {
+		os_event_set(workers->exited);
+	}
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Starts the recovery apply workers for an apply batch.
+@param[in]	n_workers	number of worker threads to start
+@return the worker state */
+static
+recv_apply_workers_t*
+recv_apply_workers_create(
+	ulint	n_workers)
+{
+	mem_heap_t*		heap = mem_heap_create(
+		sizeof(recv_apply_workers_t)
+		+ n_workers * sizeof(recv_apply_batch_t));
+	recv_apply_workers_t*	workers = static_cast<recv_apply_workers_t*>(
+		mem_heap_zalloc(heap, sizeof(*workers)));
+
+	workers->heap = heap;
+	workers->n_workers = n_workers;
+	workers->n_active = n_workers;
+	workers->exited = os_event_create(0);
+	workers->queues = static_cast<ib_wqueue_t**>(
+		mem_heap_zalloc(heap, n_workers * sizeof(*workers->queues)));
+	workers->batches = static_cast<recv_apply_batch_t**>(
+		mem_heap_zalloc(heap, n_workers * sizeof(*workers->batches)));
+
+	for (ulint i = 0; i < n_workers; i++) {
+		workers->queues[i] = ib_wqueue_create();
+	}
+
+	recv_sys->apply_workers = workers;
+
+	for (ulint i = 0; i < n_workers; i++) {
+		os_thread_create(recv_apply_thread, workers->queues[i], NULL);
+	}
+
+	return(workers);
+}
+
+/** Hands the batch being filled for a worker over to the worker.
+@param[in,out]	workers	worker state
+@param[in]	i	worker number */
+static
+void
+recv_apply_workers_post(
+	recv_apply_workers_t*	workers,
+	ulint			i)
+{
+	if (recv_apply_batch_t* batch = workers->batches[i]) {
+		workers->batches[i] = NULL;
+		ib_wqueue_add(workers->queues[i], batch, workers->heap);
+		srv_stats.recv_apply_batches.inc();
+	}
+}
+
+/** Dispatches a hashed page address to a recovery apply worker. All the
+pages of a read-ahead area go to the same worker, so that the worker can
+read them in with a single batch of asynchronous reads.
+@param[in,out]	workers		worker state
+@param[in]	recv_addr	hashed page address
+@return whether a full batch was handed over to a worker */
+static
+bool
+recv_apply_workers_dispatch(
+	recv_apply_workers_t*	workers,
+	recv_addr_t*		recv_addr)
+{
+	ulint	i = ut_fold_ulint_pair(
+		recv_addr->space,
+		recv_addr->page_no / RECV_READ_AHEAD_AREA)
+		% workers->n_workers;
+
+	recv_apply_batch_t*	batch = workers->batches[i];
+
+	if (batch == NULL) {
+		batch = static_cast<recv_apply_batch_t*>(
+			mem_heap_alloc(workers->heap, sizeof(*batch)));
+		batch->n_addrs = 0;
+		workers->batches[i] = batch;
+	}
+
+	batch->addrs[batch->n_addrs++] = recv_addr;
+
+	if (batch->n_addrs < RECV_APPLY_BATCH_SIZE) {
+		return(false);
+	}
+
+	recv_apply_workers_post(workers, i);
+
+	return(true);
+}
+
+/** Hands the remaining batches to the recovery apply workers, tells them
+to exit, waits for them to exit and frees the worker state.
+@param[in,out]	workers	worker state */
+static
+void
+recv_apply_workers_free(
+	recv_apply_workers_t*	workers)
+{
+	for (ulint i = 0; i < workers->n_workers; i++) {
+		recv_apply_workers_post(workers, i);
+		ib_wqueue_add(workers->queues[i], NULL, workers->heap);
+	}
+
+	os_event_wait(workers->exited);
+
+	os_event_destroy(workers->exited);
+
+	for (ulint i = 0; i < workers->n_workers; i++) {
+		ib_wqueue_free(workers->queues[i]);
+	}
+
+	recv_sys->apply_workers = NULL;
+
+	mem_heap_free(workers->heap);
+}
+
 /*******************************************************************//**
 Empties the hash table of stored log records, applying them to appropriate
 pages. */
@@ -1929,7 +2159,7 @@ recv_apply_hashed_log_recs(
 	recv_addr_t* recv_addr;
 	ulint	i;
 	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
+	recv_apply_workers_t*	workers	= NULL;
 loop:
 	mutex_enter(&(recv_sys->mutex));
 
@@ -1951,6 +2181,10 @@ loop:
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
+	if (srv_n_recv_apply_threads > 0) {
+		workers = recv_apply_workers_create(srv_n_recv_apply_threads);
+	}
+
 	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
 
 		for (recv_addr = static_cast<recv_addr_t*>(
@@ -1965,15 +2199,6 @@ loop:
 				continue;
 			}
 
-			const page_id_t		page_id(recv_addr->space,
-							recv_addr->page_no);
-			bool			found;
-			const page_size_t&	page_size
-				= fil_space_get_page_size(recv_addr->space,
-							  &found);
-
-			ut_ad(found);
-
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
 				if (!has_printed) {
 					ib_logf(IB_LOG_LEVEL_INFO,
@@ -1985,25 +2210,21 @@ loop:
 					has_printed = TRUE;
 				}
 
-				mutex_exit(&(recv_sys->mutex));
-
-				if (buf_page_peek(page_id)) {
-					buf_block_t*	block;
-
-					mtr_start(&mtr);
+				if (workers != NULL) {
+					if (recv_apply_workers_dispatch(
+						    workers, recv_addr)) {
+						/* Let the workers get at
+						recv_sys->mutex. */
+						mutex_exit(&recv_sys->mutex);
+						mutex_enter(&recv_sys->mutex);
+					}
 
-					block = buf_page_get(
-						page_id, page_size,
-						RW_X_LATCH, &mtr);
+					continue;
+				}
 
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+				mutex_exit(&(recv_sys->mutex));
 
-					recv_recover_page(FALSE, block);
-					mtr_commit(&mtr);
-				} else {
-					recv_read_in_area(page_id);
-				}
+				recv_apply_page(recv_addr);
 
 				mutex_enter(&(recv_sys->mutex));
 			}
@@ -2020,6 +2241,14 @@ loop:
 		}
 	}
 
+	if (workers != NULL) {
+		mutex_exit(&(recv_sys->mutex));
+
+		recv_apply_workers_free(workers);
+
+		mutex_enter(&(recv_sys->mutex));
+	}
+
 	/* Wait until all the pages have been processed */
 
 	while (recv_sys->n_addrs != 0) {
@@ -3729,6 +3958,37 @@ recv_reset_log_files_for_backup(
 }
 #endif /* UNIV_HOTBACKUP */
 
+/** Allocate a buffer for reading doublewrite pages. It is freed
+together with the list of pages.
+@param[in]	n_pages	number of pages
+@return buffer aligned to UNIV_PAGE_SIZE */
+
+byte*
+recv_dblwr_t::alloc(ulint n_pages)
+{
+	byte*	buf = static_cast<byte*>(
+		ut_malloc_nokey((n_pages + 1) * UNIV_PAGE_SIZE));
+
+	bufs.push_back(buf);
+
+	return(static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE)));
+}
+
+/** Clear the list of pages and free the buffers
+(invoked by ut_when_dtor) */
+
+void
+recv_dblwr_t::operator() ()
+{
+	pages.clear();
+
+	for (bufs_t::iterator i = bufs.begin(); i != bufs.end(); ++i) {
+		ut_free(*i);
+	}
+
+	bufs.clear();
+}
+
 /** Find a doublewrite copy of a page.
 @param[in]	space_id	tablespace identifier
 @param[in]	page_no		page number
@@ -362,6 +362,17 @@ public:
 	void finish_write(ulint len);
 
 private:
+	/** Reserve space for the redo log records in the redo log buffer.
+	The records are copied there by copy_reserved(), which does not need
+	the log mutex.
+	@param[in]	len	number of bytes to write */
+	void reserve_write(ulint len);
+
+	/** Copy the redo log records to the space reserved by
+	reserve_write().
+	@param[in]	len	number of bytes to write */
+	void copy_reserved(ulint len);
+
 	/** Prepare to write the mini-transaction log to the redo log buffer.
 	@return number of bytes to write in finish_write() */
 	ulint prepare_write();
@@ -381,6 +392,11 @@ private:
 
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
+
+	/** Offset of the space reserved by reserve_write() in the
+	redo log buffer, or ULINT_UNDEFINED if the log records were
+	already copied there */
+	ulint			m_log_offset;
 };
 
 /** Check if a mini-transaction is dirtying a clean page.
@@ -420,6 +436,32 @@ struct mtr_write_log_t {
 	}
 };
 
+/** Copy the block contents to space reserved in the REDO log buffer */
+struct mtr_write_reserved_log_t {
+	/** Number of bytes to write */
+	mutable ulint	m_len;
+
+	/** Offset in the log buffer where to write */
+	mutable ulint	m_offset;
+
+	/** Constructor */
+	mtr_write_reserved_log_t(ulint len, ulint offset)
+		: m_len (len), m_offset (offset) {}
+
+	/** Copy a block to the reserved redo log buffer space.
+	@return whether the copying should continue */
+	bool operator()(const mtr_buf_t::block_t* block) const
+	{
+		ut_ad(m_len > 0);
+
+		ulint	len = ut_min(m_len, block->used());
+
+		m_offset = log_write_reserved(m_offset, block->begin(), len);
+		m_len -= len;
+		return(m_len > 0);
+	}
+};
+
 /** Append records to the system-wide redo log buffer.
 @param[in]	log	redo log records */
 
@@ -465,6 +507,7 @@ mtr_t::start(bool sync, bool read_only)
 	m_impl.m_n_log_recs = 0;
 	m_impl.m_state = MTR_STATE_ACTIVE;
 	m_impl.m_named_space = TRX_SYS_SPACE;
+	m_impl.m_scan_ring = NULL;
 
 	ut_d(m_impl.m_magic_n = MTR_MAGIC_N);
 }
@@ -757,6 +800,48 @@ mtr_t::Command::finish_write(
 	m_end_lsn = log_close();
 }
 
+/** Reserve space for the redo log records in the redo log buffer.
+The records are copied there by copy_reserved(), which does not need
+the log mutex.
+@param[in]	len	number of bytes to write */
+
+void
+mtr_t::Command::reserve_write(
+	ulint	len)
+{
+	ut_ad(m_impl->m_log_mode == MTR_LOG_ALL);
+	ut_ad(log_mutex_own());
+	ut_ad(m_impl->m_log.size() >= len);
+	ut_ad(len > 0);
+
+#ifdef UNIV_LOG_LSN_DEBUG
+	/* The MLOG_LSN record is generated while copying. */
+	finish_write(len);
+	m_log_offset = ULINT_UNDEFINED;
+#else
+	m_start_lsn = log_reserve_and_open(len);
+	m_log_offset = log_reserve_low(len);
+	m_end_lsn = log_close();
+#endif /* UNIV_LOG_LSN_DEBUG */
+}
+
+/** Copy the redo log records to the space reserved by reserve_write().
+@param[in]	len	number of bytes to write */
+
+void
+mtr_t::Command::copy_reserved(
+	ulint	len)
+{
+	if (m_log_offset == ULINT_UNDEFINED) {
+		return;
+	}
+
+	mtr_write_reserved_log_t	write_log(len, m_log_offset);
+	m_impl->m_log.for_each_block(write_log);
+
+	log_write_reserved_complete();
+}
+
 /** Release the latches and blocks acquired by this mini-transaction */
 
 void
@@ -804,8 +889,10 @@ mtr_t::Command::execute()
 {
 	ut_ad(m_impl->m_log_mode != MTR_LOG_NONE);
 
-	if (const ulint len = prepare_write()) {
-		finish_write(len);
+	const ulint	len = prepare_write();
+
+	if (len > 0) {
+		reserve_write(len);
 	}
 
 	if (m_impl->m_made_dirty) {
@@ -825,6 +912,15 @@ mtr_t::Command::execute()
 		log_flush_order_mutex_exit();
 	}
 
+	/* Other mini-transactions can reserve log buffer space and
+	insert into the flush list while we are copying. The page latches
+	are still held, and log_write_up_to() will wait for the copying
+	to finish before writing the buffer, so no page can be flushed
+	before its log. */
+	if (len > 0) {
+		copy_reserved(len);
+	}
+
 	release_latches();
 
 	release_resources();
@@ -0,0 +1,475 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file os/os0comp.cc
+Transparent page compression in the i/o layer
+*******************************************************/
+
+#include "ha_prototypes.h"
+
+#include "os0comp.h"
+#include "fil0fil.h"
+#include "mach0data.h"
+#include "page0zip.h"
+#include "ut0new.h"
+
+#include <zlib.h>
+
+/** Compress a buffer with zlib.
+@see os_comp_codec_t::compress */
+static
+ulint
+os_comp_zlib_compress(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len)
+{
+	uLongf	len = static_cast<uLongf>(out_len);
+
+	if (compress2(out, &len, in, static_cast<uLong>(in_len),
+		      page_zip_level ? page_zip_level : 1) != Z_OK) {
+		return(0);
+	}
+
+	return(len);
+}
+
+/** Decompress a buffer with zlib.
+@see os_comp_codec_t::decompress */
+static
+bool
+os_comp_zlib_decompress(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len)
+{
+	uLongf	len = static_cast<uLongf>(out_len);
+
+	return(uncompress(out, &len, in, static_cast<uLong>(in_len)) == Z_OK
+	       && len == out_len);
+}
+
+/** Number of bits in the hash of the LZ codec match finder */
+#define OS_COMP_LZ_HASH_BITS	12
+/** Minimum length of a match of the LZ codec */
+#define OS_COMP_LZ_MIN_MATCH	4
+/** Number of bytes at the end of the input that are always literals */
+#define OS_COMP_LZ_LAST_LITERALS	5
+/** A match may not start in this many bytes at the end of the input */
+#define OS_COMP_LZ_MATCH_LIMIT	12
+/** Maximum distance of a match */
+#define OS_COMP_LZ_MAX_DISTANCE	65535
+/** Largest length that fits in a token nibble. Longer lengths continue
+in extra bytes, see os_comp_lz_write_len(). */
+static const ulint	OS_COMP_LZ_NIBBLE_MAX = 15;
+
+/** Hash the 4 bytes at a position of the input of the LZ codec.
+@param[in]	p	position
+@return hash value */
+static inline
+ulint
+os_comp_lz_hash(
+	const byte*	p)
+{
+	return((mach_read_from_4(p) * 2654435761U) & 0xFFFFFFFFU)
+		>> (32 - OS_COMP_LZ_HASH_BITS);
+}
+
+/** Write a length of the LZ codec that did not fit in a token nibble.
+@param[in]	len	remaining length, at least OS_COMP_LZ_NIBBLE_MAX
+@param[in,out]	op	output position
+@param[in]	oend	end of output
+@return output position after the length, or NULL on overflow */
+static
+byte*
+os_comp_lz_write_len(
+	ulint		len,
+	byte*		op,
+	const byte*	oend)
+{
+	for (len -= OS_COMP_LZ_NIBBLE_MAX; len >= 255; len -= 255) {
+		if (op >= oend) {
+			return(NULL);
+		}
+		*op++ = 255;
+	}
+
+	if (op >= oend) {
+		return(NULL);
+	}
+
+	*op++ = static_cast<byte>(len);
+
+	return(op);
+}
+
+/** Compress a buffer with the built-in LZ77 codec. The output is a
+sequence of tokens in the layout of the LZ4 block format: a token byte
+holding the literal length and the match length in its high and low
+nibble, the literals, and a little-endian 2-byte match distance.
+The final token only has literals.
+@see os_comp_codec_t::compress */
+static
+ulint
+os_comp_lz_compress(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len)
+{
+	/* Positions of the input plus 1, by hash of 4 bytes */
+	uint32_t	table[1 << OS_COMP_LZ_HASH_BITS];
+	const byte*	ip = in;
+	const byte*	anchor = in;
+	const byte*	end = in + in_len;
+	byte*		op = out;
+	const byte*	oend = out + out_len;
+
+	memset(table, 0, sizeof table);
+
+	if (in_len > OS_COMP_LZ_MATCH_LIMIT) {
+		const byte*	mflimit = end - OS_COMP_LZ_MATCH_LIMIT;
+		const byte*	mlimit = end - OS_COMP_LZ_LAST_LITERALS;
+
+		while (ip < mflimit) {
+			ulint		h = os_comp_lz_hash(ip);
+			ulint		ref = table[h];
+
+			table[h] = static_cast<uint32_t>(ip - in + 1);
+
+			if (ref == 0
+			    || ulint(ip - in) - (ref - 1)
+			    > OS_COMP_LZ_MAX_DISTANCE
+			    || memcmp(in + ref - 1, ip,
+				      OS_COMP_LZ_MIN_MATCH)) {
+				ip++;
+				continue;
+			}
+
+			const byte*	match = in + ref - 1;
+			const byte*	p = ip + OS_COMP_LZ_MIN_MATCH;
+
+			for (match += OS_COMP_LZ_MIN_MATCH;
+			     p < mlimit && *p == *match;
+			     p++, match++) {
+			}
+
+			ulint	lit = ip - anchor;
+			ulint	mlen = p - ip - OS_COMP_LZ_MIN_MATCH;
+			ulint	dist = p - match;
+
+			if (op >= oend) {
+				return(0);
+			}
+
+			byte*	token = op++;
+
+			*token = static_cast<byte>(
+				(ut_min(lit, OS_COMP_LZ_NIBBLE_MAX) << 4)
+				| ut_min(mlen, OS_COMP_LZ_NIBBLE_MAX));
+
+			if (lit >= OS_COMP_LZ_NIBBLE_MAX
+			    && !(op = os_comp_lz_write_len(lit, op, oend))) {
+				return(0);
+			}
+
+			if (ulint(oend - op) < lit + 2) {
+				return(0);
+			}
+
+			memcpy(op, anchor, lit);
+			op += lit;
+			*op++ = static_cast<byte>(dist);
+			*op++ = static_cast<byte>(dist >> 8);
+
+			if (mlen >= OS_COMP_LZ_NIBBLE_MAX
+			    && !(op = os_comp_lz_write_len(mlen, op, oend))) {
+				return(0);
+			}
+
+			anchor = ip = p;
+		}
+	}
+
+	ulint	lit = end - anchor;
+
+	if (op >= oend) {
+		return(0);
+	}
+
+	*op++ = static_cast<byte>(ut_min(lit, OS_COMP_LZ_NIBBLE_MAX) << 4);
+
+	if (lit >= OS_COMP_LZ_NIBBLE_MAX
+	    && !(op = os_comp_lz_write_len(lit, op, oend))) {
+		return(0);
+	}
+
+	if (ulint(oend - op) < lit) {
+		return(0);
+	}
+
+	memcpy(op, anchor, lit);
+	op += lit;
+
+	return(op - out);
+}
+
+/** Read a length of the LZ codec that did not fit in a token nibble.
+@param[in,out]	len	length from the token nibble
+@param[in,out]	ip	input position
+@param[in]	iend	end of input
+@return false on truncated input */
+static
+bool
+os_comp_lz_read_len(
+	ulint*		len,
+	const byte**	ip,
+	const byte*	iend)
+{
+	ulint	b;
+
+	do {
+		if (*ip >= iend) {
+			return(false);
+		}
+
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return(true);
+}
+
+/** Decompress a buffer with the built-in LZ77 codec.
+@see os_comp_codec_t::decompress */
+static
+bool
+os_comp_lz_decompress(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len)
+{
+	const byte*	ip = in;
+	const byte*	iend = in + in_len;
+	byte*		op = out;
+	const byte*	oend = out + out_len;
+
+	for (;;) {
+		if (ip >= iend) {
+			return(false);
+		}
+
+		ulint	token = *ip++;
+		ulint	lit = token >> 4;
+
+		if (lit == OS_COMP_LZ_NIBBLE_MAX
+		    && !os_comp_lz_read_len(&lit, &ip, iend)) {
+			return(false);
+		}
+
+		if (lit > ulint(iend - ip) || lit > ulint(oend - op)) {
+			return(false);
+		}
+
+		memcpy(op, ip, lit);
+		op += lit;
+		ip += lit;
+
+		if (ip == iend) {
+			/* The final token has no match. */
+			return(op == oend);
+		}
+
+		if (iend - ip < 2) {
+			return(false);
+		}
+
+		ulint	dist = ulint(ip[0]) | ulint(ip[1]) << 8;
+		ulint	mlen = token & OS_COMP_LZ_NIBBLE_MAX;
+
+		ip += 2;
+
+		if (dist == 0 || dist > ulint(op - out)) {
+			return(false);
+		}
+
+		if (mlen == OS_COMP_LZ_NIBBLE_MAX
+		    && !os_comp_lz_read_len(&mlen, &ip, iend)) {
+			return(false);
+		}
+
+		mlen += OS_COMP_LZ_MIN_MATCH;
+
+		if (mlen > ulint(oend - op)) {
+			return(false);
+		}
+
+		/* The match may overlap the output; copy byte by byte. */
+		for (const byte* match = op - dist; mlen--; ) {
+			*op++ = *match++;
+		}
+	}
+}
+
+/** The codecs, indexed by os_comp_t. A new codec is added by
+assigning it the next algorithm number and an entry here. */
+static const os_comp_codec_t	os_comp_codecs[OS_COMP_MAX] = {
+	{"none", NULL, NULL},
+	{"zlib", os_comp_zlib_compress, os_comp_zlib_decompress},
+	{"lz", os_comp_lz_compress, os_comp_lz_decompress}
+};
+
+/** Look up a compression algorithm by name.
+@param[in]	name	codec name, case insensitive
+@param[in]	len	length of name
+@return algorithm, or OS_COMP_MAX if there is no such codec */
+os_comp_t
+os_comp_find(
+	const char*	name,
+	ulint		len)
+{
+	for (ulint i = 0; i < OS_COMP_MAX; i++) {
+		const char*	codec = os_comp_codecs[i].name;
+		ulint		j;
+
+		for (j = 0; j < len && codec[j] != '\0'; j++) {
+			if (tolower(name[j]) != codec[j]) {
+				break;
+			}
+		}
+
+		if (j == len && codec[j] == '\0') {
+			return(static_cast<os_comp_t>(i));
+		}
+	}
+
+	return(OS_COMP_MAX);
+}
+
+/** Get the name of a compression algorithm.
+@param[in]	algorithm	compression algorithm
+@return name of the codec */
+const char*
+os_comp_name(
+	os_comp_t	algorithm)
+{
+	ut_ad(algorithm < OS_COMP_MAX);
+
+	return(os_comp_codecs[algorithm].name);
+}
+
+/** Compress a page for writing it to a data file.
+@param[in]	algorithm	compression algorithm
+@param[in]	page		uncompressed page of UNIV_PAGE_SIZE bytes
+@param[in]	block_size	file system block size
+@param[out]	out		buffer of UNIV_PAGE_SIZE bytes
+@return number of bytes to write, a multiple of block_size, or 0 if
+the page should be written uncompressed */
+ulint
+os_comp_page_compress(
+	os_comp_t	algorithm,
+	const byte*	page,
+	ulint		block_size,
+	byte*		out)
+{
+	ut_ad(algorithm > OS_COMP_NONE);
+	ut_ad(algorithm < OS_COMP_MAX);
+	ut_ad(ut_is_2pow(block_size));
+
+	if (block_size >= UNIV_PAGE_SIZE) {
+		return(0);
+	}
+
+	/* Compressing is only worthwhile if it saves a block. */
+	ulint	len = os_comp_codecs[algorithm].compress(
+		page + FIL_PAGE_TYPE, UNIV_PAGE_SIZE - FIL_PAGE_TYPE,
+		out + FIL_PAGE_DATA,
+		UNIV_PAGE_SIZE - FIL_PAGE_DATA - block_size);
+
+	if (len == 0) {
+		return(0);
+	}
+
+	memcpy(out, page, FIL_PAGE_TYPE);
+	mach_write_to_2(out + FIL_PAGE_TYPE, FIL_PAGE_COMPRESSED);
+	mach_write_to_1(out + OS_COMP_ALGORITHM, algorithm);
+	mach_write_to_1(out + OS_COMP_ALGORITHM + 1, 0);
+	mach_write_to_2(out + OS_COMP_LEN, len);
+	memset(out + OS_COMP_LEN + 2, 0, FIL_PAGE_SPACE_ID - OS_COMP_LEN - 2);
+	memcpy(out + FIL_PAGE_SPACE_ID, page + FIL_PAGE_SPACE_ID, 4);
+
+	len += FIL_PAGE_DATA;
+
+	ulint	write_len = ut_calc_align(len, block_size);
+
+	ut_ad(write_len < UNIV_PAGE_SIZE);
+
+	memset(out + len, 0, write_len - len);
+
+	return(write_len);
+}
+
+/** Decompress a page that was read from a data file, in place. Pages
+that are not compressed are left alone.
+@param[in,out]	page		page of UNIV_PAGE_SIZE bytes
+@param[in,out]	scratch		buffer of UNIV_PAGE_SIZE bytes, or NULL
+to allocate one
+@return false if the page is compressed and could not be decompressed */
+bool
+os_comp_page_decompress(
+	byte*		page,
+	byte*		scratch)
+{
+	if (mach_read_from_2(page + FIL_PAGE_TYPE) != FIL_PAGE_COMPRESSED) {
+		return(true);
+	}
+
+	ulint	algorithm = mach_read_from_1(page + OS_COMP_ALGORITHM);
+	ulint	len = mach_read_from_2(page + OS_COMP_LEN);
+
+	if (algorithm == OS_COMP_NONE
+	    || algorithm >= OS_COMP_MAX
+	    || len > UNIV_PAGE_SIZE - FIL_PAGE_DATA) {
+		return(false);
+	}
+
+	byte*	buf = scratch;
+
+	if (buf == NULL) {
+		buf = static_cast<byte*>(ut_malloc_nokey(UNIV_PAGE_SIZE));
+	}
+
+	bool	success = os_comp_codecs[algorithm].decompress(
+		page + FIL_PAGE_DATA, len,
+		buf + FIL_PAGE_TYPE, UNIV_PAGE_SIZE - FIL_PAGE_TYPE);
+
+	if (success) {
+		memcpy(page + FIL_PAGE_TYPE, buf + FIL_PAGE_TYPE,
+		       UNIV_PAGE_SIZE - FIL_PAGE_TYPE);
+	}
+
+	if (scratch == NULL) {
+		ut_free(buf);
+	}
+
+	return(success);
+}
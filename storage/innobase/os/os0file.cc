@@ -41,6 +41,7 @@ Created 10/21/1995 Heikki Tuuri
 #endif
 
 #include "ut0mem.h"
+#include "os0comp.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "fil0fil.h"
@@ -63,6 +64,12 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#ifdef LINUX_IO_URING
+#include "os0uring.h"
+#include <algorithm>
+#include <vector>
+#endif /* LINUX_IO_URING */
+
 #ifdef UNIV_DEBUG
 /** Set when InnoDB has invoked exit(). */
 bool	innodb_calling_exit;
@@ -185,18 +192,62 @@ struct os_aio_slot_t{
 					and which can be used to identify
 					which pending aio operation was
 					completed */
+	byte*		page;		/*!< the page of an OS_FILE_PAGE
+					read, which is decompressed when
+					the read completes; else NULL */
+	byte*		comp_buf;	/*!< the unaligned buffer of a
+					compressed page write, freed with
+					the slot; else NULL */
 #ifdef WIN_ASYNC_IO
 	HANDLE		handle;		/*!< handle object we need in the
 					OVERLAPPED struct */
 	OVERLAPPED	control;	/*!< Windows control block for the
 					aio request */
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+# ifdef LINUX_NATIVE_AIO
 	struct iocb	control;	/* Linux control block for aio */
+# endif /* LINUX_NATIVE_AIO */
+# ifdef LINUX_IO_URING
+	struct iovec	iov;		/* buffer of an io_uring request
+					that is not in a registered
+					buffer */
+	bool		fixed;		/* whether the io_uring request
+					reads or writes a registered
+					buffer */
+# endif /* LINUX_IO_URING */
 	int		n_bytes;	/* bytes written/read. */
 	int		ret;		/* AIO return code */
 #endif /* WIN_ASYNC_IO */
 };
 
+#ifdef LINUX_IO_URING
+/** An io_uring of an aio segment */
+struct os_aio_ring_t {
+	SysMutex		mutex;	/*!< serializes the submissions
+					to ring; the io-thread of the
+					segment reaps the completions
+					without it. Taken after the
+					mutex of the aio array. */
+	os_uring_t		ring;	/*!< the io_uring */
+	const struct iovec*	bufs;	/*!< the buffers that new
+					requests may use as registered
+					buffers, sorted by address,
+					or NULL */
+	ulint			n_bufs;	/*!< number of bufs */
+	bool			registered;
+					/*!< whether buffers are
+					registered with ring */
+	ulint			n_fixed;/*!< number of queued or
+					submitted requests that use
+					registered buffers. Changed
+					atomically, as the io-thread
+					decrements it without mutex */
+	os_event_t		no_fixed;
+					/*!< set when n_fixed drops
+					to 0 */
+};
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 struct os_aio_array_t{
 	SysMutex	mutex;	/*!< the mutex protecting the aio array */
@@ -246,6 +297,12 @@ struct os_aio_array_t{
 				possible pending IO. The size of the
 				array is equal to n_slots. */
 #endif /* LINUX_NATIV_AIO */
+#ifdef LINUX_IO_URING
+	os_aio_ring_t*		rings;
+				/* io_uring instances when
+				innodb_use_io_uring is set, one per
+				segment like aio_ctx */
+#endif /* LINUX_IO_URING */
 };
 
 #if defined(LINUX_NATIVE_AIO)
@@ -259,6 +316,26 @@ struct os_aio_array_t{
 #define OS_AIO_IO_SETUP_RETRY_ATTEMPTS	5
 #endif
 
+#ifdef LINUX_IO_URING
+/** Largest buffer that can be registered with io_uring */
+#define OS_AIO_URING_MAX_BUF_SIZE	(1UL << 30)
+
+/** Largest number of buffers that can be registered with io_uring */
+#define OS_AIO_URING_MAX_BUFS		1024
+
+/** Number of entries in os_aio_flush_ring */
+#define OS_AIO_URING_FLUSH_ENTRIES	64UL
+
+/** The ring for os_file_flush_files() */
+static os_aio_ring_t*	os_aio_flush_ring	= NULL;
+
+/** The buffers registered with the rings, sorted by address */
+static struct iovec*	os_aio_uring_bufs	= NULL;
+
+/** Number of os_aio_uring_bufs */
+static ulint		os_aio_uring_n_bufs	= 0;
+#endif /* LINUX_IO_URING */
+
 /** Array of events used in simulated aio */
 static os_event_t*	os_aio_segment_wait_events = NULL;
 
@@ -2090,6 +2167,59 @@ os_file_get_size(
 #endif /* _WIN32 */
 }
 
+/** Get the block size of the file system of a file.
+@param[in]	file	handle to a file
+@return block size, a power of 2 between 512 and UNIV_PAGE_SIZE */
+ulint
+os_file_get_block_size(
+	os_file_t	file)
+{
+	ulint	block_size = 512;
+
+#ifndef _WIN32
+	struct stat	statinfo;
+
+	if (fstat(file, &statinfo) == 0
+	    && statinfo.st_blksize > 512
+	    && ut_is_2pow(statinfo.st_blksize)) {
+		block_size = ut_min(ulint(statinfo.st_blksize),
+				    ulint(UNIV_PAGE_SIZE));
+	}
+#endif /* !_WIN32 */
+
+	return(block_size);
+}
+
+/** Free the storage of a range of a file, keeping the file size.
+The range reads back as zeros.
+@param[in]	file	handle to a file
+@param[in]	offset	start of the range
+@param[in]	len	length of the range
+@return true if successful, false if the file system does not
+support it or there was an error */
+bool
+os_file_punch_hole(
+	os_file_t	file,
+	os_offset_t	offset,
+	os_offset_t	len)
+{
+#if defined(FALLOC_FL_PUNCH_HOLE) && defined(FALLOC_FL_KEEP_SIZE)
+	if (fallocate(file, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+		      offset, len) == 0) {
+		return(true);
+	}
+
+	if (errno != EOPNOTSUPP && errno != ENOSYS) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"fallocate(FALLOC_FL_PUNCH_HOLE) failed at offset "
+			UINT64PF " with errno %d",
+			offset, errno);
+	}
+#endif /* FALLOC_FL_PUNCH_HOLE && FALLOC_FL_KEEP_SIZE */
+
+	return(false);
+}
+
 /***********************************************************************//**
 Write the specified number of zeros to a newly created file.
 @return true if success */
@@ -3657,6 +3787,460 @@ os_aio_native_aio_supported(void)
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_AIO
+/** Check if native aio is done with libaio.
+@return true if libaio is used */
+static inline
+bool
+os_aio_use_libaio()
+{
+	return(srv_use_native_aio && !srv_use_io_uring);
+}
+#endif /* LINUX_NATIVE_AIO */
+
+#ifdef LINUX_IO_URING
+/** Check if native aio is done with io_uring.
+@return true if io_uring is used */
+static inline
+bool
+os_aio_use_uring()
+{
+	return(srv_use_native_aio && srv_use_io_uring);
+}
+
+/** Check if io_uring can be used on this system.
+@return true if supported */
+static
+bool
+os_aio_uring_supported()
+{
+	os_uring_t	ring;
+	int		err = os_uring_create(&ring, 1);
+
+	if (err != 0) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"io_uring_setup() failed: %s", strerror(-err));
+		return(false);
+	}
+
+	os_uring_free(&ring);
+
+	return(true);
+}
+
+/** Create an io_uring for an aio segment or for os_file_flush_files().
+@param[out]	ring	ring to create
+@param[in]	entries	number of submission queue entries
+@return true on success */
+static
+bool
+os_aio_ring_create(
+	os_aio_ring_t*	ring,
+	ulint		entries)
+{
+	mutex_create("os_aio_uring_mutex", &ring->mutex);
+
+	ring->bufs = NULL;
+	ring->n_bufs = 0;
+	ring->registered = false;
+	ring->n_fixed = 0;
+
+	int	err = os_uring_create(&ring->ring, entries);
+
+	if (err != 0) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"io_uring_setup() failed: %s", strerror(-err));
+		return(false);
+	}
+
+	ring->no_fixed = os_event_create(0);
+
+	return(true);
+}
+
+/** Free an io_uring created by os_aio_ring_create().
+@param[in,out]	ring	ring to free */
+static
+void
+os_aio_ring_free(
+	os_aio_ring_t*	ring)
+{
+	os_uring_free(&ring->ring);
+	os_event_destroy(ring->no_fixed);
+	mutex_destroy(&ring->mutex);
+}
+
+/** Submit the queued requests of an io_uring. Running out of kernel
+resources is retried; any other failure is fatal, because the requests
+are already owned by the ring.
+@param[in,out]	ring	ring */
+static
+void
+os_aio_ring_submit(
+	os_aio_ring_t*	ring)
+{
+	ut_ad(mutex_own(&ring->mutex));
+
+	for (ulint i = 0;; ++i) {
+		int	ret = os_uring_submit(&ring->ring);
+
+		if (ret >= 0) {
+			return;
+		}
+
+		if (ret != -EAGAIN && ret != -EBUSY) {
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"io_uring_enter() failed: %s", strerror(-ret));
+		}
+
+		if (i % 100 == 0) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"io_uring_enter(): %s; retrying",
+				strerror(-ret));
+		}
+
+		os_thread_sleep(10000);
+	}
+}
+
+/** Get a submission queue entry of an io_uring. If the submission
+queue is full of queued requests, submit them first.
+@param[in,out]	ring	ring
+@return zero-filled submission queue entry */
+static
+struct io_uring_sqe*
+os_aio_ring_get_sqe(
+	os_aio_ring_t*	ring)
+{
+	ut_ad(mutex_own(&ring->mutex));
+
+	struct io_uring_sqe*	sqe = os_uring_get_sqe(&ring->ring);
+
+	if (sqe == NULL) {
+		os_aio_ring_submit(ring);
+
+		sqe = os_uring_get_sqe(&ring->ring);
+
+		ut_a(sqe != NULL);
+	}
+
+	return(sqe);
+}
+
+/** Compare a buffer address with a registered buffer.
+@param[in]	buf	buffer address
+@param[in]	iov	registered buffer
+@return whether buf is below iov */
+static
+bool
+os_aio_uring_buf_less(
+	const byte*		buf,
+	const struct iovec&	iov)
+{
+	return(buf < static_cast<const byte*>(iov.iov_base));
+}
+
+/** Order registered buffers by address.
+@param[in]	a	registered buffer
+@param[in]	b	registered buffer
+@return whether a is below b */
+static
+bool
+os_aio_uring_buf_cmp(
+	const struct iovec&	a,
+	const struct iovec&	b)
+{
+	return(a.iov_base < b.iov_base);
+}
+
+/** Look up the registered buffer that contains an i/o buffer.
+@param[in]	ring	ring
+@param[in]	buf	i/o buffer
+@param[in]	len	length of buf
+@return index of the registered buffer, or ULINT_UNDEFINED */
+static
+ulint
+os_aio_ring_find_buf(
+	const os_aio_ring_t*	ring,
+	const byte*		buf,
+	ulint			len)
+{
+	const struct iovec*	end = ring->bufs + ring->n_bufs;
+	const struct iovec*	it = std::upper_bound(
+		ring->bufs, end, buf, os_aio_uring_buf_less);
+
+	if (it == ring->bufs) {
+		return(ULINT_UNDEFINED);
+	}
+
+	--it;
+
+	if (buf + len > static_cast<const byte*>(it->iov_base)
+	    + it->iov_len) {
+
+		return(ULINT_UNDEFINED);
+	}
+
+	return(it - ring->bufs);
+}
+
+/** Queue the request of a reserved slot to the io_uring of its segment.
+Buffers inside the registered buffer pool memory are read or written
+with IORING_OP_READ_FIXED and IORING_OP_WRITE_FIXED.
+@param[in]	array	aio array
+@param[in,out]	slot	reserved slot
+@param[in]	submit	whether to submit the request now; if false,
+the request is submitted by the next os_aio_simulated_wake_handler_threads()
+or by the next request that is submitted to the ring */
+static
+void
+os_aio_uring_dispatch(
+	os_aio_array_t*	array,
+	os_aio_slot_t*	slot,
+	bool		submit)
+{
+	ut_a(slot->is_reserved);
+
+	os_aio_ring_t*	ring = &array->rings[
+		(slot->pos * array->n_segments) / array->n_slots];
+
+	mutex_enter(&ring->mutex);
+
+	struct io_uring_sqe*	sqe = os_aio_ring_get_sqe(ring);
+	ulint			index = os_aio_ring_find_buf(
+		ring, slot->buf, slot->len);
+
+	sqe->fd = slot->file;
+	sqe->off = slot->offset;
+	sqe->user_data = reinterpret_cast<uintptr_t>(slot);
+
+	slot->fixed = index != ULINT_UNDEFINED;
+
+	if (slot->fixed) {
+		sqe->opcode = slot->type == OS_FILE_READ
+			? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+		sqe->addr = reinterpret_cast<uintptr_t>(slot->buf);
+		sqe->len = static_cast<__u32>(slot->len);
+		sqe->buf_index = static_cast<__u16>(index);
+
+		(void) os_atomic_increment_ulint(&ring->n_fixed, 1);
+	} else {
+		slot->iov.iov_base = slot->buf;
+		slot->iov.iov_len = slot->len;
+
+		sqe->opcode = slot->type == OS_FILE_READ
+			? IORING_OP_READV : IORING_OP_WRITEV;
+		sqe->addr = reinterpret_cast<uintptr_t>(&slot->iov);
+		sqe->len = 1;
+	}
+
+	if (submit) {
+		os_aio_ring_submit(ring);
+	}
+
+	mutex_exit(&ring->mutex);
+}
+
+/** Submit the requests that were queued for a batch to an io_uring.
+@param[in,out]	ring	ring
+@return 0 */
+static
+int
+os_aio_ring_submit_queued(
+	os_aio_ring_t*	ring)
+{
+	mutex_enter(&ring->mutex);
+
+	if (os_uring_n_queued(&ring->ring) > 0) {
+		os_aio_ring_submit(ring);
+	}
+
+	mutex_exit(&ring->mutex);
+
+	return(0);
+}
+
+/** Wake up the io-thread that waits for completions of an io_uring
+with a no-op request.
+@param[in,out]	ring	ring
+@return 0 */
+static
+int
+os_aio_ring_wake(
+	os_aio_ring_t*	ring)
+{
+	mutex_enter(&ring->mutex);
+
+	struct io_uring_sqe*	sqe = os_aio_ring_get_sqe(ring);
+
+	sqe->opcode = IORING_OP_NOP;
+	sqe->user_data = 0;
+
+	os_aio_ring_submit(ring);
+
+	mutex_exit(&ring->mutex);
+
+	return(0);
+}
+
+/** Register os_aio_uring_bufs with an io_uring.
+@param[in,out]	ring	ring
+@return 0 or -errno */
+static
+int
+os_aio_ring_register_buffers(
+	os_aio_ring_t*	ring)
+{
+	mutex_enter(&ring->mutex);
+
+	int	err = os_uring_register_buffers(
+		&ring->ring, os_aio_uring_bufs, os_aio_uring_n_bufs);
+
+	if (err == 0) {
+		ring->bufs = os_aio_uring_bufs;
+		ring->n_bufs = os_aio_uring_n_bufs;
+		ring->registered = true;
+	}
+
+	mutex_exit(&ring->mutex);
+
+	return(err);
+}
+
+/** Unregister the buffers of an io_uring. Requests that use them
+would fail with EFAULT once they are unregistered, so new requests stop
+using them, the queued ones are submitted, and all of them are waited
+for first.
+@param[in,out]	ring	ring
+@return 0 */
+static
+int
+os_aio_ring_unregister_buffers(
+	os_aio_ring_t*	ring)
+{
+	mutex_enter(&ring->mutex);
+
+	if (!ring->registered) {
+		mutex_exit(&ring->mutex);
+		return(0);
+	}
+
+	ring->bufs = NULL;
+	ring->n_bufs = 0;
+
+	if (os_uring_n_queued(&ring->ring) > 0) {
+		os_aio_ring_submit(ring);
+	}
+
+	mutex_exit(&ring->mutex);
+
+	/* The io-thread reaps the completions without ring->mutex.
+	Do not hold it here, because a thread that is dispatching a
+	request to ring may hold the aio array mutex that the io-thread
+	needs to mark a request done. */
+	while (ring->n_fixed > 0) {
+		int64_t	sig_count = os_event_reset(ring->no_fixed);
+
+		if (ring->n_fixed == 0) {
+			break;
+		}
+
+		os_event_wait_low(ring->no_fixed, sig_count);
+	}
+
+	mutex_enter(&ring->mutex);
+
+	os_uring_unregister_buffers(&ring->ring);
+	ring->registered = false;
+
+	mutex_exit(&ring->mutex);
+
+	return(0);
+}
+
+/** Apply a function to the io_uring of each segment of the aio arrays
+that have io-threads.
+@param[in]	func	function to apply
+@return the first non-zero return value of func, or 0 */
+static
+int
+os_aio_uring_for_each(
+	int	(*func)(os_aio_ring_t*))
+{
+	os_aio_array_t*	arrays[] = {
+		os_aio_ibuf_array, os_aio_log_array,
+		os_aio_read_array, os_aio_write_array
+	};
+	int		ret = 0;
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		if (arrays[i] == NULL || arrays[i]->rings == NULL) {
+			continue;
+		}
+
+		for (ulint j = 0; j < arrays[i]->n_segments; ++j) {
+			int	err = func(&arrays[i]->rings[j]);
+
+			if (ret == 0) {
+				ret = err;
+			}
+		}
+	}
+
+	return(ret);
+}
+
+/** Reap the completed requests of an aio segment from its io_uring.
+The io-thread of the segment waits here until a request completes or
+os_aio_wake_all_threads_at_shutdown() wakes it up.
+@param[in,out]	array		aio array
+@param[in]	segment		local segment number
+@param[in]	seg_size	number of slots in a segment */
+static
+void
+os_aio_uring_collect(
+	os_aio_array_t*	array,
+	ulint		segment,
+	ulint		seg_size)
+{
+	os_aio_ring_t*		ring = &array->rings[segment];
+	struct io_uring_cqe*	cqe;
+
+	for (cqe = os_uring_wait_cqe(&ring->ring, true);
+	     cqe != NULL;
+	     cqe = os_uring_wait_cqe(&ring->ring, false)) {
+
+		os_aio_slot_t*	slot = reinterpret_cast<os_aio_slot_t*>(
+			cqe->user_data);
+		int		res = cqe->res;
+
+		os_uring_cqe_seen(&ring->ring);
+
+		if (slot == NULL) {
+			/* A wake-up at shutdown */
+			continue;
+		}
+
+		ut_a(slot->is_reserved);
+		ut_a(slot->pos >= segment * seg_size);
+		ut_a(slot->pos < (segment + 1) * seg_size);
+
+		if (slot->fixed
+		    && os_atomic_decrement_ulint(&ring->n_fixed, 1) == 0) {
+			os_event_set(ring->no_fixed);
+		}
+
+		/* Mark this request as completed. The error handling
+		will be done in the calling function. */
+		mutex_enter(&array->mutex);
+		slot->n_bytes = res < 0 ? 0 : res;
+		slot->ret = res < 0 ? res : 0;
+		slot->io_already_done = true;
+		mutex_exit(&array->mutex);
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /******************************************************************//**
 Creates an aio wait array. Note that we return NULL in case of failure.
 We don't care about freeing memory here because we assume that a
@@ -3700,13 +4284,31 @@ os_aio_array_create(
 		ut_malloc_nokey(n * sizeof(HANDLE)));
 #endif /* _WIN32 */
 
+#ifdef LINUX_IO_URING
+	array->rings = NULL;
+
+	if (os_aio_use_uring()) {
+		/* One io_uring per segment, like the io_context
+		of libaio */
+		array->rings = static_cast<os_aio_ring_t*>(
+			ut_zalloc_nokey(n_segments * sizeof(*array->rings)));
+
+		for (ulint i = 0; i < n_segments; ++i) {
+			if (!os_aio_ring_create(&array->rings[i],
+						n / n_segments)) {
+				return(NULL);
+			}
+		}
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	array->aio_ctx = NULL;
 	array->aio_events = NULL;
 
 	/* If we are not using native aio interface then skip this
 	part of initialization. */
-	if (!srv_use_native_aio) {
+	if (!os_aio_use_libaio()) {
 		goto skip_native_aio;
 	}
 
@@ -3753,8 +4355,10 @@ skip_native_aio:
 
 		array->handles[i] = over->hEvent;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+# ifdef LINUX_NATIVE_AIO
 		memset(&slot->control, 0x0, sizeof(slot->control));
+# endif /* LINUX_NATIVE_AIO */
 		slot->n_bytes = 0;
 		slot->ret = 0;
 #endif /* WIN_ASYNC_IO */
@@ -3788,12 +4392,22 @@ os_aio_array_free(
 	os_event_destroy(array->is_empty);
 
 #if defined(LINUX_NATIVE_AIO)
-	if (srv_use_native_aio) {
+	if (os_aio_use_libaio()) {
 		ut_free(array->aio_events);
 		ut_free(array->aio_ctx);
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	if (array->rings != NULL) {
+		for (ulint i = 0; i < array->n_segments; ++i) {
+			os_aio_ring_free(&array->rings[i]);
+		}
+
+		ut_free(array->rings);
+	}
+#endif /* LINUX_IO_URING */
+
 	ut_free(array->slots);
 	ut_free(array);
 
@@ -3820,9 +4434,25 @@ os_aio_init(
 {
 	os_io_init_simple();
 
+#ifdef LINUX_IO_URING
+	if (os_aio_use_uring() && !os_aio_uring_supported()) {
+# ifdef LINUX_NATIVE_AIO
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"io_uring disabled, using libaio for Linux"
+			" Native AIO.");
+# else
+		ib_logf(IB_LOG_LEVEL_WARN, "Linux Native AIO disabled.");
+
+		srv_use_native_aio = FALSE;
+# endif /* LINUX_NATIVE_AIO */
+
+		srv_use_io_uring = FALSE;
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio && !os_aio_native_aio_supported()) {
+	if (os_aio_use_libaio() && !os_aio_native_aio_supported()) {
 
 		ib_logf(IB_LOG_LEVEL_WARN, "Linux Native AIO disabled.");
 
@@ -3830,6 +4460,18 @@ os_aio_init(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	if (os_aio_use_uring()) {
+		os_aio_flush_ring = static_cast<os_aio_ring_t*>(
+			ut_zalloc_nokey(sizeof(*os_aio_flush_ring)));
+
+		if (!os_aio_ring_create(os_aio_flush_ring,
+					OS_AIO_URING_FLUSH_ENTRIES)) {
+			return(false);
+		}
+	}
+#endif /* LINUX_IO_URING */
+
 	srv_reset_io_thread_op_info();
 
 	/* Initialize ibuf and log aio segment. */
@@ -3938,6 +4580,19 @@ os_aio_free(void)
 
 	os_aio_array_free(os_aio_read_array);
 
+#ifdef LINUX_IO_URING
+	if (os_aio_flush_ring != NULL) {
+		os_aio_ring_free(os_aio_flush_ring);
+		ut_free(os_aio_flush_ring);
+		os_aio_flush_ring = NULL;
+	}
+
+	/* The buffers were unregistered when the rings were closed. */
+	ut_free(os_aio_uring_bufs);
+	os_aio_uring_bufs = NULL;
+	os_aio_uring_n_bufs = 0;
+#endif /* LINUX_IO_URING */
+
 #ifndef UNIV_HOTBACKUP
 	for (ulint i = 0; i < OS_FILE_N_SEEK_MUTEXES; i++) {
 		mutex_free(os_file_seek_mutexes[i]);
@@ -3958,6 +4613,170 @@ os_aio_free(void)
 	os_aio_n_segments = 0;
 }
 
+/** Register the buffer pool memory with the io_uring instances, so that
+page reads and writes do not need to map the pages for each request.
+Any previously registered buffers are unregistered first. This is a
+no-op unless innodb_use_io_uring is in effect.
+@param[in]	mem	start addresses of the memory chunks
+@param[in]	size	sizes of the memory chunks in bytes
+@param[in]	n	number of memory chunks */
+
+void
+os_aio_register_buffers(
+	byte* const*	mem,
+	const ulint*	size,
+	ulint		n)
+{
+#ifdef LINUX_IO_URING
+	if (!os_aio_use_uring()) {
+		return;
+	}
+
+	os_aio_unregister_buffers();
+
+	std::vector<struct iovec>	bufs;
+
+	for (ulint i = 0; i < n; ++i) {
+		for (ulint offs = 0; offs < size[i];
+		     offs += OS_AIO_URING_MAX_BUF_SIZE) {
+
+			struct iovec	iov;
+
+			iov.iov_base = mem[i] + offs;
+			iov.iov_len = ut_min(size[i] - offs,
+					     OS_AIO_URING_MAX_BUF_SIZE);
+
+			bufs.push_back(iov);
+		}
+	}
+
+	if (bufs.empty()) {
+		return;
+	}
+
+	if (bufs.size() > OS_AIO_URING_MAX_BUFS) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"The buffer pool consists of %lu pieces; not"
+			" registering it with io_uring.",
+			(ulong) bufs.size());
+		return;
+	}
+
+	std::sort(bufs.begin(), bufs.end(), os_aio_uring_buf_cmp);
+
+	os_aio_uring_n_bufs = bufs.size();
+	os_aio_uring_bufs = static_cast<struct iovec*>(
+		ut_malloc_nokey(os_aio_uring_n_bufs * sizeof(*os_aio_uring_bufs)));
+
+	memcpy(os_aio_uring_bufs, &bufs[0],
+	       os_aio_uring_n_bufs * sizeof(*os_aio_uring_bufs));
+
+	int	err = os_aio_uring_for_each(os_aio_ring_register_buffers);
+
+	if (err != 0) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Cannot register the buffer pool with io_uring: %s."
+			" Pages will be read and written without fixed"
+			" buffers.", strerror(-err));
+	}
+#endif /* LINUX_IO_URING */
+}
+
+/** Unregister the buffers registered by os_aio_register_buffers(). This
+must be called before the buffer pool memory is freed. */
+
+void
+os_aio_unregister_buffers()
+{
+#ifdef LINUX_IO_URING
+	if (os_aio_uring_bufs == NULL) {
+		return;
+	}
+
+	os_aio_uring_for_each(os_aio_ring_unregister_buffers);
+
+	ut_free(os_aio_uring_bufs);
+	os_aio_uring_bufs = NULL;
+	os_aio_uring_n_bufs = 0;
+#endif /* LINUX_IO_URING */
+}
+
+/** Flush the write buffers of several files to the disk. With io_uring
+the files are flushed concurrently; otherwise one after another with
+os_file_flush(). As with os_file_flush(), a failure is fatal.
+@param[in]	files	handles to the files
+@param[in]	n	number of files */
+
+void
+os_file_flush_files(
+	const os_file_t*	files,
+	ulint			n)
+{
+#ifdef LINUX_IO_URING
+	if (os_aio_flush_ring != NULL && n > 1) {
+		os_aio_ring_t*		ring = os_aio_flush_ring;
+
+		mutex_enter(&ring->mutex);
+
+		for (ulint i = 0; i < n; ) {
+			ulint	batch = ut_min(n - i,
+					       OS_AIO_URING_FLUSH_ENTRIES);
+
+			for (ulint j = 0; j < batch; ++j) {
+				struct io_uring_sqe*	sqe
+					= os_aio_ring_get_sqe(ring);
+
+				sqe->opcode = IORING_OP_FSYNC;
+				sqe->fd = files[i + j];
+				sqe->user_data = i + j;
+			}
+
+			os_aio_ring_submit(ring);
+
+			for (ulint j = 0; j < batch; ) {
+				struct io_uring_cqe*	cqe
+					= os_uring_wait_cqe(&ring->ring, true);
+
+				if (cqe == NULL) {
+					/* Interrupted */
+					continue;
+				}
+
+				/* The kernel may have dropped the dirty
+				pages of a file whose fsync failed, so a
+				retry could succeed after losing writes.
+				As in os_file_flush(), a failure is fatal,
+				except EINVAL on a raw device. */
+				if (cqe->res < 0
+				    && !(srv_start_raw_disk_in_use
+					 && cqe->res == -EINVAL)) {
+					ib_logf(IB_LOG_LEVEL_FATAL,
+						"fsync() of file " ULINTPF
+						" of " ULINTPF " failed: %s",
+						ulint(cqe->user_data), n,
+						strerror(-cqe->res));
+				}
+
+				os_uring_cqe_seen(&ring->ring);
+
+				os_n_fsyncs++;
+				++j;
+			}
+
+			i += batch;
+		}
+
+		mutex_exit(&ring->mutex);
+
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
+	for (ulint i = 0; i < n; ++i) {
+		os_file_flush(files[i]);
+	}
+}
+
 #ifdef WIN_ASYNC_IO
 /************************************************************************//**
 Wakes up all async i/o threads in the array in Windows async i/o at
@@ -3998,7 +4817,16 @@ os_aio_wake_all_threads_at_shutdown(void)
 		os_aio_array_wake_win_aio_at_shutdown(os_aio_log_array);
 	}
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+
+# ifdef LINUX_IO_URING
+	if (os_aio_use_uring()) {
+		/* The io helper threads wait in io_uring_enter()
+		without a timeout. Wake them up with no-op requests. */
+		os_aio_uring_for_each(os_aio_ring_wake);
+		return;
+	}
+# endif /* LINUX_IO_URING */
 
 	/* When using native AIO interface the io helper threads
 	wait on io_getevents with a timeout value of 500ms. At
@@ -4137,7 +4965,11 @@ os_aio_array_reserve_slot(
 	void*		buf,	/*!< in: buffer where to read or from which
 				to write */
 	os_offset_t	offset,	/*!< in: file offset */
-	ulint		len)	/*!< in: length of the block to read or write */
+	ulint		len,	/*!< in: length of the block to read or write */
+	byte*		page,	/*!< in: page to decompress when the read
+				completes, or NULL */
+	byte*		comp_buf)/*!< in: unaligned buffer of buf, to be
+				freed with the slot, or NULL */
 {
 	os_aio_slot_t*	slot = NULL;
 #ifdef WIN_ASYNC_IO
@@ -4173,12 +5005,11 @@ loop:
 	if (array->n_reserved == array->n_slots) {
 		mutex_exit(&array->mutex);
 
-		if (!srv_use_native_aio) {
-			/* If the handler threads are suspended, wake them
-			so that we get more slots */
+		/* If the handler threads are suspended, or requests
+		are queued to io_uring for a batch, wake them so that
+		we get more slots */
 
-			os_aio_simulated_wake_handler_threads();
-		}
+		os_aio_simulated_wake_handler_threads();
 
 		os_event_wait(array->not_full);
 
@@ -4227,6 +5058,8 @@ found:
 	slot->buf      = static_cast<byte*>(buf);
 	slot->offset   = offset;
 	slot->io_already_done = false;
+	slot->page     = page;
+	slot->comp_buf = comp_buf;
 
 #ifdef WIN_ASYNC_IO
 	control = &slot->control;
@@ -4234,10 +5067,15 @@ found:
 	control->OffsetHigh = (DWORD) (offset >> 32);
 	ResetEvent(slot->handle);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
-	/* If we are not using native AIO skip this part. */
-	if (!srv_use_native_aio) {
+	slot->n_bytes = 0;
+	slot->ret = 0;
+
+# ifdef LINUX_NATIVE_AIO
+	/* If we are not using libaio skip this part. The io_uring
+	request is prepared when it is dispatched. */
+	if (!os_aio_use_libaio()) {
 		goto skip_native_aio;
 	}
 
@@ -4258,11 +5096,10 @@ found:
 	}
 
 	iocb->data = (void*) slot;
-	slot->n_bytes = 0;
-	slot->ret = 0;
 
 skip_native_aio:
-#endif /* LINUX_NATIVE_AIO */
+# endif /* LINUX_NATIVE_AIO */
+#endif /* WIN_ASYNC_IO */
 	mutex_exit(&array->mutex);
 
 	return(slot);
@@ -4283,6 +5120,11 @@ os_aio_array_free_slot(
 
 	slot->is_reserved = false;
 
+	if (slot->comp_buf != NULL) {
+		ut_free(slot->comp_buf);
+		slot->comp_buf = NULL;
+	}
+
 	array->n_reserved--;
 
 	if (array->n_reserved == array->n_slots - 1) {
@@ -4297,10 +5139,12 @@ os_aio_array_free_slot(
 
 	ResetEvent(slot->handle);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 	if (srv_use_native_aio) {
+# ifdef LINUX_NATIVE_AIO
 		memset(&slot->control, 0x0, sizeof(slot->control));
+# endif /* LINUX_NATIVE_AIO */
 		slot->n_bytes = 0;
 		slot->ret = 0;
 		/*fprintf(stderr, "Freed up Linux native slot.\n");*/
@@ -4370,6 +5214,15 @@ void
 os_aio_simulated_wake_handler_threads(void)
 /*=======================================*/
 {
+#ifdef LINUX_IO_URING
+	if (os_aio_use_uring()) {
+		/* Submit the requests that were queued for a batch */
+		os_aio_uring_for_each(os_aio_ring_submit_queued);
+
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
 	if (srv_use_native_aio) {
 		/* We do not use simulated aio: do nothing */
 
@@ -4420,7 +5273,7 @@ readahead requests. */
 #endif /* _WIN32 */
 }
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 /*******************************************************************//**
 Dispatch an AIO request to the kernel.
 @return true on success. */
@@ -4429,17 +5282,28 @@ bool
 os_aio_linux_dispatch(
 /*==================*/
 	os_aio_array_t*	array,	/*!< in: io request array. */
-	os_aio_slot_t*	slot)	/*!< in: an already reserved slot. */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot. */
+	bool		wake_later)/*!< in: whether io_uring may defer
+				the submission to
+				os_aio_simulated_wake_handler_threads() */
 {
-	int		ret;
-	ulint		io_ctx_index;
-	struct iocb*	iocb;
-
 	ut_ad(slot != NULL);
 	ut_ad(array);
 
 	ut_a(slot->is_reserved);
 
+#ifdef LINUX_IO_URING
+	if (os_aio_use_uring()) {
+		os_aio_uring_dispatch(array, slot, !wake_later);
+		return(true);
+	}
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
+	int		ret;
+	ulint		io_ctx_index;
+	struct iocb*	iocb;
+
 	/* Find out what we are going to work with.
 	The iocb struct is directly in the slot.
 	The io_context is one per segment. */
@@ -4464,9 +5328,70 @@ os_aio_linux_dispatch(
 	}
 
 	return(true);
-}
+#else
+	ut_error;
+	return(false);
 #endif /* LINUX_NATIVE_AIO */
+}
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
+
+/** Compress a page for writing it to a data file, and release the
+storage of the rest of the page in the file.
+@param[in]	algorithm	compression algorithm
+@param[in]	file		handle to the file
+@param[in]	offset		file offset of the page
+@param[in]	page		uncompressed page
+@param[in]	block_size	file system block size
+@param[out]	len		number of bytes to write
+@return unaligned buffer whose UNIV_PAGE_SIZE aligned part holds the
+compressed page, to be freed by the caller, or NULL if the page is to
+be written uncompressed */
+static
+byte*
+os_file_compress_page(
+	os_comp_t	algorithm,
+	os_file_t	file,
+	os_offset_t	offset,
+	const byte*	page,
+	ulint		block_size,
+	ulint*		len)
+{
+	byte*	buf = static_cast<byte*>(ut_malloc_nokey(2 * UNIV_PAGE_SIZE));
+	byte*	out = static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE));
 
+	*len = os_comp_page_compress(algorithm, page, block_size, out);
+
+	if (*len == 0) {
+		ut_free(buf);
+		return(NULL);
+	}
+
+	/* The hole does not overlap the compressed page, so it can be
+	punched before the write completes. A crash in between leaves a
+	torn page, which is restored from the doublewrite buffer. */
+	os_file_punch_hole(file, offset + *len, UNIV_PAGE_SIZE - *len);
+
+	return(buf);
+}
+
+/** Decompress a page that was read from a data file, if it is
+compressed.
+@param[in]	name	name of the file
+@param[in,out]	page	page that was read */
+static
+void
+os_file_decompress_page(
+	const char*	name,
+	byte*		page)
+{
+	if (!os_comp_page_decompress(page, NULL)) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Cannot decompress page %lu of file %s",
+			(ulong) mach_read_from_4(page + FIL_PAGE_OFFSET),
+			name);
+	}
+}
 
 /*******************************************************************//**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
@@ -4476,7 +5401,10 @@ Requests an asynchronous i/o operation.
 bool
 os_aio_func(
 /*========*/
-	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE,
+				possibly ORed to OS_FILE_PAGE and
+				the compression algorithm of a page
+				write, see OS_FILE_COMPRESS_SHIFT */
 	ulint		mode,	/*!< in: OS_AIO_NORMAL, ..., possibly ORed
 				to OS_AIO_SIMULATED_WAKE_LATER: the
 				last flag advises this function not to wake
@@ -4511,6 +5439,7 @@ os_aio_func(
 {
 	os_aio_array_t*	array;
 	os_aio_slot_t*	slot;
+	byte*		comp_buf	= NULL;
 #ifdef WIN_ASYNC_IO
 	bool		retval;
 	BOOL		ret		= TRUE;
@@ -4534,6 +5463,31 @@ os_aio_func(
 	wake_later = mode & OS_AIO_SIMULATED_WAKE_LATER;
 	mode = mode & (~OS_AIO_SIMULATED_WAKE_LATER);
 
+	const os_comp_t	algorithm = static_cast<os_comp_t>(
+		type >> OS_FILE_COMPRESS_SHIFT);
+	byte*		page = (type & OS_FILE_PAGE)
+		? static_cast<byte*>(buf) : NULL;
+
+	type &= OS_FILE_TYPE_MASK;
+
+	ut_ad(algorithm < OS_COMP_MAX);
+	ut_ad(algorithm == OS_COMP_NONE
+	      || (page != NULL && type == OS_FILE_WRITE
+		  && n == UNIV_PAGE_SIZE && message1 != NULL));
+
+	if (algorithm != OS_COMP_NONE) {
+		ulint	len;
+
+		comp_buf = os_file_compress_page(
+			algorithm, file, offset, page,
+			fil_node_get_block_size(message1), &len);
+
+		if (comp_buf != NULL) {
+			buf = ut_align(comp_buf, UNIV_PAGE_SIZE);
+			n = len;
+		}
+	}
+
 	if (mode == OS_AIO_SYNC
 #ifdef WIN_ASYNC_IO
 	    && !srv_use_native_aio
@@ -4553,13 +5507,27 @@ os_aio_func(
 		and os_file_write_func() */
 
 		if (type == OS_FILE_READ) {
-			return(os_file_read_func(file, buf, offset, n));
+			if (!os_file_read_func(file, buf, offset, n)) {
+				return(false);
+			}
+
+			if (page != NULL) {
+				os_file_decompress_page(name, page);
+			}
+
+			return(true);
 		}
 
 		ut_ad(!read_only_mode);
 		ut_a(type == OS_FILE_WRITE);
 
-		return(os_file_write_func(name, file, buf, offset, n));
+		bool	ret = os_file_write_func(name, file, buf, offset, n);
+
+		if (comp_buf != NULL) {
+			ut_free(comp_buf);
+		}
+
+		return(ret);
 	}
 
 try_again:
@@ -4594,18 +5562,22 @@ try_again:
 		break;
 	case OS_AIO_SYNC:
 		array = os_aio_sync_array;
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 		/* In Linux native AIO we don't use sync IO array. */
 		ut_a(!srv_use_native_aio);
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 		break;
 	default:
 		ut_error;
 		array = NULL; /* Eliminate compiler warning */
 	}
 
-	slot = os_aio_array_reserve_slot(type, array, message1, message2, file,
-					 name, buf, offset, n);
+	slot = os_aio_array_reserve_slot(
+		type, array, message1, message2, file, name, buf, offset, n,
+		type == OS_FILE_READ ? page : NULL, comp_buf);
+
+	/* The slot owns the buffer of a compressed page now. */
+	comp_buf = NULL;
 	if (type == OS_FILE_READ) {
 		if (srv_use_native_aio) {
 			os_n_file_reads++;
@@ -4614,8 +5586,9 @@ try_again:
 			ret = ReadFile(file, buf, (DWORD) n, &len,
 				       &(slot->control));
 
-#elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!os_aio_linux_dispatch(array, slot,
+						   wake_later != 0)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4634,8 +5607,9 @@ try_again:
 			ret = WriteFile(file, buf, (DWORD) n, &len,
 					&(slot->control));
 
-#elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!os_aio_linux_dispatch(array, slot,
+						   wake_later != 0)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4679,9 +5653,14 @@ try_again:
 	/* aio was queued successfully! */
 	return(true);
 
-#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
+#if defined LINUX_NATIVE_AIO || defined LINUX_IO_URING \
+    || defined WIN_ASYNC_IO
 err_exit:
-#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING || WIN_ASYNC_IO */
+	/* Keep the buffer of a compressed page for a retry. */
+	comp_buf = slot->comp_buf;
+	slot->comp_buf = NULL;
+
 	os_aio_array_free_slot(array, slot);
 
 	if (os_file_handle_error(
@@ -4690,6 +5669,10 @@ err_exit:
 		goto try_again;
 	}
 
+	if (comp_buf != NULL) {
+		ut_free(comp_buf);
+	}
+
 	return(false);
 }
 
@@ -4863,6 +5846,10 @@ os_aio_windows_handle(
 		ret_val = ret && len == slot->len;
 	}
 
+	if (ret_val && slot->page != NULL) {
+		os_file_decompress_page(slot->name, slot->page);
+	}
+
 	os_aio_array_free_slot(array, slot);
 
 	return(ret_val);
@@ -4989,6 +5976,9 @@ retry:
 	ib_logf(IB_LOG_LEVEL_FATAL,
 		"Unexpected ret_code[%d] from io_getevents()!", ret);
 }
+#endif /* LINUX_NATIVE_AIO */
+
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 /**********************************************************************//**
 This function is only used in Linux native asynchronous i/o.
@@ -5066,7 +6056,15 @@ wait_for_event:
 
 		srv_set_io_thread_op_info(global_seg,
 			"waiting for completed aio requests");
+#ifdef LINUX_IO_URING
+		if (os_aio_use_uring()) {
+			os_aio_uring_collect(array, segment, n);
+			continue;
+		}
+#endif /* LINUX_IO_URING */
+#ifdef LINUX_NATIVE_AIO
 		os_aio_linux_collect(array, segment, n);
+#endif /* LINUX_NATIVE_AIO */
 	}
 
 found:
@@ -5095,14 +6093,25 @@ found:
 	} else if ((slot->ret == 0) && (slot->n_bytes > 0)
 		   &&  (slot->n_bytes < (long) slot->len)) {
 		/* Partial read or write scenario */
-		int submit_ret;
-		struct iocb*    iocb;
 		slot->buf = (byte*)slot->buf + slot->n_bytes;
 		slot->offset = slot->offset + slot->n_bytes;
 		slot->len = slot->len - slot->n_bytes;
 		/* Resetting the bytes read/written */
 		slot->n_bytes = 0;
 		slot->io_already_done = false;
+
+#ifdef LINUX_IO_URING
+		if (os_aio_use_uring()) {
+			/* Resubmit an I/O request */
+			os_aio_uring_dispatch(array, slot, true);
+			mutex_exit(&array->mutex);
+			goto wait_for_event;
+		}
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
+		int submit_ret;
+		struct iocb*    iocb;
 		iocb = &(slot->control);
 
 		if (slot->type == OS_FILE_READ) {
@@ -5127,6 +6136,7 @@ found:
 			mutex_exit(&array->mutex);
 			goto wait_for_event;
 		}
+#endif /* LINUX_NATIVE_AIO */
 	} else {
 		errno = -slot->ret;
 
@@ -5144,11 +6154,15 @@ found:
 
 	mutex_exit(&array->mutex);
 
+	if (ret && slot->page != NULL) {
+		os_file_decompress_page(slot->name, slot->page);
+	}
+
 	os_aio_array_free_slot(array, slot);
 
 	return(ret);
 }
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 
 /**********************************************************************//**
 Does simulated aio. This function should be called by an i/o-handler
@@ -5455,6 +6469,10 @@ slot_io_done:
 
 	mutex_exit(&array->mutex);
 
+	if (ret && aio_slot->page != NULL) {
+		os_file_decompress_page(aio_slot->name, aio_slot->page);
+	}
+
 	os_aio_array_free_slot(array, aio_slot);
 
 	return(ret);
@@ -0,0 +1,343 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file os/os0uring.cc
+A minimal interface to the Linux io_uring system calls
+*******************************************************/
+
+#include "os0uring.h"
+
+#ifdef LINUX_IO_URING
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** Load a ring index that is written by the kernel.
+@param[in]	p	index
+@return value of the index */
+static inline
+unsigned
+os_uring_load_acquire(
+	const unsigned*	p)
+{
+	return(__atomic_load_n(p, __ATOMIC_ACQUIRE));
+}
+
+/** Store a ring index that is read by the kernel.
+@param[out]	p	index
+@param[in]	v	value */
+static inline
+void
+os_uring_store_release(
+	unsigned*	p,
+	unsigned	v)
+{
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+/** io_uring_enter(2)
+@return number of submitted entries, or -errno */
+static
+int
+os_uring_enter(
+	int		fd,
+	unsigned	to_submit,
+	unsigned	min_complete,
+	unsigned	flags)
+{
+	long	ret = syscall(__NR_io_uring_enter, fd, to_submit,
+			      min_complete, flags, NULL, 0);
+
+	return(ret < 0 ? -errno : static_cast<int>(ret));
+}
+
+/** Create an io_uring instance.
+@param[out]	ring	ring to initialize
+@param[in]	entries	minimum number of submission queue entries
+@return 0 or -errno */
+int
+os_uring_create(
+	os_uring_t*	ring,
+	ulint		entries)
+{
+	struct io_uring_params	p;
+	void*			ptr;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&p, 0, sizeof(p));
+
+	ring->fd = static_cast<int>(
+		syscall(__NR_io_uring_setup,
+			static_cast<unsigned>(entries), &p));
+
+	if (ring->fd < 0) {
+		int	err = -errno;
+		ring->fd = -1;
+		return(err);
+	}
+
+	ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->cq_ring_size = p.cq_off.cqes
+		+ p.cq_entries * sizeof(struct io_uring_cqe);
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		/* The completion queue ring is in the same mapping. */
+		ring->sq_ring_size = ut_max(ring->sq_ring_size,
+					    ring->cq_ring_size);
+	}
+
+	ptr = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+
+	if (ptr == MAP_FAILED) {
+		goto err_exit;
+	}
+
+	ring->sq_ring = ptr;
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ring = NULL;
+	} else {
+		ptr = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+			   MAP_SHARED | MAP_POPULATE, ring->fd,
+			   IORING_OFF_CQ_RING);
+
+		if (ptr == MAP_FAILED) {
+			goto err_exit;
+		}
+
+		ring->cq_ring = ptr;
+	}
+
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+	if (ptr == MAP_FAILED) {
+		ring->sqes_size = 0;
+		goto err_exit;
+	}
+
+	ring->sqes = static_cast<struct io_uring_sqe*>(ptr);
+
+	{
+		byte*	sq = static_cast<byte*>(ring->sq_ring);
+		byte*	cq = ring->cq_ring != NULL
+			? static_cast<byte*>(ring->cq_ring) : sq;
+
+		ring->sq_entries = p.sq_entries;
+		ring->sq_khead = reinterpret_cast<unsigned*>(
+			sq + p.sq_off.head);
+		ring->sq_ktail = reinterpret_cast<unsigned*>(
+			sq + p.sq_off.tail);
+		ring->sq_mask = *reinterpret_cast<unsigned*>(
+			sq + p.sq_off.ring_mask);
+		ring->sq_array = reinterpret_cast<unsigned*>(
+			sq + p.sq_off.array);
+
+		ring->cq_khead = reinterpret_cast<unsigned*>(
+			cq + p.cq_off.head);
+		ring->cq_ktail = reinterpret_cast<unsigned*>(
+			cq + p.cq_off.tail);
+		ring->cq_mask = *reinterpret_cast<unsigned*>(
+			cq + p.cq_off.ring_mask);
+		ring->cqes = reinterpret_cast<struct io_uring_cqe*>(
+			cq + p.cq_off.cqes);
+	}
+
+	ring->sqe_head = ring->sqe_tail = *ring->sq_ktail;
+
+	return(0);
+
+err_exit:
+	int	err = -errno;
+
+	os_uring_free(ring);
+
+	return(err);
+}
+
+/** Free an io_uring instance. Pending requests are cancelled.
+@param[in,out]	ring	ring created by os_uring_create() */
+void
+os_uring_free(
+	os_uring_t*	ring)
+{
+	if (ring->sqes != NULL) {
+		munmap(ring->sqes, ring->sqes_size);
+	}
+
+	if (ring->cq_ring != NULL) {
+		munmap(ring->cq_ring, ring->cq_ring_size);
+	}
+
+	if (ring->sq_ring != NULL) {
+		munmap(ring->sq_ring, ring->sq_ring_size);
+	}
+
+	if (ring->fd >= 0) {
+		close(ring->fd);
+	}
+
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+/** Get a free submission queue entry. It is not visible to the kernel
+before os_uring_submit() is called.
+@param[in,out]	ring	ring
+@return zero-filled entry, or NULL if the submission queue is full */
+struct io_uring_sqe*
+os_uring_get_sqe(
+	os_uring_t*	ring)
+{
+	if (ring->sqe_tail - os_uring_load_acquire(ring->sq_khead)
+	    >= ring->sq_entries) {
+
+		return(NULL);
+	}
+
+	struct io_uring_sqe*	sqe
+		= &ring->sqes[ring->sqe_tail & ring->sq_mask];
+
+	++ring->sqe_tail;
+
+	memset(sqe, 0, sizeof(*sqe));
+
+	return(sqe);
+}
+
+/** Submit the entries that were handed out by os_uring_get_sqe().
+@param[in,out]	ring	ring
+@return number of submitted entries, or -errno */
+int
+os_uring_submit(
+	os_uring_t*	ring)
+{
+	unsigned	tail = *ring->sq_ktail;
+	unsigned	n = ring->sqe_tail - ring->sqe_head;
+
+	/* The submission queue entries are handed out in ring order,
+	so the indirection array is the identity. */
+	for (unsigned i = 0; i < n; ++i) {
+		ring->sq_array[tail & ring->sq_mask]
+			= ring->sqe_head & ring->sq_mask;
+		++tail;
+		++ring->sqe_head;
+	}
+
+	os_uring_store_release(ring->sq_ktail, tail);
+
+	/* The kernel may not consume all entries at once, or an earlier
+	call may have failed to submit some. */
+	int		n_submitted = 0;
+	unsigned	to_submit;
+
+	while ((to_submit = tail - os_uring_load_acquire(ring->sq_khead))
+	       > 0) {
+
+		int	ret = os_uring_enter(ring->fd, to_submit, 0, 0);
+
+		if (ret == -EINTR) {
+			continue;
+		} else if (ret < 0) {
+			return(ret);
+		} else if (ret == 0) {
+			return(-EAGAIN);
+		}
+
+		n_submitted += ret;
+	}
+
+	return(n_submitted);
+}
+
+/** Wait for a completion.
+@param[in,out]	ring	ring
+@param[in]	wait	whether to wait for a completion if there is
+none
+@return completion that must be released with os_uring_cqe_seen(), or
+NULL if wait == false and there is none, or if the wait was
+interrupted */
+struct io_uring_cqe*
+os_uring_wait_cqe(
+	os_uring_t*	ring,
+	bool		wait)
+{
+	unsigned	head = *ring->cq_khead;
+
+	if (head == os_uring_load_acquire(ring->cq_ktail)) {
+		if (!wait
+		    || os_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS)
+		    < 0
+		    || head == os_uring_load_acquire(ring->cq_ktail)) {
+
+			return(NULL);
+		}
+	}
+
+	return(&ring->cqes[head & ring->cq_mask]);
+}
+
+/** Release a completion returned by os_uring_wait_cqe().
+@param[in,out]	ring	ring */
+void
+os_uring_cqe_seen(
+	os_uring_t*	ring)
+{
+	os_uring_store_release(ring->cq_khead, *ring->cq_khead + 1);
+}
+
+/** Register buffers for IORING_OP_READ_FIXED and IORING_OP_WRITE_FIXED.
+@param[in,out]	ring	ring
+@param[in]	iov	buffers
+@param[in]	n	number of buffers
+@return 0 or -errno */
+int
+os_uring_register_buffers(
+	os_uring_t*		ring,
+	const struct iovec*	iov,
+	ulint			n)
+{
+	long	ret = syscall(__NR_io_uring_register, ring->fd,
+			      IORING_REGISTER_BUFFERS, iov,
+			      static_cast<unsigned>(n));
+
+	return(ret < 0 ? -errno : 0);
+}
+
+/** Unregister the buffers registered with os_uring_register_buffers().
+Requests that use them may still be in flight.
+@param[in,out]	ring	ring
+@return 0 or -errno */
+int
+os_uring_unregister_buffers(
+	os_uring_t*	ring)
+{
+	long	ret = syscall(__NR_io_uring_register, ring->fd,
+			      IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+	return(ret < 0 ? -errno : 0);
+}
+
+#endif /* LINUX_IO_URING */
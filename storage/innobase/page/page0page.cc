@@ -39,6 +39,7 @@ Created 2/2/1994 Heikki Tuuri
 # include "lock0lock.h"
 # include "fut0lst.h"
 # include "btr0sea.h"
+# include "trx0purge.h"
 #endif /* !UNIV_HOTBACKUP */
 
 /*			THE INDEX PAGE
@@ -233,6 +234,48 @@ page_set_max_trx_id(
 	}
 }
 
+#ifndef UNIV_HOTBACKUP
+/*************************************************************//**
+Records that a transaction modified a secondary index leaf page, so that
+consistent reads can tell whether they see all changes on the page even
+when PAGE_MAX_TRX_ID is not older than their read view. The record is
+kept in the buffer pool only; it restarts whenever all modifications of
+the page have become visible to the purge view. */
+
+void
+page_track_trx_id(
+/*==============*/
+	buf_block_t*	block,	/*!< in/out: X-latched page */
+	trx_id_t	trx_id)	/*!< in: id of the transaction that
+				modified the page */
+{
+	trx_id_t	max_trx_id = page_get_max_trx_id(
+		buf_block_get_frame(block));
+
+	ut_ad(trx_id > 0);
+
+	if (max_trx_id < trx_id) {
+
+		/* A new transaction is modifying the page. If every
+		read view sees the previous modifications, we only
+		need to remember this transaction. */
+
+		if (trx_purge_all_visible(max_trx_id)) {
+			block->mod_min_trx_id = trx_id;
+		} else if (page_get_min_trx_id(block) == 0) {
+			return;
+		}
+
+		block->mod_max_trx_id = trx_id;
+
+	} else if (page_get_min_trx_id(block) > trx_id) {
+
+		/* An older transaction is still modifying the page. */
+		block->mod_min_trx_id = trx_id;
+	}
+}
+#endif /* !UNIV_HOTBACKUP */
+
 /************************************************************//**
 Allocates a block of memory from the heap of an index page.
 @return pointer to start of allocated buffer, or NULL if allocation fails */
@@ -354,6 +397,10 @@ page_create_low(
 
 	buf_block_modify_clock_inc(block);
 
+#ifndef UNIV_HOTBACKUP
+	block->mod_max_trx_id = 0;
+#endif /* !UNIV_HOTBACKUP */
+
 	page = buf_block_get_frame(block);
 
 	if (is_rtree) {
@@ -523,7 +570,7 @@ page_create_empty(
 			    dict_index_is_spatial(index));
 
 		if (max_trx_id) {
-			page_update_max_trx_id(
+			page_inherit_max_trx_id(
 				block, page_zip, max_trx_id, mtr);
 		}
 	}
@@ -697,8 +744,8 @@ page_copy_rec_list_end(
 	if (dict_index_is_sec_or_ibuf(index)
 	    && page_is_leaf(page)
 	    && !dict_table_is_temporary(index->table)) {
-		page_update_max_trx_id(new_block, NULL,
-				       page_get_max_trx_id(page), mtr);
+		page_inherit_max_trx_id(new_block, NULL,
+					page_get_max_trx_id(page), mtr);
 	}
 
 	if (new_page_zip) {
@@ -856,9 +903,9 @@ page_copy_rec_list_start(
 	if (dict_index_is_sec_or_ibuf(index)
 	    && page_is_leaf(page_align(rec))
 	    && !dict_table_is_temporary(index->table)) {
-		page_update_max_trx_id(new_block, NULL,
-				       page_get_max_trx_id(page_align(rec)),
-				       mtr);
+		page_inherit_max_trx_id(new_block, NULL,
+					page_get_max_trx_id(page_align(rec)),
+					mtr);
 	}
 
 	if (new_page_zip) {
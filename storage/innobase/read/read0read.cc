@@ -163,12 +163,21 @@ For details see: row_vers_old_has_index_entry() and row_purge_poss_sec()
 Some additional issues:
 
 What if trx_sys->view_list == NULL and some transaction T1 and Purge both
-try to open read_view at same time. Only one can acquire trx_sys->mutex.
-In which order will the views be opened? Should it matter? If no, why?
-
-The order does not matter. No new transactions can be created and no running
-RW transaction can commit or rollback (or free views). AC-NL-RO transactions
-will mark their views as closed but not actually free their views.
+try to open read_view at same time. In which order will the views be opened?
+Should it matter? If no, why?
+
+Read views are not created under trx_sys->mutex. Every change to
+trx_sys->rw_trx_ids is published by MVCC::snapshot_publish() under
+trx_sys->mutex as a new, versioned snapshot and views copy the latest
+snapshot without latching (retrying if it was republished meanwhile). A
+snapshot with a higher version sees everything that an older one sees.
+T1 copies the snapshot first and only then registers its view in
+MVCC::m_views, under MVCC::m_mutex. Purge clones the oldest registered view,
+or copies the latest snapshot if there is none, under the same mutex and
+remembers the version that it used. If T1 registers after Purge and its
+snapshot is older than the one Purge used, T1 copies the snapshot again
+while holding MVCC::m_mutex. So either Purge sees the view of T1, or the
+view of T1 is at least as new as the purge view.
 */
 
 /** Minimum number of elements to reserve in ReadView::ids_t */
@@ -178,18 +187,22 @@ static const ulint MIN_TRX_IDS = 32;
 /** Functor to validate the view list. */
 struct	ViewCheck {
 
-	ViewCheck() : m_prev_view() { }
+	explicit ViewCheck(ulint version) : m_version(version) { }
 
 	void	operator()(const ReadView* view)
 	{
-		ut_a(m_prev_view == NULL
-		     || view->is_closed()
-		     || view->le(m_prev_view));
-
-		m_prev_view = view;
+		ut_a(view->is_closed()
+		     || (view->up_limit_id() <= view->low_limit_id()
+			 && view->low_limit_no() <= view->low_limit_id()));
+
+		/* Snapshot versions are always even, see
+		MVCC::snapshot_publish(). */
+		ut_a(!(view->version() & 1));
+		ut_a(view->version() <= m_version);
 	}
 
-	const ReadView*	m_prev_view;
+	/** Current snapshot version */
+	ulint	m_version;
 };
 
 /**
@@ -198,9 +211,9 @@ Validates a read view list. */
 bool
 MVCC::validate() const
 {
-	ViewCheck	check;
+	ViewCheck	check(m_version);
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&m_mutex));
 
 	ut_list_map(m_views, check);
 
@@ -330,7 +343,8 @@ ReadView::ReadView()
 	m_up_limit_id(),
 	m_creator_trx_id(),
 	m_ids(),
-	m_low_limit_no()
+	m_low_limit_no(),
+	m_version()
 {
 	ut_d(::memset(&m_view_list, 0x0, sizeof(m_view_list)));
 }
@@ -345,10 +359,20 @@ ReadView::~ReadView()
 /** Constructor
 @param size		Number of views to pre-allocate */
 MVCC::MVCC(ulint size)
+	:
+	m_purge_version(),
+	m_version(),
+	m_n_ids(),
+	m_low_limit_id(),
+	m_low_limit_no()
 {
+	mutex_create("mvcc", &m_mutex);
+
 	UT_LIST_INIT(m_free, &ReadView::m_view_list);
 	UT_LIST_INIT(m_views, &ReadView::m_view_list);
 
+	m_ids = ids_array_create(MIN_TRX_IDS, NULL);
+
 	for (ulint i = 0; i < size; ++i) {
 		ReadView*	view = UT_NEW_NOKEY(ReadView());
 
@@ -374,110 +398,202 @@ MVCC::~MVCC()
 	}
 
 	ut_a(UT_LIST_GET_LEN(m_views) == 0);
+
+	for (ids_array_t* ids = m_ids; ids != NULL; /* No op */) {
+
+		ids_array_t*	prev = ids->m_prev;
+
+		ut_free(ids);
+
+		ids = prev;
+	}
+
+	mutex_free(&m_mutex);
 }
 
-/**
-Copy the transaction ids from the source vector */
+/** Allocate an array of transaction ids.
+@param capacity		number of elements
+@param prev		the array being replaced, or NULL
+@return new array */
 
-void
-ReadView::copy_trx_ids(const trx_ids_t& trx_ids)
+MVCC::ids_array_t*
+MVCC::ids_array_create(ulint capacity, ids_array_t* prev)
 {
-	ulint	size = trx_ids.size();
+	ut_ad(capacity > 0);
 
-	if (m_creator_trx_id > 0) {
-		ut_ad(size > 0);
-		--size;
-	}
+	ids_array_t*	ids = static_cast<ids_array_t*>(ut_malloc_nokey(
+		sizeof(*ids) + (capacity - 1) * sizeof(trx_id_t)));
 
-	if (size == 0) {
-		m_ids.clear();
-		return;
+	if (ids == NULL) {
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Out of memory: read0read.cc:%d", __LINE__);
 	}
 
-	m_ids.reserve(size);
-	m_ids.resize(size);
+	ids->m_capacity = capacity;
+	ids->m_prev = prev;
 
-	ids_t::value_type*	p = m_ids.data();
+	return(ids);
+}
+
+/**
+Copy the transaction ids from the published snapshot
+@param ids		transaction ids, in ascending order
+@param n		number of elements in ids */
 
-	/* Copy all the trx_ids except the creator trx id */
+void
+ReadView::copy_trx_ids(const trx_id_t* ids, ulint n)
+{
+	if (n == 0) {
+		m_ids.clear();
+	} else {
+		m_ids.assign(ids, ids + n);
+	}
+}
 
-	if (m_creator_trx_id > 0) {
+/**
+Opens a read view where exactly the transactions serialized before this
+point in time are seen in the view. The snapshot must have been copied
+by MVCC::snapshot_copy().
+@param id		Creator transaction id */
 
-		/* Note: We go through all this trouble because it is
-		unclear whether std::vector::resize() will cause an
-		overhead or not. We should test this extensively and
-		if the vector to vector copy is fast enough then get
-		rid of this code and replace it with more readable
-		and obvious code. The code below does exactly one copy,
-		and filters out the creator's trx id. */
+void
+ReadView::prepare(trx_id_t id)
+{
+	m_creator_trx_id = id;
 
-		trx_ids_t::const_iterator	it = std::lower_bound(
-			trx_ids.begin(), trx_ids.end(), m_creator_trx_id);
+	if (id == 0) {
+		return;
+	}
 
-		ut_ad(it != trx_ids.end() && *it == m_creator_trx_id);
+	/* The creator sees its own changes through m_creator_trx_id,
+	remove its id from the copy of trx_sys_t::rw_trx_ids. */
 
-		ulint	i = std::distance(trx_ids.begin(), it);
-		ulint	n = i * sizeof(trx_ids_t::value_type);
+	ids_t::value_type*	p = m_ids.data();
+	ids_t::value_type*	end = p + m_ids.size();
+	ids_t::value_type*	it = std::lower_bound(p, end, id);
 
-		::memmove(p, &trx_ids[0], n);
+	ut_ad(it != end && *it == id);
 
-		n = (trx_ids.size() - i - 1) * sizeof(trx_ids_t::value_type);
+	if (it != end && *it == id) {
 
-		ut_ad(i + (n / sizeof(trx_ids_t::value_type)) == m_ids.size());
+		ulint	n = (end - it - 1) * sizeof(ids_t::value_type);
 
 		if (n > 0) {
-			::memmove(p + i, &trx_ids[i + 1], n);
+			::memmove(it, it + 1, n);
 		}
-	} else {
-		ulint	n = size * sizeof(trx_ids_t::value_type);
 
-		::memmove(p, &trx_ids[0], n);
+		m_ids.resize(m_ids.size() - 1);
 	}
 }
 
 /**
-Opens a read view where exactly the transactions serialized before this
-point in time are seen in the view.
-@param id		Creator transaction id */
+Complete the read view creation */
 
 void
-ReadView::prepare(trx_id_t id)
+ReadView::complete()
 {
-	ut_ad(mutex_own(&trx_sys->mutex));
+	/* The first active transaction has the smallest id. */
+	m_up_limit_id = !m_ids.empty() ? m_ids.front() : m_low_limit_id;
 
-	m_creator_trx_id = id;
+	ut_ad(m_up_limit_id <= m_low_limit_id);
 
-	m_low_limit_no = m_low_limit_id = trx_sys->max_trx_id;
+	m_closed = false;
+}
 
-	if (!trx_sys->rw_trx_ids.empty()) {
-		copy_trx_ids(trx_sys->rw_trx_ids);
-	} else {
-		m_ids.clear();
+/**
+Publish the state that read views are created from: the active read-write
+transaction ids, the transaction id high water mark and the smallest
+serialisation number. Caller must own the trx_sys_t::mutex. */
+
+void
+MVCC::snapshot_publish()
+{
+	ut_ad(trx_sys_mutex_own());
+
+	const trx_ids_t&	trx_ids = trx_sys->rw_trx_ids;
+	ulint			n_ids = trx_ids.size();
+	ids_array_t*		ids = m_ids;
+
+	if (n_ids > ids->m_capacity) {
+		ids = ids_array_create(n_ids * 2, ids);
 	}
 
+	trx_id_t	low_limit_no = trx_sys->max_trx_id;
+
 	if (UT_LIST_GET_LEN(trx_sys->serialisation_list) > 0) {
 		const trx_t*	trx;
 
 		trx = UT_LIST_GET_FIRST(trx_sys->serialisation_list);
 
-		if (trx->no < m_low_limit_no) {
-			m_low_limit_no = trx->no;
+		if (trx->no < low_limit_no) {
+			low_limit_no = trx->no;
 		}
 	}
+
+	/* Readers that overlap with the update will see an odd or
+	a changed version and copy the snapshot again. */
+
+	m_version = m_version + 1;
+
+	os_wmb;
+
+	if (n_ids > 0) {
+		::memcpy(ids->m_ids, &trx_ids[0], n_ids * sizeof(trx_id_t));
+	}
+
+	m_ids = ids;
+
+	m_n_ids = n_ids;
+
+	m_low_limit_id = trx_sys->max_trx_id;
+
+	m_low_limit_no = low_limit_no;
+
+	os_wmb;
+
+	m_version = m_version + 1;
 }
 
 /**
-Complete the read view creation */
+Copy the last published snapshot to the view. Retries if the snapshot
+is republished while it is being copied.
+@param view		view to copy the snapshot to */
 
 void
-ReadView::complete()
+MVCC::snapshot_copy(ReadView* view) const
 {
-	/* The first active transaction has the smallest id. */
-	m_up_limit_id = !m_ids.empty() ? m_ids.front() : m_low_limit_id;
+	for (;;) {
+		ulint	version = m_version;
 
-	ut_ad(m_up_limit_id <= m_low_limit_id);
+		if (version & 1) {
+			/* snapshot_publish() is in progress. */
+			UT_RELAX_CPU();
+			continue;
+		}
 
-	m_closed = false;
+		os_rmb;
+
+		const ids_array_t*	ids = m_ids;
+
+		/* The count can belong to a newer array than the one
+		that we read, never read beyond the end of the array. */
+		ulint	n_ids = std::min(ulint(m_n_ids), ids->m_capacity);
+
+		view->copy_trx_ids(ids->m_ids, n_ids);
+
+		view->m_low_limit_id = m_low_limit_id;
+
+		view->m_low_limit_no = m_low_limit_no;
+
+		os_rmb;
+
+		if (version == m_version) {
+
+			view->m_version = version;
+
+			return;
+		}
+	}
 }
 
 /**
@@ -488,7 +604,7 @@ a new view.
 ReadView*
 MVCC::get_view()
 {
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&m_mutex));
 
 	ReadView*	view;
 
@@ -508,14 +624,12 @@ MVCC::get_view()
 }
 
 /**
-Release a view that is inactive but not closed. Caller must own
-the trx_sys_t::mutex.
+Release a view that is inactive but not closed.
 @param view		View to release */
 void
 MVCC::view_release(ReadView*& view)
 {
 	ut_ad(!srv_read_only_mode);
-	ut_ad(trx_sys_mutex_own());
 
 	uintptr_t	p = reinterpret_cast<uintptr_t>(view);
 
@@ -530,10 +644,14 @@ MVCC::view_release(ReadView*& view)
 
 	ut_ad(view->m_creator_trx_id == 0);
 
+	mutex_enter(&m_mutex);
+
 	UT_LIST_REMOVE(m_views, view);
 
 	UT_LIST_ADD_LAST(m_free, view);
 
+	mutex_exit(&m_mutex);
+
 	view = NULL;
 }
 
@@ -576,20 +694,43 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 			}
 		}
 
-		mutex_enter(&trx_sys->mutex);
+		/* Purge may still be copying the view if it was closed
+		without acquiring the mutex. It cannot be modified before
+		it has been removed from the list. */
+
+		mutex_enter(&m_mutex);
 
 		UT_LIST_REMOVE(m_views, view);
 
+		mutex_exit(&m_mutex);
+
 	} else {
-		mutex_enter(&trx_sys->mutex);
+		mutex_enter(&m_mutex);
 
 		view = get_view();
+
+		mutex_exit(&m_mutex);
 	}
 
 	if (view != NULL) {
 
+		snapshot_copy(view);
+
 		view->prepare(trx->id);
 
+		mutex_enter(&m_mutex);
+
+		if (view->m_version < m_purge_version) {
+
+			/* Purge used a newer snapshot while we were
+			copying ours, it may have removed versions that
+			our snapshot would need. */
+
+			snapshot_copy(view);
+
+			view->prepare(trx->id);
+		}
+
 		view->complete();
 
 		UT_LIST_ADD_FIRST(m_views, view);
@@ -597,32 +738,38 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 		ut_ad(!view->is_closed());
 
 		ut_ad(validate());
-	}
 
-	trx_sys_mutex_exit();
+		mutex_exit(&m_mutex);
+	}
 }
 
 /**
-Get the oldest (active) view in the system. 
+Get the oldest (active) view in the system.
 @return oldest view if found or NULL */
 
 ReadView*
 MVCC::get_oldest_view() const
 {
-	ReadView*	view;
+	ReadView*	oldest_view = NULL;
+
+	ut_ad(mutex_own(&m_mutex));
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	/* The views are not ordered on the snapshot version because
+	the snapshot is copied before the view is registered. */
 
-	for (view = UT_LIST_GET_LAST(m_views);
+	for (ReadView* view = UT_LIST_GET_FIRST(m_views);
 	     view != NULL;
-	     view = UT_LIST_GET_PREV(m_view_list, view)) {
+	     view = UT_LIST_GET_NEXT(m_view_list, view)) {
 
-		if (!view->is_closed()) {
-			break;
+		if (!view->is_closed()
+		    && (oldest_view == NULL
+			|| view->m_version < oldest_view->m_version)) {
+
+			oldest_view = view;
 		}
 	}
 
-	return(view);
+	return(oldest_view);
 }
 
 /**
@@ -649,6 +796,8 @@ ReadView::copy_prepare(const ReadView& other)
 	m_low_limit_id = other.m_low_limit_id;
 
 	m_creator_trx_id = other.m_creator_trx_id;
+
+	m_version = other.m_version;
 }
 
 /**
@@ -684,23 +833,32 @@ purge the delete marked record or not.
 void
 MVCC::clone_oldest_view(ReadView* view)
 {
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&m_mutex);
 
 	ReadView*	oldest_view = get_oldest_view();
 
 	if (oldest_view == NULL) {
 
-		view->prepare(0);
-
-		trx_sys_mutex_exit();
+		snapshot_copy(view);
 
-		view->complete();
+		view->prepare(0);
 
 	} else {
 		view->copy_prepare(*oldest_view);
+	}
+
+	/* Views that are registered from now on must not be older
+	than the purge view, see view_open(). */
+
+	if (view->m_version > m_purge_version) {
+		m_purge_version = view->m_version;
+	}
 
-		trx_sys_mutex_exit();
+	mutex_exit(&m_mutex);
 
+	if (oldest_view == NULL) {
+		view->complete();
+	} else {
 		view->copy_complete();
 	}
 }
@@ -709,9 +867,9 @@ MVCC::clone_oldest_view(ReadView* view)
 @return the number of active views */
 
 ulint
-MVCC::size() const
+MVCC::size()
 {
-	trx_sys_mutex_enter();
+	mutex_enter(&m_mutex);
 
 	ulint	size = 0;
 
@@ -724,7 +882,7 @@ MVCC::size() const
 		}
 	}
 
-	trx_sys_mutex_exit();
+	mutex_exit(&m_mutex);
 
 	return(size);
 }
@@ -732,16 +890,17 @@ MVCC::size() const
 /**
 Close a view created by the above function.
 @para view		view allocated by trx_open.
-@param own_mutex	true if caller owns trx_sys_t::mutex */
+@param free_view	true if the view should be returned to the free
+			list, false if it should only be marked as closed */
 
 void
-MVCC::view_close(ReadView*& view, bool own_mutex)
+MVCC::view_close(ReadView*& view, bool free_view)
 {
 	uintptr_t	p = reinterpret_cast<uintptr_t>(view);
 
 	/* Note: The assumption here is that AC-NL-RO transactions will
-	call this function with own_mutex == false. */
-	if (!own_mutex) {
+	call this function with free_view == false. */
+	if (!free_view) {
 		/* Sanitise the pointer first. */
 		ReadView*	ptr = reinterpret_cast<ReadView*>(p & ~1);
 
@@ -754,6 +913,8 @@ MVCC::view_close(ReadView*& view, bool own_mutex)
 	} else {
 		view = reinterpret_cast<ReadView*>(p & ~1);
 
+		mutex_enter(&m_mutex);
+
 		view->close();
 
 		UT_LIST_REMOVE(m_views, view);
@@ -761,6 +922,8 @@ MVCC::view_close(ReadView*& view, bool own_mutex)
 
 		ut_ad(validate());
 
+		mutex_exit(&m_mutex);
+
 		view = NULL;
 	}
 }
@@ -775,7 +938,10 @@ void
 MVCC::set_view_creator_trx_id(ReadView* view, trx_id_t id)
 {
 	ut_ad(id > 0);
-	ut_ad(mutex_own(&trx_sys->mutex));
+
+	mutex_enter(&m_mutex);
 
 	view->creator_trx_id(id);
+
+	mutex_exit(&m_mutex);
 }
@@ -789,22 +789,22 @@ cmp_rec_rec_simple_field(
 }
 
 /** Compare two physical records that contain the same number of columns,
-none of which are stored externally.
+none of which are stored externally, without reporting duplicates.
 @retval positive if rec1 (including non-ordering columns) is greater than rec2
 @retval negative if rec1 (including non-ordering columns) is less than rec2
 @retval 0 if rec1 is a duplicate of rec2 */
 
 int
-cmp_rec_rec_simple(
-/*===============*/
+cmp_rec_rec_simple_low(
+/*===================*/
 	const rec_t*		rec1,	/*!< in: physical record */
 	const rec_t*		rec2,	/*!< in: physical record */
 	const ulint*		offsets1,/*!< in: rec_get_offsets(rec1, ...) */
 	const ulint*		offsets2,/*!< in: rec_get_offsets(rec2, ...) */
 	const dict_index_t*	index,	/*!< in: data dictionary index */
-	struct TABLE*		table)	/*!< in: MySQL table, for reporting
-					duplicate key value if applicable,
-					or NULL */
+	bool			check_dup)/*!< in: whether equal ordering
+					columns of a unique index are a
+					duplicate */
 {
 	ulint		n;
 	ulint		n_uniq	= dict_index_get_n_unique(index);
@@ -838,9 +838,7 @@ cmp_rec_rec_simple(
 	/* If we ran out of fields, the ordering columns of rec1 were
 	equal to rec2. Issue a duplicate key error if needed. */
 
-	if (!null_eq && table && dict_index_is_unique(index)) {
-		/* Report erroneous row using new version of table. */
-		innobase_rec_to_mysql(table, rec1, index, offsets1);
+	if (!null_eq && check_dup && dict_index_is_unique(index)) {
 		return(0);
 	}
 
@@ -866,6 +864,35 @@ cmp_rec_rec_simple(
 	return(0);
 }
 
+/** Compare two physical records that contain the same number of columns,
+none of which are stored externally.
+@retval positive if rec1 (including non-ordering columns) is greater than rec2
+@retval negative if rec1 (including non-ordering columns) is less than rec2
+@retval 0 if rec1 is a duplicate of rec2 */
+
+int
+cmp_rec_rec_simple(
+/*===============*/
+	const rec_t*		rec1,	/*!< in: physical record */
+	const rec_t*		rec2,	/*!< in: physical record */
+	const ulint*		offsets1,/*!< in: rec_get_offsets(rec1, ...) */
+	const ulint*		offsets2,/*!< in: rec_get_offsets(rec2, ...) */
+	const dict_index_t*	index,	/*!< in: data dictionary index */
+	struct TABLE*		table)	/*!< in: MySQL table, for reporting
+					duplicate key value if applicable,
+					or NULL */
+{
+	int	cmp = cmp_rec_rec_simple_low(
+		rec1, rec2, offsets1, offsets2, index, table != NULL);
+
+	if (!cmp && table && dict_index_is_unique(index)) {
+		/* Report erroneous row using new version of table. */
+		innobase_rec_to_mysql(table, rec1, index, offsets1);
+	}
+
+	return(cmp);
+}
+
 /** Compare two B-tree records.
 @param[in] rec1 B-tree record
 @param[in] rec2 B-tree record
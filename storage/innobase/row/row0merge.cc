@@ -31,8 +31,11 @@ Completed by Sunny Bains and Marko Makela
 #include "row0log.h"
 #include "row0ins.h"
 #include "row0sel.h"
+#include "row0upd.h"
+#include "dict0boot.h"
 #include "dict0crea.h"
 #include "trx0purge.h"
+#include "trx0rec.h"
 #include "lock0lock.h"
 #include "pars0pars.h"
 #include "ut0sort.h"
@@ -219,7 +222,7 @@ public:
 				}
 
 				if (error == DB_SUCCESS) {
-					page_update_max_trx_id(
+					page_inherit_max_trx_id(
 						btr_cur_get_block(&ins_cur),
 						btr_cur_get_page_zip(&ins_cur),
 						trx->id, &mtr);
@@ -260,11 +263,15 @@ private:
 @param[in]	trx_id		transaction identifier
 @param[in]	index		index to be inserted
 @param[in]	old_table	old table
-@param[in]	fd		file descriptor
-@param[in,out]	block		file buffer
+@param[in]	files		sorted files, merged while inserting
+@param[in]	n_files		number of files
+@param[in,out]	block		file buffer, 3 * srv_sort_buf_size
+for each file
 @param[in]	row_buf		row_buf the sorted data tuples,
-or NULL if fd, block will be used instead
+or NULL if files, block will be used instead
 @param[in,out]	btr_bulk	btr bulk instance
+@param[in,out]	table	MySQL table, for reporting duplicates
+between the files, or NULL
 @return DB_SUCCESS or error number */
 static	__attribute__((warn_unused_result))
 dberr_t
@@ -272,10 +279,12 @@ row_merge_insert_index_tuples(
 	trx_id_t		trx_id,
 	dict_index_t*		index,
 	const dict_table_t*	old_table,
-	int			fd,
+	const merge_file_t*	files,
+	ulint			n_files,
 	row_merge_block_t*	block,
 	const row_merge_buf_t*	row_buf,
-	BtrBulk*		btr_bulk);
+	BtrBulk*		btr_bulk,
+	struct TABLE*		table);
 
 /******************************************************//**
 Encode an index record. */
@@ -726,6 +735,39 @@ row_merge_dup_report(
 	}
 }
 
+/** Report a duplicate merge record, or copy it to dup->heap for
+reporting it later from the thread that owns dup->table.
+@param[in,out]	dup	for reporting duplicates
+@param[in]	mrec	duplicate merge record
+@param[in]	offsets	offsets of mrec */
+static
+void
+row_merge_dup_report_rec(
+	row_merge_dup_t*	dup,
+	const mrec_t*		mrec,
+	const ulint*		offsets)
+{
+	if (dup->n_dup++) {
+		return;
+	}
+
+	if (dup->heap == NULL) {
+		innobase_rec_to_mysql(dup->table, mrec, dup->index, offsets);
+		return;
+	}
+
+	ulint		n_ext;
+	dtuple_t*	entry = row_rec_to_index_entry_low(
+		mrec, dup->index, offsets, &n_ext, dup->heap);
+
+	/* The fields point to the merge block; copy them. */
+	for (ulint i = 0; i < dtuple_get_n_fields(entry); i++) {
+		dfield_dup(dtuple_get_nth_field(entry, i), dup->heap);
+	}
+
+	dup->entry = entry;
+}
+
 /*************************************************************//**
 Compare two tuples.
 @return positive, 0, negative if a is greater, equal, less, than b,
@@ -1330,14 +1372,13 @@ row_merge_tmpfile_if_needed(
 
 /** Create a temporary file for merge sort if it was not created already.
 @param[in,out]	file	merge file structure
-@param[in]	nrec	number of records in the file
+@param[in,out]	tmpfd	temporary file handle
 @return file descriptor, or -1 on failure */
 static __attribute__((warn_unused_result))
 int
 row_merge_file_create_if_needed(
 	merge_file_t*	file,
-	int*		tmpfd,
-	ulint		nrec)
+	int*		tmpfd)
 {
 	ut_ad(file->fd < 0 || *tmpfd >=0);
 	if (file->fd < 0 && row_merge_file_create(file) >= 0) {
@@ -1345,8 +1386,6 @@ row_merge_file_create_if_needed(
 		if (row_merge_tmpfile_if_needed(tmpfd) < 0) {
 			return(-1);
 		}
-
-		file->n_rec = nrec;
 	}
 
 	ut_ad(file->fd < 0 || *tmpfd >=0);
@@ -1400,7 +1439,7 @@ row_mtuple_cmp(
 Reads clustered index of the table and create temporary files
 containing the index entries for the indexes to be built.
 @return DB_SUCCESS or error */
-static __attribute__((nonnull(1,2,3,4,6,9,10,16), warn_unused_result))
+static __attribute__((nonnull(1,2,3,4,6,9,11,17), warn_unused_result))
 dberr_t
 row_merge_read_clustered_index(
 /*===========================*/
@@ -1421,7 +1460,11 @@ row_merge_read_clustered_index(
 	fts_psort_t*		psort_info,
 					/*!< in: parallel sort info for
 					fts_sort_idx creation, or NULL */
-	merge_file_t*		files,	/*!< in: temporary files */
+	merge_file_t*		files,	/*!< in: temporary files, n_files
+					for each index */
+	ulint			n_files,/*!< in: number of temporary files
+					that the sorted runs of an index
+					are distributed over */
 	const ulint*		key_numbers,
 					/*!< in: MySQL key numbers to create */
 	ulint			n_index,/*!< in: number of indexes to create */
@@ -1484,7 +1527,8 @@ row_merge_read_clustered_index(
 	merge_buf = static_cast<row_merge_buf_t**>(
 		ut_malloc_nokey(n_index * sizeof *merge_buf));
 
-	row_merge_dup_t	clust_dup = {index[0], table, col_map, 0};
+	row_merge_dup_t	clust_dup = {
+		index[0], table, col_map, 0, NULL, NULL};
 	dfield_t*	prev_fields;
 	const ulint	n_uniq = dict_index_get_n_unique(index[0]);
 
@@ -1905,7 +1949,7 @@ write_buffers:
 
 		for (ulint i = 0; i < n_index; i++, skip_sort = false) {
 			row_merge_buf_t*	buf	= merge_buf[i];
-			merge_file_t*		file	= &files[i];
+			merge_file_t*		file	= &files[i * n_files];
 			ulint			rows_added = 0;
 
 			if (dict_index_is_spatial(buf->index)) {
@@ -1932,7 +1976,6 @@ write_buffers:
 				/* If we are creating FTS index,
 				a single row can generate more
 				records for tokenized word */
-				file->n_rec += rows_added;
 				if (doc_id > max_doc_id) {
 					max_doc_id = doc_id;
 				}
@@ -2045,7 +2088,8 @@ write_buffers:
 
 					err = row_merge_insert_index_tuples(
 						trx->id, index[i], old_table,
-						-1, NULL, buf, clust_btr_bulk);
+						NULL, 0, NULL, buf,
+						clust_btr_bulk, NULL);
 
 					if (row == NULL) {
 						err = clust_btr_bulk->finish(
@@ -2081,7 +2125,8 @@ write_buffers:
 					}
 				} else if (dict_index_is_unique(buf->index)) {
 					row_merge_dup_t	dup = {
-						buf->index, table, col_map, 0};
+						buf->index, table, col_map, 0,
+						NULL, NULL};
 
 					row_merge_buf_sort(buf, &dup);
 
@@ -2146,13 +2191,26 @@ write_buffers:
 
 					err = row_merge_insert_index_tuples(
 						trx->id, index[i], old_table,
-						-1, NULL, buf, &btr_bulk);
+						NULL, 0, NULL, buf, &btr_bulk,
+						NULL);
 
 					err = btr_bulk.finish(err);
 				} else {
+					/* Distribute the sorted runs
+					round-robin over the files of the
+					index, so that the files can be
+					merge sorted in parallel. */
+					merge_file_t*	run_file = file;
+
+					for (ulint k = 1; k < n_files; k++) {
+						if (file[k].offset
+						    < run_file->offset) {
+							run_file = &file[k];
+						}
+					}
+
 					if (row_merge_file_create_if_needed(
-						file, tmpfd,
-						buf->n_tuples) < 0) {
+						run_file, tmpfd) < 0) {
 						err = DB_OUT_OF_MEMORY;
 						trx->error_key_num = i;
 						goto func_exit;
@@ -2165,12 +2223,16 @@ write_buffers:
 						clust_temp_file = true;
 					}
 
-					ut_ad(file->n_rec > 0);
+					run_file->n_rec += buf->n_tuples;
+
+					ut_ad(run_file->n_rec > 0);
 
-					row_merge_buf_write(buf, file, block);
+					row_merge_buf_write(
+						buf, run_file, block);
 
 					if (!row_merge_write(
-						    file->fd, file->offset++,
+						    run_file->fd,
+						    run_file->offset++,
 						    block)) {
 						err = DB_TEMP_FILE_WRITE_FAIL;
 						trx->error_key_num = i;
@@ -2197,8 +2259,6 @@ write_buffers:
 					room for at least one record. */
 					ut_error;
 				}
-
-				file->n_rec += rows_added;
 			}
 		}
 
@@ -2371,7 +2431,7 @@ static __attribute__((nonnull, warn_unused_result))
 dberr_t
 row_merge_blocks(
 /*=============*/
-	const row_merge_dup_t*	dup,	/*!< in: descriptor of
+	row_merge_dup_t*	dup,	/*!< in/out: descriptor of
 					index being created */
 	const merge_file_t*	file,	/*!< in: file containing
 					index entries */
@@ -2431,14 +2491,15 @@ corrupt:
 	}
 
 	while (mrec0 && mrec1) {
-		int cmp = cmp_rec_rec_simple(
+		int cmp = cmp_rec_rec_simple_low(
 			mrec0, mrec1, offsets0, offsets1,
-			dup->index, dup->table);
+			dup->index, dup->table != NULL);
 		if (cmp < 0) {
 			ROW_MERGE_WRITE_GET_NEXT(0, dup->index, goto merged);
 		} else if (cmp) {
 			ROW_MERGE_WRITE_GET_NEXT(1, dup->index, goto merged);
 		} else {
+			row_merge_dup_report_rec(dup, mrec0, offsets0);
 			mem_heap_free(heap);
 			DBUG_RETURN(DB_DUPLICATE_KEY);
 		}
@@ -2543,7 +2604,7 @@ dberr_t
 row_merge(
 /*======*/
 	trx_t*			trx,	/*!< in: transaction */
-	const row_merge_dup_t*	dup,	/*!< in: descriptor of
+	row_merge_dup_t*	dup,	/*!< in/out: descriptor of
 					index being created */
 	merge_file_t*		file,	/*!< in/out: file containing
 					index entries */
@@ -2673,7 +2734,7 @@ dberr_t
 row_merge_sort(
 /*===========*/
 	trx_t*			trx,	/*!< in: transaction */
-	const row_merge_dup_t*	dup,	/*!< in: descriptor of
+	row_merge_dup_t*	dup,	/*!< in/out: descriptor of
 					index being created */
 	merge_file_t*		file,	/*!< in/out: file containing
 					index entries */
@@ -2722,6 +2783,123 @@ row_merge_sort(
 	DBUG_RETURN(error);
 }
 
+/** Merge sort of one of the files of an index, by a parallel thread */
+struct row_merge_psort_t {
+	trx_t*			trx;	/*!< transaction */
+	row_merge_dup_t		dup;	/*!< descriptor of the index
+					being created, private to the
+					thread */
+	merge_file_t*		file;	/*!< file to sort */
+	row_merge_block_t*	block;	/*!< 3 buffers */
+	int			tmpfd;	/*!< temporary file handle */
+	dberr_t			error;	/*!< result of row_merge_sort() */
+	os_event_t		event;	/*!< set when the thread is done */
+};
+
+/*********************************************************************//**
+Function performs the merge sort of one file of an index.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+row_merge_sort_thread(
+/*==================*/
+	void*		arg)		/*!< in/out: row_merge_psort_t */
+{
+	row_merge_psort_t*	psort = static_cast<row_merge_psort_t*>(arg);
+
+	psort->error = row_merge_sort(
+		psort->trx, &psort->dup, psort->file, psort->block,
+		&psort->tmpfd);
+
+	os_event_set(psort->event);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Merge sort the files of an index in parallel. The first file is sorted
+by the calling thread, each other file by a thread of its own. The
+threads only copy the first duplicate they find; it is reported to
+dup->table by the calling thread once they are done.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_sort_parallel(
+/*====================*/
+	trx_t*			trx,	/*!< in: transaction */
+	row_merge_dup_t*	dup,	/*!< in/out: descriptor of
+					index being created */
+	merge_file_t*		files,	/*!< in/out: files containing
+					index entries */
+	ulint			n_files,/*!< in: number of files */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers for
+					each file */
+	int*			tmpfd)	/*!< in/out: temporary file handle
+					for the first file */
+{
+	dberr_t			error = DB_SUCCESS;
+	ulint			n_started = 1;
+	row_merge_psort_t*	psort;
+
+	psort = static_cast<row_merge_psort_t*>(
+		ut_zalloc_nokey(n_files * sizeof *psort));
+
+	for (ulint k = 1; k < n_files; k++, n_started++) {
+		psort[k].trx = trx;
+		psort[k].dup = *dup;
+		psort[k].dup.n_dup = 0;
+		psort[k].dup.entry = NULL;
+		psort[k].file = &files[k];
+		psort[k].block = &block[k * 3 * srv_sort_buf_size];
+		psort[k].tmpfd = -1;
+		psort[k].error = DB_SUCCESS;
+
+		if (row_merge_tmpfile_if_needed(&psort[k].tmpfd) < 0) {
+			error = DB_OUT_OF_MEMORY;
+			break;
+		}
+
+		psort[k].dup.heap = mem_heap_create(1024);
+
+		psort[k].event = os_event_create(0);
+
+		os_thread_create(row_merge_sort_thread, &psort[k], NULL);
+	}
+
+	if (error == DB_SUCCESS) {
+		error = row_merge_sort(trx, dup, &files[0], block, tmpfd);
+	}
+
+	for (ulint k = 1; k < n_started; k++) {
+		os_event_wait(psort[k].event);
+
+		if (error == DB_SUCCESS) {
+			error = psort[k].error;
+		}
+
+		/* Report the first duplicate, unless an earlier file
+		already did. */
+		if (psort[k].dup.entry != NULL && !dup->n_dup) {
+			innobase_fields_to_mysql(
+				dup->table, dup->index,
+				psort[k].dup.entry->fields);
+		}
+
+		dup->n_dup += psort[k].dup.n_dup;
+
+		mem_heap_free(psort[k].dup.heap);
+		os_event_destroy(psort[k].event);
+
+		row_merge_file_destroy_low(psort[k].tmpfd);
+	}
+
+	ut_free(psort);
+
+	return(error);
+}
+
 /** Copy externally stored columns to the data tuple.
 @param[in]	mrec		record containing BLOB pointers,
 or NULL to use tuple instead
@@ -2811,11 +2989,15 @@ row_merge_mtuple_to_dtuple(
 @param[in]	trx_id		transaction identifier
 @param[in]	index		index to be inserted
 @param[in]	old_table	old table
-@param[in]	fd		file descriptor
-@param[in,out]	block		file buffer
+@param[in]	files		sorted files, merged while inserting
+@param[in]	n_files		number of files
+@param[in,out]	block		file buffer, 3 * srv_sort_buf_size
+for each file
 @param[in]	row_buf		row_buf the sorted data tuples,
-or NULL if fd, block will be used instead
+or NULL if files, block will be used instead
 @param[in,out]	btr_bulk	btr bulk instance
+@param[in,out]	table	MySQL table, for reporting duplicates
+between the files, or NULL
 @return DB_SUCCESS or error number */
 static	__attribute__((warn_unused_result))
 dberr_t
@@ -2823,18 +3005,21 @@ row_merge_insert_index_tuples(
 	trx_id_t		trx_id,
 	dict_index_t*		index,
 	const dict_table_t*	old_table,
-	int			fd,
+	const merge_file_t*	files,
+	ulint			n_files,
 	row_merge_block_t*	block,
 	const row_merge_buf_t*	row_buf,
-	BtrBulk*		btr_bulk)
+	BtrBulk*		btr_bulk,
+	struct TABLE*		table)
 {
-	const byte*		b;
+	const byte**		b = NULL;
 	mem_heap_t*		heap;
 	mem_heap_t*		tuple_heap;
 	dberr_t			error = DB_SUCCESS;
-	ulint			foffs = 0;
-	ulint*			offsets;
-	mrec_buf_t*		buf;
+	ulint*			foffs = NULL;
+	ulint**			offsets;
+	mrec_buf_t*		buf = NULL;
+	const mrec_t**		mrecs = NULL;
 	ulint			n_rows = 0;
 	dtuple_t*		dtuple;
 	DBUG_ENTER("row_merge_insert_index_tuples");
@@ -2843,49 +3028,78 @@ row_merge_insert_index_tuples(
 	ut_ad(!(index->type & DICT_FTS));
 	ut_ad(!dict_index_is_spatial(index));
 	ut_ad(trx_id);
+	ut_ad((row_buf == NULL) == (n_files > 0));
 
 	tuple_heap = mem_heap_create(1000);
 
 	{
 		ulint i	= 1 + REC_OFFS_HEADER_SIZE
 			+ dict_index_get_n_fields(index);
-		heap = mem_heap_create(sizeof *buf + i * sizeof *offsets);
-		offsets = static_cast<ulint*>(
-			mem_heap_alloc(heap, i * sizeof *offsets));
-		offsets[0] = i;
-		offsets[1] = dict_index_get_n_fields(index);
+		ulint n = ut_max(n_files, ulint(1));
+
+		heap = mem_heap_create(
+			n * (sizeof *buf + sizeof *offsets
+			     + i * sizeof **offsets));
+		offsets = static_cast<ulint**>(
+			mem_heap_alloc(heap, n * sizeof *offsets));
+
+		for (ulint k = 0; k < n; k++) {
+			offsets[k] = static_cast<ulint*>(
+				mem_heap_alloc(heap, i * sizeof **offsets));
+			offsets[k][0] = i;
+			offsets[k][1] = dict_index_get_n_fields(index);
+		}
 	}
 
 	if (row_buf != NULL) {
-		ut_ad(fd == -1);
 		ut_ad(block == NULL);
 		DBUG_EXECUTE_IF("row_merge_read_failure",
 				error = DB_CORRUPTION;
 				goto err_exit;);
-		buf = NULL;
-		b = NULL;
 		dtuple = dtuple_create(
 			heap, dict_index_get_n_fields(index));
 		dtuple_set_n_fields_cmp(
 			dtuple, dict_index_get_n_unique_in_tree(index));
 	} else {
-		b = block;
 		dtuple = NULL;
 
-		if (!row_merge_read(fd, foffs, block)) {
-			error = DB_CORRUPTION;
-			goto err_exit;
-		} else {
-			buf = static_cast<mrec_buf_t*>(
-				mem_heap_alloc(heap, sizeof *buf));
+		b = static_cast<const byte**>(
+			mem_heap_alloc(heap, n_files * sizeof *b));
+		foffs = static_cast<ulint*>(
+			mem_heap_alloc(heap, n_files * sizeof *foffs));
+		mrecs = static_cast<const mrec_t**>(
+			mem_heap_alloc(heap, n_files * sizeof *mrecs));
+		buf = static_cast<mrec_buf_t*>(
+			mem_heap_alloc(heap, n_files * sizeof *buf));
+
+		/* Read the first record of each file. */
+		for (ulint k = 0; k < n_files; k++) {
+			row_merge_block_t*	kblock
+				= &block[k * 3 * srv_sort_buf_size];
+
+			foffs[k] = 0;
+
+			if (!row_merge_read(files[k].fd, foffs[k], kblock)) {
+				error = DB_CORRUPTION;
+				goto err_exit;
+			}
+
+			b[k] = row_merge_read_rec(
+				kblock, &buf[k], kblock, index,
+				files[k].fd, &foffs[k], &mrecs[k],
+				offsets[k]);
+
+			if (UNIV_UNLIKELY(!b[k] && mrecs[k])) {
+				error = DB_CORRUPTION;
+				goto err_exit;
+			}
 		}
 	}
 
-
 	for (;;) {
 		const mrec_t*	mrec;
 		ulint		n_ext;
-		mtr_t		mtr;
+		ulint		k = 0;
 
 		 if (row_buf != NULL) {
 			if (n_rows >= row_buf->n_tuples) {
@@ -2902,18 +3116,40 @@ row_merge_insert_index_tuples(
 			/* BLOB pointers must be copied from dtuple */
 			mrec = NULL;
 		} else {
-			b = row_merge_read_rec(block, buf, b, index,
-					       fd, &foffs, &mrec, offsets);
-			if (UNIV_UNLIKELY(!b)) {
-				/* End of list, or I/O error */
-				if (mrec) {
-					error = DB_CORRUPTION;
+			/* Pick the smallest record of the files. The
+			files are few, a linear search is good enough. */
+			k = ULINT_UNDEFINED;
+
+			for (ulint j = 0; j < n_files; j++) {
+				if (mrecs[j] == NULL) {
+					/* End of file */
+					continue;
+				} else if (k == ULINT_UNDEFINED) {
+					k = j;
+					continue;
+				}
+
+				int	cmp = cmp_rec_rec_simple(
+					mrecs[j], mrecs[k],
+					offsets[j], offsets[k],
+					index, table);
+
+				if (cmp < 0) {
+					k = j;
+				} else if (cmp == 0) {
+					error = DB_DUPLICATE_KEY;
+					goto err_exit;
 				}
+			}
+
+			if (k == ULINT_UNDEFINED) {
 				break;
 			}
 
+			mrec = mrecs[k];
+
 			dtuple = row_rec_to_index_entry_low(
-				mrec, index, offsets, &n_ext, tuple_heap);
+				mrec, index, offsets[k], &n_ext, tuple_heap);
 		}
 
 		dict_index_t*	old_index
@@ -2951,7 +3187,7 @@ row_merge_insert_index_tuples(
 			row_log_table_blob_alloc() and
 			row_log_table_blob_free(). */
 			row_merge_copy_blobs(
-				mrec, offsets,
+				mrec, offsets[k],
 				dict_table_page_size(old_table),
 				dtuple, tuple_heap);
 		}
@@ -2965,6 +3201,21 @@ row_merge_insert_index_tuples(
 		}
 
 		mem_heap_empty(tuple_heap);
+
+		if (row_buf == NULL) {
+			/* Read the next record of the file, now that
+			the current one has been inserted. */
+			b[k] = row_merge_read_rec(
+				&block[k * 3 * srv_sort_buf_size],
+				&buf[k], b[k], index, files[k].fd,
+				&foffs[k], &mrecs[k], offsets[k]);
+
+			if (UNIV_UNLIKELY(!b[k] && mrecs[k])) {
+				/* I/O error */
+				error = DB_CORRUPTION;
+				break;
+			}
+		}
 	}
 
 err_exit:
@@ -3969,6 +4220,8 @@ row_merge_build_indexes(
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
 	bool			is_redo_skipped;
+	/* Number of threads that sort the entries of an index. */
+	const ulint		n_threads = srv_parallel_ddl_threads;
 	DBUG_ENTER("row_merge_build_indexes");
 
 	ut_ad(!srv_read_only_mode);
@@ -3981,8 +4234,10 @@ row_merge_build_indexes(
 	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
 
 	/* This will allocate "3 * srv_sort_buf_size" elements of type
-	row_merge_block_t. The latter is defined as byte. */
-	block = alloc.allocate_large(3 * srv_sort_buf_size, &block_pfx);
+	row_merge_block_t for each sort thread. The latter is defined
+	as byte. */
+	block = alloc.allocate_large(
+		n_threads * 3 * srv_sort_buf_size, &block_pfx);
 
 	if (block == NULL) {
 		DBUG_RETURN(DB_OUT_OF_MEMORY);
@@ -3990,15 +4245,19 @@ row_merge_build_indexes(
 
 	trx_start_if_not_started_xa(trx, true);
 
+	/* The sorted runs of each index are distributed over
+	n_threads files, which are merge sorted in parallel. */
 	merge_files = static_cast<merge_file_t*>(
-		ut_malloc_nokey(n_indexes * sizeof *merge_files));
+		ut_malloc_nokey(n_indexes * n_threads * sizeof *merge_files));
 
 	/* Initialize all the merge file descriptors, so that we
 	don't call row_merge_file_destroy() on uninitialized
 	merge file descriptor */
 
-	for (i = 0; i < n_indexes; i++) {
+	for (i = 0; i < n_indexes * n_threads; i++) {
 		merge_files[i].fd = -1;
+		merge_files[i].offset = 0;
+		merge_files[i].n_rec = 0;
 	}
 
 	/* Check whether we can skip redo log for page allocation.
@@ -4030,6 +4289,8 @@ row_merge_build_indexes(
 			dup->table = table;
 			dup->col_map = col_map;
 			dup->n_dup = 0;
+			dup->heap = NULL;
+			dup->entry = NULL;
 
 			row_fts_psort_info_init(
 				trx, dup, new_table, opt_doc_id_size,
@@ -4049,9 +4310,9 @@ row_merge_build_indexes(
 	secondary index entries for merge sort */
 	error = row_merge_read_clustered_index(
 		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, add_cols, col_map, add_autoinc, sequence,
-		block, skip_pk_sort, &tmpfd);
+		fts_sort_idx, psort_info, merge_files, n_threads,
+		key_numbers, n_indexes, add_cols, col_map, add_autoinc,
+		sequence, block, skip_pk_sort, &tmpfd);
 
 	if (error != DB_SUCCESS) {
 
@@ -4136,29 +4397,40 @@ wait_again:
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
-		} else if (merge_files[i].fd >= 0) {
+		} else if (merge_files[i * n_threads].fd >= 0) {
+			merge_file_t*	files = &merge_files[i * n_threads];
+			ulint		n_files = 1;
 			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
+				sort_idx, table, col_map, 0, NULL, NULL};
+
+			/* The runs were written round-robin, starting
+			from the first file. */
+			while (n_files < n_threads && files[n_files].fd >= 0) {
+				n_files++;
+			}
 
-			error = row_merge_sort(
-				trx, &dup, &merge_files[i],
-				block, &tmpfd);
+			error = row_merge_sort_parallel(
+				trx, &dup, files, n_files, block, &tmpfd);
 
 			if (error == DB_SUCCESS) {
 				BtrBulk	btr_bulk(sort_idx, trx->id);
 				btr_bulk.init();
 
+				/* Merge the sorted files while inserting,
+				checking for duplicates between them. */
 				error = row_merge_insert_index_tuples(
 					trx->id, sort_idx, old_table,
-					merge_files[i].fd, block, NULL,
-					&btr_bulk);
+					files, n_files, block, NULL,
+					&btr_bulk, table);
 
 				error = btr_bulk.finish(error);
 			}
 		}
 
-		/* Close the temporary file to free up space. */
-		row_merge_file_destroy(&merge_files[i]);
+		/* Close the temporary files to free up space. */
+		for (j = 0; j < n_threads; j++) {
+			row_merge_file_destroy(&merge_files[i * n_threads + j]);
+		}
 
 		if (indexes[i]->type & DICT_FTS) {
 			row_fts_psort_info_destroy(psort_info, merge_info);
@@ -4206,7 +4478,7 @@ func_exit:
 
 	row_merge_file_destroy_low(tmpfd);
 
-	for (i = 0; i < n_indexes; i++) {
+	for (i = 0; i < n_indexes * n_threads; i++) {
 		row_merge_file_destroy(&merge_files[i]);
 	}
 
@@ -4266,3 +4538,540 @@ func_exit:
 
 	DBUG_RETURN(error);
 }
+
+/** Bulk insert into an empty table. The clustered index is built with
+BtrBulk for as long as the rows arrive in ascending order of the PRIMARY
+KEY; the secondary index entries are sorted and loaded at the end. */
+struct row_merge_bulk_t {
+	dict_table_t*		table;	/*!< table being loaded */
+	trx_t*			trx;	/*!< transaction */
+	que_thr_t*		thr;	/*!< query thread of the insert
+					graph */
+	struct TABLE*		mysql_table;
+					/*!< MySQL table, for reporting
+					duplicate keys */
+	roll_ptr_t		roll_ptr;
+					/*!< DB_ROLL_PTR of the loaded rows,
+					pointing to the TRX_UNDO_EMPTY
+					record */
+	BtrBulk*		clust_bulk;
+					/*!< bulk load of the clustered
+					index, or NULL after a row arrived
+					out of order */
+	bool			clust_started;
+					/*!< whether clust_bulk has pages */
+	dfield_t*		last;	/*!< PRIMARY KEY of the last row,
+					or NULL if none was loaded yet */
+	mem_heap_t*		last_heap;
+					/*!< heap for last */
+	ulint			n_indexes;
+					/*!< number of secondary indexes */
+	dict_index_t**		indexes;/*!< secondary indexes */
+	row_merge_buf_t**	bufs;	/*!< sort buffers of indexes[] */
+	merge_file_t*		files;	/*!< sorted runs of indexes[] */
+	row_merge_block_t*	block;	/*!< 3 buffers for sorting, or NULL
+					if no run was written yet */
+	ut_new_pfx_t		block_pfx;
+					/*!< allocation of block */
+	int			tmpfd;	/*!< temporary file for merging */
+	dberr_t			error;	/*!< first error that aborted
+					the bulk insert */
+};
+
+/** Check whether an index tree consists of an empty root page.
+@param[in]	index	index tree
+@return whether the index is empty */
+static
+bool
+row_merge_bulk_index_is_empty(
+	const dict_index_t*	index)
+{
+	mtr_t	mtr;
+
+	mtr_start(&mtr);
+
+	const page_t*	root = btr_root_get(index, &mtr);
+	const bool	empty = root != NULL
+		&& page_is_leaf(root)
+		&& page_get_n_recs(root) == 0;
+
+	mtr_commit(&mtr);
+
+	return(empty);
+}
+
+/** Check whether all indexes of a table are empty.
+@param[in]	table	table
+@return whether the table is empty */
+bool
+row_merge_bulk_table_is_empty(
+	const dict_table_t*	table)
+{
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (!row_merge_bulk_index_is_empty(index)) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Start a bulk insert into an empty table. A single TRX_UNDO_EMPTY
+record is written, whose rollback empties the table, instead of an undo
+log record for each row. The caller must hold an exclusive lock on the
+table, and all inserts into the table until row_merge_bulk_finish() must
+go through row_merge_bulk_insert().
+@param[in,out]	trx		transaction
+@param[in]	thr		query thread of the insert graph
+@param[in,out]	table		table to load
+@param[in,out]	mysql_table	MySQL table, for reporting duplicate keys
+@param[out]	bulk		bulk insert, or NULL if the table is not
+empty
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_create(
+	trx_t*			trx,
+	que_thr_t*		thr,
+	dict_table_t*		table,
+	struct TABLE*		mysql_table,
+	row_merge_bulk_t**	bulk)
+{
+	dict_index_t*		clust_index = dict_table_get_first_index(table);
+	roll_ptr_t		roll_ptr;
+	row_merge_bulk_t*	b;
+	dberr_t			err;
+	ulint			i;
+
+	ut_ad(!dict_table_is_temporary(table));
+
+	*bulk = NULL;
+
+	if (!row_merge_bulk_table_is_empty(table)) {
+		return(DB_SUCCESS);
+	}
+
+	err = trx_undo_report_row_operation(
+		0, TRX_UNDO_INSERT_OP, thr, clust_index, NULL, NULL, 0,
+		NULL, NULL, &roll_ptr);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	b = static_cast<row_merge_bulk_t*>(ut_zalloc_nokey(sizeof *b));
+
+	b->table = table;
+	b->trx = trx;
+	b->thr = thr;
+	b->mysql_table = mysql_table;
+	b->roll_ptr = roll_ptr;
+	b->last_heap = mem_heap_create(256);
+	b->tmpfd = -1;
+	b->error = DB_SUCCESS;
+
+	/* The page allocations must be redo logged, so that the
+	rollback can free the pages after a crash. */
+	clust_index->is_redo_skipped = false;
+
+	b->clust_bulk = UT_NEW_NOKEY(BtrBulk(clust_index, trx->id));
+	b->clust_bulk->init();
+
+	b->n_indexes = UT_LIST_GET_LEN(table->indexes) - 1;
+
+	if (b->n_indexes > 0) {
+		b->indexes = static_cast<dict_index_t**>(
+			ut_zalloc_nokey(b->n_indexes * sizeof *b->indexes));
+		b->bufs = static_cast<row_merge_buf_t**>(
+			ut_zalloc_nokey(b->n_indexes * sizeof *b->bufs));
+		b->files = static_cast<merge_file_t*>(
+			ut_zalloc_nokey(b->n_indexes * sizeof *b->files));
+	}
+
+	i = 0;
+
+	for (dict_index_t* index = dict_table_get_next_index(clust_index);
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		ut_ad(!(index->type & (DICT_FTS | DICT_SPATIAL)));
+
+		index->is_redo_skipped = false;
+
+		b->indexes[i] = index;
+		b->bufs[i] = row_merge_buf_create(index);
+		b->files[i].fd = -1;
+	}
+
+	*bulk = b;
+
+	return(DB_SUCCESS);
+}
+
+/** Insert a clustered index entry in bulk mode.
+@param[in,out]	bulk	bulk insert
+@param[in,out]	entry	clustered index entry
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_bulk_insert_clust(
+	row_merge_bulk_t*	bulk,
+	dtuple_t*		entry)
+{
+	dict_index_t*	index = dict_table_get_first_index(bulk->table);
+	const ulint	n_uniq = dict_index_get_n_unique(index);
+	dberr_t		err;
+
+	if (bulk->clust_bulk != NULL) {
+		int	cmp = 1;
+
+		if (bulk->last != NULL) {
+			const dfield_t*	f = dtuple_get_nth_field(entry, 0);
+			const dfield_t*	l = bulk->last;
+			ulint		n = n_uniq;
+
+			do {
+				cmp = cmp_dfield_dfield(f++, l++);
+			} while (!cmp && --n);
+		}
+
+		if (cmp == 0) {
+			bulk->trx->error_info = index;
+			return(DB_DUPLICATE_KEY);
+		}
+
+		if (bulk->clust_started) {
+			bulk->clust_bulk->latch();
+		}
+
+		bulk->clust_started = true;
+
+		if (cmp > 0) {
+			err = bulk->clust_bulk->insert(entry);
+
+			bulk->clust_bulk->release();
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+
+			/* Remember the PRIMARY KEY for the next row. */
+			mem_heap_empty(bulk->last_heap);
+
+			bulk->last = static_cast<dfield_t*>(
+				mem_heap_alloc(bulk->last_heap,
+					       n_uniq * sizeof *bulk->last));
+
+			for (ulint i = 0; i < n_uniq; i++) {
+				dfield_copy(&bulk->last[i],
+					    dtuple_get_nth_field(entry, i));
+				dfield_dup(&bulk->last[i], bulk->last_heap);
+			}
+
+			return(DB_SUCCESS);
+		}
+
+		/* The row is out of order. Complete the tree that was
+		built so far, and insert the rest of the rows one by one.
+		The pages that were written without redo logging must
+		be flushed before any redo log is written for them. */
+		err = bulk->clust_bulk->finish(DB_SUCCESS);
+
+		UT_DELETE(bulk->clust_bulk);
+		bulk->clust_bulk = NULL;
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		log_make_checkpoint_at(LSN_MAX, TRUE);
+	}
+
+	/* The rows are not undo logged nor locked individually. Their
+	DB_TRX_ID and DB_ROLL_PTR are already in the entry. */
+	const ulint	flags = BTR_NO_UNDO_LOG_FLAG | BTR_NO_LOCKING_FLAG
+		| BTR_KEEP_SYS_FLAG;
+	const ulint	n_ext = dtuple_get_n_ext(entry);
+
+	log_free_check();
+
+	err = row_ins_clust_index_entry_low(
+		flags, BTR_MODIFY_LEAF, index, n_uniq, entry, n_ext,
+		bulk->thr, false);
+
+	if (err == DB_FAIL) {
+		err = row_ins_clust_index_entry_low(
+			flags, BTR_MODIFY_TREE, index, n_uniq, entry, n_ext,
+			bulk->thr, false);
+	}
+
+	return(err);
+}
+
+/** Sort the buffered entries of a secondary index and write them to the
+sorted runs of the index.
+@param[in,out]	bulk	bulk insert
+@param[in]	i	index number
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_bulk_write(
+	row_merge_bulk_t*	bulk,
+	ulint			i)
+{
+	row_merge_buf_t*	buf = bulk->bufs[i];
+	merge_file_t*		file = &bulk->files[i];
+
+	if (dict_index_is_unique(buf->index)) {
+		row_merge_dup_t	dup = {
+			buf->index, bulk->mysql_table, NULL, 0,
+			NULL, NULL};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			bulk->trx->error_info = buf->index;
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	if (bulk->block == NULL) {
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+		bulk->block = alloc.allocate_large(
+			3 * srv_sort_buf_size, &bulk->block_pfx);
+
+		if (bulk->block == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	if (row_merge_file_create_if_needed(file, &bulk->tmpfd) < 0) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	file->n_rec += buf->n_tuples;
+
+	row_merge_buf_write(buf, file, bulk->block);
+
+	if (!row_merge_write(file->fd, file->offset++, bulk->block)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&bulk->block[0], srv_sort_buf_size);
+
+	bulk->bufs[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/** Insert a row in bulk mode.
+@param[in,out]	bulk	bulk insert
+@param[in,out]	node	insert node, with the row converted from the
+MySQL format and DB_TRX_ID written
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_insert(
+	row_merge_bulk_t*	bulk,
+	ins_node_t*		node)
+{
+	dict_index_t*	index = dict_table_get_first_index(bulk->table);
+	dtuple_t*	entry = UT_LIST_GET_FIRST(node->entry_list);
+	dberr_t		err;
+
+	ut_ad(node->table == bulk->table);
+
+	if (bulk->error != DB_SUCCESS) {
+		return(bulk->error);
+	}
+
+	if (!dict_index_is_unique(index)) {
+		dict_sys_write_row_id(
+			node->row_id_buf, dict_sys_get_new_row_id());
+	}
+
+	err = row_ins_index_entry_set_vals(index, entry, node->row);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	row_upd_index_entry_sys_field(
+		entry, index, DATA_ROLL_PTR, bulk->roll_ptr);
+
+	err = row_merge_bulk_insert_clust(bulk, entry);
+
+	if (err != DB_SUCCESS) {
+		/* Even a duplicate key must stop the load, as the
+		secondary index entries of the previous rows must not
+		be built into a tree that is going to be rolled back. */
+		goto err_exit;
+	}
+
+	for (ulint i = 0; i < bulk->n_indexes; i++) {
+		doc_id_t	doc_id = 0;
+
+		if (row_merge_buf_add(bulk->bufs[i], NULL, bulk->table,
+				      NULL, node->row, NULL, &doc_id)) {
+			continue;
+		}
+
+		err = row_merge_bulk_write(bulk, i);
+
+		if (err != DB_SUCCESS) {
+			goto err_exit;
+		}
+
+		if (!row_merge_buf_add(bulk->bufs[i], NULL, bulk->table,
+				       NULL, node->row, NULL, &doc_id)) {
+			/* An empty buffer should have enough room for
+			at least one record. */
+			ut_error;
+		}
+	}
+
+	return(DB_SUCCESS);
+
+err_exit:
+	/* Some index entries of the row were not inserted.
+	The statement must be rolled back. */
+	bulk->error = err;
+	return(err);
+}
+
+/** Finish a bulk insert: complete the clustered index, build the
+secondary indexes from the sorted entries, and make the loaded pages
+durable by a checkpoint.
+@param[in,out]	bulk	bulk insert, freed by row_merge_bulk_free()
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_bulk_finish(
+	row_merge_bulk_t*	bulk)
+{
+	trx_t*	trx = bulk->trx;
+	dberr_t	err = bulk->error;
+
+	if (bulk->clust_bulk != NULL) {
+		if (bulk->clust_started) {
+			bulk->clust_bulk->latch();
+		}
+
+		err = bulk->clust_bulk->finish(err);
+
+		UT_DELETE(bulk->clust_bulk);
+		bulk->clust_bulk = NULL;
+	}
+
+	for (ulint i = 0; i < bulk->n_indexes && err == DB_SUCCESS; i++) {
+		dict_index_t*		index = bulk->indexes[i];
+		row_merge_buf_t*	buf = bulk->bufs[i];
+		merge_file_t*		file = &bulk->files[i];
+		BtrBulk			btr_bulk(index, trx->id);
+
+		btr_bulk.init();
+
+		if (file->fd < 0) {
+			/* All the entries fit in the sort buffer. */
+			if (dict_index_is_unique(index)) {
+				row_merge_dup_t	dup = {
+					index, bulk->mysql_table, NULL, 0,
+					NULL, NULL};
+
+				if (buf->n_tuples > 0) {
+					row_merge_buf_sort(buf, &dup);
+				}
+
+				if (dup.n_dup) {
+					trx->error_info = index;
+					err = DB_DUPLICATE_KEY;
+				}
+			} else if (buf->n_tuples > 0) {
+				row_merge_buf_sort(buf, NULL);
+			}
+
+			if (err == DB_SUCCESS && buf->n_tuples > 0) {
+				err = row_merge_insert_index_tuples(
+					trx->id, index, bulk->table,
+					NULL, 0, NULL, buf, &btr_bulk, NULL);
+			}
+		} else {
+			row_merge_dup_t	dup = {
+				index, bulk->mysql_table, NULL, 0, NULL, NULL};
+
+			if (buf->n_tuples > 0) {
+				err = row_merge_bulk_write(bulk, i);
+			}
+
+			if (err == DB_SUCCESS) {
+				err = row_merge_sort(
+					trx, &dup, file, bulk->block,
+					&bulk->tmpfd);
+			}
+
+			if (err == DB_SUCCESS) {
+				err = row_merge_insert_index_tuples(
+					trx->id, index, bulk->table,
+					file, 1, bulk->block, NULL,
+					&btr_bulk, bulk->mysql_table);
+			}
+
+			if (err == DB_DUPLICATE_KEY) {
+				trx->error_info = index;
+			}
+
+			row_merge_file_destroy(file);
+		}
+
+		err = btr_bulk.finish(err);
+	}
+
+	if (err == DB_SUCCESS) {
+		log_make_checkpoint_at(LSN_MAX, TRUE);
+	}
+
+	bulk->error = err;
+
+	return(err);
+}
+
+/** Free a bulk insert. If row_merge_bulk_finish() was not called, the
+loaded pages are abandoned; the statement must then be rolled back.
+@param[in,out]	bulk	bulk insert */
+void
+row_merge_bulk_free(
+	row_merge_bulk_t*	bulk)
+{
+	if (bulk->clust_bulk != NULL) {
+		if (bulk->clust_started) {
+			bulk->clust_bulk->latch();
+		}
+
+		bulk->clust_bulk->finish(DB_INTERRUPTED);
+		UT_DELETE(bulk->clust_bulk);
+	}
+
+	for (ulint i = 0; i < bulk->n_indexes; i++) {
+		row_merge_buf_free(bulk->bufs[i]);
+		row_merge_file_destroy(&bulk->files[i]);
+	}
+
+	row_merge_file_destroy_low(bulk->tmpfd);
+
+	if (bulk->block != NULL) {
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+		alloc.deallocate_large(bulk->block, &bulk->block_pfx);
+	}
+
+	ut_free(bulk->indexes);
+	ut_free(bulk->bufs);
+	ut_free(bulk->files);
+
+	mem_heap_free(bulk->last_heap);
+
+	ut_free(bulk);
+}
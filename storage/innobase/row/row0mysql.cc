@@ -36,6 +36,7 @@ Created 9/17/2000 Heikki Tuuri
 #endif
 
 #include "btr0sea.h"
+#include "buf0lru.h"
 #include "dict0boot.h"
 #include "dict0crea.h"
 #include <sql_const.h>
@@ -943,6 +944,8 @@ row_create_prebuilt(
 
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+
 	prebuilt->ins_sel_stmt = false;
 	prebuilt->session = NULL;
 
@@ -951,6 +954,43 @@ row_create_prebuilt(
 	return(prebuilt);
 }
 
+/********************************************************************//**
+Free the fetch cache of a prebuilt struct, after checking the magic numbers
+around the cached rows. */
+
+void
+row_prebuilt_free_fetch_cache(
+/*==========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	if (prebuilt->fetch_cache == NULL) {
+		return;
+	}
+
+	byte*	base = prebuilt->fetch_cache[0] - 4;
+	byte*	ptr = base;
+
+	for (ulint i = 0; i < prebuilt->fetch_cache_size; i++) {
+		ulint	magic1 = mach_read_from_4(ptr);
+		ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+
+		byte*	row = ptr;
+		ut_a(row == prebuilt->fetch_cache[i]);
+		ptr += prebuilt->mysql_row_len;
+
+		ulint	magic2 = mach_read_from_4(ptr);
+		ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+	}
+
+	ut_free(base);
+	ut_free(prebuilt->fetch_cache);
+
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_size = 0;
+}
+
 /********************************************************************//**
 Free a prebuilt struct for a MySQL table handle. */
 
@@ -991,25 +1031,14 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			ulint	magic1 = mach_read_from_4(ptr);
-			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-
-			byte*	row = ptr;
-			ut_a(row == prebuilt->fetch_cache[i]);
-			ptr += prebuilt->mysql_row_len;
+	row_prebuilt_free_fetch_cache(prebuilt);
 
-			ulint	magic2 = mach_read_from_4(ptr);
-			ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-		}
+	if (prebuilt->scan_ring != NULL) {
+		buf_LRU_scan_ring_free(prebuilt->scan_ring);
+	}
 
-		ut_free(base);
+	if (prebuilt->bulk != NULL) {
+		row_merge_bulk_free(prebuilt->bulk);
 	}
 
 	if (prebuilt->rtr_info) {
@@ -1487,6 +1516,37 @@ row_insert_for_mysql_using_cursor(
 	return(err);
 }
 
+/** Does an insert for MySQL in bulk mode, see row_insert_bulk_start().
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@return error code or DB_SUCCESS */
+static
+dberr_t
+row_insert_bulk_for_mysql(
+	row_prebuilt_t*	prebuilt)
+{
+	trx_t*		trx	= prebuilt->trx;
+	ins_node_t*	node	= prebuilt->ins_node;
+	dict_table_t*	table	= prebuilt->table;
+	dberr_t		err;
+
+	memset(node->trx_id_buf, 0, DATA_TRX_ID_LEN);
+	trx_write_trx_id(node->trx_id_buf, trx->id);
+
+	err = row_merge_bulk_insert(prebuilt->bulk, node);
+
+	if (err == DB_SUCCESS) {
+		srv_stats.n_rows_inserted.inc();
+
+		dict_table_n_rows_inc(table);
+
+		row_update_statistics_if_needed(table);
+	}
+
+	trx->op_info = "";
+
+	return(err);
+}
+
 /** Does an insert for MySQL using INSERT graph. This function will run/execute
 INSERT graph.
 @param[in]	mysql_rec	row in the MySQL format
@@ -1559,6 +1619,10 @@ row_insert_for_mysql_using_ins_graph(
 
 	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec);
 
+	if (prebuilt->bulk != NULL) {
+		return(row_insert_bulk_for_mysql(prebuilt));
+	}
+
 	savept = trx_savept_take(trx);
 
 	thr = que_fork_get_first_thr(prebuilt->ins_graph);
@@ -1696,6 +1760,91 @@ row_insert_for_mysql(
 	}
 }
 
+/** Start a bulk insert into an empty table. If the table is empty, it is
+locked exclusively, and if it is still empty, the following
+row_insert_for_mysql() calls load it in bulk until row_insert_bulk_end().
+Nothing is done for tables that the bulk insert does not support.
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in,out]	mysql_table	MySQL table, for reporting duplicate keys
+@return error code or DB_SUCCESS */
+
+dberr_t
+row_insert_bulk_start(
+	row_prebuilt_t*	prebuilt,
+	struct TABLE*	mysql_table)
+{
+	trx_t*		trx	= prebuilt->trx;
+	dict_table_t*	table	= prebuilt->table;
+	dberr_t		err;
+
+	ut_ad(prebuilt->bulk == NULL);
+
+	if (srv_read_only_mode
+	    || dict_table_is_temporary(table)
+	    || dict_table_is_discarded(table)
+	    || table->ibd_file_missing
+	    || table->fts != NULL
+	    || !table->foreign_set.empty()
+	    || !table->referenced_set.empty()
+	    || trx->duplicates) {
+
+		return(DB_SUCCESS);
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (dict_index_is_spatial(index)
+		    || (index->type & DICT_FTS)
+		    || dict_index_is_corrupted(index)
+		    || dict_index_is_online_ddl(index)) {
+
+			return(DB_SUCCESS);
+		}
+	}
+
+	/* Do not lock a table that is not empty. The check is repeated
+under the table lock. */
+	if (!row_merge_bulk_table_is_empty(table)) {
+		return(DB_SUCCESS);
+	}
+
+	trx_start_if_not_started_xa(trx, true);
+
+	err = row_lock_table_for_mysql(prebuilt, table, LOCK_X);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	row_get_prebuilt_insert_row(prebuilt);
+
+	return(row_merge_bulk_create(
+		       trx, que_fork_get_first_thr(prebuilt->ins_graph),
+		       table, mysql_table, &prebuilt->bulk));
+}
+
+/** End a bulk insert that was started by row_insert_bulk_start().
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@return error code or DB_SUCCESS */
+
+dberr_t
+row_insert_bulk_end(
+	row_prebuilt_t*	prebuilt)
+{
+	dberr_t	err;
+
+	ut_ad(prebuilt->bulk != NULL);
+
+	err = row_merge_bulk_finish(prebuilt->bulk);
+
+	row_merge_bulk_free(prebuilt->bulk);
+	prebuilt->bulk = NULL;
+
+	return(err);
+}
+
 /*********************************************************************//**
 Builds a dummy query graph used in selects. */
 
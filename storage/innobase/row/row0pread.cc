@@ -0,0 +1,443 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel consistent read of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "os0thread.h"
+#include "rem0cmp.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+#include "ut0counter.h"
+
+#include <vector>
+
+/** Number of key ranges to aim for per thread. Having more ranges than
+threads evens out the work when the subtrees differ in size. */
+#define ROW_PREAD_RANGES_PER_THREAD	8
+
+/** Key range of a clustered index, from start (inclusive) to end
+(exclusive). NULL stands for the beginning or the end of the index. */
+struct row_pread_range_t {
+	const dtuple_t*	start;	/*!< first key, or NULL */
+	const dtuple_t*	end;	/*!< key after the last, or NULL */
+};
+
+typedef std::vector<row_pread_range_t, ut_allocator<row_pread_range_t> >
+	row_pread_ranges_t;
+
+/** State of a parallel read, shared by the threads */
+struct row_pread_ctx_t {
+	trx_t*			trx;	/*!< transaction */
+	dict_index_t*		index;	/*!< clustered index */
+	const row_pread_ranges_t*
+				ranges;	/*!< key ranges to scan */
+	ulint			next;	/*!< next range to scan;
+					incremented atomically */
+	row_pread_fn_t		fn;	/*!< callback */
+	void*			arg;	/*!< argument of fn */
+	volatile dberr_t	error;	/*!< error of any thread; makes
+					the other threads stop */
+};
+
+/** A thread of a parallel read */
+struct row_pread_thread_t {
+	row_pread_ctx_t*	ctx;	/*!< shared state */
+	ulint			thread_no;/*!< number of the thread */
+	dberr_t			error;	/*!< result of the thread */
+	os_event_t		event;	/*!< set when the thread is done */
+};
+
+/** Split a clustered index into key ranges at the node pointers of the
+highest level that has at least n_ranges node pointers, or of level 1.
+@param[in]	index		clustered index
+@param[in]	n_ranges	desired number of ranges
+@param[in,out]	heap		memory heap for the keys
+@param[out]	ranges		key ranges that cover the whole index */
+static
+void
+row_pread_partition(
+	dict_index_t*		index,
+	ulint			n_ranges,
+	mem_heap_t*		heap,
+	row_pread_ranges_t&	ranges)
+{
+	const ulint	n_fields = dict_index_get_n_unique_in_tree(index);
+	mtr_t		mtr;
+	row_pread_range_t	range;
+
+	range.start = NULL;
+	range.end = NULL;
+	ranges.clear();
+
+	mtr_start(&mtr);
+
+	/* Prevent changes to the tree structure, but not to the
+	records, while the node pointers are being read. */
+	mtr_sx_lock(dict_index_get_lock(index), &mtr);
+
+	for (ulint level = btr_height_get(index, &mtr); level > 0; level--) {
+		btr_pcur_t	pcur;
+
+		ranges.clear();
+
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_TREE | BTR_ALREADY_S_LATCHED,
+			&pcur, true, level, &mtr);
+		btr_pcur_move_to_next_on_page(&pcur);
+
+		/* The first node pointer on the level points to the
+		subtree that starts from the beginning of the index.
+		Every other one starts a range of its own. */
+		ut_ad(btr_pcur_is_on_user_rec(&pcur));
+		btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+
+		for (; btr_pcur_is_on_user_rec(&pcur);
+		     btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+			const dtuple_t*	key = dict_index_build_data_tuple(
+				index, btr_pcur_get_rec(&pcur),
+				n_fields, heap);
+
+			range.end = key;
+			ranges.push_back(range);
+			range.start = key;
+		}
+
+		range.end = NULL;
+
+		/* Release the latch on the last page, because that is
+		not done by btr_pcur_close(). */
+		btr_leaf_page_release(
+			btr_pcur_get_block(&pcur), BTR_SEARCH_LEAF, &mtr);
+
+		btr_pcur_close(&pcur);
+
+		if (ranges.size() + 1 >= n_ranges || level == 1) {
+			break;
+		}
+
+		/* Read one level down. The number of pages on it is
+		the number of node pointers on this level, which is
+		less than n_ranges. */
+		range.start = NULL;
+	}
+
+	mtr_commit(&mtr);
+
+	ranges.push_back(range);
+}
+
+/** Scan a key range of the clustered index and invoke the callback for
+the records that are visible in the read view.
+@param[in,out]	ctx		parallel read
+@param[in]	range		key range
+@param[in]	thread_no	number of the thread
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_pread_scan_range(
+	row_pread_ctx_t*		ctx,
+	const row_pread_range_t&	range,
+	ulint				thread_no)
+{
+	dict_index_t*	index = ctx->index;
+	ReadView*	view = trx_get_read_view(ctx->trx);
+	const bool	comp = dict_table_is_comp(index->table);
+	mem_heap_t*	heap = NULL;
+	mem_heap_t*	vers_heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	ulint		cnt = 1000;
+	dberr_t		err = DB_SUCCESS;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+
+	if (range.start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(index, range.start, PAGE_CUR_GE,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+	}
+
+	for (bool more = btr_pcur_is_on_user_rec(&pcur)
+		     || btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+	     more;
+	     more = btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		offsets = rec_get_offsets(
+			rec, index, offsets, ULINT_UNDEFINED, &heap);
+
+		if (range.end != NULL
+		    && cmp_dtuple_rec(range.end, rec, offsets) <= 0) {
+			break;
+		}
+
+		/* Fetch a previous version of the record if the current
+		one is not visible in the read view, like
+		row_search_mvcc() does. */
+		if (srv_force_recovery < 5
+		    && !lock_clust_rec_cons_read_sees(
+			    rec, index, offsets, view)) {
+
+			rec_t*	old_vers;
+
+			if (vers_heap == NULL) {
+				vers_heap = mem_heap_create(200);
+			} else {
+				mem_heap_empty(vers_heap);
+			}
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, view, &heap,
+				vers_heap, &old_vers);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			/* NULL if the record did not exist in the view */
+			rec = old_vers;
+		}
+
+		if (rec != NULL && !rec_get_deleted_flag(rec, comp)) {
+			err = ctx->fn(rec, offsets, thread_no, ctx->arg);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+		}
+
+		/* Every 1,000 records, check for interrupts and release
+		the page latch, so that the thread does not block writers
+		for long. */
+		if (--cnt == 0) {
+			cnt = 1000;
+
+			if (trx_is_interrupted(ctx->trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			} else if (ctx->error != DB_SUCCESS) {
+				/* Another thread failed */
+				break;
+			}
+
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr_commit(&mtr);
+			mtr_start(&mtr);
+			btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur, &mtr);
+		}
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	if (vers_heap != NULL) {
+		mem_heap_free(vers_heap);
+	}
+
+	return(err);
+}
+
+/** Scan key ranges until all ranges have been taken or a thread fails.
+@param[in,out]	ctx		parallel read
+@param[in]	thread_no	number of the thread
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_pread_worker(
+	row_pread_ctx_t*	ctx,
+	ulint			thread_no)
+{
+	for (;;) {
+		ulint	i = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (i >= ctx->ranges->size() || ctx->error != DB_SUCCESS) {
+			return(DB_SUCCESS);
+		}
+
+		dberr_t	err = row_pread_scan_range(
+			ctx, (*ctx->ranges)[i], thread_no);
+
+		if (err != DB_SUCCESS) {
+			ctx->error = err;
+			return(err);
+		}
+	}
+}
+
+/*********************************************************************//**
+Function run by a thread of a parallel read, other than the calling one.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+row_pread_thread(
+/*=============*/
+	void*		arg)		/*!< in/out: row_pread_thread_t */
+{
+	row_pread_thread_t*	thr = static_cast<row_pread_thread_t*>(arg);
+
+	thr->error = row_pread_worker(thr->ctx, thr->thread_no);
+
+	os_event_set(thr->event);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Scan a clustered index in parallel, in the read view of a transaction.
+The callback is invoked for each record that exists and is not
+delete-marked in the read view, in no particular order between the
+threads. The read view must have been assigned.
+@param[in]	trx		transaction
+@param[in]	index		clustered index
+@param[in]	n_threads	number of threads to use, including
+the calling thread
+@param[in]	fn		callback for each visible record
+@param[in,out]	arg		argument to fn
+@return DB_SUCCESS or error code */
+dberr_t
+row_pread_scan(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	row_pread_fn_t	fn,
+	void*		arg)
+{
+	row_pread_ranges_t	ranges;
+	row_pread_ctx_t		ctx;
+	row_pread_thread_t*	thr;
+	dberr_t			err;
+	mem_heap_t*		heap = mem_heap_create(1024);
+
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(n_threads > 0);
+	ut_ad(n_threads <= ROW_PREAD_MAX_THREADS);
+	ut_ad(srv_read_only_mode
+	      || dict_table_is_temporary(index->table)
+	      || MVCC::is_view_active(trx->read_view));
+
+	row_pread_partition(
+		index, n_threads * ROW_PREAD_RANGES_PER_THREAD, heap, ranges);
+
+	n_threads = ut_min(n_threads, ranges.size());
+
+	ctx.trx = trx;
+	ctx.index = index;
+	ctx.ranges = &ranges;
+	ctx.next = 0;
+	ctx.fn = fn;
+	ctx.arg = arg;
+	ctx.error = DB_SUCCESS;
+
+	thr = static_cast<row_pread_thread_t*>(
+		ut_zalloc_nokey(n_threads * sizeof *thr));
+
+	for (ulint k = 1; k < n_threads; k++) {
+		thr[k].ctx = &ctx;
+		thr[k].thread_no = k;
+		thr[k].error = DB_SUCCESS;
+		thr[k].event = os_event_create(0);
+
+		os_thread_create(row_pread_thread, &thr[k], NULL);
+	}
+
+	err = row_pread_worker(&ctx, 0);
+
+	for (ulint k = 1; k < n_threads; k++) {
+		os_event_wait(thr[k].event);
+
+		if (err == DB_SUCCESS) {
+			err = thr[k].error;
+		}
+
+		os_event_destroy(thr[k].event);
+	}
+
+	ut_free(thr);
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/** Per-thread record counts of row_pread_count() */
+typedef ib_counter_t<ulint, ROW_PREAD_MAX_THREADS> row_pread_counter_t;
+
+/** Count a record for row_pread_count().
+@param[in]	rec		record
+@param[in]	offsets		rec_get_offsets(rec, index)
+@param[in]	thread_no	number of the thread
+@param[in,out]	arg		row_pread_counter_t
+@return DB_SUCCESS */
+static
+dberr_t
+row_pread_count_rec(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	ulint		thread_no,
+	void*		arg)
+{
+	static_cast<row_pread_counter_t*>(arg)->add(thread_no, 1);
+
+	return(DB_SUCCESS);
+}
+
+/** Count the records of a clustered index that are visible in the
+read view of a transaction, using parallel threads.
+@param[in]	trx		transaction
+@param[in]	index		clustered index
+@param[in]	n_threads	number of threads to use
+@param[out]	n_rows		number of records
+@return DB_SUCCESS or error code */
+dberr_t
+row_pread_count(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	ulint*		n_rows)
+{
+	row_pread_counter_t	counter;
+
+	dberr_t	err = row_pread_scan(
+		trx, index, n_threads, row_pread_count_rec, &counter);
+
+	*n_rows = err == DB_SUCCESS ? ulint(counter) : 0;
+
+	return(err);
+}
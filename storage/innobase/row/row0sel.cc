@@ -1421,7 +1421,8 @@ row_sel_try_search_shortcut(
 				index */
 	ibool		search_latch_locked,
 				/*!< in: whether the search holds
-				btr_search_latch */
+				the adaptive hash index latch of
+				plan->index */
 	mtr_t*		mtr)	/*!< in: mtr */
 {
 	dict_index_t*	index;
@@ -1439,7 +1440,7 @@ row_sel_try_search_shortcut(
 	ut_ad(!plan->must_get_clust);
 #ifdef UNIV_SYNC_DEBUG
 	if (search_latch_locked) {
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_S));
+		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
 	}
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -1476,7 +1477,8 @@ row_sel_try_search_shortcut(
 		}
 	} else if (!srv_read_only_mode
 		   && !lock_sec_rec_cons_read_sees(
-			rec, index, node->read_view)) {
+			rec, btr_pcur_get_block(&plan->pcur), index,
+			node->read_view)) {
 
 		ret = SEL_RETRY;
 		goto func_exit;
@@ -1535,6 +1537,7 @@ row_sel(
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
 	ibool		search_latch_locked;
+	rw_lock_t*	search_latch			= NULL;
 	ibool		consistent_read;
 
 	/* The following flag becomes TRUE when we are doing a
@@ -1613,20 +1616,26 @@ table_loop:
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			search_latch = btr_get_search_latch(plan->index);
+			rw_lock_s_lock(search_latch);
 
 			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_X_WAIT) {
-
-			/* There is an x-latch request waiting: release the
-			s-latch for a moment; as an s-latch here is often
-			kept for some 10 searches before being released,
-			a waiting x-latch request would block other threads
-			from acquiring an s-latch for a long time, lowering
+		} else if (search_latch != btr_get_search_latch(plan->index)
+			   || rw_lock_get_writer(search_latch)
+			   == RW_LOCK_X_WAIT) {
+
+			/* Either the index of this plan maps to another
+			adaptive hash index partition, or there is an
+			x-latch request waiting: release the s-latch for
+			a moment; as an s-latch here is often kept for
+			some 10 searches before being released, a waiting
+			x-latch request would block other threads from
+			acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
+			search_latch = btr_get_search_latch(plan->index);
+			rw_lock_s_lock(search_latch);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan,
@@ -1651,7 +1660,7 @@ table_loop:
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 
 		search_latch_locked = FALSE;
 	}
@@ -1926,7 +1935,8 @@ skip_lock:
 			}
 		} else if (!srv_read_only_mode
 			   && !lock_sec_rec_cons_read_sees(
-				   rec, index, node->read_view)) {
+				   rec, btr_pcur_get_block(&plan->pcur),
+				   index, node->read_view)) {
 
 			cons_read_requires_clust_rec = TRUE;
 		}
@@ -2245,7 +2255,7 @@ lock_wait_or_error:
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 	}
 
 	if (heap != NULL) {
@@ -3712,7 +3722,31 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
+Sets the number of rows that the next batch may fetch to the fetch cache.
+The number grows with the number of rows that have been fetched after
+positioning the cursor, so that long range scans restore the cursor and
+latch the index pages less often, while short scans do not pay for
+converting rows that are never used. */
+UNIV_INLINE
+void
+row_sel_fetch_cache_resize(
+/*=======================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ut_ad(prebuilt->n_fetch_cached == 0);
+
+	const ulint	max_rows = ut_max(
+		static_cast<ulint>(MYSQL_FETCH_CACHE_SIZE),
+		MYSQL_FETCH_CACHE_MAX_BYTES / (prebuilt->mysql_row_len + 8));
+
+	prebuilt->fetch_cache_limit = ut_min(
+		max_rows,
+		ut_max(static_cast<ulint>(MYSQL_FETCH_CACHE_SIZE),
+		       prebuilt->n_rows_fetched));
+}
+
+/********************************************************************//**
+Initialise the prefetch cache for fetch_cache_limit rows. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
@@ -3723,11 +3757,18 @@ row_sel_prefetch_cache_init(
 	ulint	sz;
 	byte*	ptr;
 
+	ut_ad(prebuilt->fetch_cache == NULL);
+
+	prebuilt->fetch_cache_size = prebuilt->fetch_cache_limit;
+
+	prebuilt->fetch_cache = static_cast<byte**>(
+		ut_malloc_nokey(prebuilt->fetch_cache_size * sizeof(byte*)));
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = prebuilt->fetch_cache_size * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < prebuilt->fetch_cache_size; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3754,12 +3795,14 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache, or replace it
+		with a larger one */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
+		row_prebuilt_free_fetch_cache(prebuilt);
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
@@ -4346,7 +4389,7 @@ row_search_mvcc(
 
 	if (trx->has_search_latch
 #ifndef INNODB_RW_LOCKS_USE_ATOMICS
-	    && rw_lock_get_writer(&btr_search_latch) != RW_LOCK_NOT_LOCKED
+	    && rw_lock_get_writer(trx->search_latch) != RW_LOCK_NOT_LOCKED
 #endif /* !INNODB_RW_LOCKS_USE_ATOMICS */
 	    ) {
 
@@ -4355,10 +4398,17 @@ row_search_mvcc(
 		BTR_SEA_TIMEOUT rounds before trying to keep it again over
 		calls from MySQL */
 
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = false;
+		trx_search_latch_release_if_reserved(trx);
 
 		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
+
+	} else if (trx->has_search_latch
+		   && trx->search_latch != btr_get_search_latch(index)) {
+
+		/* The s-latch kept over calls from MySQL is on the
+		adaptive hash index partition of another index. */
+
+		trx_search_latch_release_if_reserved(trx);
 	}
 
 	/* Reset the new record lock info if srv_locks_unsafe_for_binlog
@@ -4376,6 +4426,7 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		row_sel_fetch_cache_resize(prebuilt);
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -4411,7 +4462,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -4428,6 +4480,8 @@ row_search_mvcc(
 			prebuilt->n_rows_fetched = 500000000;
 		}
 
+		row_sel_fetch_cache_resize(prebuilt);
+
 		mode = pcur->search_mode;
 	}
 
@@ -4477,6 +4531,7 @@ row_search_mvcc(
 	}
 
 	mtr_start(&mtr);
+	mtr.set_scan_ring(prebuilt->scan_ring);
 
 	/*-------------------------------------------------------------*/
 	/* PHASE 2: Try fast adaptive hash index search if possible */
@@ -4516,7 +4571,9 @@ row_search_mvcc(
 			hash index semaphore! */
 
 			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
+				trx->search_latch = btr_get_search_latch(
+					index);
+				rw_lock_s_lock(trx->search_latch);
 				trx->has_search_latch = true;
 			}
 
@@ -4586,8 +4643,8 @@ release_search_latch_if_needed:
 					trx->search_latch_timeout--;
 #endif /* !INNODB_RW_LOCKS_USE_ATOMICS */
 
-					rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = false;
+					trx_search_latch_release_if_reserved(
+						trx);
 				}
 
 				/* NOTE that we do NOT store the cursor
@@ -4603,16 +4660,14 @@ release_search_latch_if_needed:
 
 			mtr_commit(&mtr);
 			mtr_start(&mtr);
+			mtr.set_scan_ring(prebuilt->scan_ring);
 		}
 	}
 
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = false;
-	}
+	trx_search_latch_release_if_reserved(trx);
 
 	spatial_search = dict_index_is_spatial(index)
 			 && mode >= PAGE_CUR_CONTAIN;
@@ -5260,7 +5315,8 @@ no_gap_lock:
 
 			if (!srv_read_only_mode
 			    && !lock_sec_rec_cons_read_sees(
-					rec, index, trx->read_view)) {
+					rec, btr_pcur_get_block(pcur),
+					index, trx->read_view)) {
 				/* We should look at the clustered index.
 				However, as this is a non-locking read,
 				we can skip the clustered index lookup if
@@ -5467,7 +5523,7 @@ requires_clust_rec:
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5520,7 +5576,7 @@ requires_clust_rec:
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
@@ -5645,6 +5701,7 @@ next_rec:
 		mtr_has_extra_clust_latch = FALSE;
 
 		mtr_start(&mtr);
+		mtr.set_scan_ring(prebuilt->scan_ring);
 
 		if (!spatial_search
 		    && sel_restore_position_for_mysql(&same_user_rec,
@@ -5718,6 +5775,7 @@ lock_table_wait:
 
 		thr->lock_state = QUE_THR_LOCK_NOLOCK;
 		mtr_start(&mtr);
+		mtr.set_scan_ring(prebuilt->scan_ring);
 
 		/* Table lock waited, go try to obtain table lock
 		again */
@@ -344,7 +344,7 @@ row_undo_ins_parse_undo_rec(
 
 	ptr = trx_undo_rec_get_pars(node->undo_rec, &type, &dummy,
 				    &dummy_extern, &undo_no, &table_id);
-	ut_ad(type == TRX_UNDO_INSERT_REC);
+	ut_ad(type == TRX_UNDO_INSERT_REC || type == TRX_UNDO_EMPTY);
 	node->rec_type = type;
 
 	node->update = NULL;
@@ -357,6 +357,9 @@ row_undo_ins_parse_undo_rec(
 close_table:
 		dict_table_close(node->table, dict_locked, FALSE);
 		node->table = NULL;
+	} else if (type == TRX_UNDO_EMPTY) {
+		/* There is no row reference; row_undo_ins_empty()
+		empties all the indexes of the table. */
 	} else {
 		clust_index = dict_table_get_first_index(node->table);
 
@@ -440,6 +443,30 @@ func_exit:
 	return(err);
 }
 
+/***********************************************************//**
+Undoes a bulk insert into an empty table by emptying all its indexes.
+The table was locked in exclusive mode for the bulk insert, and the
+table lock is held until the end of the rollback. */
+static
+void
+row_undo_ins_empty(
+/*===============*/
+	undo_node_t*	node)	/*!< in: row undo node */
+{
+	for (dict_index_t* index = dict_table_get_first_index(node->table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (index->type & DICT_FTS) {
+			continue;
+		}
+
+		log_free_check();
+
+		btr_empty_index(index, node->trx->id);
+	}
+}
+
 /***********************************************************//**
 Undoes a fresh insert of a row to a table. A fresh insert means that
 the same clustered index unique key did not have any record, even delete
@@ -469,6 +496,16 @@ row_undo_ins(
 		return(DB_SUCCESS);
 	}
 
+	if (node->rec_type == TRX_UNDO_EMPTY) {
+		row_undo_ins_empty(node);
+
+		dict_table_close(node->table, dict_locked, FALSE);
+
+		node->table = NULL;
+
+		return(DB_SUCCESS);
+	}
+
 	/* Iterate over all the indexes and undo the insert.*/
 
 	node->index = dict_table_get_first_index(node->table);
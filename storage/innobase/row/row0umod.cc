@@ -1120,6 +1120,10 @@ row_undo_mod_parse_undo_rec(
 		return;
 	}
 
+	/* The undo log record is removed by the rollback and will not
+	be seen by purge. */
+	dict_table_purge_lag_sub(node->table, 1);
+
 	clust_index = dict_table_get_first_index(node->table);
 
 	ptr = trx_undo_update_rec_get_sys_cols(ptr, &trx_id, &roll_ptr,
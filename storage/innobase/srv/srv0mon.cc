@@ -25,6 +25,7 @@ Created 12/9/2009 Jimmy Yang
 *******************************************************/
 
 #ifndef UNIV_HOTBACKUP
+#include "btr0sea.h"
 #include "buf0buf.h"
 #include "dict0mem.h"
 #include "ibuf0ibuf.h"
@@ -866,6 +867,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_PADDED},
 
+	{"log_recovery_apply_batches", "recovery",
+	 "Number of page batches handed to the recovery apply threads",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT | MONITOR_DEFAULT_ON),
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_RECV_APPLY_BATCHES},
+
+	{"log_recovery_apply_pages", "recovery",
+	 "Number of pages processed by the recovery apply threads",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT | MONITOR_DEFAULT_ON),
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_RECV_APPLY_PAGES},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
@@ -923,6 +936,24 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_INDEX_DISCARD},
 
+	{"index_sec_rec_page_visible", "index",
+	 "Number of consistent reads of secondary index records that"
+	 " skipped the clustered index lookup because the read view sees"
+	 " every transaction that may have modified the page",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_SEC_REC_PAGE_VISIBLE},
+
+	{"index_stats_sampled_pages", "index",
+	 "Number of leaf pages analyzed by persistent statistics sampling",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_STATS_SAMPLED_PAGES},
+
+	{"index_stats_reused_pages", "index",
+	 "Number of leaf page samples that persistent statistics sampling"
+	 " reused from the previous calculation",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_STATS_REUSED_PAGES},
+
 	/* ========== Counters for Adaptive Hash Index ========== */
 	{"module_adaptive_hash", "adaptive_hash_index", "Adpative Hash Index",
 	 MONITOR_MODULE,
@@ -939,6 +970,13 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE},
 
+	{"adaptive_hash_searches_failed", "adaptive_hash_index",
+	 "Number of searches that tried the Adaptive Hash Index and fell"
+	 " back to the B-tree",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_FAIL},
+
 	{"adaptive_hash_pages_added", "adaptive_hash_index",
 	 "Number of index pages on which the Adaptive Hash Index is built",
 	 MONITOR_NONE,
@@ -1033,6 +1071,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_IBUF_SIZE},
 
+	{"ibuf_merge_batches", "change_buffer",
+	 "Number of batches of page reads issued by the change buffer"
+	 " merge threads",
+	 MONITOR_DEFAULT_ON,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_BATCHES},
+
+	{"ibuf_merge_batch_pages", "change_buffer",
+	 "Number of pages read for merging by the change buffer"
+	 " merge threads",
+	 MONITOR_DEFAULT_ON,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_BATCH_PAGES},
+
 	/* ========== Counters for server operations ========== */
 	{"module_innodb", "innodb",
 	 "Counter for general InnoDB server wide operations and properties",
@@ -1656,6 +1706,14 @@ srv_mon_process_existing_counter(
 		value = srv_stats.log_padded;
 		break;
 
+	case MONITOR_OVLD_RECV_APPLY_BATCHES:
+		value = srv_stats.recv_apply_batches;
+		break;
+
+	case MONITOR_OVLD_RECV_APPLY_PAGES:
+		value = srv_stats.recv_apply_pages;
+		break;
+
 	/* innodb_dblwr_writes */
 	case MONITOR_OVLD_SRV_DBLWR_WRITES:
 		value = srv_stats.dblwr_writes;
@@ -1841,6 +1899,11 @@ srv_mon_process_existing_counter(
 		value = btr_cur_n_non_sea;
 		break;
 
+	case MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_FAIL:
+		value = btr_search_sys != NULL
+			? btr_search_get_n_hash_fail() : 0;
+		break;
+
 	default:
 		ut_error;
 	}
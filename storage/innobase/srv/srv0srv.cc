@@ -151,6 +151,12 @@ on duplicate key checking and foreign key checking */
 ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size = 1048576;
+/** Number of threads that sort and merge the entries of each
+index in index creation */
+ulong	srv_parallel_ddl_threads = 1;
+/** Number of threads that count the records of a table in a
+consistent read */
+ulong	srv_parallel_read_threads = 1;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
 
@@ -160,6 +166,10 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio = TRUE;
 
+/** If this flag is TRUE, Linux native aio is done with io_uring instead
+of libaio (provided we compiled Innobase with it in) */
+my_bool	srv_use_io_uring = FALSE;
+
 /*------------------------- LOG FILES ------------------------ */
 char*	srv_log_group_home_dir	= NULL;
 
@@ -216,6 +226,10 @@ ulint	srv_buf_pool_base_size	= 0;
 ulint	srv_buf_pool_curr_size	= 0;
 /** Dump this % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/** Seconds between periodic buffer pool dumps, 0 if disabled */
+ulong	srv_buf_pool_dump_interval = 0;
+/** Number of threads that read pages during a buffer pool load */
+ulong	srv_buf_pool_load_threads = 4;
 /** Lock table size in bytes */
 ulint	srv_lock_table_size	= ULINT_MAX;
 
@@ -236,6 +250,10 @@ ulong	srv_read_ahead_threshold	= 56;
 of the buffer pool. */
 uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
 
+/** Number of change buffer merge threads, innodb_change_buffer_merge_threads.
+0 leaves the change buffer merge to the master thread. */
+ulong	srv_n_ibuf_merge_threads = 0;
+
 /* This parameter is used to throttle the number of insert buffers that are
 merged in a batch. By increasing this parameter on a faster disk you can
 possibly reduce the number of I/O operations performed to complete the
@@ -262,6 +280,10 @@ ulong	srv_max_io_capacity     = 400;
 /* The number of page cleaner threads to use.*/
 ulong	srv_n_page_cleaners = 1;
 
+/* The number of threads applying redo log records during crash recovery;
+0 means that the records are applied by the recovery thread itself. */
+ulong	srv_n_recv_apply_threads = 0;
+
 /* The InnoDB main thread tries to keep the ratio of modified pages
 in the buffer pool to all database pages in the buffer pool smaller than
 the following number. But it is not guaranteed that the value stays below
@@ -308,6 +330,9 @@ ulong	srv_force_recovery_crash;
 
 my_bool	srv_print_all_deadlocks = FALSE;
 
+/** When to search for deadlocks, innodb_deadlock_detect */
+ulong	srv_deadlock_detect = SRV_DEADLOCK_DETECT_IMMEDIATE;
+
 /** Enable INFORMATION_SCHEMA.innodb_cmp_per_index */
 my_bool	srv_cmp_per_index_enabled = FALSE;
 
@@ -329,6 +354,10 @@ this many index pages, there are 2 ways to calculate statistics:
 unsigned long long	srv_stats_transient_sample_pages = 8;
 my_bool		srv_stats_persistent = TRUE;
 unsigned long long	srv_stats_persistent_sample_pages = 20;
+/* number of threads that calculate the persistent stats of a table */
+ulong		srv_stats_persistent_threads = 1;
+/* whether the persistent stats reuse the samples of unmodified subtrees */
+my_bool		srv_stats_persistent_incremental = FALSE;
 my_bool		srv_stats_auto_recalc = TRUE;
 
 ibool	srv_use_doublewrite_buf	= TRUE;
@@ -1176,9 +1205,7 @@ srv_printf_innodb_monitor(
 	      "-------------------------------------\n", file);
 	ibuf_print(file);
 
-	rw_lock_s_lock(&btr_search_latch);
-	ha_print_info(file, btr_search_sys->hash_index);
-	rw_lock_s_unlock(&btr_search_latch);
+	btr_search_print_info(file);
 
 	fprintf(file,
 		"%.2f hash searches/s, %.2f non-hash searches/s\n",
@@ -1751,6 +1778,8 @@ srv_any_background_threads_are_active(void)
 		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
+	} else if (ibuf_merge_threads_active()) {
+		thread_active = "ibuf_merge_thread";
 	}
 
 	os_event_set(srv_error_event);
@@ -1424,10 +1424,19 @@ innobase_start_or_create_for_mysql(void)
 		break;
 	}
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+
+# ifndef LINUX_NATIVE_AIO
+	/* Without libaio, Linux native AIO is only available
+	through io_uring. */
+	if (!srv_use_io_uring) {
+		srv_use_native_aio = FALSE;
+	}
+# endif /* !LINUX_NATIVE_AIO */
 
 	if (srv_use_native_aio) {
-		ib_logf(IB_LOG_LEVEL_INFO, "Using Linux native AIO");
+		ib_logf(IB_LOG_LEVEL_INFO, "Using Linux native AIO%s",
+			srv_use_io_uring ? " with io_uring" : "");
 	}
 #else
 	/* Currently native AIO is supported only on windows and linux
@@ -1436,6 +1445,11 @@ innobase_start_or_create_for_mysql(void)
 	srv_use_native_aio = FALSE;
 #endif /* _WIN32 */
 
+#ifndef LINUX_IO_URING
+	/* io_uring is only available when the support is compiled in */
+	srv_use_io_uring = FALSE;
+#endif /* !LINUX_IO_URING */
+
 	if (srv_file_flush_method_str == NULL) {
 		/* These are the default options */
 #ifndef _WIN32
@@ -1505,6 +1519,7 @@ innobase_start_or_create_for_mysql(void)
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
 			    + srv_n_page_cleaners
+			    + srv_n_recv_apply_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -2505,6 +2520,13 @@ files_checked:
 		/* Create the dict stats gathering thread */
 		os_thread_create(dict_stats_thread, NULL, NULL);
 
+		/* Create the change buffer merge threads */
+		if (srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE) {
+			for (ulint i = 0; i < srv_n_ibuf_merge_threads; ++i) {
+				os_thread_create(ibuf_merge_thread, NULL, NULL);
+			}
+		}
+
 		/* Create the thread that will optimize the FTS sub-system. */
 		fts_optimize_init();
 
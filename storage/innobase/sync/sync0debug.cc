@@ -600,8 +600,9 @@ SyncDebug::check_order(const latch_t* latch)
 	case SYNC_ANY_LATCH:
 	case SYNC_FILE_FORMAT_TAG:
 	case SYNC_DOUBLEWRITE:
-	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
+	case SYNC_MVCC:
+	case SYNC_LOCK_REC_SHARD:
 	case SYNC_LOCK_SYS:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
@@ -637,6 +638,19 @@ SyncDebug::check_order(const latch_t* latch)
 		}
 		break;
 
+	case SYNC_SEARCH_SYS:
+		/* btr_search_x_lock_all() latches every adaptive hash
+		index partition, in ascending partition order. */
+
+		/* Fall through */
+
+	case SYNC_LOCK_SYS_LATCH:
+		/* lock_rec_shards_x_lock() latches every record lock
+		shard, in ascending shard order, and the holders of a
+		page shard may latch another one. */
+
+		/* Fall through */
+
 	case SYNC_BUF_FLUSH_LIST:
 	case SYNC_BUF_POOL:
 
@@ -1078,6 +1092,10 @@ sync_latch_meta_init()
 		  SYNC_LOCK_SYS,
 		  lock_mutex_key);
 
+	LATCH_ADD(SrvLatches, "lock_rec_shard",
+		  SYNC_LOCK_REC_SHARD,
+		  lock_rec_shard_mutex_key);
+
 	LATCH_ADD(SrvLatches, "lock_sys_wait",
 		  SYNC_LOCK_WAIT_SYS,
 		  lock_wait_mutex_key);
@@ -1086,6 +1104,10 @@ sync_latch_meta_init()
 		  SYNC_TRX_SYS,
 		  trx_sys_mutex_key);
 
+	LATCH_ADD(SrvLatches, "mvcc",
+		  SYNC_MVCC,
+		  mvcc_mutex_key);
+
 	LATCH_ADD(SrvLatches, "srv_sys",
 		  SYNC_THREADS,
 		  srv_sys_mutex_key);
@@ -1154,6 +1176,14 @@ sync_latch_meta_init()
 		  SYNC_NO_ORDER_CHECK,
 		  PFS_NOT_INSTRUMENTED);
 
+	LATCH_ADD(SrvLatches, "os_aio_uring_mutex",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
+	LATCH_ADD(SrvLatches, "buf_load_mutex",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
 	LATCH_ADD(SrvLatches, "row_drop_list",
 		  SYNC_NO_ORDER_CHECK,
 		  row_drop_list_mutex_key);
@@ -1209,6 +1239,10 @@ sync_latch_meta_init()
 		  SYNC_PURGE_LATCH,
 		  trx_purge_latch_key);
 
+	LATCH_ADD(SrvLatches, "lock_sys_latch",
+		  SYNC_LOCK_SYS_LATCH,
+		  lock_sys_latch_key);
+
 	LATCH_ADD(SrvLatches, "ibuf_index_tree",
 		  SYNC_IBUF_INDEX_TREE,
 		  index_tree_rw_lock_key);
@@ -92,7 +92,9 @@ mysql_pfs_key_t	trx_pool_mutex_key;
 mysql_pfs_key_t	trx_pool_manager_mutex_key;
 mysql_pfs_key_t	lock_mutex_key;
 mysql_pfs_key_t	lock_wait_mutex_key;
+mysql_pfs_key_t	lock_rec_shard_mutex_key;
 mysql_pfs_key_t	trx_sys_mutex_key;
+mysql_pfs_key_t	mvcc_mutex_key;
 mysql_pfs_key_t	srv_sys_mutex_key;
 mysql_pfs_key_t	srv_threads_mutex_key;
 #ifndef HAVE_ATOMIC_BUILTINS
@@ -126,6 +128,7 @@ mysql_pfs_key_t	fts_cache_rw_lock_key;
 mysql_pfs_key_t	fts_cache_init_rw_lock_key;
 mysql_pfs_key_t trx_i_s_cache_lock_key;
 mysql_pfs_key_t	trx_purge_latch_key;
+mysql_pfs_key_t	lock_sys_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 /** The number of iterations in the mutex_spin_wait() spin loop.
@@ -1366,7 +1366,7 @@ trx_i_s_possibly_fetch_data_into_cache(
 
 	/* We need to read trx_sys and record/table lock queues */
 
-	lock_mutex_enter();
+	lock_mutex_enter_all();
 
 	trx_sys_mutex_enter();
 
@@ -1374,7 +1374,7 @@ trx_i_s_possibly_fetch_data_into_cache(
 
 	trx_sys_mutex_exit();
 
-	lock_mutex_exit();
+	lock_mutex_exit_all();
 
 	return(0);
 }
@@ -31,6 +31,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0purge.ic"
 #endif
 
+#include "dict0dict.h"
 #include "fsp0fsp.h"
 #include "fut0fut.h"
 #include "mach0data.h"
@@ -264,7 +265,13 @@ trx_purge_sys_create(
 
 	purge_sys->view_active = true;
 
+	purge_sys->view_up_limit_id = purge_sys->view.up_limit_id();
+
 	purge_sys->rseg_iter = UT_NEW_NOKEY(TrxUndoRsegsIterator(purge_sys));
+
+	purge_sys->tables = UT_NEW_NOKEY(purge_table_map_t());
+
+	purge_sys->heap = mem_heap_create(UNIV_PAGE_SIZE);
 }
 
 /************************************************************************
@@ -302,6 +309,10 @@ trx_purge_sys_close(void)
 
 	UT_DELETE(purge_sys->rseg_iter);
 
+	UT_DELETE(purge_sys->tables);
+
+	mem_heap_free(purge_sys->heap);
+
 	ut_free(purge_sys);
 
 	purge_sys = NULL;
@@ -1565,6 +1576,151 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Minimum number of records of a table that are handed to one purge
+worker before the table can move to a less loaded worker. */
+#define TRX_PURGE_TABLE_CHUNK	64
+
+/** Purge worker threads of a batch */
+typedef std::vector<que_thr_t*, ut_allocator<que_thr_t*> >	purge_thrs_t;
+
+/** Get the table id of an undo log record to purge.
+@param[in]	undo_rec	undo log record
+@return table id, or 0 for trx_purge_dummy_rec */
+static
+table_id_t
+trx_purge_get_table_id(
+	trx_undo_rec_t*	undo_rec)
+{
+	ulint		type;
+	ulint		cmpl_info;
+	bool		updated_extern;
+	undo_no_t	undo_no;
+	table_id_t	table_id;
+
+	if (undo_rec == &trx_purge_dummy_rec) {
+		return(0);
+	}
+
+	trx_undo_rec_get_pars(
+		undo_rec, &type, &cmpl_info, &updated_extern,
+		&undo_no, &table_id);
+
+	return(table_id);
+}
+
+/** Find the purge worker that has been handed the fewest records.
+@param[in]	n_recs		number of records of each worker
+@param[in]	n_workers	number of workers
+@return index of the least loaded worker */
+static
+ulint
+trx_purge_least_loaded(
+	const ulint*	n_recs,
+	ulint		n_workers)
+{
+	ulint	worker = 0;
+
+	for (ulint i = 1; i < n_workers; ++i) {
+		if (n_recs[i] < n_recs[worker]) {
+			worker = i;
+		}
+	}
+
+	return(worker);
+}
+
+/** Choose the purge worker for an undo log record. The records of a
+table go to the same worker, so that the workers operate on disjoint
+sets of tables. A table that has more than its fair share of the batch
+is handed out in chunks, each to the least loaded worker at the time.
+@param[in,out]	tables		tables of the batch
+@param[in]	table_id	table of the record, 0 if none
+@param[in,out]	n_recs		number of records of each worker
+@param[in]	n_workers	number of workers
+@param[in]	n_total		number of records in the batch so far
+@return index of the worker */
+static
+ulint
+trx_purge_choose_worker(
+	purge_table_map_t*	tables,
+	table_id_t		table_id,
+	ulint*			n_recs,
+	ulint			n_workers,
+	ulint			n_total)
+{
+	ulint	worker;
+
+	if (table_id == 0) {
+		worker = trx_purge_least_loaded(n_recs, n_workers);
+
+	} else {
+		purge_table_map_t::iterator	it = tables->find(table_id);
+
+		if (it == tables->end()) {
+			purge_table_batch_t	batch;
+
+			batch.worker = trx_purge_least_loaded(
+				n_recs, n_workers);
+			batch.n_chunk = 0;
+			batch.n_recs = 0;
+
+			it = tables->insert(
+				purge_table_map_t::value_type(
+					table_id, batch)).first;
+
+		} else if (it->second.n_chunk >= ut_max(
+				   static_cast<ulint>(TRX_PURGE_TABLE_CHUNK),
+				   n_total / n_workers)) {
+
+			it->second.worker = trx_purge_least_loaded(
+				n_recs, n_workers);
+			it->second.n_chunk = 0;
+		}
+
+		++it->second.n_chunk;
+		++it->second.n_recs;
+
+		worker = it->second.worker;
+	}
+
+	++n_recs[worker];
+
+	return(worker);
+}
+
+/** Update the purge lag of the tables of a completed purge batch.
+@param[in]	tables	tables of the batch */
+static
+void
+trx_purge_update_table_lag(
+	const purge_table_map_t*	tables)
+{
+	if (tables->empty()) {
+		return;
+	}
+
+	mutex_enter(&dict_sys->mutex);
+
+	for (purge_table_map_t::const_iterator it = tables->begin();
+	     it != tables->end();
+	     ++it) {
+
+		dict_table_t*	table;
+
+		/* Tables that are not in the cache have no lag to
+		update; do not load them. */
+		HASH_SEARCH(id_hash, dict_sys->table_id_hash,
+			    ut_fold_ull(it->first), dict_table_t*, table,
+			    ut_ad(table->cached), table->id == it->first);
+
+		if (table != NULL) {
+			dict_table_purge_lag_sub(table, it->second.n_recs);
+		}
+	}
+
+	mutex_exit(&dict_sys->mutex);
+}
+
 /*******************************************************************//**
 This function runs a purge batch.
 @return number of undo log pages handled in the batch */
@@ -1579,12 +1735,20 @@ trx_purge_attach_undo_recs(
 	que_thr_t*	thr;
 	ulint		i = 0;
 	ulint		n_pages_handled = 0;
-	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	ulint		n_total = 0;
+	purge_thrs_t	thrs;
 
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->limit = purge_sys->iter;
 
+	purge_sys->tables->clear();
+
+	/* The workers of the previous batch have completed. */
+	mem_heap_empty(purge_sys->heap);
+
+	thrs.reserve(n_purge_threads);
+
 	/* Debug code to validate some pre-requisites and reset done flag. */
 	for (thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
 	     thr != NULL && i < n_purge_threads;
@@ -1598,35 +1762,29 @@ trx_purge_attach_undo_recs(
 		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
 		ut_a(node->undo_recs == NULL);
 		ut_a(node->done);
+		ut_a(!thr->is_active);
 
 		node->done = FALSE;
+
+		thrs.push_back(thr);
 	}
 
 	/* There should never be fewer nodes than threads, the inverse
 	however is allowed because we only use purge threads as needed. */
 	ut_a(i == n_purge_threads);
 
-	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
-	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-	ut_a(n_thrs > 0 && thr != NULL);
+	/* Number of records handed to each worker */
+	ulint*	n_recs = static_cast<ulint*>(
+		ut_zalloc_nokey(n_purge_threads * sizeof(*n_recs)));
 
 	ut_ad(trx_purge_check_limit());
 
-	i = 0;
-
+	/* Fetch and parse the UNDO records. The UNDO records are added
+	to a per purge node vector. The records of a table go to the
+	same node, see trx_purge_choose_worker(). */
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t		purge_rec;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1635,40 +1793,46 @@ trx_purge_attach_undo_recs(
 			purge_sys->limit = purge_sys->iter;
 		}
 
-		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+		/* Fetch the next record, and advance the purge_sys->iter.
+		The worker is only known once the record has been read,
+		so the record is copied to the heap of the batch. */
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-		if (purge_rec->undo_rec != NULL) {
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		ulint	worker = trx_purge_choose_worker(
+			purge_sys->tables,
+			trx_purge_get_table_id(purge_rec.undo_rec),
+			n_recs, n_purge_threads, n_total);
 
-			ib_vector_push(node->undo_recs, purge_rec);
+		++n_total;
 
-			if (n_pages_handled >= batch_size) {
+		node = static_cast<purge_node_t*>(thrs[worker]->child);
+		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
 
-				break;
-			}
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
 		} else {
-			break;
+			ut_a(!ib_vector_is_empty(node->undo_recs));
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		ib_vector_push(node->undo_recs, &purge_rec);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-		}
+		if (n_pages_handled >= batch_size) {
 
-		ut_a(thr != NULL);
+			break;
+		}
 	}
 
+	ut_free(n_recs);
+
 	ut_ad(trx_purge_check_limit());
 
 	return(n_pages_handled);
@@ -1808,6 +1972,10 @@ trx_purge(
 
 	purge_sys->view_active = true;
 
+	if (purge_sys->view.up_limit_id() > purge_sys->view_up_limit_id) {
+		purge_sys->view_up_limit_id = purge_sys->view.up_limit_id();
+	}
+
 	rw_lock_x_unlock(&purge_sys->latch);
 
 #ifdef UNIV_DEBUG
@@ -1867,6 +2035,8 @@ run_synchronously:
 
 	ut_a(purge_sys->n_submitted == purge_sys->n_completed);
 
+	trx_purge_update_table_lag(purge_sys->tables);
+
 #ifdef UNIV_DEBUG
 	rw_lock_x_lock(&purge_sys->latch);
 	if (purge_sys->limit.trx_no == 0) {
@@ -1906,6 +2076,24 @@ trx_purge_state(void)
 	return(state);
 }
 
+/*******************************************************************//**
+Determines whether every read view, present or future, sees the changes
+of all transactions whose id is not bigger than trx_id.
+@return true if the changes are visible to all read views */
+
+bool
+trx_purge_all_visible(
+/*==================*/
+	trx_id_t	trx_id)		/*!< in: transaction id */
+{
+	/* The purge view is a copy of the oldest read view, and no
+	view that is opened later can be older than it. We do not
+	acquire purge_sys->latch, because the callers may hold latches
+	that rank below it. A stale value is smaller and thus safe. */
+
+	return(purge_sys != NULL && trx_id < purge_sys->view_up_limit_id);
+}
+
 /*******************************************************************//**
 Stop purge and wait for it to stop, move to PURGE_STATE_STOP. */
 
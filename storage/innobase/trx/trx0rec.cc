@@ -215,7 +215,10 @@ trx_undo_page_report_insert(
 	trx_t*		trx,		/*!< in: transaction */
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: index entry which will be
-					inserted to the clustered index */
+					inserted to the clustered index,
+					or NULL to write a TRX_UNDO_EMPTY
+					record for a bulk insert into an
+					empty table */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	ulint		first_free;
@@ -243,9 +246,16 @@ trx_undo_page_report_insert(
 	ptr += 2;
 
 	/* Store first some general parameters to the undo log */
-	*ptr++ = TRX_UNDO_INSERT_REC;
+	*ptr++ = clust_entry != NULL ? TRX_UNDO_INSERT_REC : TRX_UNDO_EMPTY;
 	ptr += mach_u64_write_much_compressed(ptr, trx->undo_no);
 	ptr += mach_u64_write_much_compressed(ptr, index->table->id);
+
+	if (clust_entry == NULL) {
+		/* The rollback of a bulk insert empties the table;
+		no row reference is needed. */
+		return(trx_undo_page_set_next_prev_and_add(
+			       undo_page, ptr, mtr));
+	}
 	/*----------------------------------------*/
 	/* Store then the fields required to uniquely determine the record
 	to be inserted in the clustered index */
@@ -1246,7 +1256,9 @@ trx_undo_report_row_operation(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: in the case of an insert,
 					index entry to insert into the
-					clustered index, otherwise NULL */
+					clustered index, or NULL for a
+					TRX_UNDO_EMPTY record; otherwise
+					NULL */
 	const upd_t*	update,		/*!< in: in the case of an update,
 					the update vector, otherwise NULL */
 	ulint		cmpl_info,	/*!< in: compiler info on secondary
@@ -1284,7 +1296,7 @@ trx_undo_report_row_operation(
 	ut_ad(thr);
 	ut_ad(!srv_read_only_mode);
 	ut_ad((op_type != TRX_UNDO_INSERT_OP)
-	      || (clust_entry && !update && !rec));
+	      || (!update && !rec));
 
 	trx = thr_get_trx(thr);
 
@@ -1444,6 +1456,10 @@ trx_undo_report_row_operation(
 
 			mutex_exit(&trx->undo_mutex);
 
+			if (op_type == TRX_UNDO_MODIFY_OP && !is_temp_table) {
+				dict_table_purge_lag_inc(index->table);
+			}
+
 			*roll_ptr = trx_undo_build_roll_ptr(
 				op_type == TRX_UNDO_INSERT_OP,
 				undo_ptr->rseg->id, page_no, offset);
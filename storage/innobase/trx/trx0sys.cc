@@ -465,6 +465,9 @@ trx_sys_init_at_db_start(void)
 
 	trx_sys_mutex_enter();
 
+	/* Publish the resurrected transactions for read view creation. */
+	trx_sys->mvcc->snapshot_publish();
+
 	if (UT_LIST_GET_LEN(trx_sys->rw_trx_list) > 0) {
 		const trx_t*	trx;
 
@@ -627,6 +627,7 @@ trx_resurrect_table_locks(
 	page_t*			undo_page;
 	trx_undo_rec_t*		undo_rec;
 	table_id_set		tables;
+	table_id_set		empty_tables;
 
 	ut_ad(undo == undo_ptr->insert_undo || undo == undo_ptr->update_undo);
 
@@ -673,6 +674,12 @@ trx_resurrect_table_locks(
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
 
+		if (type == TRX_UNDO_EMPTY) {
+			/* The rollback will empty the table, so no
+			other transaction may insert into it before. */
+			empty_tables.insert(table_id);
+		}
+
 		undo_rec = trx_undo_get_prev_rec(
 			undo_rec, undo->hdr_page_no,
 			undo->hdr_offset, false, &mtr);
@@ -693,12 +700,17 @@ trx_resurrect_table_locks(
 				continue;
 			}
 
-			lock_table_ix_resurrect(table, trx);
+			const bool	empty = empty_tables.find(*i)
+				!= empty_tables.end();
+
+			lock_table_resurrect(
+				table, trx, empty ? LOCK_X : LOCK_IX);
 
 			DBUG_PRINT("ib_trx",
 				   ("resurrect" TRX_ID_FMT
-				    "  table '%s' IX lock from %s undo",
+				    "  table '%s' %s lock from %s undo",
 				    trx_get_id_for_print(trx), table->name,
+				    empty ? "X" : "IX",
 				    undo == undo_ptr->insert_undo
 				    ? "insert" : "update"));
 
@@ -1220,6 +1232,8 @@ trx_assign_rseg(
 
 		trx_sys->rw_trx_ids.push_back(trx->id);
 
+		trx_sys->mvcc->snapshot_publish();
+
 		trx_sys->rw_trx_set.insert(TrxTrack(trx->id, trx));
 
 		mutex_exit(&trx_sys->mutex);
@@ -1313,6 +1327,8 @@ trx_start_low(
 
 		trx_sys->rw_trx_ids.push_back(trx->id);
 
+		trx_sys->mvcc->snapshot_publish();
+
 		trx_sys_rw_trx_add(trx);
 
 		ut_ad(trx->rsegs.m_redo.rseg != 0
@@ -1353,6 +1369,8 @@ trx_start_low(
 
 				trx_sys->rw_trx_ids.push_back(trx->id);
 
+				trx_sys->mvcc->snapshot_publish();
+
 				trx_sys->rw_trx_set.insert(
 					TrxTrack(trx->id, trx));
 
@@ -1785,6 +1803,8 @@ trx_erase_from_write_set(trx_t* trx, bool serialised)
 	ut_ad(*it == trx->id);
 
 	trx_sys->rw_trx_ids.erase(it);
+
+	trx_sys->mvcc->snapshot_publish();
 }
 
 /****************************************************************//**
@@ -3113,11 +3133,14 @@ trx_set_rw_mode(
 
 	trx_sys->rw_trx_ids.push_back(trx->id);
 
+	trx_sys->mvcc->snapshot_publish();
+
 	trx_sys->rw_trx_set.insert(TrxTrack(trx->id, trx));
 
 	/* So that we can see our own changes. */
 	if (MVCC::is_view_active(trx->read_view)) {
-		MVCC::set_view_creator_trx_id(trx->read_view, trx->id);
+		trx_sys->mvcc->set_view_creator_trx_id(
+			trx->read_view, trx->id);
 	}
 
 #ifdef UNIV_DEBUG